@@ -0,0 +1,138 @@
+#include "ConnectionManager.h"
+#include "DbcSender.h"
+#include <QRegularExpression>
+#include <QDebug>
+
+ConnectionManager::ConnectionManager(QObject *parent) : QObject(parent)
+{
+}
+
+ConnectionManager::~ConnectionManager()
+{
+    for (auto& [node, sender] : senders) {
+        sender->disconnect();
+    }
+}
+
+bool ConnectionManager::isValidNodeName(const QString& node)
+{
+    // Ends up in front of a bus name and in saved configs, so nothing that could be part of either
+    static const QRegularExpression name("^[A-Za-z0-9_.-]+$");
+    return name.match(node).hasMatch();
+}
+
+bool ConnectionManager::splitBus(const QString& qualifiedBus, QString& node, QString& bus)
+{
+    qsizetype colon = qualifiedBus.indexOf(':');
+    if (colon <= 0) {
+        node.clear();
+        bus = qualifiedBus;
+        return false;
+    }
+    node = qualifiedBus.left(colon);
+    bus = qualifiedBus.mid(colon + 1);
+    return true;
+}
+
+bool ConnectionManager::addServer(const QString& node, const QString& address, const QString& port)
+{
+    if (!isValidNodeName(node)) {
+        qWarning() << "ConnectionManager: invalid node name" << node;
+        return false;
+    }
+
+    auto it = senders.find(node);
+    if (it == senders.end()) {
+        auto sender = std::make_unique<DbcSender>(); // Owned here, not by the QObject tree
+        DbcSender* raw = sender.get();
+        connect(raw, &DbcSender::taskEvent, this, [this, node](const QString& taskId, const QString& state, const QString& detail) {
+            emit taskEvent(node, taskId, state, detail);
+        });
+        connect(raw, &DbcSender::taskSendsCounted, this, [this, node](const QString& taskId, int sends) {
+            emit taskSendsCounted(node, taskId, sends);
+        });
+        connect(raw, &DbcSender::connectionLost, this, &ConnectionManager::nodesChanged);
+        connect(raw, &DbcSender::reconnected, this, &ConnectionManager::nodesChanged);
+        it = senders.emplace(node, std::move(sender)).first;
+    } else if (it->second->isConnected()) {
+        it->second->disconnect();
+    }
+
+    // A node removed before it has connected cancels this along with its DbcSender
+    it->second->initiateConnection(address, port).then(it->second.get(), [this, node, address, port](qint8 result) {
+        qDebug() << "ConnectionManager: node" << node << "at" << address + ":" + port << (result == 0 ? "connected" : "failed");
+        emit nodesChanged();
+        emit serverAdded(node, result);
+    });
+    return true;
+}
+
+bool ConnectionManager::removeServer(const QString& node)
+{
+    auto it = senders.find(node);
+    if (it == senders.end()) {
+        return false;
+    }
+    // Out of the map first, so nothing routes to it while it says goodbye to its server
+    std::unique_ptr<DbcSender> sender = std::move(it->second);
+    senders.erase(it);
+    sender->disconnect();
+    emit nodesChanged();
+    return true;
+}
+
+QStringList ConnectionManager::nodes() const
+{
+    QStringList names;
+    for (const auto& [node, sender] : senders) {
+        names.append(node);
+    }
+    return names;
+}
+
+DbcSender* ConnectionManager::senderFor(const QString& node) const
+{
+    auto it = senders.find(node);
+    return it == senders.end() ? nullptr : it->second.get();
+}
+
+QFuture<QStringList> ConnectionManager::interfaces() const
+{
+    // Every node's LIST_CAN_INTERFACES goes out at once, each on its own pipeline thread
+    QStringList asked;
+    QList<QFuture<QString>> replies;
+    for (const auto& [node, sender] : senders) {
+        if (sender->isConnected()) {
+            asked.append(node);
+            replies.append(sender->requestAsync("LIST_CAN_INTERFACES"));
+        }
+    }
+
+    // "Available CAN interfaces (<n>):" then one indented name per line, or "No CAN interfaces available".
+    // A node that doesn't answer is left out once its request times out
+    return QtFuture::whenAll(replies.begin(), replies.end()).then([asked](const QList<QFuture<QString>>& answered) {
+        QStringList qualified;
+        for (qsizetype i = 0; i < answered.size(); ++i) {
+            if (answered[i].resultCount() == 0 || answered[i].result().isEmpty()) {
+                qDebug() << "ConnectionManager: node" << asked[i] << "did not list its interfaces";
+                continue;
+            }
+            const QStringList lines = answered[i].result().split('\n', Qt::SkipEmptyParts);
+            for (const QString& line : lines) {
+                if (line.startsWith("  ")) {
+                    qualified.append(asked[i] + ':' + line.trimmed());
+                }
+            }
+        }
+        return qualified;
+    });
+}
+
+void ConnectionManager::killAllTasks()
+{
+    for (const auto& [node, sender] : senders) {
+        if (sender->isConnected()) {
+            sender->requestAsync("KILL_ALL_TASKS");
+        }
+    }
+}
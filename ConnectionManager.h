@@ -0,0 +1,48 @@
+#ifndef CONNECTIONMANAGER_H
+#define CONNECTIONMANAGER_H
+#include <QObject>
+#include <QFuture>
+#include <QString>
+#include <QStringList>
+#include <map>
+#include <memory>
+
+class DbcSender;
+
+// The other servers of a distributed test bench, one DbcSender (own pipeline thread, heartbeat and reconnect)
+// per node. DbcParser's own DbcSender stays the default node: its buses keep their plain names, while a bus
+// on another node is called "<node>:<bus>" everywhere in the GUI, so the bus alone says where a task runs
+class ConnectionManager : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ConnectionManager(QObject *parent = nullptr);
+    ~ConnectionManager();
+
+    // Connects (or reconnects) node `node` to the server at address:port in the background; serverAdded has the
+    // outcome. False, and no signal, for a name that can't be part of a bus name
+    bool addServer(const QString& node, const QString& address, const QString& port);
+    bool removeServer(const QString& node); // Disconnects; the node's tasks stop as with any disconnect
+    QStringList nodes() const;
+    DbcSender* senderFor(const QString& node) const; // Null for a node that isn't added
+
+    // "<node>:<bus>" for every connected node's interfaces. The nodes are all asked at once, so the list is
+    // ready once the slowest one has answered rather than after the sum
+    QFuture<QStringList> interfaces() const;
+    void killAllTasks(); // On every node, without waiting for the replies
+
+    // "<node>:<bus>" -> node and bus; false (node empty, bus unchanged) for a plain bus of the default node
+    static bool splitBus(const QString& qualifiedBus, QString& node, QString& bus);
+    static bool isValidNodeName(const QString& node);
+
+signals:
+    // DbcSender's task events, tagged with the node they came from
+    void taskEvent(const QString& node, const QString& taskId, const QString& state, const QString& detail);
+    void taskSendsCounted(const QString& node, const QString& taskId, int sends);
+    void nodesChanged(); // Added, removed, lost or reconnected
+    void serverAdded(const QString& node, qint8 result); // 0 connected, otherwise DbcSender::initiateConnection's error code
+
+private:
+    std::map<QString, std::unique_ptr<DbcSender>> senders; // By node name, so listings come out sorted
+};
+#endif // CONNECTIONMANAGER_H
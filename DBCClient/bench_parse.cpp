@@ -0,0 +1,243 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 Joseph Ogle, Kunal Singh, and Deven Nasso
+
+// Microbenchmark for command dispatch + CANSEND parsing, single thread: the old std::string/stringstream path
+// against the string_view/prefix table path in server.cpp. Prints commands/s and heap allocations per command.
+//   g++ -std=c++20 -O2 -o bench_parse bench_parse.cpp && ./bench_parse
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sstream>
+#include <array>
+#include <optional>
+#include <charconv>
+#include <chrono>
+#include <functional>
+#include <unordered_map>
+#include <cstdlib>
+#include <new>
+
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    ++allocations;
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+bool isValidCanInterface(std::string_view iface) {
+    return iface == "vcan0" || iface == "can0";
+}
+
+// ---- old path: copy of the parser and dispatch before the string_view rewrite ----
+
+std::string trim(const std::string& str) {
+    size_t first = str.find_first_not_of(" \t\r\n\f\v");
+    if (first == std::string::npos) return "";
+    size_t last = str.find_last_not_of(" \t\r\n\f\v");
+    return str.substr(first, last - first + 1);
+}
+
+struct CansendConfig {
+    std::string command;
+    std::string canIdData;
+    std::string canBus;
+    int intervalMs;
+    int priority;
+};
+
+bool parseOld(const std::string& payload, int defaultPriority, CansendConfig& outConfig, std::string& errorMsg) {
+    std::vector<std::string> parts;
+    std::stringstream ss(payload);
+    std::string part;
+    while (std::getline(ss, part, '#')) {
+        parts.push_back(trim(part));
+    }
+    if (parts.size() < 4) {
+        errorMsg = "ERROR: Invalid CANSEND syntax\n";
+        return false;
+    }
+    std::string canId = parts[0];
+    std::string canPayload = parts[1];
+    std::string timeStr = parts[2];
+    std::string canBus = parts[3];
+    if (canId.starts_with("0x") || canId.starts_with("0X")) {
+        canId = canId.substr(2);
+    }
+    if (timeStr.ends_with("ms")) {
+        timeStr = timeStr.substr(0, timeStr.size() - 2);
+    }
+    int parsedPriority = defaultPriority;
+    if (parts.size() >= 5 && !parts[4].empty()) {
+        std::string priorityStr = trim(parts[4]);
+        if (priorityStr.size() == 1 && priorityStr[0] >= '0' && priorityStr[0] <= '9') {
+            parsedPriority = priorityStr[0] - '0';
+        }
+    }
+    if (!isValidCanInterface(canBus)) {
+        errorMsg = "ERROR: CAN interface '" + canBus + "' is not available.\n";
+        return false;
+    }
+    int intervalMs;
+    try {
+        intervalMs = std::stoi(timeStr);
+    } catch (...) {
+        errorMsg = "ERROR: Invalid time value\n";
+        return false;
+    }
+    std::string canIdData = canId + "#" + canPayload;
+    outConfig.command = "cansend " + canBus + " " + canIdData;
+    outConfig.canIdData = canIdData;
+    outConfig.canBus = canBus;
+    outConfig.intervalMs = intervalMs;
+    outConfig.priority = parsedPriority;
+    return true;
+}
+
+// ---- new path: copy of splitFields, parseCansendPayload and matchCommand from server.cpp ----
+
+std::string_view trimView(std::string_view str) {
+    size_t first = str.find_first_not_of(" \t\r\n\f\v");
+    if (first == std::string_view::npos) return {};
+    size_t last = str.find_last_not_of(" \t\r\n\f\v");
+    return str.substr(first, last - first + 1);
+}
+
+template <size_t N>
+size_t splitFields(std::string_view text, char sep, std::array<std::string_view, N>& fields) {
+    size_t count = 0;
+    while (!text.empty() && count < N) {
+        size_t pos = text.find(sep);
+        fields[count++] = trimView(text.substr(0, pos));
+        if (pos == std::string_view::npos) break;
+        text.remove_prefix(pos + 1);
+    }
+    return count;
+}
+
+struct CansendRequest {
+    std::string_view canId;
+    std::string_view canPayload;
+    std::string_view canBus;
+    int intervalMs = 0;
+    int priority = 5;
+};
+
+bool parseNew(std::string_view payload, int defaultPriority, CansendRequest& out, std::string& errorMsg) {
+    std::array<std::string_view, 6> parts;
+    size_t count = splitFields(payload, '#', parts);
+    if (count < 4) {
+        errorMsg = "ERROR: Invalid CANSEND syntax\n";
+        return false;
+    }
+    std::string_view canId = parts[0];
+    std::string_view timeStr = parts[2];
+    if (canId.starts_with("0x") || canId.starts_with("0X")) {
+        canId.remove_prefix(2);
+    }
+    if (timeStr.ends_with("ms")) {
+        timeStr.remove_suffix(2);
+    }
+    int parsedPriority = defaultPriority;
+    if (count >= 5 && parts[4].size() == 1 && parts[4][0] >= '0' && parts[4][0] <= '9') {
+        parsedPriority = parts[4][0] - '0';
+    }
+    if (!isValidCanInterface(parts[3])) {
+        errorMsg = "ERROR: CAN interface '" + std::string(parts[3]) + "' is not available.\n";
+        return false;
+    }
+    int intervalMs = 0;
+    if (std::from_chars(timeStr.data(), timeStr.data() + timeStr.size(), intervalMs).ec != std::errc{}) {
+        errorMsg = "ERROR: Invalid time value\n";
+        return false;
+    }
+    out.canId = canId;
+    out.canPayload = parts[1];
+    out.canBus = parts[3];
+    out.intervalMs = intervalMs;
+    out.priority = parsedPriority;
+    return true;
+}
+
+enum class Command { LIST_TASKS, KILL_ALL_TASKS, KILL_ALL, SEND_TASK, CANSEND, COUNT };
+
+struct CommandPrefix {
+    std::string_view prefix;
+    Command command;
+};
+
+constexpr std::array<CommandPrefix, static_cast<size_t>(Command::COUNT)> commandTable{{
+    {"CANSEND#", Command::CANSEND},
+    {"SEND_TASK#", Command::SEND_TASK},
+    {"LIST_TASKS", Command::LIST_TASKS},
+    {"KILL_ALL_TASKS", Command::KILL_ALL_TASKS},
+    {"KILL_ALL", Command::KILL_ALL},
+}};
+
+constexpr std::optional<Command> matchCommand(std::string_view msg) {
+    for (const auto& entry : commandTable) {
+        if (msg.starts_with(entry.prefix)) return entry.command;
+    }
+    return std::nullopt;
+}
+
+// ---- driver ----
+
+const char* const messages[] = {
+    "CANSEND#0x123#DEADBEEF#100ms#vcan0#7\n",
+    "SEND_TASK#321#CAFEBABE#250#can0\n",
+    "CANSEND#7FF#0102030405060708#10#vcan0#3#catch_up\n",
+};
+
+template <typename Fn>
+void run(const char* label, Fn&& handle) {
+    constexpr int iterations = 2'000'000;
+    long sink = 0;
+    size_t before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        sink += handle(messages[i % 3]);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << label << ": " << static_cast<long>(iterations / elapsed.count()) << " commands/s, "
+              << static_cast<double>(allocations - before) / iterations << " allocations/command"
+              << " (checksum " << sink << ")\n";
+}
+
+int main() {
+    std::array<char, 128> buf{};
+
+    // old: copy into a std::string, scan the unordered_map with rfind, stringstream parse
+    std::unordered_map<std::string, std::function<int(const std::string&)>> commandMap;
+    commandMap["LIST_TASKS"] = [](const std::string&) { return 0; };
+    commandMap["KILL_ALL_TASKS"] = [](const std::string&) { return 0; };
+    commandMap["KILL_ALL"] = [](const std::string&) { return 0; };
+    run("std::string + stringstream", [&](const char* text) {
+        std::string receivedMsg(text);
+        for (const auto& pair : commandMap) {
+            if (receivedMsg.rfind(pair.first, 0) == 0) return pair.second(receivedMsg);
+        }
+        size_t skip = receivedMsg.rfind("SEND_TASK#", 0) == 0 ? 10 : 8;
+        CansendConfig cfg;
+        std::string errorMsg;
+        return parseOld(trim(receivedMsg.substr(skip)), 5, cfg, errorMsg) ? cfg.intervalMs : -1;
+    });
+
+    // new: view over the receive buffer, prefix table, fixed-field parse
+    run("string_view + prefix table", [&](const char* text) {
+        size_t len = std::char_traits<char>::length(text);
+        std::char_traits<char>::copy(buf.data(), text, len);  // stands in for recv()
+        std::string_view receivedMsg(buf.data(), len);
+        auto command = matchCommand(receivedMsg);
+        if (!command || (*command != Command::CANSEND && *command != Command::SEND_TASK)) return 0;
+        CansendRequest cfg;
+        std::string errorMsg;
+        size_t skip = *command == Command::SEND_TASK ? 10 : 8;
+        return parseNew(trimView(receivedMsg.substr(skip)), 5, cfg, errorMsg) ? cfg.intervalMs : -1;
+    });
+    return 0;
+}
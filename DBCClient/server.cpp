@@ -5,36 +5,72 @@
  * @file server.cpp - for Linux
  * @brief Multi-threaded TCP server for scheduling CAN bus transmissions and handling client commands.
  *
- * This server reads configuration from a file (PORT, LOG_LEVEL, WORKER_THREADS), opens a TCP listener,
- * and accepts client connections. Each connection is handled in a dedicated client-handler thread.
- * Scheduling uses an in-process deadline-aware ThreadPool with priority ordering. Tasks fork/exec the
- * system `cansend` utility to perform CAN transmissions.
+ * This server reads configuration from a file (PORT, LOG_LEVEL, WORKER_THREADS), opens a TCP listener
+ * plus a local AF_UNIX socket for clients on the same host, and accepts client connections. Each connection is handled in a dedicated client-handler thread.
+ * Scheduling uses an in-process deadline-aware ThreadPool with priority ordering. Tasks posix_spawnp the
+ * system `cansend` utility directly (no shell) to perform CAN transmissions, one child per task at a time; a
+ * reaper thread collects the children through pidfds + epoll, so workers never block in waitpid.
  *
  * Configuration file (key=value):
  *  - PORT=<port_number>
  *  - LOG_LEVEL=<DEBUG|INFO|WARNING|ERROR|NOLOG>
  *  - WORKER_THREADS=<n>   # optional, clamped to at least 1
+ *  - MISS_POLICY=<DROP|SKIP|CATCH_UP>   # optional, default SKIP
+ *  - DEADLINE_TOLERANCE_MS=<n>          # optional, lateness before a tick counts as missed, default 2
+ *  - CATCH_UP_BURST=<n>                 # optional, max back-to-back sends for CATCH_UP, default 5
+ *  - TASK_JOURNAL=<path>                # optional, journal of leased tasks, default tasks.journal, empty disables
+ *  - DEFAULT_LEASE_MS=<n>               # optional, lease given to every new task, default 0 (no lease)
+ *  - SESSION_GRACE_MS=<n>               # optional, how long a dropped session's tasks keep running, default 30000
+ *  - TASK_HISTORY_SIZE=<n>              # optional, finished tasks listed per client (ring buffer), default 100
+ *  - UNIX_SOCKET=<path>                 # optional, local control socket, default /tmp/can-scheduler.sock, empty disables
  *
  * Client commands (text protocol; server matches prefixes):
- *  - CANSEND#<id>#<payload>#<interval_ms>#<interface>[#priority]
+ *  - CANSEND#<id>#<payload>#<interval_ms>#<interface>[#priority[#policy]]
  *      Schedule a recurring CAN transmit. Examples:
  *        CANSEND#123#DEADBEEF#1000#vcan0
  *        CANSEND#0x123#deadbeef#250ms#vcan0#7
+ *        CANSEND#0x123#deadbeef#10#vcan0#7#catch_up
  *      Notes: ID may be hex with 0x prefix; time may include "ms" suffix; priority optional (0-9), default 5.
+ *      Policy decides what happens to ticks that started late: drop (skip them all), skip (send once
+ *      and realign to the interval grid) or catch_up (send up to CATCH_UP_BURST back to back). An empty
+ *      policy field takes MISS_POLICY; any other name is answered with an ERROR.
  *
- *  - SEND_TASK#<id>#<payload>#<delay_ms>#<interface>[#priority]
+ *  - SEND_TASK#<id>#<payload>#<delay_ms>#<interface>[#priority[#policy]]
  *      Schedule a single-shot send after delay_ms milliseconds. Same parsing rules as CANSEND.
+ *      With the drop policy a late one-shot is discarded instead of sent.
  *
  *  - LIST_TASKS
- *      Returns per-client task list with status (running, paused, stopped, completed, error) and short error text if available.
+ *      Returns per-client task list with status (running, paused, stopped, completed, error), missed/dropped
+ *      deadline counts and short error text if available. Finished tasks are listed from a bounded history
+ *      (TASK_HISTORY_SIZE); KILL_TASK on one removes it from the history.
+ *
+ *  - LIST_TASKS since=<version> [limit=<n>]
+ *      The same list as records, only those that changed after <version> (0 for all), oldest change first:
+ *        "TASKS <next> <count> <more>" then <count> lines of
+ *        "<task_id> <version> <running|paused|stopped|error> <recurring|once> <interval_ms> <priority> <policy>
+ *         <bus> <id>#<data> <sent> <missed> <dropped> <lease_ms>[ <error>]"  (one line)
+ *        "<task_id> <version> removed"  (killed, or pushed out of the history)
+ *      Pass <next> as since= on the following call; more=1 means limit cut the page short. Send counts don't
+ *      bump a task's version. A version older than this connection's removal log gets "TASKS <version> reset":
+ *      drop everything and list again from 0.
+ *
+ *  - STATUS <task_id>
+ *      Returns the LIST_TASKS line for one task. Looks the ID up server-wide, so it also answers for
+ *      leased tasks no client owns, then in the client's own history of finished tasks.
  *
  *  - PAUSE <task_id>
  *  - RESUME <task_id>
- *      Pause or resume a specific task for this client connection.
+ *      Pause or resume a specific task for this client connection. A paused task is parked (taken out of the
+ *      scheduler queue); RESUME puts it back on its original interval grid, a one-shot at its original time
+ *      if that is still ahead.
  *
  *  - KILL_TASK <task_id>
  *  - KILL_ALL_TASKS
- *      Remove/stop one or all scheduled tasks for this client.
+ *      Remove/stop one or all scheduled tasks for this client. KILL_TASK also finds leased tasks that no client owns.
+ *
+ *  - LEASE <task_id> <ms>
+ *      Keep the task running for <ms> after this client disconnects (0 clears it). Leased tasks are written to
+ *      the task journal and resumed when the server restarts.
  *
  *  - LIST_CAN_INTERFACES
  *      Refresh and list discovered CAN/vCAN interfaces on the host.
@@ -54,12 +90,39 @@
  *  - SHUTDOWN
  *      Client-requested graceful shutdown of the connection (does not stop the server process).
  *
+ *  - SESSION
+ *      Start a session for this connection (or return the current one). Reply: "SESSION <token> <grace_ms>".
+ *      If the connection drops without SHUTDOWN, its tasks keep running for grace_ms.
+ *
+ *  - ATTACH <token>
+ *      Take back the tasks of a dropped session. Reply: "Attached <token>" followed by the task list in
+ *      LIST_TASKS format, or "Session not found".
+ *
+ *  - RESTART
+ *      Re-exec the server process. Leased tasks resume from the journal, all connections are dropped.
+ *
+ *  - SHM_RING
+ *      Local socket only. Creates a shared-memory ring (layout in shm_ring.h) that gets one report per finished
+ *      send of this client's tasks. Reply: "SHM_RING <shm name> <slots>". The segment goes away with the connection.
+ *
+ *  - SUBSCRIBE
+ *      Push this client's task events from now on instead of making it poll LIST_TASKS. Reply: "SUBSCRIBED".
+ *      Events are lines starting with '!', sent only between replies:
+ *        "!TASK <task_id> <created|paused|resumed|completed|stopped|error>[ <error>]"
+ *        "!SENT <task_id> <n>"  (sends since the last !SENT for that task, batched every EVENT_FLUSH_MS)
+ *
+ *  - PING
+ *      Reply: "PONG". The GUI sends it tagged a few times a second to measure round trip time and notice a
+ *      dead connection long before a command would time out.
+ *
  * Protocol notes:
  *  - Server replies to each command with a short text response (OK / ERROR / Unknown command).
- *  - Task IDs are generated as "task_<n>" per client session and returned on scheduling.
+ *  - A command sent as "@<tag> <command>\n" is answered with "@<tag> <length>\n" plus <length> bytes of reply, so a
+ *    client can pipeline many tagged commands on one connection and match the replies up. Untagged commands work as before.
+ *  - Task IDs are generated as "task_<n>", unique across the server (and across restarts), and returned on scheduling.
  *  - The ThreadPool uses std::chrono::steady_clock for deadlines; higher numeric priority runs earlier when deadlines tie.
  *
- * Dependencies: POSIX sockets, fork/wait, C++20, and `cansend` (from can-utils) available in PATH.
+ * Dependencies: POSIX sockets, POSIX shared memory, posix_spawnp, pidfd_open (Linux 5.3+, falls back to waitpid), epoll, C++20, and `cansend` (from can-utils) available in PATH.
  */
 /* priority of todos: 1 high, 2 medium, 3 low
 
@@ -67,7 +130,6 @@ TODOS:
 1 add license stuff
 1 Frontend can decide to keep one-shot messages to resend manually (can change things to accommodate this better), or remove(kill) them
 1 FE also might need to kill tasks (completed/recurring) when they are changed/updated
-1 Old one-shot tasks might build up in memory, but it might not matter
 
 2 maybe add (automatic and manual) check for all busses available to system and send message to client
 2 add button for the above manual bus check in GUI
@@ -77,7 +139,6 @@ TODOS:
 
 3 deadline doesn't seem to work with enough precision. effectively just sleep
 3 make a sequence of one-shots for a simulation of a scenario (Frontend feature idea, maybe already implemented)
-3 add feature to restart server from client
 3 add client window for server log viewing
 3 update frontend info "message" <- forgot what I meant here
 
@@ -93,6 +154,8 @@ add resource monitoring to send to client ui
 #include <stdlib.h>
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <charconv>
 #include <cstring>
 #include <unistd.h>
 #include <sys/types.h>
@@ -102,6 +165,14 @@ add resource monitoring to send to client ui
 #include <arpa/inet.h>
 #include <sys/wait.h>
 #include <signal.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/un.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <sys/syscall.h>
 #include <cerrno>
 #include <system_error>
 #include <fstream>
@@ -115,14 +186,21 @@ add resource monitoring to send to client ui
 #include <mutex>
 #include <vector>
 #include <queue>
+#include <deque>
 #include <functional>
 #include <condition_variable>
 #include <atomic>
 #include <sstream>
 #include <unordered_map>
+#include <utility>
+#include <random>
+#include <new>
+#include "shm_ring.h"
 
 #define BACKLOG 10
 #define MAXDATASIZE 10000
+#define SHM_RING_SLOTS 4096 // per-send reports a local client can fall behind by before they are dropped
+#define EVENT_FLUSH_MS 100 // how often a subscribed client gets its batched send counts
 
 // config file variables. parsed in main
 int port = 0;
@@ -142,6 +220,623 @@ std::string trim(const std::string& str) {
     return str.substr(first, last - first + 1);
 }
 
+// Same as trim, for views into the receive buffer
+std::string_view trimView(std::string_view str) {
+    size_t first = str.find_first_not_of(" \t\r\n\f\v");
+    if (first == std::string_view::npos) return {};
+    size_t last = str.find_last_not_of(" \t\r\n\f\v");
+    return str.substr(first, last - first + 1);
+}
+
+// What a task does when the pool gets to it after its deadline has passed
+enum class MissPolicy {
+    DROP,     // don't send the late tick, next send stays on the original grid
+    SKIP,     // send once now, skip any other missed ticks and re-align to the grid
+    CATCH_UP  // send every missed tick back-to-back, at most catch_up_burst of them
+};
+
+// deadline-miss config. parsed in main, policy can be overridden per task
+MissPolicy default_miss_policy = MissPolicy::SKIP;
+int deadline_tolerance_ms = 2; // lateness allowed before a tick counts as missed
+int catch_up_burst = 5;        // max back-to-back sends for a CATCH_UP task that fell behind
+
+std::optional<MissPolicy> parseMissPolicy(std::string_view str) {
+    auto is = [str](std::string_view name) {  // case-insensitive, without copying str
+        return std::equal(str.begin(), str.end(), name.begin(), name.end(),
+                          [](char a, char b) { return std::toupper(static_cast<unsigned char>(a)) == b; });
+    };
+    if (is("DROP")) return MissPolicy::DROP;
+    if (is("SKIP")) return MissPolicy::SKIP;
+    if (is("CATCH_UP") || is("CATCHUP")) return MissPolicy::CATCH_UP;
+    return std::nullopt;
+}
+
+const char* missPolicyName(MissPolicy policy) {
+    switch (policy) {
+        case MissPolicy::DROP: return "drop";
+        case MissPolicy::SKIP: return "skip";
+        case MissPolicy::CATCH_UP: return "catch_up";
+    }
+    return "skip";
+}
+
+// Per-task deadline counters, shared between the client handler (LIST_TASKS) and pool workers
+struct DeadlineStats {
+    std::atomic<uint64_t> missed{0};  // ticks that started later than the tolerance
+    std::atomic<uint64_t> dropped{0}; // ticks that were never sent because of the policy
+};
+
+// Wall clock in ms since epoch. Leases are written to the journal, so they can't use steady_clock
+int64_t wallClockMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// IDs of tasks that stopped on a worker thread, for the owning client handler to move into its history
+struct FinishedTasks {
+    std::mutex mtx;
+    std::vector<std::string> ids;
+
+    void push(const std::string& id) {
+        std::lock_guard<std::mutex> lock(mtx);
+        ids.push_back(id);
+    }
+
+    std::vector<std::string> take() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return std::exchange(ids, {});
+    }
+};
+
+// Bumped on every task state change, so LIST_TASKS since=<version> only has to return what changed
+std::atomic<uint64_t> taskVersionCounter{0};
+
+// Task events for a client that sent SUBSCRIBE, filled by workers and sent by the client handler between
+// replies. Status changes wake the handler through the eventfd; send counts are only added up and go out
+// with the next EVENT_FLUSH_MS tick, so a 1 ms task doesn't become a thousand lines a second
+struct TaskEvents {
+    int fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    std::mutex mtx;
+    std::vector<std::pair<std::string, uint64_t>> pending;  // event line, or task ID with its send count
+    std::unordered_map<std::string, size_t> openCount;      // task ID -> its count in `pending`, until a status line follows
+
+    TaskEvents() = default;
+    TaskEvents(const TaskEvents&) = delete;
+    TaskEvents& operator=(const TaskEvents&) = delete;
+    ~TaskEvents() {
+        if (fd != -1) close(fd);
+    }
+
+    void status(const std::string& id, std::string_view what) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            pending.emplace_back("!TASK " + id + " " + std::string(what) + "\n", 0);
+            openCount.erase(id);  // later sends come after this line
+        }
+        uint64_t one = 1;
+        if (fd != -1 && write(fd, &one, sizeof(one)) == -1) {
+            // only fails when the counter is saturated, and then the handler is awake already
+        }
+    }
+
+    void sent(const std::string& id) {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto [it, added] = openCount.try_emplace(id, pending.size());
+        if (added) pending.emplace_back(id, 0);
+        ++pending[it->second].second;
+    }
+
+    // Everything since the last call, in order
+    std::string take() {
+        std::vector<std::pair<std::string, uint64_t>> events;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            events = std::exchange(pending, {});
+            openCount.clear();
+        }
+        uint64_t count;
+        if (fd != -1 && read(fd, &count, sizeof(count)) == -1) count = 0;  // resets the wakeup, EAGAIN if there was none
+        std::string lines;
+        for (const auto& [text, sends] : events) {
+            lines += sends == 0 ? text : "!SENT " + text + " " + std::to_string(sends) + "\n";
+        }
+        return lines;
+    }
+};
+
+// Server end of a shm_ring segment, made for a client on the local socket that sent SHM_RING. The name is
+// unlinked once the client handler and all of its tasks have let go of it
+class ReportRing {
+public:
+    static std::shared_ptr<ReportRing> create(uint32_t capacity, std::string& errorMsg) {
+        static std::atomic<unsigned> counter{0};
+        std::string name = "/can-scheduler-" + std::to_string(getpid()) + "-" + std::to_string(counter++);
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd == -1) {
+            errorMsg = "shm_open: " + std::string(strerror(errno));
+            return nullptr;
+        }
+        size_t size = shm_ring::mappedSize(capacity);
+        void* mem = MAP_FAILED;
+        if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+            mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        int savedErrno = errno;
+        close(fd);
+        if (mem == MAP_FAILED) {
+            shm_unlink(name.c_str());
+            errorMsg = "mmap: " + std::string(strerror(savedErrno));
+            return nullptr;
+        }
+        auto* header = new (mem) shm_ring::Header{};
+        header->capacity = capacity;
+        header->slotSize = sizeof(shm_ring::SendReport);
+        header->version = shm_ring::VERSION;
+        header->magic = shm_ring::MAGIC;
+        return std::shared_ptr<ReportRing>(new ReportRing(std::move(name), header, size));
+    }
+
+    ~ReportRing() {
+        munmap(header, size);
+        shm_unlink(name.c_str());
+    }
+
+    const std::string& segmentName() const { return name; }
+    uint32_t capacity() const { return header->capacity; }
+
+    // The ring wants a single producer; sends finish on the reaper thread, failed spawns on workers
+    void push(const shm_ring::SendReport& report) {
+        std::lock_guard<std::mutex> lock(mtx);
+        shm_ring::push(header, report);
+    }
+
+private:
+    ReportRing(std::string name, shm_ring::Header* header, size_t size) : name(std::move(name)), header(header), size(size) {}
+
+    std::string name;
+    shm_ring::Header* header;
+    size_t size;
+    std::mutex mtx;
+};
+
+// One CANSEND/SEND_TASK. Shared by the owning client handler, the pool closures and the journal,
+// so a leased task can keep running after the connection that created it is gone
+struct ScheduledTask {
+    std::string id;
+    std::string command;               // "cansend <bus> <id>#<data>"
+    bool recurring = true;
+    int intervalMs = 0;                // interval for recurring tasks, delay for single-shots
+    int priority = 5;
+    MissPolicy policy = MissPolicy::SKIP;
+    int64_t dueMs = 0;                 // wall clock time a single-shot fires, so a restart doesn't reset the delay
+    std::atomic<bool> active{true};
+    std::atomic<bool> paused{false};
+    std::atomic<int64_t> leaseMs{0};    // how long to keep running without a client, 0 = stop on disconnect
+    std::atomic<int64_t> leaseUntil{0}; // wall clock ms when the lease runs out, 0 while a client owns the task
+    std::atomic<pid_t> pid{0};          // cansend child currently running for this task, 0 if none
+    std::atomic<uint64_t> version{++taskVersionCounter}; // counter value at the last state change
+    std::atomic<uint64_t> sends{0};     // successful sends
+    DeadlineStats stats;
+
+    void touch() {
+        version = ++taskVersionCounter;
+    }
+
+    std::string detail() const {
+        std::lock_guard<std::mutex> lock(detailMutex);
+        return detailText;
+    }
+
+    void setDetail(const std::string& text) {
+        std::lock_guard<std::mutex> lock(detailMutex);
+        detailText = text;
+    }
+
+    // Why the task stopped, empty unless cansend failed
+    std::string error() const {
+        std::lock_guard<std::mutex> lock(detailMutex);
+        return errorText;
+    }
+
+    void setError(const std::string& text) {
+        {
+            std::lock_guard<std::mutex> lock(detailMutex);
+            errorText = text;
+        }
+        touch();
+    }
+
+    bool leaseExpired() const {
+        int64_t until = leaseUntil.load();
+        return until != 0 && wallClockMs() > until;
+    }
+
+    // Pausing parks the task: its tick finds it paused and leaves the pool queue instead of re-enqueueing,
+    // so a parked task costs nothing. Resuming hands the parked deadline to the reschedule hook.
+    // Both sides take parkMutex, so a RESUME can't slip in between a tick's check and its park.
+    bool parkIfPaused(std::chrono::steady_clock::time_point deadline) {
+        std::lock_guard<std::mutex> lock(parkMutex);
+        if (!paused) return false;
+        parked = true;
+        parkedDeadline = deadline;
+        return true;
+    }
+
+    void setPaused(bool value) {
+        std::function<void(std::chrono::steady_clock::time_point)> wake;
+        std::chrono::steady_clock::time_point deadline;
+        {
+            std::lock_guard<std::mutex> lock(parkMutex);
+            paused = value;
+            if (!value && parked) {
+                parked = false;
+                deadline = parkedDeadline;
+                wake = reschedule;
+            }
+        }
+        touch();
+        if (wake) wake(deadline);
+    }
+
+    // Set by the scheduler: puts a parked task back in the pool, given the deadline it was parked at
+    void setReschedule(std::function<void(std::chrono::steady_clock::time_point)> fn) {
+        std::lock_guard<std::mutex> lock(parkMutex);
+        reschedule = std::move(fn);
+    }
+
+    enum class SendSlot { NOW, QUEUED, FULL };
+
+    // Takes a send for the task. NOW: the caller spawns it. QUEUED: it waits for the sends ahead of it and
+    // nextSend() hands it out. FULL: `limit` sends are waiting already (cansend can't keep up), it isn't taken
+    SendSlot queueSend(std::function<void(bool)> done, std::size_t limit) {
+        std::lock_guard<std::mutex> lock(sendMutex);
+        if (!sending) {
+            sending = true;
+            return SendSlot::NOW;
+        }
+        if (pendingSends.size() >= limit) return SendSlot::FULL;
+        pendingSends.push_back(std::move(done));
+        return SendSlot::QUEUED;
+    }
+
+    // The running send finished: true with the next waiting one in `done`, false if there is none to start
+    // (nothing waits, or the task has stopped)
+    bool nextSend(std::function<void(bool)>& done) {
+        std::lock_guard<std::mutex> lock(sendMutex);
+        if (!active) pendingSends.clear();
+        if (pendingSends.empty()) {
+            sending = false;
+            return false;
+        }
+        done = std::move(pendingSends.front());
+        pendingSends.pop_front();
+        return true;
+    }
+
+    // Where to report that the task stopped. Set by the client handler that owns it
+    void setFinishedQueue(const std::shared_ptr<FinishedTasks>& queue) {
+        std::lock_guard<std::mutex> lock(detailMutex);
+        finishedQueue = queue;
+    }
+
+    void notifyFinished() {
+        touch();
+        std::shared_ptr<FinishedTasks> queue;
+        {
+            std::lock_guard<std::mutex> lock(detailMutex);
+            queue = finishedQueue;
+        }
+        if (queue) queue->push(id);
+        if (auto sink = eventSink()) {
+            std::string why = error();
+            sink->status(id, !why.empty() ? "error " + why : recurring ? "stopped" : "completed");
+        }
+    }
+
+    // Where to push events, if the owning client subscribed
+    void setEventSink(const std::shared_ptr<TaskEvents>& sink) {
+        std::lock_guard<std::mutex> lock(detailMutex);
+        events = sink;
+    }
+
+    std::shared_ptr<TaskEvents> eventSink() const {
+        std::lock_guard<std::mutex> lock(detailMutex);
+        return events;
+    }
+
+    // Where to stream per-send reports, if the owning client mapped a ring
+    void setReportRing(const std::shared_ptr<ReportRing>& ring) {
+        std::lock_guard<std::mutex> lock(detailMutex);
+        reportRing = ring;
+    }
+
+    void reportSend(bool ok) {
+        std::shared_ptr<ReportRing> ring;
+        std::shared_ptr<TaskEvents> sink;
+        {
+            std::lock_guard<std::mutex> lock(detailMutex);
+            ring = reportRing;
+            sink = events;
+        }
+        if (ok) ++sends;
+        if (sink && ok) sink->sent(id);
+        if (!ring) return;
+        shm_ring::SendReport report{};
+        std::string_view number = std::string_view(id).substr(id.find('_') + 1);  // "task_<n>"
+        std::from_chars(number.data(), number.data() + number.size(), report.taskNumber);
+        report.completedMs = wallClockMs();
+        report.ok = ok ? 1 : 0;
+        report.missed = static_cast<uint32_t>(stats.missed);
+        report.dropped = static_cast<uint32_t>(stats.dropped);
+        ring->push(report);
+    }
+
+private:
+    mutable std::mutex detailMutex;
+    std::string detailText;
+    std::string errorText;
+    std::shared_ptr<FinishedTasks> finishedQueue;
+    std::shared_ptr<ReportRing> reportRing;
+    std::shared_ptr<TaskEvents> events;
+
+    std::mutex sendMutex;
+    bool sending = false;  // a cansend child of this task is running
+    std::deque<std::function<void(bool)>> pendingSends;
+
+    std::mutex parkMutex;
+    bool parked = false;
+    std::chrono::steady_clock::time_point parkedDeadline;
+    std::function<void(std::chrono::steady_clock::time_point)> reschedule;
+};
+
+// Task details shown by LIST_TASKS before the task has run
+std::string taskDetailText(const ScheduledTask& task) {
+    if (task.recurring) {
+        return task.command + " every " + std::to_string(task.intervalMs) + "ms priority " + std::to_string(task.priority) + " policy " + missPolicyName(task.policy);
+    }
+    return task.command + " once after " + std::to_string(task.intervalMs) + "ms priority " + std::to_string(task.priority) + " policy " + missPolicyName(task.policy);
+}
+
+// One LIST_TASKS line: "<id>: <detail> missed N dropped M [lease Nms] (<status>)" plus an error line if it failed
+std::string taskStatusLine(const ScheduledTask& task) {
+    std::string error = task.error();
+    std::string status;
+    if (!task.active) {
+        status = error.empty() ? "stopped" : "stopped (error)";
+    } else if (task.paused) {
+        status = "paused";
+    } else {
+        status = "running";
+    }
+    std::string counts = " missed " + std::to_string(task.stats.missed.load()) +
+                         " dropped " + std::to_string(task.stats.dropped.load());
+    if (task.leaseMs > 0) {
+        counts += " lease " + std::to_string(task.leaseMs.load()) + "ms";
+    }
+    std::string line = task.id + ": " + task.detail() + counts + " (" + status + ")\n";
+    if (!task.active && !error.empty()) {
+        line += "  Error: " + error + "\n";
+    }
+    return line;
+}
+
+// One LIST_TASKS since= record, see the protocol notes at the top
+std::string taskRecord(const ScheduledTask& task) {
+    std::string error = task.error();
+    std::replace(error.begin(), error.end(), '\n', ' ');
+    const char* state = !task.active ? (error.empty() ? "stopped" : "error") : task.paused ? "paused" : "running";
+    std::string_view target(task.command);  // "cansend <bus> <id>#<data>"
+    target.remove_prefix(std::min(target.size(), target.find(' ') + 1));
+    std::string record = task.id + " " + std::to_string(task.version.load()) + " " + state +
+                         (task.recurring ? " recurring " : " once ") + std::to_string(task.intervalMs) + " " +
+                         std::to_string(task.priority) + " " + missPolicyName(task.policy) + " " + std::string(target) + " " +
+                         std::to_string(task.sends.load()) + " " + std::to_string(task.stats.missed.load()) + " " +
+                         std::to_string(task.stats.dropped.load()) + " " + std::to_string(task.leaseMs.load());
+    if (!error.empty()) {
+        record += " " + error;
+    }
+    return record + "\n";
+}
+
+/**
+ * @class TaskHistory
+ * @brief Fixed-size ring of the LIST_TASKS lines of a client's finished tasks.
+ *
+ * Finished tasks are moved here out of the live task set, so LIST_TASKS costs O(active + capacity) no matter
+ * how many one-shots a client has fired. Once full, the oldest entry is overwritten. Entries can be removed
+ * by ID (KILL_TASK on a finished one-shot); that leaves a hole that the ring fills again in time.
+ */
+class TaskHistory {
+public:
+    struct Entry {
+        std::string id;
+        std::string line;    // LIST_TASKS line
+        std::string record;  // LIST_TASKS since= record
+        uint64_t version = 0;
+    };
+
+    explicit TaskHistory(std::size_t capacity) : entries(capacity) {}
+
+    // Returns the ID of the entry pushed out to make room, if any
+    std::string push(Entry entry) {
+        if (entries.empty()) return entry.id;
+        std::string evicted = std::move(entries[next].id);
+        entries[next] = std::move(entry);
+        next = (next + 1) % entries.size();
+        return evicted;
+    }
+
+    std::string push(const ScheduledTask& task) {
+        return push(Entry{task.id, taskStatusLine(task), taskRecord(task), task.version});
+    }
+
+    const Entry* find(const std::string& id) const {
+        for (const auto& entry : entries) {
+            if (!entry.id.empty() && entry.id == id) return &entry;
+        }
+        return nullptr;
+    }
+
+    bool remove(const std::string& id) {
+        for (auto& entry : entries) {
+            if (!entry.id.empty() && entry.id == id) {
+                entry = Entry{};
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void clear() {
+        std::fill(entries.begin(), entries.end(), Entry{});
+        next = 0;
+    }
+
+    // Oldest first
+    template <class F>
+    void forEach(F&& f) const {
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            const Entry& entry = entries[(next + i) % entries.size()];
+            if (!entry.id.empty()) f(entry);
+        }
+    }
+
+    std::string toString() const {
+        std::string out;
+        forEach([&out](const Entry& entry) { out += entry.line; });
+        return out;
+    }
+
+private:
+    std::vector<Entry> entries;
+    std::size_t next = 0;
+};
+
+/**
+ * @class TaskTombstones
+ * @brief The IDs that left a client's listing (killed, or pushed out of its history), for LIST_TASKS since=.
+ *
+ * Each removal gets its own version, so removals sort in with the task records. Only the newest `capacity` are
+ * kept; a client asking from before the oldest one kept (or from before this connection) can't be answered with
+ * a delta and is told to list again from 0.
+ */
+class TaskTombstones {
+public:
+    explicit TaskTombstones(std::size_t capacity) : capacity(std::max<std::size_t>(capacity, 1)), floor(taskVersionCounter.load()) {}
+
+    void add(const std::string& id) {
+        if (entries.size() == capacity) {
+            floor = entries.front().first;
+            entries.pop_front();
+        }
+        entries.emplace_back(++taskVersionCounter, id);
+    }
+
+    bool covers(uint64_t since) const {
+        return since == 0 || since >= floor;
+    }
+
+    template <class F>
+    void forEachSince(uint64_t since, F&& f) const {
+        auto it = std::upper_bound(entries.begin(), entries.end(), since,
+                                   [](uint64_t version, const auto& entry) { return version < entry.first; });
+        for (; it != entries.end(); ++it) f(it->first, it->second);
+    }
+
+private:
+    std::size_t capacity;
+    uint64_t floor;  // removals at or before this version are forgotten
+    std::deque<std::pair<uint64_t, std::string>> entries;  // oldest first
+};
+
+std::atomic<uint64_t> nextTaskId{0}; // server-wide so task IDs never collide between clients or restarts
+
+/**
+ * @class TaskRegistry
+ * @brief Server-wide index of every scheduled task by its ID.
+ *
+ * Tasks are spread over a fixed number of shards by ID hash, each with its own mutex, so lookups from
+ * different client handlers and pool workers rarely contend. Lookups are O(1); nothing ever walks the
+ * whole registry while holding a lock.
+ *
+ * A task stays registered while a client owns it (even after it stopped, so its status and error can
+ * still be queried), while it runs unowned under a lease, and while it sits in a detached session.
+ */
+class TaskRegistry {
+public:
+    void add(const std::shared_ptr<ScheduledTask>& task) {
+        Shard& shard = shardFor(task->id);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        shard.tasks[task->id] = task;
+    }
+
+    void remove(const std::string& id) {
+        Shard& shard = shardFor(id);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        shard.tasks.erase(id);
+    }
+
+    std::shared_ptr<ScheduledTask> find(const std::string& id) {
+        Shard& shard = shardFor(id);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        auto it = shard.tasks.find(id);
+        return it == shard.tasks.end() ? nullptr : it->second;
+    }
+
+    std::size_t size() {
+        std::size_t total = 0;
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            total += shard.tasks.size();
+        }
+        return total;
+    }
+
+private:
+    static constexpr std::size_t SHARD_COUNT = 32;
+
+    struct Shard {
+        std::mutex mtx;
+        std::unordered_map<std::string, std::shared_ptr<ScheduledTask>> tasks;
+    };
+
+    Shard& shardFor(const std::string& id) {
+        return shards[std::hash<std::string>{}(id) % SHARD_COUNT];
+    }
+
+    std::array<Shard, SHARD_COUNT> shards;
+};
+
+TaskRegistry taskRegistry;
+
+// task persistence config. parsed in main
+std::string journal_path = "tasks.journal";
+int64_t default_lease_ms = 0; // lease given to new tasks, LEASE overrides it per task
+std::vector<std::string> server_args; // argv, kept for RESTART
+int64_t session_grace_ms = 30000; // how long a dropped session's tasks keep running waiting for ATTACH
+std::size_t task_history_size = 100; // finished tasks each client keeps listing, oldest dropped first
+std::string unix_socket_path = "/tmp/can-scheduler.sock"; // local control socket, empty disables it
+
+// Tasks of a client that dropped without ending its session, waiting to be picked up with ATTACH <token>
+struct DetachedSession {
+    std::unordered_map<std::string, std::shared_ptr<ScheduledTask>> tasks;
+    TaskHistory history{0};
+    int64_t expiresMs = 0;
+};
+std::unordered_map<std::string, DetachedSession> detachedSessions;
+std::mutex sessionMutex;
+
+// 128-bit random hex token handed out by SESSION
+std::string generateSessionToken() {
+    static std::mutex rngMutex;
+    static std::mt19937_64 rng(std::random_device{}());
+    std::lock_guard<std::mutex> lock(rngMutex);
+    char token[33];
+    std::snprintf(token, sizeof token, "%016llx%016llx",
+                  static_cast<unsigned long long>(rng()), static_cast<unsigned long long>(rng()));
+    return token;
+}
+
+
 struct ThreadInfo {
     std::thread::id id;
     std::string name;
@@ -211,39 +906,6 @@ public:
 // Global registry
 ThreadRegistry registry;
 
-// Global map to track PIDs to task IDs for error handling
-std::unordered_map<pid_t, std::string> globalPidToTaskId;
-std::mutex globalPidMutex;  // Protect the global map
-
-// Add a new global map for task error messages
-std::unordered_map<std::string, std::string> globalTaskErrors;
-std::mutex globalErrorMutex;
-
-// Signal handler for SIGCHLD - now only for logging, reaping handled in tasks
-void sigchld_handler(int s) {
-    (void)s;
-    /* // Removed waitpid loop to avoid conflicts
-    int saved_errno = errno;
-    int status;
-    pid_t pid;
-    while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
-        if (WIFEXITED(status)) {
-            int exit_code = WEXITSTATUS(status);
-            if (exit_code != 0) {
-                logEvent(ERROR, "Child process " + std::to_string(pid) + " exited with error code " + std::to_string(exit_code));
-            } else {
-                logEvent(DEBUG, "Child process " + std::to_string(pid) + " exited successfully");
-            }
-        } else if (WIFSIGNALED(status)) {
-            int signal_num = WTERMSIG(status);
-            logEvent(ERROR, "Child process " + std::to_string(pid) + " terminated by signal " + std::to_string(signal_num));
-        }
-        // Optionally, remove PID from clientPids if tracked globally (but it's per-client)
-    }
-    errno = saved_errno;
-    */
-}
-
 // Get sockaddr, IPv4 or IPv6
 void* get_in_addr(struct sockaddr* sa) {
     if (sa->sa_family == AF_INET) {
@@ -269,7 +931,8 @@ void logEvent(int level, const std::string& message) { //logging with hierarchy
  *
  * The ThreadPool uses a priority queue to schedule tasks based on deadlines and a priority number for FIFO ordering.
  * Tasks can be enqueued with or without priorities. Deadlines are like timers. If a task has a deadline, it will be executed as soon as possible after the deadline,
- * or can be discarded if the deadline is missed and drop_if_missed is true. Priorities determine execution order when deadlines are equal
+ * or can be discarded if the deadline is missed by more than deadline_tolerance_ms and drop_if_missed is true (the optional on_missed callback runs instead).
+ * Recurring tasks apply their MissPolicy themselves since they need to know their grid. Priorities determine execution order when deadlines are equal
  * (higher priority runs first). For tasks with the same deadline and priority, FIFO order is preserved.
  * 
  * The thread pool automatically registers worker threads with a Thread registry for identification.
@@ -297,8 +960,16 @@ public:
                                     // Execute task immediately
                                     task = std::move(pq.top());
                                     pq.pop();
+                                    bool missed = task.drop_if_missed &&
+                                                  now - task.deadline > std::chrono::milliseconds(deadline_tolerance_ms);
                                     lock.unlock();
-                                    try { task.func(); } catch (...) { /* handle */ }
+                                    if (missed) {
+                                        if (task.on_missed) {
+                                            try { task.on_missed(); } catch (...) { /* handle */ }
+                                        }
+                                    } else {
+                                        try { task.func(); } catch (...) { /* handle */ }
+                                    }
                                     lock.lock();
                                 } else {
                                     // Wait until deadline or new task
@@ -329,6 +1000,15 @@ public:
         enqueue_impl(deadline, priority, drop_if_missed, std::forward<F>(f));
     }
 
+    // Enqueue with a deadline that is dropped when missed; on_missed runs in place of f so the owner can record it
+    template <class F, class M>
+    void enqueue_droppable(std::chrono::steady_clock::time_point deadline,
+                           int priority,
+                           F&& f,
+                           M&& on_missed) {
+        enqueue_impl(deadline, priority, true, std::forward<F>(f), std::function<void()>(std::forward<M>(on_missed)));
+    }
+
     ~ThreadPool() {
         {
             std::lock_guard<std::mutex> lock(mtx);
@@ -345,6 +1025,7 @@ private:
         std::size_t seq;
         std::function<void()> func;
         bool drop_if_missed;
+        std::function<void()> on_missed; // optional, runs instead of func when the task is dropped
     };
 
     struct Cmp {
@@ -362,11 +1043,12 @@ private:
     void enqueue_impl(std::chrono::steady_clock::time_point deadline, 
                       int priority,
                       bool drop_if_missed,
-                      F&& f) {
+                      F&& f,
+                      std::function<void()> on_missed = nullptr) {
         std::function<void()> fn(std::forward<F>(f));
         {
             std::lock_guard<std::mutex> lock(mtx);
-            pq.push(Task{deadline, priority, seq++, std::move(fn), drop_if_missed});
+            pq.push(Task{deadline, priority, seq++, std::move(fn), drop_if_missed, std::move(on_missed)});
         }
         cv.notify_one();
     }
@@ -465,57 +1147,974 @@ std::vector<std::string> discoverCanInterfaces() {
 }
 
 // Add helper function to validate CAN interface
-bool isValidCanInterface(const std::string& interface) {
+bool isValidCanInterface(std::string_view interface) {
     std::lock_guard<std::mutex> lock(canInterfacesMutex);
     return std::find(availableCanInterfaces.begin(), 
                      availableCanInterfaces.end(), 
                      interface) != availableCanInterfaces.end();
 }
 
-int main(int argc, char* argv[]) {
-    int sockfd, new_fd;
-    struct addrinfo hints, *servinfo, *p;
-    struct sockaddr_storage their_addr;
-    socklen_t sin_size;
-    struct sigaction sa;
-    int yes = 1;
-    char s[INET6_ADDRSTRLEN];
-    int rv;
+// Splits on `sep` into trimmed views, like getline would: empty fields in the middle are kept, a trailing
+// separator adds nothing. Fields past N are ignored. Returns the number of fields
+template <size_t N>
+size_t splitFields(std::string_view text, char sep, std::array<std::string_view, N>& fields) {
+    size_t count = 0;
+    while (!text.empty() && count < N) {
+        size_t pos = text.find(sep);
+        fields[count++] = trimView(text.substr(0, pos));
+        if (pos == std::string_view::npos) break;
+        text.remove_prefix(pos + 1);
+    }
+    return count;
+}
 
-    int configuredWorkerCount = 1;
+// Parsed CANSEND/SEND_TASK payload. The views point into the receive buffer, so parsing never allocates;
+// the cansend command line is only built once a task is created from it
+struct CansendRequest {
+    std::string_view canId;       // without the 0x prefix
+    std::string_view canPayload;
+    std::string_view canBus;
+    int intervalMs = 0;
+    int priority = 5;
+    MissPolicy missPolicy = MissPolicy::SKIP;
+
+    std::string canIdData() const { return std::string(canId) + "#" + std::string(canPayload); }
+    std::string command() const { return "cansend " + std::string(canBus) + " " + canIdData(); }
+};
 
-    std::memset(&hints, 0, sizeof hints);
-    hints.ai_family = AF_UNSPEC;
-    hints.ai_socktype = SOCK_STREAM;
-    hints.ai_flags = AI_PASSIVE;
+// <id>#<payload>#<time_ms>#<bus>[#priority[#policy]]. errorMsg is only written on failure
+bool parseCansendPayload(std::string_view payload, int defaultPriority, CansendRequest& out, std::string& errorMsg) {
+    std::array<std::string_view, 6> parts;
+    size_t count = splitFields(payload, '#', parts);
 
-    if (argc != 2) {
-        std::cerr << std::format("Error: incorrect number of arguments. Usage: {} <config_file>\n", *argv);
-        logEvent(DEBUG, "server <config_file> has incorrect number of arguments");
-        return 1;
+    if (count < 4) {
+        errorMsg = "ERROR: Invalid CANSEND syntax. Usage: CANSEND#<id>#<payload>#<time_ms>#<bus>[#priority 0-9[#drop|skip|catch_up]]\n";
+        return false;
     }
 
-    std::string configFileName = argv[1];
-    std::optional<std::string> port;
+    std::string_view canId = parts[0];
+    std::string_view timeStr = parts[2];
 
-    std::filesystem::path configFilePath(configFileName);
-    if (!std::filesystem::is_regular_file(configFilePath)) {
-        std::cerr << std::format("Error opening configuration file: {}\n", configFileName);
-        logEvent(ERROR, "Error opening configuration file: " + configFileName);
-        return 1;
+    if (canId.starts_with("0x") || canId.starts_with("0X")) {
+        canId.remove_prefix(2);
     }
 
-    std::ifstream configFile(configFileName);
-    std::string line;
-    while (std::getline(configFile, line)) {
-        std::string_view lineView(line);
-        if (lineView.substr(0, 5) == "PORT=") {
-            std::string portStr = trim(std::string(lineView.substr(5)));
-            port = portStr;
-            logEvent(DEBUG, "Port set to " + *port);
-        } else if (lineView.substr(0, 10) == "LOG_LEVEL=") {
-            std::string logLevelStr = trim(std::string(lineView.substr(10)));
-            log_level_str = logLevelStr;
+    if (timeStr.ends_with("ms")) {
+        timeStr.remove_suffix(2);
+    }
+
+    int parsedPriority = defaultPriority;
+    if (count >= 5 && parts[4].size() == 1 && parts[4][0] >= '0' && parts[4][0] <= '9') {
+        parsedPriority = parts[4][0] - '0';
+    }
+
+    MissPolicy parsedPolicy = default_miss_policy;
+    if (count >= 6 && !parts[5].empty()) {
+        auto policy = parseMissPolicy(parts[5]);
+        if (!policy) {
+            errorMsg = "ERROR: Unknown miss policy '" + std::string(parts[5]) + "'. Use drop, skip or catch_up\n";
+            return false;
+        }
+        parsedPolicy = *policy;
+    }
+
+    if (!isValidCanInterface(parts[3])) {
+        errorMsg = "ERROR: CAN interface '" + std::string(parts[3]) + "' is not available. Use LIST_CAN_INTERFACES to see available interfaces.\n";
+        return false;
+    }
+
+    // like stoi: leading number counts, trailing junk is ignored
+    int intervalMs = 0;
+    if (std::from_chars(timeStr.data(), timeStr.data() + timeStr.size(), intervalMs).ec != std::errc{}) {
+        errorMsg = "ERROR: Invalid time value\n";
+        return false;
+    }
+
+    if (intervalMs < 0) {
+        errorMsg = "ERROR: Time value must be non-negative\n";
+        return false;
+    }
+
+    out.canId = canId;
+    out.canPayload = parts[1];
+    out.canBus = parts[3];
+    out.intervalMs = intervalMs;
+    out.priority = parsedPriority;
+    out.missPolicy = parsedPolicy;
+    return true;
+}
+
+// Client commands, matched by prefix
+enum class Command {
+    SHUTDOWN, KILL_ALL_TASKS, KILL_ALL, LIST_THREADS, RESTART, KILL_THREAD, SET_LOG_LEVEL, PAUSE, RESUME,
+    LIST_TASKS, STATUS, KILL_TASK, SESSION, ATTACH, LEASE, LIST_CAN_INTERFACES, SEND_TASK, CANSEND, SHM_RING,
+    SUBSCRIBE, PING, COUNT
+};
+
+struct CommandPrefix {
+    std::string_view prefix;
+    Command command;
+};
+
+// Checked in order, so a prefix of another prefix has to come after it (KILL_ALL after KILL_ALL_TASKS)
+constexpr std::array<CommandPrefix, static_cast<size_t>(Command::COUNT)> commandTable{{
+    {"CANSEND#", Command::CANSEND},
+    {"SEND_TASK#", Command::SEND_TASK},
+    {"LIST_TASKS", Command::LIST_TASKS},
+    {"STATUS ", Command::STATUS},
+    {"PAUSE ", Command::PAUSE},
+    {"RESUME ", Command::RESUME},
+    {"KILL_TASK ", Command::KILL_TASK},
+    {"KILL_ALL_TASKS", Command::KILL_ALL_TASKS},
+    {"KILL_ALL", Command::KILL_ALL},
+    {"LEASE ", Command::LEASE},
+    {"SESSION", Command::SESSION},
+    {"ATTACH ", Command::ATTACH},
+    {"LIST_CAN_INTERFACES", Command::LIST_CAN_INTERFACES},
+    {"LIST_THREADS", Command::LIST_THREADS},
+    {"SET_LOG_LEVEL ", Command::SET_LOG_LEVEL},
+    {"KILL_THREAD ", Command::KILL_THREAD},
+    {"RESTART", Command::RESTART},
+    {"SHUTDOWN", Command::SHUTDOWN},
+    {"SHM_RING", Command::SHM_RING},
+    {"SUBSCRIBE", Command::SUBSCRIBE},
+    {"PING", Command::PING},
+}};
+
+constexpr bool commandTableUnambiguous() {
+    for (size_t i = 0; i < commandTable.size(); ++i) {
+        for (size_t j = i + 1; j < commandTable.size(); ++j) {
+            if (commandTable[j].prefix.starts_with(commandTable[i].prefix)) return false;
+        }
+    }
+    return true;
+}
+static_assert(commandTableUnambiguous(), "commandTable entry is shadowed by an earlier, shorter prefix");
+
+constexpr std::optional<Command> matchCommand(std::string_view msg) {
+    for (const auto& entry : commandTable) {
+        if (msg.starts_with(entry.prefix)) return entry.command;
+    }
+    return std::nullopt;
+}
+
+// Tagged requests let a client keep many commands in flight on one connection: "@<tag> <command>\n" is answered
+// with "@<tag> <length>\n" followed by exactly <length> bytes of the usual reply. Tags are decimal, up to 20 digits
+constexpr bool parseTaggedRequest(std::string_view line, std::string_view& tag, std::string_view& command) {
+    if (!line.starts_with('@')) return false;
+    size_t space = line.find(' ');
+    if (space == std::string_view::npos || space == 1 || space > 21) return false;
+    for (char c : line.substr(1, space - 1)) {
+        if (c < '0' || c > '9') return false;
+    }
+    tag = line.substr(1, space - 1);
+    command = line.substr(space + 1);
+    if (command.ends_with('\r')) command.remove_suffix(1);
+    return true;
+}
+
+std::string frameTaggedReply(std::string_view tag, std::string_view reply) {
+    std::string framed = "@" + std::string(tag) + " " + std::to_string(reply.size()) + "\n";
+    framed.append(reply);
+    return framed;
+}
+
+struct ListTasksQuery {
+    uint64_t since = 0;
+    uint32_t limit = 0;  // records per reply, 0 for no limit
+};
+
+// Arguments of LIST_TASKS: "since=<version> [limit=<n>]" in any order, since= required
+bool parseListTasksQuery(std::string_view args, ListTasksQuery& query) {
+    bool haveSince = false;
+    while (!args.empty()) {
+        size_t space = args.find(' ');
+        std::string_view field = args.substr(0, space);
+        args.remove_prefix(space == std::string_view::npos ? args.size() : space + 1);
+        if (field.empty()) continue;
+        size_t equals = field.find('=');
+        if (equals == std::string_view::npos) return false;
+        std::string_view key = field.substr(0, equals);
+        std::string_view value = field.substr(equals + 1);
+        uint64_t number = 0;
+        auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), number);
+        if (value.empty() || ec != std::errc() || end != value.data() + value.size()) return false;
+        if (key == "since") {
+            query.since = number;
+            haveSince = true;
+        } else if (key == "limit" && number <= UINT32_MAX) {
+            query.limit = static_cast<uint32_t>(number);
+        } else {
+            return false;
+        }
+    }
+    return haveSince;
+}
+
+/**
+ * @class TaskJournal
+ * @brief Append-only on-disk journal of leased tasks, so they survive client disconnects and server restarts.
+ *
+ * Each record is one text line. "ADD" carries the full state of a task and is written again whenever the state
+ * changes (last one wins), "DEL" forgets it:
+ *   ADD <id> <R|S> <interval_ms> <priority> <policy> <due_ms> <lease_ms> <lease_until_ms> <paused> <cansend command>
+ *   DEL <id>
+ * Records are flushed as they are written. Once the file holds a few times more records than there are live tasks
+ * it is rewritten from the live set (temp file + rename, so a crash never leaves a half-compacted journal).
+ * A torn last line from a crash is skipped on load.
+ */
+class TaskJournal {
+public:
+    bool open(const std::string& journalPath) {
+        std::lock_guard<std::mutex> lock(mtx);
+        path = journalPath;
+        out.open(path, std::ios::app);
+        return out.is_open();
+    }
+
+    // Record a leased task, or its new state
+    void put(const std::shared_ptr<ScheduledTask>& task) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!out.is_open()) return;
+        live[task->id] = task;
+        append(addRecord(*task));
+    }
+
+    void remove(const std::string& id) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!out.is_open() || !live.erase(id)) return;
+        append("DEL " + id);
+    }
+
+    void compact() {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (out.is_open()) compactLocked();
+    }
+
+    // Read what a previous run left behind. Returns the live tasks in the order they were first added
+    static std::vector<std::shared_ptr<ScheduledTask>> load(const std::string& journalPath) {
+        std::ifstream in(journalPath);
+        std::vector<std::string> order;
+        std::unordered_map<std::string, std::shared_ptr<ScheduledTask>> byId;
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream iss(line);
+            std::string kind, id;
+            iss >> kind >> id;
+            if (kind == "DEL") {
+                byId.erase(id);
+                continue;
+            }
+            if (kind != "ADD") continue;
+
+            auto task = std::make_shared<ScheduledTask>();
+            std::string type, policyStr;
+            int64_t leaseMs, leaseUntil;
+            int paused;
+            if (!(iss >> type >> task->intervalMs >> task->priority >> policyStr >> task->dueMs >> leaseMs >> leaseUntil >> paused)) {
+                logEvent(WARNING, "Skipping malformed journal record: " + line);
+                continue;
+            }
+            std::getline(iss, task->command);
+            task->command = trim(task->command);
+            if (task->command.empty()) {
+                logEvent(WARNING, "Skipping malformed journal record: " + line);
+                continue;
+            }
+            task->id = id;
+            task->recurring = type == "R";
+            task->policy = parseMissPolicy(policyStr).value_or(default_miss_policy);
+            task->leaseMs = leaseMs;
+            task->leaseUntil = leaseUntil;
+            task->paused = paused != 0;
+            task->setDetail(taskDetailText(*task));
+
+            if (!byId.count(id)) order.push_back(id);
+            byId[id] = task;
+        }
+
+        std::vector<std::shared_ptr<ScheduledTask>> tasks;
+        for (const auto& id : order) {
+            auto it = byId.find(id);
+            if (it != byId.end()) {
+                tasks.push_back(it->second);
+                byId.erase(it); // an ID re-added after a DEL shows up twice in order
+            }
+        }
+        return tasks;
+    }
+
+private:
+    static std::string addRecord(const ScheduledTask& task) {
+        return "ADD " + task.id + " " + (task.recurring ? "R" : "S") + " " + std::to_string(task.intervalMs) + " " +
+               std::to_string(task.priority) + " " + missPolicyName(task.policy) + " " + std::to_string(task.dueMs) + " " +
+               std::to_string(task.leaseMs.load()) + " " + std::to_string(task.leaseUntil.load()) + " " +
+               (task.paused ? "1" : "0") + " " + task.command;
+    }
+
+    void append(const std::string& record) {
+        out << record << '\n';
+        out.flush();
+        if (++records > live.size() * 4 + 64) {
+            compactLocked();
+        }
+    }
+
+    void compactLocked() {
+        std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream tmp(tmpPath, std::ios::trunc);
+            for (const auto& [id, task] : live) {
+                tmp << addRecord(*task) << '\n';
+            }
+            if (!tmp) {
+                logEvent(ERROR, "Failed to write compacted journal " + tmpPath);
+                return;
+            }
+        }
+        out.close();
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, path, ec);
+        if (ec) {
+            logEvent(ERROR, "Failed to replace journal " + path + ": " + ec.message());
+        }
+        out.open(path, std::ios::app);
+        records = live.size();
+        logEvent(DEBUG, "Compacted task journal to " + std::to_string(records) + " records");
+    }
+
+    std::mutex mtx;
+    std::string path;
+    std::ofstream out;
+    std::unordered_map<std::string, std::shared_ptr<ScheduledTask>> live;
+    std::size_t records = 0;
+};
+
+TaskJournal taskJournal;
+
+// Forget sessions nobody came back for. Their tasks retire themselves once their lease runs out
+void pruneDetachedSessions() {
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    int64_t now = wallClockMs();
+    for (auto it = detachedSessions.begin(); it != detachedSessions.end();) {
+        if (it->second.expiresMs < now) {
+            logEvent(DEBUG, "Session " + it->first + " expired");
+            for (const auto& [id, task] : it->second.tasks) {
+                if (!task->active) {
+                    taskRegistry.remove(id);  // running ones go when their lease runs out
+                }
+            }
+            it = detachedSessions.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// ATTACH <token>: moves the tasks of a detached session over to the client that asked. Running ones go into
+// `tasks`, owned again, and `adopt` points them at that client. Ones that stopped while nobody owned them (a
+// failed send, a lease that ran out) go into `history` after the session's own history. Returns how many tasks
+// the session held, nothing if there is no such session or its grace ran out
+std::optional<std::size_t> attachSession(const std::string& token,
+                                         std::unordered_map<std::string, std::shared_ptr<ScheduledTask>>& tasks,
+                                         TaskHistory& history, TaskTombstones& tombstones,
+                                         const std::function<void(const std::shared_ptr<ScheduledTask>&)>& adopt) {
+    pruneDetachedSessions();
+    DetachedSession session;
+    {
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        auto it = detachedSessions.find(token);
+        if (it == detachedSessions.end()) {
+            return std::nullopt;
+        }
+        session = std::move(it->second);
+        detachedSessions.erase(it);
+    }
+    session.history.forEach([&](const TaskHistory::Entry& entry) {
+        if (std::string evicted = history.push(entry); !evicted.empty()) tombstones.add(evicted);
+    });
+    for (auto& [id, task] : session.tasks) {
+        task->leaseUntil = 0;  // owned again
+        task->touch();
+        if (!task->active) {
+            if (std::string evicted = history.push(*task); !evicted.empty()) tombstones.add(evicted);
+            taskRegistry.remove(id);
+            continue;
+        }
+        adopt(task);
+        taskRegistry.add(task);  // back in case its lease ran out just now
+        if (task->leaseMs > 0) {
+            taskJournal.put(task);
+        }
+        tasks[id] = task;
+    }
+    return session.tasks.size();
+}
+
+// Stop a task for good: no more runs and gone from the journal. A task nobody owns is dropped from the
+// registry too; an owned one stays so its client can still see how it ended
+void retireTask(const std::shared_ptr<ScheduledTask>& task) {
+    task->active = false;
+    task->setReschedule(nullptr);  // the hook holds the scheduling closure, which holds the task
+    taskJournal.remove(task->id);
+    if (task->leaseUntil != 0) {
+        taskRegistry.remove(task->id);
+    }
+    task->notifyFinished();
+}
+
+// Orphaned tasks stop once their lease runs out. Returns true if the task was retired
+bool retireIfLeaseExpired(const std::shared_ptr<ScheduledTask>& task) {
+    if (!task->leaseExpired()) return false;
+    logEvent(INFO, "Lease for task " + task->id + " ran out, stopping it");
+    retireTask(task);
+    return true;
+}
+
+// A parked task never ticks, so an unowned one gets a separate wakeup for when its lease runs out
+void scheduleLeaseExpiry(ThreadPool& pool, const std::shared_ptr<ScheduledTask>& task) {
+    int64_t remaining = std::max<int64_t>(0, task->leaseUntil - wallClockMs());
+    pool.enqueue_deadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(remaining + 1),
+                          task->priority,
+                          false,
+                          [task]() {
+                              if (task->active) retireIfLeaseExpired(task);
+                          });
+}
+
+extern char** environ;
+
+/**
+ * @class ChildReaper
+ * @brief Spawns cansend children and reaps them asynchronously on one epoll thread.
+ *
+ * Children are started with posix_spawnp, straight from the command's words with no shell in between (glibc
+ * implements it with clone(CLONE_VM | CLONE_VFORK), so there is no page table copy like with fork). watch() opens a pidfd for the child and adds it to an epoll set; the reaper
+ * thread collects the exit status once the pidfd turns readable and runs the completion callback there. Pool
+ * workers therefore go back to the queue as soon as the child is spawned instead of sitting in waitpid.
+ *
+ * On kernels without pidfd_open (< 5.3) watch() falls back to a blocking waitpid in the caller.
+ */
+class ChildReaper {
+public:
+    using Callback = std::function<void(bool success, const std::string& errorMsg)>;
+
+    // Starts the reaper thread. Detached: the server never tears it down
+    void start() {
+        epfd = epoll_create1(EPOLL_CLOEXEC);
+        if (epfd == -1) {
+            logEvent(WARNING, "epoll_create1 failed, reaping children synchronously: " + std::string(strerror(errno)));
+            return;
+        }
+        std::thread([this] { run(); }).detach();
+    }
+
+    // Spawn the command's space-separated words as argv ("cansend <bus> <id>#<data>"), the first looked up in
+    // PATH. Returns the pid, or -1 with errorMsg set
+    static pid_t spawn(const std::string& command, std::string& errorMsg) {
+        std::vector<std::string> words;
+        std::string_view rest(command);
+        while (!rest.empty()) {
+            size_t start = rest.find_first_not_of(' ');
+            if (start == std::string_view::npos) break;
+            rest.remove_prefix(start);
+            size_t end = std::min(rest.find(' '), rest.size());
+            words.emplace_back(rest.substr(0, end));
+            rest.remove_prefix(end);
+        }
+        if (words.empty()) {
+            errorMsg = "empty command";
+            return -1;
+        }
+        std::vector<char*> argv;
+        for (auto& word : words) argv.push_back(word.data());
+        argv.push_back(nullptr);
+
+        pid_t pid;
+        int rc = posix_spawnp(&pid, argv[0], nullptr, nullptr, argv.data(), environ);
+        if (rc != 0) {
+            errorMsg = "posix_spawnp " + words[0] + " failed: " + std::string(strerror(rc));
+            return -1;
+        }
+        return pid;
+    }
+
+    // Run done(success, error) once the child exits
+    void watch(pid_t pid, Callback done) {
+        int pidfd = -1;
+#ifdef SYS_pidfd_open
+        if (epfd != -1) {
+            pidfd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+        }
+#endif
+        if (pidfd == -1) {
+            finish(pid, done);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            children[pidfd] = Child{pid, std::move(done)};
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = pidfd;
+        if (epoll_ctl(epfd, EPOLL_CTL_ADD, pidfd, &ev) == -1) {
+            Child child;
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                child = std::move(children[pidfd]);
+                children.erase(pidfd);
+            }
+            close(pidfd);
+            finish(child.pid, child.done);
+        }
+    }
+
+private:
+    struct Child {
+        pid_t pid = 0;
+        Callback done;
+    };
+
+    void run() {
+        registry.add(std::this_thread::get_id(), "child reaper");
+        std::array<epoll_event, 64> events;
+        for (;;) {
+            int n = epoll_wait(epfd, events.data(), static_cast<int>(events.size()), -1);
+            if (n == -1) {
+                if (errno == EINTR) continue;
+                logEvent(ERROR, "epoll_wait failed in child reaper: " + std::string(strerror(errno)));
+                return;
+            }
+            for (int i = 0; i < n; ++i) {
+                int pidfd = events[i].data.fd;
+                Child child;
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    auto it = children.find(pidfd);
+                    if (it == children.end()) continue;
+                    child = std::move(it->second);
+                    children.erase(it);
+                }
+                epoll_ctl(epfd, EPOLL_CTL_DEL, pidfd, nullptr);
+                close(pidfd);
+                finish(child.pid, child.done);
+            }
+        }
+    }
+
+    // The child has exited (or we're on the fallback path), so waitpid returns right away
+    static void finish(pid_t pid, const Callback& done) {
+        int status;
+        pid_t result = waitpid(pid, &status, 0);
+        bool success = true;
+        std::string errorMsg;
+
+        if (result > 0) {
+            if (WIFEXITED(status) && WEXITSTATUS(status) != 0) {
+                success = false;
+                errorMsg = "cansend failed with exit code " + std::to_string(WEXITSTATUS(status));
+            } else if (WIFSIGNALED(status)) {
+                success = false;
+                errorMsg = "cansend terminated by signal " + std::to_string(WTERMSIG(status));
+            }
+        } else {
+            success = false;
+            errorMsg = "waitpid failed: " + std::string(strerror(errno));
+        }
+
+        try {
+            done(success, errorMsg);
+        } catch (...) {
+            logEvent(ERROR, "Unhandled exception in cansend completion for PID " + std::to_string(pid));
+        }
+    }
+
+    int epfd = -1;
+    std::mutex mtx;
+    std::unordered_map<int, Child> children;  // pidfd -> child
+};
+
+ChildReaper childReaper;
+
+void startCansend(const std::shared_ptr<ScheduledTask>& task, std::function<void(bool)> done);
+
+// Spawn the task's cansend and return straight away. On failure the task is stopped with the error recorded;
+// either way done(success) runs once the child has exited (on the reaper thread) or right here if spawn failed.
+// A task's sends go one at a time: while its previous child still runs, this one waits behind it, so the frames
+// of a CATCH_UP burst reach the bus in order. Up to catch_up_burst wait; a send past that is dropped like a
+// missed tick, and its done never runs (only recurring tasks send more than once)
+void runCansendCommand(const std::shared_ptr<ScheduledTask>& task, std::function<void(bool)> done = nullptr) {
+    switch (task->queueSend(done, static_cast<std::size_t>(std::max(catch_up_burst, 1)))) {
+        case ScheduledTask::SendSlot::NOW:
+            startCansend(task, std::move(done));
+            break;
+        case ScheduledTask::SendSlot::QUEUED:
+            break;
+        case ScheduledTask::SendSlot::FULL:
+            task->stats.missed++;
+            task->stats.dropped++;
+            logEvent(DEBUG, "Task " + task->id + " dropped a send, its previous cansend is still running");
+            break;
+    }
+}
+
+void startCansend(const std::shared_ptr<ScheduledTask>& task, std::function<void(bool)> done) {
+    auto complete = [task, done](bool success, const std::string& errorMsg) {
+        task->reportSend(success);
+        if (!success) {
+            task->setError(errorMsg);
+            task->active = false;
+            logEvent(ERROR, "Task " + task->id + " stopped: " + errorMsg);
+        }
+        if (done) done(success);
+        // Sends queued behind this one are dropped once the task has stopped
+        std::function<void(bool)> next;
+        if (task->nextSend(next)) {
+            startCansend(task, std::move(next));
+        }
+    };
+
+    std::string errorMsg;
+    pid_t pid = ChildReaper::spawn(task->command, errorMsg);
+    if (pid == -1) {
+        complete(false, errorMsg);
+        return;
+    }
+
+    task->pid = pid;
+    childReaper.watch(pid, [task, pid, complete](bool success, const std::string& errorMsg) {
+        pid_t expected = pid;
+        task->pid.compare_exchange_strong(expected, 0);  // a later send may have replaced it
+        complete(success, errorMsg);
+    });
+}
+
+// What a recurring tick does about the grid points that have gone by
+struct TickPlan {
+    int sends = 1;                                // cansends to run now
+    uint64_t missed = 0;                          // grid points that passed before the tick ran, its own included
+    uint64_t dropped = 0;                         // of those, the ones never sent
+    std::chrono::steady_clock::time_point next;   // grid point the next tick is scheduled for
+};
+
+// The tick for `deadline` running at `now` on a grid of `period`. Within `tolerance` it sends once and the next
+// tick is one period on. Later than that, every grid point up to now is missed and `policy` decides how many are
+// sent (DROP none, SKIP one, CATCH_UP up to `burst`); the next tick is the first grid point after now
+TickPlan planRecurringTick(std::chrono::steady_clock::time_point deadline, std::chrono::steady_clock::time_point now,
+                           std::chrono::milliseconds period, std::chrono::milliseconds tolerance,
+                           MissPolicy policy, int burst) {
+    TickPlan plan;
+    if (now - deadline <= tolerance) {
+        plan.next = deadline + period;
+        return plan;
+    }
+    auto overdue = (now - deadline) / period + 1;
+    switch (policy) {
+        case MissPolicy::DROP: plan.sends = 0; break;
+        case MissPolicy::SKIP: plan.sends = 1; break;
+        case MissPolicy::CATCH_UP: plan.sends = static_cast<int>(std::min<decltype(overdue)>(overdue, std::max(burst, 1))); break;
+    }
+    plan.missed = static_cast<uint64_t>(overdue);
+    plan.dropped = static_cast<uint64_t>(overdue - plan.sends);
+    plan.next = deadline + overdue * period;
+    return plan;
+}
+
+void setupRecurringCansend(ThreadPool& pool, const std::shared_ptr<ScheduledTask>& task, std::chrono::steady_clock::time_point firstDeadline) {
+    // Each run gets the grid point it was scheduled for, so the next one is computed from the
+    // grid instead of from "now" and the interval doesn't drift by the cansend runtime
+    auto recurring = std::make_shared<std::function<void(std::chrono::steady_clock::time_point)>>();
+    int priority = task->priority;
+
+    // Weak so the closure doesn't keep itself alive; the queued entry holds it while a tick is pending
+    std::weak_ptr<std::function<void(std::chrono::steady_clock::time_point)>> weakRecurring = recurring;
+    auto enqueueRecurring = [&pool, priority, weakRecurring](std::chrono::steady_clock::time_point deadline) {
+        auto recurring = weakRecurring.lock();
+        if (!recurring) return;
+        pool.enqueue_deadline(deadline,
+                              priority,
+                              false,
+                              [recurring, deadline]() {
+                                  try {
+                                      (*recurring)(deadline);
+                                  } catch (...) {
+                                      logEvent(ERROR, "Unhandled exception in recurring cansend task");
+                                  }
+                              });
+    };
+
+    // The closure holds the task itself, so it keeps running after the client handler lets go of it
+    *recurring = [task, enqueueRecurring](std::chrono::steady_clock::time_point deadline) mutable {
+        if (!task->active || retireIfLeaseExpired(task)) return;
+        if (task->parkIfPaused(deadline)) return;
+
+        if (task->intervalMs <= 0) {
+            // no grid to keep, just run back to back like before: the next send goes once this child has exited
+            runCansendCommand(task, [task, enqueueRecurring](bool success) mutable {
+                if (!success) {
+                    retireTask(task);
+                } else if (task->active) {
+                    enqueueRecurring(std::chrono::steady_clock::now());
+                }
+            });
+            return;
+        }
+
+        TickPlan plan = planRecurringTick(deadline, std::chrono::steady_clock::now(), std::chrono::milliseconds(task->intervalMs),
+                                          std::chrono::milliseconds(deadline_tolerance_ms), task->policy, catch_up_burst);
+        if (plan.missed > 0) {
+            task->stats.missed += plan.missed;
+            task->stats.dropped += plan.dropped;
+            logEvent(DEBUG, "Task " + task->id + " missed " + std::to_string(plan.missed) + " deadline(s), sending " + std::to_string(plan.sends) + " (" + missPolicyName(task->policy) + ")");
+        }
+        for (int i = 0; i < plan.sends && task->active; ++i) {
+            runCansendCommand(task, [task](bool success) {
+                if (!success) retireTask(task);  // don't bring it back after a restart
+            });
+        }
+
+        // a failed send shows up on a later tick, which then finds the task inactive
+        if (task->active) {
+            enqueueRecurring(plan.next);
+        }
+    };
+
+    // RESUME continues on the original grid: the first grid point at or after now, counting from where it parked
+    task->setReschedule([recurring, enqueueRecurring, interval = task->intervalMs](std::chrono::steady_clock::time_point parkedAt) mutable {
+        auto now = std::chrono::steady_clock::now();
+        auto next = parkedAt;
+        if (interval <= 0) {
+            next = now;
+        } else if (now > parkedAt) {
+            auto period = std::chrono::milliseconds(interval);
+            next = parkedAt + ((now - parkedAt + period - std::chrono::nanoseconds(1)) / period) * period;
+        }
+        enqueueRecurring(next);
+    });
+
+    enqueueRecurring(firstDeadline);
+}
+
+// A DROP one-shot the worker found past its deadline. A paused one parks as on any other tick and goes out on
+// RESUME, so pausing a one-shot that is still queued doesn't drop it. Returns true if it was dropped
+bool dropMissedShot(const std::shared_ptr<ScheduledTask>& task, std::chrono::steady_clock::time_point deadline) {
+    if (!task->active || task->parkIfPaused(deadline)) return false;
+    task->stats.missed++;
+    task->stats.dropped++;
+    task->setDetail(task->command + " once (dropped)");
+    retireTask(task);
+    logEvent(WARNING, "Task " + task->id + " dropped, deadline missed");
+    return true;
+}
+
+void setupSingleShotCansend(ThreadPool& pool, const std::shared_ptr<ScheduledTask>& task, std::chrono::steady_clock::time_point deadline) {
+    auto singleShot = std::make_shared<std::function<void(std::chrono::steady_clock::time_point)>>();
+
+    // DROP one-shots go through enqueue_droppable so the worker discards them when late
+    // instead of sending a stale frame; the other policies still send once
+    std::weak_ptr<std::function<void(std::chrono::steady_clock::time_point)>> weakShot = singleShot;
+    auto enqueueShot = [&pool, weakShot, task](std::chrono::steady_clock::time_point deadline) {
+        auto singleShot = weakShot.lock();
+        if (!singleShot) return;
+        if (task->policy == MissPolicy::DROP) {
+            pool.enqueue_droppable(deadline,
+                                   task->priority,
+                                   [singleShot, deadline]() {
+                                       (*singleShot)(deadline);
+                                   },
+                                   [task, deadline]() {
+                                       dropMissedShot(task, deadline);
+                                   });
+        } else {
+            pool.enqueue_deadline(deadline,
+                                  task->priority,
+                                  false,
+                                  [singleShot, deadline]() {
+                                      (*singleShot)(deadline);
+                                  });
+        }
+    };
+
+    *singleShot = [task, enqueueShot](std::chrono::steady_clock::time_point deadline) mutable {
+        if (!task->active || retireIfLeaseExpired(task)) {
+            return;
+        }
+
+        if (task->parkIfPaused(deadline)) {
+            return;
+        }
+
+        if (std::chrono::steady_clock::now() - deadline > std::chrono::milliseconds(deadline_tolerance_ms)) {
+            task->stats.missed++;
+        }
+
+        runCansendCommand(task, [task](bool success) {
+            task->setDetail(task->command + (success ? " once (completed)" : " once (error)"));
+            retireTask(task);
+        });
+    };
+
+    // RESUME sends at the original time if it's still ahead, otherwise straight away
+    task->setReschedule([singleShot, enqueueShot](std::chrono::steady_clock::time_point parkedAt) mutable {
+        enqueueShot(std::max(parkedAt, std::chrono::steady_clock::now()));
+    });
+
+    enqueueShot(deadline);
+}
+
+// Bring back the leased tasks a previous run journaled. They come back without an owner and keep
+// running until their lease runs out or a client kills them. A single-shot keeps its wall-clock due time;
+// the journal has no grid for a recurring task, so it starts a new one at `now` with a send straight away,
+// and the ticks it would have sent while the server was down are not counted as missed
+void restoreJournaledTasks(ThreadPool& pool) {
+    auto tasks = TaskJournal::load(journal_path);
+    taskJournal.open(journal_path);
+    if (tasks.empty()) {
+        taskJournal.compact();
+        return;
+    }
+
+    int64_t nowMs = wallClockMs();
+    auto now = std::chrono::steady_clock::now();
+    std::size_t restored = 0;
+    for (const auto& task : tasks) {
+        // keep new IDs clear of the restored ones
+        if (task->id.starts_with("task_")) {
+            try {
+                uint64_t n = std::stoull(task->id.substr(5));
+                uint64_t next = nextTaskId.load();
+                while (next <= n && !nextTaskId.compare_exchange_weak(next, n + 1)) {}
+            } catch (...) {}
+        }
+
+        // a task whose client was still connected when the server went down starts its lease now
+        if (task->leaseUntil == 0) {
+            task->leaseUntil = nowMs + task->leaseMs;
+        }
+        if (task->leaseExpired()) {
+            logEvent(INFO, "Not restoring task " + task->id + ", lease ran out while the server was down");
+            continue;
+        }
+
+        taskRegistry.add(task);
+        taskJournal.put(task);
+        scheduleLeaseExpiry(pool, task);
+
+        if (task->recurring) {
+            setupRecurringCansend(pool, task, now);
+        } else {
+            auto delay = std::max<int64_t>(0, task->dueMs - nowMs);
+            setupSingleShotCansend(pool, task, now + std::chrono::milliseconds(delay));
+        }
+        restored++;
+    }
+    taskJournal.compact();
+    logEvent(INFO, "Restored " + std::to_string(restored) + " task(s) from " + journal_path);
+}
+
+// Re-exec the server in place. Leased tasks come back from the journal, everything else ends with
+// this process. Only returns if exec failed
+void restartServer() {
+    taskJournal.compact();
+    logEvent(INFO, "Restarting server");
+
+    // don't leak the listening socket and client connections into the new image
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator("/proc/self/fd", ec)) {
+        int fd = std::atoi(entry.path().filename().c_str());
+        if (fd > 2) {
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+    }
+
+    std::vector<char*> args;
+    for (auto& arg : server_args) {
+        args.push_back(arg.data());
+    }
+    args.push_back(nullptr);
+    execv("/proc/self/exe", args.data());
+    logEvent(ERROR, "Server restart failed: " + std::string(strerror(errno)));
+}
+
+// Listening AF_UNIX socket for clients on this host, or -1. A socket file left behind by a crash is replaced,
+// one a running server still answers on is left alone
+int openUnixListener(const std::string& path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        logEvent(WARNING, "UNIX_SOCKET path too long, local socket disabled: " + path);
+        return -1;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        logEvent(WARNING, "local socket: " + std::string(strerror(errno)));
+        return -1;
+    }
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+        logEvent(WARNING, "Another server is listening on " + path + ", local socket disabled");
+        close(fd);
+        return -1;
+    }
+    close(fd);
+    unlink(path.c_str());
+
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1 || bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1 || listen(fd, BACKLOG) == -1) {
+        logEvent(WARNING, "Could not listen on " + path + ": " + std::string(strerror(errno)) + ", local socket disabled");
+        if (fd != -1) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int main(int argc, char* argv[]) {
+    int sockfd, new_fd;
+    struct addrinfo hints, *servinfo, *p;
+    struct sockaddr_storage their_addr;
+    socklen_t sin_size;
+    int yes = 1;
+    char s[INET6_ADDRSTRLEN];
+    int rv;
+
+    int configuredWorkerCount = 1;
+
+    std::memset(&hints, 0, sizeof hints);
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+
+    if (argc != 2) {
+        std::cerr << std::format("Error: incorrect number of arguments. Usage: {} <config_file>\n", *argv);
+        logEvent(DEBUG, "server <config_file> has incorrect number of arguments");
+        return 1;
+    }
+
+    std::string configFileName = argv[1];
+    server_args.assign(argv, argv + argc);
+    std::optional<std::string> port;
+
+    std::filesystem::path configFilePath(configFileName);
+    if (!std::filesystem::is_regular_file(configFilePath)) {
+        std::cerr << std::format("Error opening configuration file: {}\n", configFileName);
+        logEvent(ERROR, "Error opening configuration file: " + configFileName);
+        return 1;
+    }
+
+    std::ifstream configFile(configFileName);
+    std::string line;
+    while (std::getline(configFile, line)) {
+        std::string_view lineView(line);
+        if (lineView.substr(0, 5) == "PORT=") {
+            std::string portStr = trim(std::string(lineView.substr(5)));
+            port = portStr;
+            logEvent(DEBUG, "Port set to " + *port);
+        } else if (lineView.substr(0, 10) == "LOG_LEVEL=") {
+            std::string logLevelStr = trim(std::string(lineView.substr(10)));
+            log_level_str = logLevelStr;
             if (logLevelStr == "DEBUG") {
                 log_level = DEBUG;
             } else if (logLevelStr == "INFO") {
@@ -547,6 +2146,93 @@ int main(int argc, char* argv[]) {
                 logEvent(WARNING, "Error parsing WORKER_THREADS value '" + workerThreadsStr + "': " + e.what() + ". Using default.");
             }
         }
+        else if (lineView.substr(0, 12) == "MISS_POLICY=") {
+            std::string policyStr = trim(std::string(lineView.substr(12)));
+            if (auto policy = parseMissPolicy(policyStr)) {
+                default_miss_policy = *policy;
+                logEvent(DEBUG, "Default miss policy set to " + std::string(missPolicyName(default_miss_policy)));
+            } else {
+                logEvent(WARNING, "Unknown MISS_POLICY '" + policyStr + "', using " + missPolicyName(default_miss_policy));
+            }
+        }
+        else if (lineView.substr(0, 22) == "DEADLINE_TOLERANCE_MS=") {
+            std::string toleranceStr = trim(std::string(lineView.substr(22)));
+            try {
+                int tolerance = std::stoi(toleranceStr);
+                if (tolerance >= 0) {
+                    deadline_tolerance_ms = tolerance;
+                    logEvent(DEBUG, "Deadline tolerance set to " + std::to_string(deadline_tolerance_ms) + "ms");
+                } else {
+                    logEvent(WARNING, "Invalid DEADLINE_TOLERANCE_MS value '" + toleranceStr + "', must be non-negative. Using default.");
+                }
+            } catch (const std::exception& e) {
+                logEvent(WARNING, "Error parsing DEADLINE_TOLERANCE_MS value '" + toleranceStr + "': " + e.what() + ". Using default.");
+            }
+        }
+        else if (lineView.substr(0, 13) == "TASK_JOURNAL=") {
+            journal_path = trim(std::string(lineView.substr(13)));
+            logEvent(DEBUG, "Task journal set to " + journal_path);
+        }
+        else if (lineView.substr(0, 17) == "DEFAULT_LEASE_MS=") {
+            std::string leaseStr = trim(std::string(lineView.substr(17)));
+            try {
+                int64_t lease = std::stoll(leaseStr);
+                if (lease >= 0) {
+                    default_lease_ms = lease;
+                    logEvent(DEBUG, "Default task lease set to " + std::to_string(default_lease_ms) + "ms");
+                } else {
+                    logEvent(WARNING, "Invalid DEFAULT_LEASE_MS value '" + leaseStr + "', must be non-negative. Using default.");
+                }
+            } catch (const std::exception& e) {
+                logEvent(WARNING, "Error parsing DEFAULT_LEASE_MS value '" + leaseStr + "': " + e.what() + ". Using default.");
+            }
+        }
+        else if (lineView.substr(0, 18) == "TASK_HISTORY_SIZE=") {
+            std::string historyStr = trim(std::string(lineView.substr(18)));
+            try {
+                int size = std::stoi(historyStr);
+                if (size >= 0) {
+                    task_history_size = static_cast<std::size_t>(size);
+                    logEvent(DEBUG, "Task history size set to " + std::to_string(task_history_size));
+                } else {
+                    logEvent(WARNING, "Invalid TASK_HISTORY_SIZE value '" + historyStr + "', must be non-negative. Using default.");
+                }
+            } catch (const std::exception& e) {
+                logEvent(WARNING, "Error parsing TASK_HISTORY_SIZE value '" + historyStr + "': " + e.what() + ". Using default.");
+            }
+        }
+        else if (lineView.substr(0, 17) == "SESSION_GRACE_MS=") {
+            std::string graceStr = trim(std::string(lineView.substr(17)));
+            try {
+                int64_t grace = std::stoll(graceStr);
+                if (grace >= 0) {
+                    session_grace_ms = grace;
+                    logEvent(DEBUG, "Session grace period set to " + std::to_string(session_grace_ms) + "ms");
+                } else {
+                    logEvent(WARNING, "Invalid SESSION_GRACE_MS value '" + graceStr + "', must be non-negative. Using default.");
+                }
+            } catch (const std::exception& e) {
+                logEvent(WARNING, "Error parsing SESSION_GRACE_MS value '" + graceStr + "': " + e.what() + ". Using default.");
+            }
+        }
+        else if (lineView.substr(0, 12) == "UNIX_SOCKET=") {
+            unix_socket_path = trim(std::string(lineView.substr(12)));
+            logEvent(DEBUG, "Local socket set to " + unix_socket_path);
+        }
+        else if (lineView.substr(0, 15) == "CATCH_UP_BURST=") {
+            std::string burstStr = trim(std::string(lineView.substr(15)));
+            try {
+                int burst = std::stoi(burstStr);
+                if (burst >= 1) {
+                    catch_up_burst = burst;
+                    logEvent(DEBUG, "Catch-up burst set to " + std::to_string(catch_up_burst));
+                } else {
+                    logEvent(WARNING, "Invalid CATCH_UP_BURST value '" + burstStr + "', must be positive integer. Using default.");
+                }
+            } catch (const std::exception& e) {
+                logEvent(WARNING, "Error parsing CATCH_UP_BURST value '" + burstStr + "': " + e.what() + ". Using default.");
+            }
+        }
     }
     configFile.close();
 
@@ -607,14 +2293,15 @@ int main(int argc, char* argv[]) {
         throw std::system_error(errno, std::generic_category(), "listen");
     }
 
-    sa.sa_handler = sigchld_handler; // Reap all dead processes
-    sigemptyset(&sa.sa_mask);
-    sa.sa_flags = SA_RESTART;
-    if (sigaction(SIGCHLD, &sa, NULL) == -1) {
-        logEvent(ERROR, "server: sigaction");
-        throw std::system_error(errno, std::generic_category(), "sigaction");
+    // Same-host clients (the GUI) can skip loopback TCP through the local socket
+    int unixfd = unix_socket_path.empty() ? -1 : openUnixListener(unix_socket_path);
+    if (unixfd != -1) {
+        logEvent(INFO, "Local socket listening on " + unix_socket_path);
     }
 
+    // cansend children are reaped by childReaper through their pidfds, SIGCHLD keeps its default disposition
+    childReaper.start();
+
     logEvent(INFO, "server: waiting for connections...");
     std::cout << "server: waiting for connections...\n";
 
@@ -632,16 +2319,34 @@ int main(int argc, char* argv[]) {
         logEvent(INFO, "Available CAN interfaces: " + ifaceList);
     }
 
+    // Resume leased tasks from the last run before taking new connections
+    if (!journal_path.empty()) {
+        restoreJournaledTasks(pool);
+    }
+
+    std::array<pollfd, 2> listeners{{{sockfd, POLLIN, 0}, {unixfd, POLLIN, 0}}};  // poll skips a -1 fd
     while (true) {
+        if (poll(listeners.data(), listeners.size(), -1) == -1) {
+            if (errno != EINTR) {
+                logEvent(ERROR, "server: poll");
+                std::perror("poll");
+            }
+            continue;
+        }
+        bool localClient = !(listeners[0].revents & POLLIN);
         sin_size = sizeof their_addr;
-        new_fd = accept(sockfd, (struct sockaddr*)&their_addr, &sin_size);
+        new_fd = accept(localClient ? unixfd : sockfd, (struct sockaddr*)&their_addr, &sin_size);
         if (new_fd == -1) {
             logEvent(ERROR, "server: accept");
             std::perror("accept");
             continue;
         }
 
-        inet_ntop(their_addr.ss_family, get_in_addr((struct sockaddr*)&their_addr), s, sizeof s);
+        if (localClient) {
+            std::snprintf(s, sizeof s, "local#%d", new_fd);
+        } else {
+            inet_ntop(their_addr.ss_family, get_in_addr((struct sockaddr*)&their_addr), s, sizeof s);
+        }
         std::cout << "Connection from: " << s << std::endl;
         /* // todo add this only for potential ssh client. if client is not gui
         if (send (new_fd, "Hello, you are connected to the server!\n", 39, 0) == -1) { 
@@ -652,7 +2357,7 @@ int main(int argc, char* argv[]) {
         logEvent(INFO, "Connection from: " + std::string(s));
 
         // Create a new thread to handle the client communication
-        std::thread clientThread([new_fd, s, &pool]() {
+        std::thread clientThread([new_fd, s, localClient, &pool]() {
             registry.add(std::this_thread::get_id(), "client handler for " + std::string(s));  // Add to registry
             ThreadInfo info;
             info.id = std::this_thread::get_id();
@@ -666,54 +2371,81 @@ int main(int argc, char* argv[]) {
             // `time_ms` parsed from commands determines recurring interval or single-shot delay
             std::string canInterface; //can0, vcan1, etc.
             std::string canIdStr; //CAN ID and data in hex
-            std::vector<pid_t> clientPids;  // Track PIDs of spawned processes
-            std::unordered_map<std::string, std::shared_ptr<bool>> taskPauses;  // Paused tasks are kept but don't run
-            std::unordered_map<std::string, std::shared_ptr<bool>> taskActive;  // Active tasks get rescheduled
-            std::unordered_map<std::string, std::string> taskDetails;  // Task details for status
-            std::atomic<int> taskCounter{0};  // For unique task IDs
-            std::unordered_map<std::string, std::function<void(const std::string& receivedMsg)>> commandMap;
-
-            commandMap["SHUTDOWN"] = [&](const std::string&) {
+            std::unordered_map<std::string, std::shared_ptr<ScheduledTask>> tasks;  // Tasks owned by this connection
+            std::string sessionToken;  // Set by SESSION/ATTACH. With a token, tasks get a grace period on disconnect
+            TaskHistory history(task_history_size);  // Finished tasks, moved out of `tasks`
+            TaskTombstones tombstones(std::max<size_t>(4 * task_history_size, 1024));  // What left `tasks` and `history`, for LIST_TASKS since=
+            auto finished = std::make_shared<FinishedTasks>();  // Filled by workers as this client's tasks stop
+            std::shared_ptr<ReportRing> reportRing;  // Set by SHM_RING, local clients only
+            std::shared_ptr<TaskEvents> events;  // Set by SUBSCRIBE
+            std::array<std::function<void(std::string_view receivedMsg)>, static_cast<size_t>(Command::COUNT)> handlers;
+            auto on = [&](Command command) -> auto& { return handlers[static_cast<size_t>(command)]; };
+
+            // Replies go straight out, except while a tagged request runs: then they are collected and sent as one frame
+            std::string_view replyTag;  // Tag of the request being handled, empty for untagged ones
+            std::string taggedReply;
+            bool tagAnswered = false;
+            auto reply = [&](std::string_view text) {
+                if (replyTag.empty()) {
+                    send(new_fd, text.data(), text.size(), 0);
+                } else {
+                    taggedReply.append(text);
+                }
+            };
+            // Sends what a tagged request has replied so far. Every tagged request gets at least one frame
+            auto flushReply = [&]() {
+                if (replyTag.empty() || (tagAnswered && taggedReply.empty())) return;
+                std::string framed = frameTaggedReply(replyTag, taggedReply);
+                send(new_fd, framed.data(), framed.size(), 0);
+                taggedReply.clear();
+                tagAnswered = true;
+            };
+
+            on(Command::SHUTDOWN) = [&](std::string_view) {
                 logEvent(INFO, "Received SHUTDOWN command from " + std::string(s));
                 niceShutdown = true;
             };
 
-            commandMap["KILL_ALL"] = [&](const std::string&) { // kills all processes started by this client. not sure of usefulness yet. doesn't seem to work right
+            on(Command::KILL_ALL) = [&](std::string_view) { // kills all processes started by this client. not sure of usefulness yet. doesn't seem to work right
                 logEvent(INFO, "Received KILL_ALL command from " + std::string(s));
-                for (auto pid : clientPids) {
-                    if (kill(pid, SIGTERM) == -1) {
+                for (const auto& [id, task] : tasks) {
+                    pid_t pid = task->pid;
+                    if (pid > 0 && kill(pid, SIGTERM) == -1) {
                         logEvent(WARNING, "Failed to kill PID " + std::to_string(pid) + ": " + std::string(strerror(errno)));
                     }
                 }
-                clientPids.clear();
-                send(new_fd, "All processes killed.\n", 48, 0);
+                reply("All processes killed.\n");
             };
 
-            commandMap["LIST_THREADS"] = [&](const std::string&) { //also called UPDATE
+            on(Command::LIST_THREADS) = [&](std::string_view) { //also called UPDATE
                 logEvent(INFO, "Received LIST_THREADS command from " + std::string(s));
-                send(new_fd, registry.toString().c_str(), registry.toString().size(), 0);
+                reply(registry.toString());
             };
 
-            commandMap["RESTART"] = [&](const std::string&) {
+            on(Command::RESTART) = [&](std::string_view) {
                 logEvent(INFO, "Received RESTART command from " + std::string(s));
-                send(new_fd, "Server restart not implemented yet.\n", 36, 0);
+                std::string response = "Server restarting, leased tasks will resume\n";
+                reply(response);
+                flushReply();  // exec doesn't come back to the receive loop
+                restartServer();
+                reply("Server restart failed\n");
             };
 
-            commandMap["KILL_THREAD "] = [&](const std::string& msg) {
-                std::string threadIdStr = trim(msg.substr(12));
+            on(Command::KILL_THREAD) = [&](std::string_view msg) {
+                std::string threadIdStr = std::string(trimView(msg.substr(12)));
                 try {
                     std::thread::id threadId = std::thread::id(std::stoull(threadIdStr));
                     registry.remove(threadId);
                     logEvent(INFO, "Removed thread " + threadIdStr + " as per request from " + std::string(s));
-                    send(new_fd, "Thread removed\n", 16, 0);
+                    reply("Thread removed\n");
                 } catch (const std::exception& e) {
                     logEvent(ERROR, "Invalid thread ID in KILL_THREAD command from " + std::string(s));
-                    send(new_fd, "Invalid thread ID\n", 18, 0);
+                    reply("Invalid thread ID\n");
                 }
             };
 
-            commandMap["SET_LOG_LEVEL "] = [&](const std::string& msg) {
-                std::string levelStr = trim(msg.substr(14));
+            on(Command::SET_LOG_LEVEL) = [&](std::string_view msg) {
+                std::string levelStr = std::string(trimView(msg.substr(14)));
                 if (levelStr == "DEBUG") {
                     log_level = DEBUG;
                     log_level_str = "DEBUG";
@@ -728,348 +2460,382 @@ int main(int argc, char* argv[]) {
                     log_level_str = "ERROR";
                 } else {
                     logEvent(ERROR, "Invalid log level in SET_LOG_LEVEL command from " + std::string(s));
-                    send(new_fd, "Invalid log level\n", 18, 0);
+                    reply("Invalid log level\n");
                     return;
                 }
                 logEvent(INFO, "Log level set to " + log_level_str + " as per request from " + std::string(s));
-                send(new_fd, ("Log level set to " + log_level_str + "\n").c_str(), log_level_str.size() + 16, 0);
+                reply("Log level set to " + log_level_str + "\n");
             };
 
-            commandMap["PAUSE "] = [&](const std::string& msg) {
-                std::string taskId = trim(msg.substr(6));
-                if (taskPauses.count(taskId)) {
-                    *taskPauses[taskId] = true;
-                    send(new_fd, ("Paused " + taskId + "\n").c_str(), ("Paused " + taskId + "\n").size(), 0);
+            on(Command::PAUSE) = [&](std::string_view msg) {
+                std::string taskId = std::string(trimView(msg.substr(6)));
+                if (tasks.count(taskId)) {
+                    tasks[taskId]->setPaused(true);
+                    if (tasks[taskId]->leaseMs > 0) taskJournal.put(tasks[taskId]);
+                    if (events) events->status(taskId, "paused");
+                    reply("Paused " + taskId + "\n");
                 } else {
-                    send(new_fd, "Task not found\n", 15, 0);
+                    reply("Task not found\n");
                 }
             };
 
-            commandMap["RESUME "] = [&](const std::string& msg) {
-                std::string taskId = trim(msg.substr(7));
-                if (taskPauses.count(taskId)) {
-                    *taskPauses[taskId] = false;
-                    send(new_fd, ("Resumed " + taskId + "\n").c_str(), ("Resumed " + taskId + "\n").size(), 0);
+            on(Command::RESUME) = [&](std::string_view msg) {
+                std::string taskId = std::string(trimView(msg.substr(7)));
+                if (tasks.count(taskId)) {
+                    tasks[taskId]->setPaused(false);
+                    if (tasks[taskId]->leaseMs > 0) taskJournal.put(tasks[taskId]);
+                    if (events) events->status(taskId, "resumed");
+                    reply("Resumed " + taskId + "\n");
                 } else {
-                    send(new_fd, "Task not found\n", 15, 0);
+                    reply("Task not found\n");
                 }
             };
 
-            commandMap["LIST_TASKS"] = [&](const std::string&) {
-                std::string response = "Active tasks:\n";
-                for (const auto& [id, detail] : taskDetails) {
-                    std::string status;
-                    if (!*taskActive[id]) {
-                        std::lock_guard<std::mutex> lock(globalErrorMutex);
-                        if (globalTaskErrors.count(id)) {
-                            status = "stopped (error)";
-                        } else {
-                            status = "stopped";
-                        }
-                    } else if (*taskPauses[id]) {
-                        status = "paused";
-                    } else {
-                        status = "running";
-                    }
-                    response += id + ": " + detail + " (" + status + ")\n";
-                    
-                    // Include error message if available
-                    if (!*taskActive[id]) {
-                        std::lock_guard<std::mutex> lock(globalErrorMutex);
-                        if (globalTaskErrors.count(id)) {
-                            response += "  Error: " + globalTaskErrors[id] + "\n";
-                        }
-                    }
+            // Move tasks that stopped since the last command from the live set into the history
+            auto collectFinished = [&]() {
+                for (const auto& id : finished->take()) {
+                    auto it = tasks.find(id);
+                    if (it == tasks.end() || it->second->active) continue;  // killed, or taken over already
+                    if (std::string evicted = history.push(*it->second); !evicted.empty()) tombstones.add(evicted);
+                    taskRegistry.remove(id);
+                    tasks.erase(it);
                 }
-                send(new_fd, response.c_str(), response.size(), 0);
             };
 
-            commandMap["KILL_TASK "] = [&](const std::string& msg) {
-                std::string taskId = trim(msg.substr(10));  // "KILL_TASK " is 10 chars
-                if (taskActive.count(taskId)) {
-                    *taskActive[taskId] = false;  // Stop rescheduling
-                    taskPauses.erase(taskId);
-                    taskDetails.erase(taskId);
-                    taskActive.erase(taskId);
-                    {
-                        std::lock_guard<std::mutex> lock(globalErrorMutex);
-                        globalTaskErrors.erase(taskId);  // Clean up error message
-                    }
-                    logEvent(INFO, "Killed task " + taskId + " from " + std::string(s));
-                    send(new_fd, ("Task " + taskId + " killed\n").c_str(), ("Task " + taskId + " killed\n").size(), 0);
-                } else {
-                    send(new_fd, "Task not found\n", 15, 0);
+            // One line per task, shared by LIST_TASKS and ATTACH
+            auto listTaskLines = [&]() {
+                std::string response;
+                for (const auto& [id, task] : tasks) {
+                    response += taskStatusLine(*task);
                 }
+                return response + history.toString();
             };
 
-            commandMap["KILL_ALL_TASKS"] = [&](const std::string&) {
-                logEvent(INFO, "Received KILL_ALL_TASKS command from " + std::string(s));
-                for (auto& [id, active] : taskActive) {
-                    *active = false;  // Stop all rescheduling
+            on(Command::LIST_TASKS) = [&](std::string_view msg) {
+                std::string_view args = trimView(msg.substr(10));
+                if (args.empty()) {
+                    std::string response = "Active tasks:\n" + listTaskLines();
+                    reply(response);
+                    return;
                 }
-                taskPauses.clear();
-                taskDetails.clear();
-                taskActive.clear();
-                {
-                    std::lock_guard<std::mutex> lock(globalErrorMutex);
-                    globalTaskErrors.clear();  // Clean up all error messages
+                ListTasksQuery query;
+                if (!parseListTasksQuery(args, query)) {
+                    reply("ERROR: expected LIST_TASKS since=<version> [limit=<n>]\n");
+                    return;
                 }
-                send(new_fd, "All tasks killed\n", 17, 0);
-            };
-
-            commandMap["LIST_CAN_INTERFACES"] = [&](const std::string&) {
-                logEvent(INFO, "Received LIST_CAN_INTERFACES command from " + std::string(s));
-                std::string response;
-                {
-                    std::lock_guard<std::mutex> lock(canInterfacesMutex);
-                    // Refresh interfaces before listing to ensure current state
-                    availableCanInterfaces = discoverCanInterfaces();
-                    
-                    if (availableCanInterfaces.empty()) {
-                        response = "No CAN interfaces available\n";
+                uint64_t current = taskVersionCounter.load();  // before the scan, so nothing changed during it is missed
+                if (!tombstones.covers(query.since)) {
+                    reply("TASKS " + std::to_string(current) + " reset\n");
+                    return;
+                }
+                // Everything newer than `since`; records are only rendered for the page that goes out
+                struct Change {
+                    uint64_t version;
+                    const ScheduledTask* task;     // live task
+                    const std::string* text;       // history record, or the ID of a removal
+                    bool removed;
+                };
+                std::vector<Change> changes;
+                for (const auto& [id, task] : tasks) {
+                    if (uint64_t version = task->version; version > query.since) changes.push_back({version, task.get(), nullptr, false});
+                }
+                history.forEach([&](const TaskHistory::Entry& entry) {
+                    if (entry.version > query.since) changes.push_back({entry.version, nullptr, &entry.record, false});
+                });
+                if (query.since > 0) {
+                    tombstones.forEachSince(query.since, [&](uint64_t version, const std::string& id) {
+                        changes.push_back({version, nullptr, &id, true});
+                    });
+                }
+                bool more = query.limit > 0 && changes.size() > query.limit;
+                auto pageEnd = more ? changes.begin() + query.limit : changes.end();
+                auto byVersion = [](const Change& a, const Change& b) { return a.version < b.version; };
+                std::partial_sort(changes.begin(), pageEnd, changes.end(), byVersion);
+                uint64_t next = more ? std::prev(pageEnd)->version : current;
+                std::string response = "TASKS " + std::to_string(next) + " " + std::to_string(pageEnd - changes.begin()) + " " + (more ? "1" : "0") + "\n";
+                for (auto it = changes.begin(); it != pageEnd; ++it) {
+                    if (it->task) {
+                        response += taskRecord(*it->task);
+                    } else if (it->removed) {
+                        response += *it->text + " " + std::to_string(it->version) + " removed\n";
                     } else {
-                        response = "Available CAN interfaces (" + 
-                                  std::to_string(availableCanInterfaces.size()) + "):\n";
-                        for (const auto& iface : availableCanInterfaces) {
-                            response += "  " + iface + "\n";
-                        }
+                        response += *it->text;
                     }
                 }
-                send(new_fd, response.c_str(), response.size(), 0);
+                reply(response);
             };
 
-            auto runCansendCommand = [&](const std::string& cmd,
-                                         const std::string& taskId,
-                                         const std::shared_ptr<bool>& activeFlag) -> bool {
-                pid_t pid = fork();
-                if (pid == 0) {
-                    execl("/bin/sh", "sh", "-c", cmd.c_str(), NULL);
-                    _exit(1);
-                } else if (pid > 0) {
-                    {
-                        std::lock_guard<std::mutex> lock(globalPidMutex);
-                        globalPidToTaskId[pid] = taskId;
-                    }
+            on(Command::STATUS) = [&](std::string_view msg) {
+                // STATUS <task_id>: single-task LIST_TASKS line, works for any task on the server and for this
+                // client's finished ones still in its history
+                std::string taskId = std::string(trimView(msg.substr(7)));
+                if (auto task = taskRegistry.find(taskId)) {
+                    std::string response = taskStatusLine(*task);
+                    reply(response);
+                } else if (const TaskHistory::Entry* entry = history.find(taskId)) {
+                    reply(entry->line);
+                } else {
+                    reply("Task not found\n");
+                }
+            };
 
-                    int status;
-                    pid_t result = waitpid(pid, &status, 0);
-                    bool success = true;
-                    std::string errorMsg;
+            on(Command::KILL_TASK) = [&](std::string_view msg) {
+                std::string taskId = std::string(trimView(msg.substr(10)));  // "KILL_TASK " is 10 chars
+                std::shared_ptr<ScheduledTask> task;
+                if (tasks.count(taskId)) {
+                    task = tasks[taskId];
+                    tasks.erase(taskId);
+                    tombstones.add(taskId);
+                } else if (auto found = taskRegistry.find(taskId); found && found->leaseUntil != 0) {
+                    // leased tasks left behind by a disconnect or restored after a restart can be killed by anyone
+                    task = found;
+                }
+                if (!task && history.remove(taskId)) {
+                    tombstones.add(taskId);
+                    reply("Task " + taskId + " killed\n");
+                    return;
+                }
+                if (task) {
+                    retireTask(task);  // Stop rescheduling
+                    taskRegistry.remove(taskId);
+                    logEvent(INFO, "Killed task " + taskId + " from " + std::string(s));
+                    reply("Task " + taskId + " killed\n");
+                } else {
+                    reply("Task not found\n");
+                }
+            };
 
-                    if (result > 0) {
-                        if (WIFEXITED(status) && WEXITSTATUS(status) != 0) {
-                            success = false;
-                            errorMsg = "cansend failed with exit code " + std::to_string(WEXITSTATUS(status));
-                        } else if (WIFSIGNALED(status)) {
-                            success = false;
-                            errorMsg = "cansend terminated by signal " + std::to_string(WTERMSIG(status));
-                        }
-                    } else {
-                        success = false;
-                        errorMsg = "waitpid failed: " + std::string(strerror(errno));
-                    }
+            on(Command::KILL_ALL_TASKS) = [&](std::string_view) {
+                logEvent(INFO, "Received KILL_ALL_TASKS command from " + std::string(s));
+                for (auto& [id, task] : tasks) {
+                    retireTask(task);  // Stop all rescheduling
+                    taskRegistry.remove(id);
+                    tombstones.add(id);
+                }
+                history.forEach([&](const TaskHistory::Entry& entry) { tombstones.add(entry.id); });
+                tasks.clear();
+                history.clear();
+                reply("All tasks killed\n");
+            };
 
-                    {
-                        std::lock_guard<std::mutex> lock(globalPidMutex);
-                        globalPidToTaskId.erase(pid);
-                    }
+            on(Command::SESSION) = [&](std::string_view) {
+                pruneDetachedSessions();
+                if (sessionToken.empty()) {
+                    sessionToken = generateSessionToken();
+                    logEvent(INFO, "Started session " + sessionToken + " for " + std::string(s));
+                }
+                std::string response = "SESSION " + sessionToken + " " + std::to_string(session_grace_ms) + "\n";
+                reply(response);
+            };
 
-                    if (!success) {
-                        *activeFlag = false;
-                        logEvent(ERROR, "Task " + taskId + " stopped: " + errorMsg);
-                        std::lock_guard<std::mutex> lock(globalErrorMutex);
-                        globalTaskErrors[taskId] = errorMsg;
-                    }
+            on(Command::ATTACH) = [&](std::string_view msg) {
+                // ATTACH <token>: take back the tasks of a dropped session and reply with all of them at once
+                std::string token = std::string(trimView(msg.substr(7)));
+                auto count = attachSession(token, tasks, history, tombstones, [&](const std::shared_ptr<ScheduledTask>& task) {
+                    task->setFinishedQueue(finished);
+                    task->setReportRing(reportRing);
+                    task->setEventSink(events);
+                });
+                if (!count) {
+                    reply("Session not found\n");
+                    return;
+                }
+                sessionToken = token;
+                logEvent(INFO, "Session " + token + " reattached by " + std::string(s) + " with " + std::to_string(*count) + " task(s)");
+                std::string response = "Attached " + token + "\n" + listTaskLines();
+                reply(response);
+            };
 
-                    return success;
+            on(Command::LEASE) = [&](std::string_view msg) {
+                // LEASE <task_id> <ms>: keep the task running for <ms> after this client disconnects, 0 to clear
+                std::istringstream iss(std::string(trimView(msg.substr(6))));
+                std::string taskId, leaseStr;
+                iss >> taskId >> leaseStr;
+                if (leaseStr.ends_with("ms")) {
+                    leaseStr = leaseStr.substr(0, leaseStr.size() - 2);
+                }
+                int64_t leaseMs;
+                try {
+                    leaseMs = std::stoll(leaseStr);
+                } catch (...) {
+                    reply("Invalid lease\n");
+                    return;
+                }
+                if (leaseMs < 0) {
+                    reply("Invalid lease\n");
+                    return;
+                }
+                if (!tasks.count(taskId)) {
+                    reply("Task not found\n");
+                    return;
+                }
+                auto& task = tasks[taskId];
+                task->leaseMs = leaseMs;
+                task->touch();
+                if (leaseMs > 0 && task->active) {
+                    taskJournal.put(task);
                 } else {
-                    std::string errorMsg = "fork() failed for task " + taskId + ": " + std::string(strerror(errno));
-                    logEvent(ERROR, errorMsg);
-                    *activeFlag = false;
-                    {
-                        std::lock_guard<std::mutex> lock(globalErrorMutex);
-                        globalTaskErrors[taskId] = "fork() failed: system resource limit reached";
-                    }
-                    return false;
+                    taskJournal.remove(taskId);
                 }
+                logEvent(INFO, "Lease for task " + taskId + " set to " + std::to_string(leaseMs) + "ms by " + std::string(s));
+                std::string response = "Lease for " + taskId + " set to " + std::to_string(leaseMs) + "ms\n";
+                reply(response);
             };
 
-            auto setupRecurringCansend = [&](const std::string& cmd, int ct, int priority, ThreadPool& pool, std::vector<pid_t>& clientPids, std::unordered_map<std::string, std::shared_ptr<bool>>& taskPauses, std::unordered_map<std::string, std::shared_ptr<bool>>& taskActive, std::unordered_map<std::string, std::string>& taskDetails, std::atomic<int>& taskCounter) -> std::string {
-                std::string taskId = "task_" + std::to_string(taskCounter++);
-                auto pauseFlag = std::make_shared<bool>(false);
-                auto activeFlag = std::make_shared<bool>(true);
-                
-                taskPauses[taskId] = pauseFlag;
-                taskActive[taskId] = activeFlag;
-                taskDetails[taskId] = cmd + " every " + std::to_string(ct) + "ms priority " + std::to_string(priority);
-                
-                // Capture shared_ptrs directly instead of accessing via maps
-                auto recurring = std::make_shared<std::function<void()>>();
-                std::string m = cmd; // snapshot the command
-                int interval = ct; // snapshot the interval
-
-                auto enqueueRecurring = [&pool, interval, priority, recurring]() {
-                    pool.enqueue_deadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(interval),  // Changed to steady_clock
-                                          priority,
-                                          false,
-                                          [recurring]() {
-                                              try {
-                                                  (*recurring)();
-                                              } catch (...) {
-                                                  logEvent(ERROR, "Unhandled exception in recurring cansend task");
-                                              }
-                                          });
-                };
-
-                // Capture the shared_ptrs by value, not by accessing maps
-                *recurring = [recurring, m, interval, &pool, priority, &clientPids, taskId, pauseFlag, activeFlag, enqueueRecurring, &runCansendCommand]() mutable {
-                    if (!*activeFlag) return;
-                    
-                    if (!*pauseFlag) {
-                        runCansendCommand(m, taskId, activeFlag);
+            on(Command::SHM_RING) = [&](std::string_view) {
+                // SHM_RING: stream a report per finished send through shared memory, same-host clients only
+                if (!localClient) {
+                    std::string response = "ERROR: SHM_RING is only available on the local socket\n";
+                    reply(response);
+                    return;
+                }
+                if (!reportRing) {
+                    std::string errorMsg;
+                    reportRing = ReportRing::create(SHM_RING_SLOTS, errorMsg);
+                    if (!reportRing) {
+                        logEvent(ERROR, "Could not create report ring for " + std::string(s) + ": " + errorMsg);
+                        std::string response = "ERROR: " + errorMsg + "\n";
+                        reply(response);
+                        return;
                     }
-                    
-                    if (*activeFlag) {
-                        enqueueRecurring();
+                    for (auto& [id, task] : tasks) {
+                        task->setReportRing(reportRing);
                     }
-                };
-
-                enqueueRecurring();
-                return taskId;
+                    logEvent(INFO, "Report ring " + reportRing->segmentName() + " created for " + std::string(s));
+                }
+                std::string response = "SHM_RING " + reportRing->segmentName() + " " + std::to_string(reportRing->capacity()) + "\n";
+                reply(response);
             };
 
-            auto setupSingleShotCansend = [&](const std::string& cmd,
-                                              int delayMs,
-                                              int priority,
-                                              ThreadPool& pool,
-                                              std::unordered_map<std::string, std::shared_ptr<bool>>& taskPauses,
-                                              std::unordered_map<std::string, std::shared_ptr<bool>>& taskActive,
-                                              std::unordered_map<std::string, std::string>& taskDetails,
-                                              std::atomic<int>& taskCounter) -> std::string {
-                std::string taskId = "task_" + std::to_string(taskCounter++);
-                auto pauseFlag = std::make_shared<bool>(false);
-                auto activeFlag = std::make_shared<bool>(true);
-
-                taskPauses[taskId] = pauseFlag;
-                taskActive[taskId] = activeFlag;
-                taskDetails[taskId] = cmd + " once after " + std::to_string(delayMs) + "ms priority " + std::to_string(priority);
-
-                auto singleShot = std::make_shared<std::function<void()>>();
-                *singleShot = [singleShot,
-                               cmd,
-                               taskId,
-                               pauseFlag,
-                               activeFlag,
-                               priority,
-                               &pool,
-                               &taskDetails,
-                               &runCansendCommand]() mutable {
-                    if (!*activeFlag) {
+            on(Command::SUBSCRIBE) = [&](std::string_view) {
+                // SUBSCRIBE: push task events from now on, see TaskEvents
+                if (!events) {
+                    events = std::make_shared<TaskEvents>();
+                    if (events->fd == -1) {
+                        logEvent(ERROR, "Could not create event fd for " + std::string(s) + ": " + std::string(strerror(errno)));
+                        events.reset();
+                        reply("ERROR: " + std::string(strerror(errno)) + "\n");
                         return;
                     }
-
-                    if (*pauseFlag) {
-                        pool.enqueue_deadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(50),
-                                              priority,
-                                              false,
-                                              [singleShot]() {
-                                                  (*singleShot)();
-                                              });
-                        return;
-                    }
-
-                    bool success = runCansendCommand(cmd, taskId, activeFlag);
-                    if (success) {
-                        *activeFlag = false;
-                        taskDetails[taskId] = cmd + " once (completed)";
-                    } else {
-                        taskDetails[taskId] = cmd + " once (error)";
+                    for (auto& [id, task] : tasks) {
+                        task->setEventSink(events);
                     }
-                };
-
-                pool.enqueue_deadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(delayMs),
-                                      priority,
-                                      false,
-                                      [singleShot]() {
-                                          (*singleShot)();
-                                      });
-
-                return taskId;
+                    logEvent(INFO, "Task events subscribed by " + std::string(s));
+                }
+                reply("SUBSCRIBED\n");
             };
 
-            struct CansendConfig {
-                std::string command;
-                std::string canIdData;
-                std::string canBus;
-                int intervalMs;
-                int priority;
+            on(Command::PING) = [&](std::string_view) {
+                reply("PONG\n");  // heartbeat, not logged
             };
 
-            auto parseCansendPayload = [&](const std::string& payload,
-                                            int defaultPriority,
-                                            CansendConfig& outConfig,
-                                            std::string& errorMsg) -> bool {
-                std::vector<std::string> parts;
-                std::stringstream ss(payload);
-                std::string part;
-                while (std::getline(ss, part, '#')) {
-                    parts.push_back(trim(part));
-                }
-
-                if (parts.size() < 4) {
-                    errorMsg = "ERROR: Invalid CANSEND syntax. Usage: CANSEND#<id>#<payload>#<time_ms>#<bus> [priority 0-9]\n";
-                    return false;
+            on(Command::LIST_CAN_INTERFACES) = [&](std::string_view) {
+                logEvent(INFO, "Received LIST_CAN_INTERFACES command from " + std::string(s));
+                std::string response;
+                {
+                    std::lock_guard<std::mutex> lock(canInterfacesMutex);
+                    // Refresh interfaces before listing to ensure current state
+                    availableCanInterfaces = discoverCanInterfaces();
+                    
+                    if (availableCanInterfaces.empty()) {
+                        response = "No CAN interfaces available\n";
+                    } else {
+                        response = "Available CAN interfaces (" + 
+                                  std::to_string(availableCanInterfaces.size()) + "):\n";
+                        for (const auto& iface : availableCanInterfaces) {
+                            response += "  " + iface + "\n";
+                        }
+                    }
                 }
+                reply(response);
+            };
 
-                std::string canId = parts[0];
-                std::string canPayload = parts[1];
-                std::string timeStr = parts[2];
-                std::string canBus = parts[3];
-
-                if (canId.starts_with("0x") || canId.starts_with("0X")) {
-                    canId = canId.substr(2);
+            auto createTask = [&](const CansendRequest& cfg, bool recurring) -> std::shared_ptr<ScheduledTask> {
+                auto task = std::make_shared<ScheduledTask>();
+                task->id = "task_" + std::to_string(nextTaskId++);
+                task->command = cfg.command();
+                task->recurring = recurring;
+                task->intervalMs = cfg.intervalMs;
+                task->priority = cfg.priority;
+                task->policy = cfg.missPolicy;
+                task->dueMs = recurring ? 0 : wallClockMs() + cfg.intervalMs;
+                task->leaseMs = default_lease_ms;
+                task->setDetail(taskDetailText(*task));
+                task->setFinishedQueue(finished);
+                task->setReportRing(reportRing);
+                task->setEventSink(events);
+                tasks[task->id] = task;
+                taskRegistry.add(task);
+                if (task->leaseMs > 0) {
+                    taskJournal.put(task);
                 }
+                if (events) events->status(task->id, "created");
+                return task;
+            };
 
-                if (timeStr.ends_with("ms")) {
-                    timeStr = timeStr.substr(0, timeStr.size() - 2);
+            on(Command::SEND_TASK) = [&](std::string_view msg) {
+                std::string_view payload = trimView(msg.substr(10));
+                CansendRequest cfg;
+                std::string errorMsg;
+                if (!parseCansendPayload(payload, priority, cfg, errorMsg)) {
+                    logEvent(ERROR, "Invalid SEND_TASK payload from " + std::string(s) + ": " + std::string(payload));
+                    reply(errorMsg);
+                    return;
                 }
 
-                int parsedPriority = defaultPriority;
-                if (parts.size() >= 5 && !parts[4].empty()) {
-                    std::string priorityStr = trim(parts[4]);
-                    if (priorityStr.size() == 1 && priorityStr[0] >= '0' && priorityStr[0] <= '9') {
-                        parsedPriority = priorityStr[0] - '0';
-                    }
-                }
+                logEvent(INFO, "Parsed SEND_TASK: " + std::string(cfg.canBus) + " " + cfg.canIdData() + " in " + std::to_string(cfg.intervalMs) + "ms priority " + std::to_string(cfg.priority) + " from " + std::string(s));
+                auto task = createTask(cfg, false);
+                setupSingleShotCansend(pool, task, std::chrono::steady_clock::now() + std::chrono::milliseconds(cfg.intervalMs));
+                std::string taskId = task->id;
+                std::string response = "OK: SEND_TASK scheduled with task ID: " + taskId + "\n";
+                reply(response);
+            };
 
-                if (!isValidCanInterface(canBus)) {
-                    errorMsg = "ERROR: CAN interface '" + canBus + "' is not available. Use LIST_CAN_INTERFACES to see available interfaces.\n";
-                    return false;
+            on(Command::CANSEND) = [&](std::string_view msg) {
+                std::string_view payload = trimView(msg.substr(8));
+                CansendRequest cfg;
+                std::string errorMsg;
+                if (!parseCansendPayload(payload, priority, cfg, errorMsg)) {
+                    logEvent(ERROR, "Invalid CANSEND payload from " + std::string(s) + ": " + std::string(payload));
+                    reply(errorMsg);
+                    return;
                 }
 
-                int intervalMs;
-                try {
-                    intervalMs = std::stoi(timeStr);
-                } catch (...) {
-                    errorMsg = "ERROR: Invalid time value\n";
-                    return false;
-                }
+                logEvent(INFO, "Parsed CANSEND: " + std::string(cfg.canBus) + " " + cfg.canIdData() + " every " + std::to_string(cfg.intervalMs) + "ms priority " + std::to_string(cfg.priority) + " from " + std::string(s));
+                auto task = createTask(cfg, true);
+                setupRecurringCansend(pool, task, std::chrono::steady_clock::now() + std::chrono::milliseconds(cfg.intervalMs));
+                std::string taskId = task->id;
+                std::string response = "OK: CANSEND scheduled with task ID: " + taskId + "\n";
+                reply(response);
+            };
 
-                if (intervalMs < 0) {
-                    errorMsg = "ERROR: Time value must be non-negative\n";
-                    return false;
+            auto dispatch = [&](std::string_view msg) {
+                collectFinished();
+                if (auto command = matchCommand(msg)) {
+                    handlers[static_cast<size_t>(*command)](msg);
+                } else {
+                    logEvent(WARNING, "Unknown command from " + std::string(s) + ": " + std::string(msg));
+                    reply("Unknown command: " + std::string(msg));
                 }
+            };
+            std::string pendingRequests;  // Tagged requests received so far, up to the last complete line
 
-                std::string canIdData = canId + "#" + canPayload;
-                outConfig.command = "cansend " + canBus + " " + canIdData;
-                outConfig.canIdData = canIdData;
-                outConfig.canBus = canBus;
-                outConfig.intervalMs = intervalMs;
-                outConfig.priority = parsedPriority;
-                return true;
+            // Subscribed clients get their events between replies, so nothing else writes to the socket
+            auto sendEvents = [&]() {
+                collectFinished();
+                std::string lines = events->take();
+                if (!lines.empty()) send(new_fd, lines.data(), lines.size(), 0);
             };
 
             while (!niceShutdown) {
+                std::array<pollfd, 2> fds{{{new_fd, POLLIN, 0}, {events ? events->fd : -1, POLLIN, 0}}};
+                if (poll(fds.data(), fds.size(), events ? EVENT_FLUSH_MS : -1) == -1) {
+                    if (errno == EINTR) continue;
+                    logEvent(ERROR, "poll: " + std::string(strerror(errno)));
+                    break;
+                }
+                if (events) sendEvents();
+                if (fds[0].revents == 0) continue;
                 if ((numbytes = recv(new_fd, buf.data(), MAXDATASIZE - 1, 0)) == -1) {
                     logEvent(ERROR, "recv");
                     perror("recv");
@@ -1080,87 +2846,78 @@ int main(int argc, char* argv[]) {
                 }
 
                 buf[numbytes] = '\0';
-                std::string receivedMsg(buf.data(), static_cast<size_t>(numbytes));
-                logEvent(DEBUG, "Received from " + std::string(s) + ": " + receivedMsg);
-
-                bool handled = false;
-                for (const auto& pair : commandMap) {
-                    if (receivedMsg.rfind(pair.first, 0) == 0) {
-                        pair.second(receivedMsg);
-                        handled = true;
-                        break;
-                    }
+                std::string_view receivedMsg(buf.data(), static_cast<size_t>(numbytes));
+                if (log_level <= DEBUG) {
+                    logEvent(DEBUG, "Received from " + std::string(s) + ": " + std::string(receivedMsg));
                 }
-                if (!handled) {
-                    if (receivedMsg.rfind("SEND_TASK#", 0) == 0) {
-                        std::string payload = trim(receivedMsg.substr(10));
-                        CansendConfig cfg;
-                        std::string errorMsg;
-                        if (!parseCansendPayload(payload, priority, cfg, errorMsg)) {
-                            logEvent(ERROR, "Invalid SEND_TASK payload from " + std::string(s) + ": " + payload);
-                            send(new_fd, errorMsg.c_str(), errorMsg.size(), 0);
-                            continue;
-                        }
-
-                        logEvent(INFO, "Parsed SEND_TASK: " + cfg.canBus + " " + cfg.canIdData + " in " + std::to_string(cfg.intervalMs) + "ms priority " + std::to_string(cfg.priority) + " from " + std::string(s));
-                        std::string taskId = setupSingleShotCansend(cfg.command, cfg.intervalMs, cfg.priority, pool, taskPauses, taskActive, taskDetails, taskCounter);
-                        std::string response = "OK: SEND_TASK scheduled with task ID: " + taskId + "\n";
-                        send(new_fd, response.c_str(), response.size(), 0);
-                    } else if (receivedMsg.rfind("CANSEND#", 0) == 0) {
-                        std::string payload = trim(receivedMsg.substr(8));
-                        CansendConfig cfg;
-                        std::string errorMsg;
-                        if (!parseCansendPayload(payload, priority, cfg, errorMsg)) {
-                            logEvent(ERROR, "Invalid CANSEND payload from " + std::string(s) + ": " + payload);
-                            send(new_fd, errorMsg.c_str(), errorMsg.size(), 0);
-                            continue;
-                        }
 
-                        logEvent(INFO, "Parsed CANSEND: " + cfg.canBus + " " + cfg.canIdData + " every " + std::to_string(cfg.intervalMs) + "ms priority " + std::to_string(cfg.priority) + " from " + std::string(s));
-                        std::string taskId = setupRecurringCansend(cfg.command, cfg.intervalMs, cfg.priority, pool, clientPids, taskPauses, taskActive, taskDetails, taskCounter);
-                        std::string response = "OK: CANSEND scheduled with task ID: " + taskId + "\n";
-                        send(new_fd, response.c_str(), response.size(), 0);
-                    } else {
-                        logEvent(WARNING, "Unknown command from " + std::string(s) + ": " + receivedMsg);
-                        std::string response = "Unknown command: " + receivedMsg;
-                        send(new_fd, response.c_str(), response.size(), 0);
+                // Untagged: one recv() is one command, as before. Tagged requests are newline-terminated and may
+                // arrive several to a recv() or split across two, so they are cut into lines first
+                if (!receivedMsg.starts_with('@') && pendingRequests.empty()) {
+                    dispatch(receivedMsg);
+                    continue;
+                }
+                pendingRequests.append(receivedMsg);
+                size_t lineStart = 0;
+                size_t lineEnd;
+                while (!niceShutdown && (lineEnd = pendingRequests.find('\n', lineStart)) != std::string::npos) {
+                    std::string_view line(pendingRequests.data() + lineStart, lineEnd - lineStart);
+                    lineStart = lineEnd + 1;
+                    std::string_view tag;
+                    std::string_view command;
+                    if (!parseTaggedRequest(line, tag, command)) {
+                        if (!trimView(line).empty()) dispatch(line);
+                        continue;
                     }
+                    replyTag = tag;
+                    tagAnswered = false;
+                    dispatch(command);
+                    flushReply();
+                    replyTag = {};
+                }
+                pendingRequests.erase(0, lineStart);
+                if (pendingRequests.size() > MAXDATASIZE) {
+                    logEvent(WARNING, "Dropping " + std::to_string(pendingRequests.size()) + " bytes without a newline from " + std::string(s));
+                    pendingRequests.clear();
                 }
             }
 
             // Clean up all tasks on disconnect
             logEvent(INFO, "Cleaning up tasks for disconnected client: " + std::string(s));
-            for (auto& [id, active] : taskActive) {
-                *active = false;  // Stop all task rescheduling
-                logEvent(DEBUG, "Stopped task " + id + " for client " + std::string(s));
-            }
-            taskPauses.clear();
-            taskDetails.clear();
-            taskActive.clear();
-            {
-                std::lock_guard<std::mutex> lock(globalErrorMutex);
-                // Remove error messages for this client's tasks
-                for (auto it = globalTaskErrors.begin(); it != globalTaskErrors.end();) {
-                    if (it->first.find("task_") == 0) {
-                        // Check if this task belongs to this client by checking if it's in taskActive
-                        // Since taskActive is already cleared, we can't verify, so just log
-                        logEvent(DEBUG, "Cleaned up error for task " + it->first);
-                        it = globalTaskErrors.erase(it);
-                    } else {
-                        ++it;
+            // A client with a session may have just lost its network, so its tasks get the grace period to ATTACH again
+            bool detachSession = !niceShutdown && !sessionToken.empty() && session_grace_ms > 0 && !tasks.empty();
+            for (auto& [id, task] : tasks) {
+                task->setReportRing(nullptr);  // nobody reads it anymore
+                task->setEventSink(nullptr);
+                int64_t keepMs = task->leaseMs;
+                if (detachSession) {
+                    keepMs = std::max(keepMs, session_grace_ms);
+                }
+                if (task->active && keepMs > 0) {
+                    // leased tasks keep running on their own until the lease runs out
+                    task->leaseUntil = wallClockMs() + keepMs;
+                    if (task->leaseMs > 0) {
+                        taskJournal.put(task);
+                    }
+                    scheduleLeaseExpiry(pool, task);
+                    logEvent(DEBUG, "Kept task " + id + " alive for " + std::to_string(keepMs) + "ms after " + std::string(s) + " disconnected");
+                } else {
+                    retireTask(task);  // Stop all task rescheduling
+                    if (task->pid > 0) {
+                        kill(task->pid, SIGTERM);
+                    }
+                    if (!detachSession) {
+                        taskRegistry.remove(id);
                     }
+                    logEvent(DEBUG, "Stopped task " + id + " for client " + std::string(s));
                 }
             }
-
-            // Clean up any remaining PIDs on disconnect
-            for (auto pid : clientPids) {
-                kill(pid, SIGTERM);
-                {
-                    std::lock_guard<std::mutex> lock(globalPidMutex);
-                    globalPidToTaskId.erase(pid);
-                }
+            if (detachSession) {
+                std::lock_guard<std::mutex> lock(sessionMutex);
+                detachedSessions[sessionToken] = DetachedSession{tasks, history, wallClockMs() + session_grace_ms};
+                logEvent(INFO, "Session " + sessionToken + " detached, " + std::to_string(tasks.size()) + " task(s) kept for " + std::to_string(session_grace_ms) + "ms");
             }
-            clientPids.clear();
+            tasks.clear();
 
             close(new_fd);
             registry.remove(std::this_thread::get_id());  // Remove from registry
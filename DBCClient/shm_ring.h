@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 Joseph Ogle, Kunal Singh, and Deven Nasso
+
+/**
+ * @file shm_ring.h
+ * @brief Layout of the shared-memory ring the server streams per-send reports through to a client on the same host.
+ *
+ * server.cpp creates the segment when a client on the local socket sends SHM_RING and is the only producer;
+ * the client maps it and is the only consumer. The two are built separately, so both include this file.
+ * No locks live in the segment: head is written only by the server, tail only by the client.
+ */
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace shm_ring {
+
+constexpr uint32_t MAGIC = 0x43414e52;  // "CANR"
+constexpr uint32_t VERSION = 1;
+
+// One finished cansend
+struct SendReport {
+    uint64_t taskNumber;  // <n> of "task_<n>"
+    int64_t completedMs;  // wall clock, ms since epoch
+    uint32_t ok;          // 1 if cansend exited cleanly
+    uint32_t missed;      // the task's deadline counters at that point
+    uint32_t dropped;
+    uint32_t reserved;
+};
+static_assert(sizeof(SendReport) == 32);
+
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;  // slots, a power of two
+    uint32_t slotSize;  // sizeof(SendReport), checked by the client
+    alignas(64) std::atomic<uint64_t> head;      // next slot the server writes
+    alignas(64) std::atomic<uint64_t> tail;      // next slot the client reads
+    alignas(64) std::atomic<uint64_t> overruns;  // reports dropped because the ring was full
+};
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring counters are shared between processes");
+
+inline size_t mappedSize(uint32_t capacity) {
+    return sizeof(Header) + static_cast<size_t>(capacity) * sizeof(SendReport);
+}
+
+inline SendReport* slots(Header* header) {
+    return reinterpret_cast<SendReport*>(header + 1);
+}
+
+// Checks a freshly mapped segment of `size` bytes before the client trusts anything in it
+inline bool valid(const Header* header, size_t size) {
+    if (size < sizeof(Header)) return false;
+    uint32_t capacity = header->capacity;
+    return header->magic == MAGIC && header->version == VERSION && header->slotSize == sizeof(SendReport) &&
+           capacity != 0 && (capacity & (capacity - 1)) == 0 && mappedSize(capacity) <= size;
+}
+
+// Producer. Never waits for the client: a full ring drops the report and counts it
+inline bool push(Header* header, const SendReport& report) {
+    uint64_t head = header->head.load(std::memory_order_relaxed);
+    if (head - header->tail.load(std::memory_order_acquire) >= header->capacity) {
+        header->overruns.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    slots(header)[head & (header->capacity - 1)] = report;
+    header->head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+// Consumer
+inline bool pop(Header* header, SendReport& report) {
+    uint64_t tail = header->tail.load(std::memory_order_relaxed);
+    if (tail == header->head.load(std::memory_order_acquire)) return false;
+    report = slots(header)[tail & (header->capacity - 1)];
+    header->tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+}  // namespace shm_ring
+
+#endif  // SHM_RING_H
@@ -3,68 +3,133 @@
 
 #include <iostream>
 #include <string>
-#include <vector>
-#include <sstream>
 #include <cassert>
 #include <algorithm>
+#include <optional>
+#include <cctype>
+#include <array>
+#include <string_view>
+#include <charconv>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+#include <condition_variable>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+#include <spawn.h>
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include "shm_ring.h"
 
-// Mock trim function (assuming it's defined elsewhere)
-std::string trim(const std::string& str) {
-    size_t first = str.find_first_not_of(' ');
-    if (first == std::string::npos) return "";
-    size_t last = str.find_last_not_of(' ');
-    return str.substr(first, (last - first + 1));
+// Copy of trimView from server.cpp
+std::string_view trimView(std::string_view str) {
+    size_t first = str.find_first_not_of(" \t\r\n\f\v");
+    if (first == std::string_view::npos) return {};
+    size_t last = str.find_last_not_of(" \t\r\n\f\v");
+    return str.substr(first, last - first + 1);
 }
 
 // Mock isValidCanInterface (simplified for testing; in real code, check against discovered interfaces)
-bool isValidCanInterface(const std::string& iface) {
+bool isValidCanInterface(std::string_view iface) {
     // For tests, assume vcan0, can0, vcan1 are valid
     return iface == "vcan0" || iface == "can0" || iface == "vcan1";
 }
 
-// Updated parsing function to match parseCansendPayload logic from server.cpp
-bool parseCansendPayload(const std::string& payload, int defaultPriority, std::string& command, std::string& canIdData, std::string& canBus, int& intervalMs, int& priority, std::string& errorMsg) {
-    std::vector<std::string> parts;
-    std::stringstream ss(payload);
-    std::string part;
-    while (std::getline(ss, part, '#')) {
-        parts.push_back(trim(part));
+enum class MissPolicy { DROP, SKIP, CATCH_UP };
+MissPolicy default_miss_policy = MissPolicy::SKIP;
+
+// Copy of parseMissPolicy from server.cpp
+std::optional<MissPolicy> parseMissPolicy(std::string_view str) {
+    auto is = [str](std::string_view name) {
+        return std::equal(str.begin(), str.end(), name.begin(), name.end(),
+                          [](char a, char b) { return std::toupper(static_cast<unsigned char>(a)) == b; });
+    };
+    if (is("DROP")) return MissPolicy::DROP;
+    if (is("SKIP")) return MissPolicy::SKIP;
+    if (is("CATCH_UP") || is("CATCHUP")) return MissPolicy::CATCH_UP;
+    return std::nullopt;
+}
+
+// Copy of splitFields from server.cpp
+template <size_t N>
+size_t splitFields(std::string_view text, char sep, std::array<std::string_view, N>& fields) {
+    size_t count = 0;
+    while (!text.empty() && count < N) {
+        size_t pos = text.find(sep);
+        fields[count++] = trimView(text.substr(0, pos));
+        if (pos == std::string_view::npos) break;
+        text.remove_prefix(pos + 1);
     }
+    return count;
+}
+
+// Copy of CansendRequest from server.cpp
+struct CansendRequest {
+    std::string_view canId;
+    std::string_view canPayload;
+    std::string_view canBus;
+    int intervalMs = 0;
+    int priority = 5;
+    MissPolicy missPolicy = MissPolicy::SKIP;
+
+    std::string canIdData() const { return std::string(canId) + "#" + std::string(canPayload); }
+    std::string command() const { return "cansend " + std::string(canBus) + " " + canIdData(); }
+};
 
-    if (parts.size() < 4) {
-        errorMsg = "ERROR: Invalid CANSEND syntax. Usage: CANSEND#<id>#<payload>#<time_ms>#<bus> [priority 0-9]\n";
+// Copy of parseCansendPayload from server.cpp
+bool parseCansendPayload(std::string_view payload, int defaultPriority, CansendRequest& out, std::string& errorMsg) {
+    std::array<std::string_view, 6> parts;
+    size_t count = splitFields(payload, '#', parts);
+
+    if (count < 4) {
+        errorMsg = "ERROR: Invalid CANSEND syntax. Usage: CANSEND#<id>#<payload>#<time_ms>#<bus>[#priority 0-9[#drop|skip|catch_up]]\n";
         return false;
     }
 
-    std::string canId = parts[0];
-    std::string canPayload = parts[1];
-    std::string timeStr = parts[2];
-    canBus = parts[3];
+    std::string_view canId = parts[0];
+    std::string_view timeStr = parts[2];
 
     if (canId.starts_with("0x") || canId.starts_with("0X")) {
-        canId = canId.substr(2);
+        canId.remove_prefix(2);
     }
 
     if (timeStr.ends_with("ms")) {
-        timeStr = timeStr.substr(0, timeStr.size() - 2);
+        timeStr.remove_suffix(2);
+    }
+
+    int parsedPriority = defaultPriority;
+    if (count >= 5 && parts[4].size() == 1 && parts[4][0] >= '0' && parts[4][0] <= '9') {
+        parsedPriority = parts[4][0] - '0';
     }
 
-    priority = defaultPriority;
-    if (parts.size() >= 5 && !parts[4].empty()) {
-        std::string priorityStr = trim(parts[4]);
-        if (priorityStr.size() == 1 && priorityStr[0] >= '0' && priorityStr[0] <= '9') {
-            priority = priorityStr[0] - '0';
+    MissPolicy parsedPolicy = default_miss_policy;
+    if (count >= 6 && !parts[5].empty()) {
+        auto policy = parseMissPolicy(parts[5]);
+        if (!policy) {
+            errorMsg = "ERROR: Unknown miss policy '" + std::string(parts[5]) + "'. Use drop, skip or catch_up\n";
+            return false;
         }
+        parsedPolicy = *policy;
     }
 
-    if (!isValidCanInterface(canBus)) {
-        errorMsg = "ERROR: CAN interface '" + canBus + "' is not available. Use LIST_CAN_INTERFACES to see available interfaces.\n";
+    if (!isValidCanInterface(parts[3])) {
+        errorMsg = "ERROR: CAN interface '" + std::string(parts[3]) + "' is not available. Use LIST_CAN_INTERFACES to see available interfaces.\n";
         return false;
     }
 
-    try {
-        intervalMs = std::stoi(timeStr);
-    } catch (...) {
+    int intervalMs = 0;
+    if (std::from_chars(timeStr.data(), timeStr.data() + timeStr.size(), intervalMs).ec != std::errc{}) {
         errorMsg = "ERROR: Invalid time value\n";
         return false;
     }
@@ -74,11 +139,899 @@ bool parseCansendPayload(const std::string& payload, int defaultPriority, std::s
         return false;
     }
 
-    canIdData = canId + "#" + canPayload;
-    command = "cansend " + canBus + " " + canIdData;
+    out.canId = canId;
+    out.canPayload = parts[1];
+    out.canBus = parts[3];
+    out.intervalMs = intervalMs;
+    out.priority = parsedPriority;
+    out.missPolicy = parsedPolicy;
     return true;
 }
 
+// Old-style signature on top of the copy, so the checks below read the same as before
+bool parseCansendPayload(const std::string& payload, int defaultPriority, std::string& command, std::string& canIdData, std::string& canBus, int& intervalMs, int& priority, std::string& errorMsg) {
+    CansendRequest request;
+    if (!parseCansendPayload(std::string_view(payload), defaultPriority, request, errorMsg)) {
+        return false;
+    }
+    command = request.command();
+    canIdData = request.canIdData();
+    canBus = std::string(request.canBus);
+    intervalMs = request.intervalMs;
+    priority = request.priority;
+    return true;
+}
+
+// Copy of the prefix table and matchCommand from server.cpp
+enum class Command {
+    SHUTDOWN, KILL_ALL_TASKS, KILL_ALL, LIST_THREADS, RESTART, KILL_THREAD, SET_LOG_LEVEL, PAUSE, RESUME,
+    LIST_TASKS, STATUS, KILL_TASK, SESSION, ATTACH, LEASE, LIST_CAN_INTERFACES, SEND_TASK, CANSEND, SHM_RING,
+    SUBSCRIBE, PING, COUNT
+};
+
+struct CommandPrefix {
+    std::string_view prefix;
+    Command command;
+};
+
+constexpr std::array<CommandPrefix, static_cast<size_t>(Command::COUNT)> commandTable{{
+    {"CANSEND#", Command::CANSEND},
+    {"SEND_TASK#", Command::SEND_TASK},
+    {"LIST_TASKS", Command::LIST_TASKS},
+    {"STATUS ", Command::STATUS},
+    {"PAUSE ", Command::PAUSE},
+    {"RESUME ", Command::RESUME},
+    {"KILL_TASK ", Command::KILL_TASK},
+    {"KILL_ALL_TASKS", Command::KILL_ALL_TASKS},
+    {"KILL_ALL", Command::KILL_ALL},
+    {"LEASE ", Command::LEASE},
+    {"SESSION", Command::SESSION},
+    {"ATTACH ", Command::ATTACH},
+    {"LIST_CAN_INTERFACES", Command::LIST_CAN_INTERFACES},
+    {"LIST_THREADS", Command::LIST_THREADS},
+    {"SET_LOG_LEVEL ", Command::SET_LOG_LEVEL},
+    {"KILL_THREAD ", Command::KILL_THREAD},
+    {"RESTART", Command::RESTART},
+    {"SHUTDOWN", Command::SHUTDOWN},
+    {"SHM_RING", Command::SHM_RING},
+    {"SUBSCRIBE", Command::SUBSCRIBE},
+    {"PING", Command::PING},
+}};
+
+constexpr std::optional<Command> matchCommand(std::string_view msg) {
+    for (const auto& entry : commandTable) {
+        if (msg.starts_with(entry.prefix)) return entry.command;
+    }
+    return std::nullopt;
+}
+
+// Copy of parseTaggedRequest and frameTaggedReply from server.cpp
+constexpr bool parseTaggedRequest(std::string_view line, std::string_view& tag, std::string_view& command) {
+    if (!line.starts_with('@')) return false;
+    size_t space = line.find(' ');
+    if (space == std::string_view::npos || space == 1 || space > 21) return false;
+    for (char c : line.substr(1, space - 1)) {
+        if (c < '0' || c > '9') return false;
+    }
+    tag = line.substr(1, space - 1);
+    command = line.substr(space + 1);
+    if (command.ends_with('\r')) command.remove_suffix(1);
+    return true;
+}
+
+std::string frameTaggedReply(std::string_view tag, std::string_view reply) {
+    std::string framed = "@" + std::string(tag) + " " + std::to_string(reply.size()) + "\n";
+    framed.append(reply);
+    return framed;
+}
+
+// Copy of ListTasksQuery and parseListTasksQuery from server.cpp
+struct ListTasksQuery {
+    uint64_t since = 0;
+    uint32_t limit = 0;  // records per reply, 0 for no limit
+};
+
+// Arguments of LIST_TASKS: "since=<version> [limit=<n>]" in any order, since= required
+bool parseListTasksQuery(std::string_view args, ListTasksQuery& query) {
+    bool haveSince = false;
+    while (!args.empty()) {
+        size_t space = args.find(' ');
+        std::string_view field = args.substr(0, space);
+        args.remove_prefix(space == std::string_view::npos ? args.size() : space + 1);
+        if (field.empty()) continue;
+        size_t equals = field.find('=');
+        if (equals == std::string_view::npos) return false;
+        std::string_view key = field.substr(0, equals);
+        std::string_view value = field.substr(equals + 1);
+        uint64_t number = 0;
+        auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), number);
+        if (value.empty() || ec != std::errc() || end != value.data() + value.size()) return false;
+        if (key == "since") {
+            query.since = number;
+            haveSince = true;
+        } else if (key == "limit" && number <= UINT32_MAX) {
+            query.limit = static_cast<uint32_t>(number);
+        } else {
+            return false;
+        }
+    }
+    return haveSince;
+}
+
+// Copy of TickPlan and planRecurringTick from server.cpp
+// What a recurring tick does about the grid points that have gone by
+struct TickPlan {
+    int sends = 1;                                // cansends to run now
+    uint64_t missed = 0;                          // grid points that passed before the tick ran, its own included
+    uint64_t dropped = 0;                         // of those, the ones never sent
+    std::chrono::steady_clock::time_point next;   // grid point the next tick is scheduled for
+};
+
+// The tick for `deadline` running at `now` on a grid of `period`. Within `tolerance` it sends once and the next
+// tick is one period on. Later than that, every grid point up to now is missed and `policy` decides how many are
+// sent (DROP none, SKIP one, CATCH_UP up to `burst`); the next tick is the first grid point after now
+TickPlan planRecurringTick(std::chrono::steady_clock::time_point deadline, std::chrono::steady_clock::time_point now,
+                           std::chrono::milliseconds period, std::chrono::milliseconds tolerance,
+                           MissPolicy policy, int burst) {
+    TickPlan plan;
+    if (now - deadline <= tolerance) {
+        plan.next = deadline + period;
+        return plan;
+    }
+    auto overdue = (now - deadline) / period + 1;
+    switch (policy) {
+        case MissPolicy::DROP: plan.sends = 0; break;
+        case MissPolicy::SKIP: plan.sends = 1; break;
+        case MissPolicy::CATCH_UP: plan.sends = static_cast<int>(std::min<decltype(overdue)>(overdue, std::max(burst, 1))); break;
+    }
+    plan.missed = static_cast<uint64_t>(overdue);
+    plan.dropped = static_cast<uint64_t>(overdue - plan.sends);
+    plan.next = deadline + overdue * period;
+    return plan;
+}
+
+// Copy of the pause/park part of ScheduledTask from server.cpp
+struct ParkableTask {
+    std::atomic<bool> active{true};
+    std::atomic<bool> paused{false};
+    std::atomic<uint64_t> missed{0};
+    std::atomic<uint64_t> dropped{0};
+
+    bool parkIfPaused(std::chrono::steady_clock::time_point deadline) {
+        std::lock_guard<std::mutex> lock(parkMutex);
+        if (!paused) return false;
+        parked = true;
+        parkedDeadline = deadline;
+        return true;
+    }
+
+    void setPaused(bool value) {
+        std::function<void(std::chrono::steady_clock::time_point)> wake;
+        std::chrono::steady_clock::time_point deadline;
+        {
+            std::lock_guard<std::mutex> lock(parkMutex);
+            paused = value;
+            if (!value && parked) {
+                parked = false;
+                deadline = parkedDeadline;
+                wake = reschedule;
+            }
+        }
+        if (wake) wake(deadline);
+    }
+
+    void setReschedule(std::function<void(std::chrono::steady_clock::time_point)> fn) {
+        std::lock_guard<std::mutex> lock(parkMutex);
+        reschedule = std::move(fn);
+    }
+
+private:
+    std::mutex parkMutex;
+    bool parked = false;
+    std::chrono::steady_clock::time_point parkedDeadline;
+    std::function<void(std::chrono::steady_clock::time_point)> reschedule;
+};
+
+// Copy of dropMissedShot from server.cpp, retiring the task by clearing `active`
+bool dropMissedShot(ParkableTask& task, std::chrono::steady_clock::time_point deadline) {
+    if (!task.active || task.parkIfPaused(deadline)) return false;
+    task.missed++;
+    task.dropped++;
+    task.active = false;
+    return true;
+}
+
+// Log levels from server.cpp, and a logEvent that keeps quiet
+const int INFO = 10;
+const int WARNING = 20;
+const int ERROR = 30;
+const int DEBUG = 5;
+void logEvent(int, const std::string&) {}
+
+// Copy of trim, wallClockMs, missPolicyName and taskVersionCounter from server.cpp
+std::string trim(const std::string& str) {
+    size_t first = str.find_first_not_of(" \t\r\n\f\v");
+    if (first == std::string::npos) return "";
+    size_t last = str.find_last_not_of(" \t\r\n\f\v");
+    return str.substr(first, last - first + 1);
+}
+
+int64_t wallClockMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+const char* missPolicyName(MissPolicy policy) {
+    switch (policy) {
+        case MissPolicy::DROP: return "drop";
+        case MissPolicy::SKIP: return "skip";
+        case MissPolicy::CATCH_UP: return "catch_up";
+    }
+    return "skip";
+}
+
+std::atomic<uint64_t> taskVersionCounter{0};
+
+// Copy of DeadlineStats from server.cpp
+struct DeadlineStats {
+    std::atomic<uint64_t> missed{0};  // ticks that started later than the tolerance
+    std::atomic<uint64_t> dropped{0}; // ticks that were never sent because of the policy
+};
+
+// Copy of the parts of ScheduledTask from server.cpp that the copies below use
+struct ScheduledTask {
+    std::string id;
+    std::string command;               // "cansend <bus> <id>#<data>"
+    bool recurring = true;
+    int intervalMs = 0;                // interval for recurring tasks, delay for single-shots
+    int priority = 5;
+    MissPolicy policy = MissPolicy::SKIP;
+    int64_t dueMs = 0;                 // wall clock time a single-shot fires, so a restart doesn't reset the delay
+    std::atomic<bool> active{true};
+    std::atomic<bool> paused{false};
+    std::atomic<int64_t> leaseMs{0};    // how long to keep running without a client, 0 = stop on disconnect
+    std::atomic<int64_t> leaseUntil{0}; // wall clock ms when the lease runs out, 0 while a client owns the task
+    std::atomic<pid_t> pid{0};          // cansend child currently running for this task, 0 if none
+    std::atomic<uint64_t> version{++taskVersionCounter}; // counter value at the last state change
+    std::atomic<uint64_t> sends{0};     // successful sends
+    DeadlineStats stats;
+
+    void touch() {
+        version = ++taskVersionCounter;
+    }
+
+    std::string detail() const {
+        return detailText;
+    }
+
+    void setDetail(const std::string& text) {
+        detailText = text;
+    }
+
+    std::string error() const {
+        return errorText;
+    }
+
+    void setError(const std::string& text) {
+        errorText = text;
+        touch();
+    }
+
+    bool leaseExpired() const {
+        int64_t until = leaseUntil.load();
+        return until != 0 && wallClockMs() > until;
+    }
+
+    enum class SendSlot { NOW, QUEUED, FULL };
+
+    // Takes a send for the task. NOW: the caller spawns it. QUEUED: it waits for the sends ahead of it and
+    // nextSend() hands it out. FULL: `limit` sends are waiting already (cansend can't keep up), it isn't taken
+    SendSlot queueSend(std::function<void(bool)> done, std::size_t limit) {
+        std::lock_guard<std::mutex> lock(sendMutex);
+        if (!sending) {
+            sending = true;
+            return SendSlot::NOW;
+        }
+        if (pendingSends.size() >= limit) return SendSlot::FULL;
+        pendingSends.push_back(std::move(done));
+        return SendSlot::QUEUED;
+    }
+
+    // The running send finished: true with the next waiting one in `done`, false if there is none to start
+    // (nothing waits, or the task has stopped)
+    bool nextSend(std::function<void(bool)>& done) {
+        std::lock_guard<std::mutex> lock(sendMutex);
+        if (!active) pendingSends.clear();
+        if (pendingSends.empty()) {
+            sending = false;
+            return false;
+        }
+        done = std::move(pendingSends.front());
+        pendingSends.pop_front();
+        return true;
+    }
+
+    // Counts the send; the ring and event sink it also feeds in server.cpp aren't copied
+    void reportSend(bool ok) {
+        if (ok) ++sends;
+    }
+
+private:
+    std::string detailText;
+    std::string errorText;
+
+    std::mutex sendMutex;
+    bool sending = false;  // a cansend child of this task is running
+    std::deque<std::function<void(bool)>> pendingSends;
+};
+
+// Copy of taskDetailText from server.cpp
+std::string taskDetailText(const ScheduledTask& task) {
+    if (task.recurring) {
+        return task.command + " every " + std::to_string(task.intervalMs) + "ms priority " + std::to_string(task.priority) + " policy " + missPolicyName(task.policy);
+    }
+    return task.command + " once after " + std::to_string(task.intervalMs) + "ms priority " + std::to_string(task.priority) + " policy " + missPolicyName(task.policy);
+}
+
+// Copy of TaskJournal from server.cpp
+class TaskJournal {
+public:
+    bool open(const std::string& journalPath) {
+        std::lock_guard<std::mutex> lock(mtx);
+        path = journalPath;
+        out.open(path, std::ios::app);
+        return out.is_open();
+    }
+
+    // Record a leased task, or its new state
+    void put(const std::shared_ptr<ScheduledTask>& task) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!out.is_open()) return;
+        live[task->id] = task;
+        append(addRecord(*task));
+    }
+
+    void remove(const std::string& id) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!out.is_open() || !live.erase(id)) return;
+        append("DEL " + id);
+    }
+
+    void compact() {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (out.is_open()) compactLocked();
+    }
+
+    // Read what a previous run left behind. Returns the live tasks in the order they were first added
+    static std::vector<std::shared_ptr<ScheduledTask>> load(const std::string& journalPath) {
+        std::ifstream in(journalPath);
+        std::vector<std::string> order;
+        std::unordered_map<std::string, std::shared_ptr<ScheduledTask>> byId;
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream iss(line);
+            std::string kind, id;
+            iss >> kind >> id;
+            if (kind == "DEL") {
+                byId.erase(id);
+                continue;
+            }
+            if (kind != "ADD") continue;
+
+            auto task = std::make_shared<ScheduledTask>();
+            std::string type, policyStr;
+            int64_t leaseMs, leaseUntil;
+            int paused;
+            if (!(iss >> type >> task->intervalMs >> task->priority >> policyStr >> task->dueMs >> leaseMs >> leaseUntil >> paused)) {
+                logEvent(WARNING, "Skipping malformed journal record: " + line);
+                continue;
+            }
+            std::getline(iss, task->command);
+            task->command = trim(task->command);
+            if (task->command.empty()) {
+                logEvent(WARNING, "Skipping malformed journal record: " + line);
+                continue;
+            }
+            task->id = id;
+            task->recurring = type == "R";
+            task->policy = parseMissPolicy(policyStr).value_or(default_miss_policy);
+            task->leaseMs = leaseMs;
+            task->leaseUntil = leaseUntil;
+            task->paused = paused != 0;
+            task->setDetail(taskDetailText(*task));
+
+            if (!byId.count(id)) order.push_back(id);
+            byId[id] = task;
+        }
+
+        std::vector<std::shared_ptr<ScheduledTask>> tasks;
+        for (const auto& id : order) {
+            auto it = byId.find(id);
+            if (it != byId.end()) {
+                tasks.push_back(it->second);
+                byId.erase(it); // an ID re-added after a DEL shows up twice in order
+            }
+        }
+        return tasks;
+    }
+
+private:
+    static std::string addRecord(const ScheduledTask& task) {
+        return "ADD " + task.id + " " + (task.recurring ? "R" : "S") + " " + std::to_string(task.intervalMs) + " " +
+               std::to_string(task.priority) + " " + missPolicyName(task.policy) + " " + std::to_string(task.dueMs) + " " +
+               std::to_string(task.leaseMs.load()) + " " + std::to_string(task.leaseUntil.load()) + " " +
+               (task.paused ? "1" : "0") + " " + task.command;
+    }
+
+    void append(const std::string& record) {
+        out << record << '\n';
+        out.flush();
+        if (++records > live.size() * 4 + 64) {
+            compactLocked();
+        }
+    }
+
+    void compactLocked() {
+        std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream tmp(tmpPath, std::ios::trunc);
+            for (const auto& [id, task] : live) {
+                tmp << addRecord(*task) << '\n';
+            }
+            if (!tmp) {
+                logEvent(ERROR, "Failed to write compacted journal " + tmpPath);
+                return;
+            }
+        }
+        out.close();
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, path, ec);
+        if (ec) {
+            logEvent(ERROR, "Failed to replace journal " + path + ": " + ec.message());
+        }
+        out.open(path, std::ios::app);
+        records = live.size();
+        logEvent(DEBUG, "Compacted task journal to " + std::to_string(records) + " records");
+    }
+
+    std::mutex mtx;
+    std::string path;
+    std::ofstream out;
+    std::unordered_map<std::string, std::shared_ptr<ScheduledTask>> live;
+    std::size_t records = 0;
+};
+
+// Copy of taskStatusLine and taskRecord from server.cpp
+std::string taskStatusLine(const ScheduledTask& task) {
+    std::string error = task.error();
+    std::string status;
+    if (!task.active) {
+        status = error.empty() ? "stopped" : "stopped (error)";
+    } else if (task.paused) {
+        status = "paused";
+    } else {
+        status = "running";
+    }
+    std::string counts = " missed " + std::to_string(task.stats.missed.load()) +
+                         " dropped " + std::to_string(task.stats.dropped.load());
+    if (task.leaseMs > 0) {
+        counts += " lease " + std::to_string(task.leaseMs.load()) + "ms";
+    }
+    std::string line = task.id + ": " + task.detail() + counts + " (" + status + ")\n";
+    if (!task.active && !error.empty()) {
+        line += "  Error: " + error + "\n";
+    }
+    return line;
+}
+
+std::string taskRecord(const ScheduledTask& task) {
+    std::string error = task.error();
+    std::replace(error.begin(), error.end(), '\n', ' ');
+    const char* state = !task.active ? (error.empty() ? "stopped" : "error") : task.paused ? "paused" : "running";
+    std::string_view target(task.command);  // "cansend <bus> <id>#<data>"
+    target.remove_prefix(std::min(target.size(), target.find(' ') + 1));
+    std::string record = task.id + " " + std::to_string(task.version.load()) + " " + state +
+                         (task.recurring ? " recurring " : " once ") + std::to_string(task.intervalMs) + " " +
+                         std::to_string(task.priority) + " " + missPolicyName(task.policy) + " " + std::string(target) + " " +
+                         std::to_string(task.sends.load()) + " " + std::to_string(task.stats.missed.load()) + " " +
+                         std::to_string(task.stats.dropped.load()) + " " + std::to_string(task.leaseMs.load());
+    if (!error.empty()) {
+        record += " " + error;
+    }
+    return record + "\n";
+}
+
+// Copy of TaskHistory and TaskTombstones from server.cpp
+class TaskHistory {
+public:
+    struct Entry {
+        std::string id;
+        std::string line;    // LIST_TASKS line
+        std::string record;  // LIST_TASKS since= record
+        uint64_t version = 0;
+    };
+
+    explicit TaskHistory(std::size_t capacity) : entries(capacity) {}
+
+    // Returns the ID of the entry pushed out to make room, if any
+    std::string push(Entry entry) {
+        if (entries.empty()) return entry.id;
+        std::string evicted = std::move(entries[next].id);
+        entries[next] = std::move(entry);
+        next = (next + 1) % entries.size();
+        return evicted;
+    }
+
+    std::string push(const ScheduledTask& task) {
+        return push(Entry{task.id, taskStatusLine(task), taskRecord(task), task.version});
+    }
+
+    const Entry* find(const std::string& id) const {
+        for (const auto& entry : entries) {
+            if (!entry.id.empty() && entry.id == id) return &entry;
+        }
+        return nullptr;
+    }
+
+    bool remove(const std::string& id) {
+        for (auto& entry : entries) {
+            if (!entry.id.empty() && entry.id == id) {
+                entry = Entry{};
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void clear() {
+        std::fill(entries.begin(), entries.end(), Entry{});
+        next = 0;
+    }
+
+    // Oldest first
+    template <class F>
+    void forEach(F&& f) const {
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            const Entry& entry = entries[(next + i) % entries.size()];
+            if (!entry.id.empty()) f(entry);
+        }
+    }
+
+    std::string toString() const {
+        std::string out;
+        forEach([&out](const Entry& entry) { out += entry.line; });
+        return out;
+    }
+
+private:
+    std::vector<Entry> entries;
+    std::size_t next = 0;
+};
+
+class TaskTombstones {
+public:
+    explicit TaskTombstones(std::size_t capacity) : capacity(std::max<std::size_t>(capacity, 1)), floor(taskVersionCounter.load()) {}
+
+    void add(const std::string& id) {
+        if (entries.size() == capacity) {
+            floor = entries.front().first;
+            entries.pop_front();
+        }
+        entries.emplace_back(++taskVersionCounter, id);
+    }
+
+    bool covers(uint64_t since) const {
+        return since == 0 || since >= floor;
+    }
+
+    template <class F>
+    void forEachSince(uint64_t since, F&& f) const {
+        auto it = std::upper_bound(entries.begin(), entries.end(), since,
+                                   [](uint64_t version, const auto& entry) { return version < entry.first; });
+        for (; it != entries.end(); ++it) f(it->first, it->second);
+    }
+
+private:
+    std::size_t capacity;
+    uint64_t floor;  // removals at or before this version are forgotten
+    std::deque<std::pair<uint64_t, std::string>> entries;  // oldest first
+};
+
+// Stand-in for the sharded TaskRegistry in server.cpp: one map, same interface
+class TaskRegistry {
+public:
+    void add(const std::shared_ptr<ScheduledTask>& task) {
+        std::lock_guard<std::mutex> lock(mtx);
+        tasks[task->id] = task;
+    }
+
+    void remove(const std::string& id) {
+        std::lock_guard<std::mutex> lock(mtx);
+        tasks.erase(id);
+    }
+
+    std::shared_ptr<ScheduledTask> find(const std::string& id) {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = tasks.find(id);
+        return it == tasks.end() ? nullptr : it->second;
+    }
+
+private:
+    std::mutex mtx;
+    std::unordered_map<std::string, std::shared_ptr<ScheduledTask>> tasks;
+};
+
+TaskRegistry taskRegistry;
+TaskJournal taskJournal;  // never opened here, so put/remove do nothing
+
+// Copy of DetachedSession, pruneDetachedSessions and attachSession from server.cpp
+struct DetachedSession {
+    std::unordered_map<std::string, std::shared_ptr<ScheduledTask>> tasks;
+    TaskHistory history{0};
+    int64_t expiresMs = 0;
+};
+std::unordered_map<std::string, DetachedSession> detachedSessions;
+std::mutex sessionMutex;
+
+void pruneDetachedSessions() {
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    int64_t now = wallClockMs();
+    for (auto it = detachedSessions.begin(); it != detachedSessions.end();) {
+        if (it->second.expiresMs < now) {
+            logEvent(DEBUG, "Session " + it->first + " expired");
+            for (const auto& [id, task] : it->second.tasks) {
+                if (!task->active) {
+                    taskRegistry.remove(id);  // running ones go when their lease runs out
+                }
+            }
+            it = detachedSessions.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+std::optional<std::size_t> attachSession(const std::string& token,
+                                         std::unordered_map<std::string, std::shared_ptr<ScheduledTask>>& tasks,
+                                         TaskHistory& history, TaskTombstones& tombstones,
+                                         const std::function<void(const std::shared_ptr<ScheduledTask>&)>& adopt) {
+    pruneDetachedSessions();
+    DetachedSession session;
+    {
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        auto it = detachedSessions.find(token);
+        if (it == detachedSessions.end()) {
+            return std::nullopt;
+        }
+        session = std::move(it->second);
+        detachedSessions.erase(it);
+    }
+    session.history.forEach([&](const TaskHistory::Entry& entry) {
+        if (std::string evicted = history.push(entry); !evicted.empty()) tombstones.add(evicted);
+    });
+    for (auto& [id, task] : session.tasks) {
+        task->leaseUntil = 0;  // owned again
+        task->touch();
+        if (!task->active) {
+            if (std::string evicted = history.push(*task); !evicted.empty()) tombstones.add(evicted);
+            taskRegistry.remove(id);
+            continue;
+        }
+        adopt(task);
+        taskRegistry.add(task);  // back in case its lease ran out just now
+        if (task->leaseMs > 0) {
+            taskJournal.put(task);
+        }
+        tasks[id] = task;
+    }
+    return session.tasks.size();
+}
+
+// Stand-in for ThreadRegistry in server.cpp, which only lists threads
+struct ThreadRegistry {
+    void add(const std::thread::id&, const std::string&) {}
+};
+ThreadRegistry registry;
+
+int catch_up_burst = 5;
+extern char** environ;
+
+// Copy of ChildReaper, runCansendCommand and startCansend from server.cpp
+class ChildReaper {
+public:
+    using Callback = std::function<void(bool success, const std::string& errorMsg)>;
+
+    // Starts the reaper thread. Detached: the server never tears it down
+    void start() {
+        epfd = epoll_create1(EPOLL_CLOEXEC);
+        if (epfd == -1) {
+            logEvent(WARNING, "epoll_create1 failed, reaping children synchronously: " + std::string(strerror(errno)));
+            return;
+        }
+        std::thread([this] { run(); }).detach();
+    }
+
+    // Spawn the command's space-separated words as argv ("cansend <bus> <id>#<data>"), the first looked up in
+    // PATH. Returns the pid, or -1 with errorMsg set
+    static pid_t spawn(const std::string& command, std::string& errorMsg) {
+        std::vector<std::string> words;
+        std::string_view rest(command);
+        while (!rest.empty()) {
+            size_t start = rest.find_first_not_of(' ');
+            if (start == std::string_view::npos) break;
+            rest.remove_prefix(start);
+            size_t end = std::min(rest.find(' '), rest.size());
+            words.emplace_back(rest.substr(0, end));
+            rest.remove_prefix(end);
+        }
+        if (words.empty()) {
+            errorMsg = "empty command";
+            return -1;
+        }
+        std::vector<char*> argv;
+        for (auto& word : words) argv.push_back(word.data());
+        argv.push_back(nullptr);
+
+        pid_t pid;
+        int rc = posix_spawnp(&pid, argv[0], nullptr, nullptr, argv.data(), environ);
+        if (rc != 0) {
+            errorMsg = "posix_spawnp " + words[0] + " failed: " + std::string(strerror(rc));
+            return -1;
+        }
+        return pid;
+    }
+
+    // Run done(success, error) once the child exits
+    void watch(pid_t pid, Callback done) {
+        int pidfd = -1;
+#ifdef SYS_pidfd_open
+        if (epfd != -1) {
+            pidfd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+        }
+#endif
+        if (pidfd == -1) {
+            finish(pid, done);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            children[pidfd] = Child{pid, std::move(done)};
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = pidfd;
+        if (epoll_ctl(epfd, EPOLL_CTL_ADD, pidfd, &ev) == -1) {
+            Child child;
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                child = std::move(children[pidfd]);
+                children.erase(pidfd);
+            }
+            close(pidfd);
+            finish(child.pid, child.done);
+        }
+    }
+
+private:
+    struct Child {
+        pid_t pid = 0;
+        Callback done;
+    };
+
+    void run() {
+        registry.add(std::this_thread::get_id(), "child reaper");
+        std::array<epoll_event, 64> events;
+        for (;;) {
+            int n = epoll_wait(epfd, events.data(), static_cast<int>(events.size()), -1);
+            if (n == -1) {
+                if (errno == EINTR) continue;
+                logEvent(ERROR, "epoll_wait failed in child reaper: " + std::string(strerror(errno)));
+                return;
+            }
+            for (int i = 0; i < n; ++i) {
+                int pidfd = events[i].data.fd;
+                Child child;
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    auto it = children.find(pidfd);
+                    if (it == children.end()) continue;
+                    child = std::move(it->second);
+                    children.erase(it);
+                }
+                epoll_ctl(epfd, EPOLL_CTL_DEL, pidfd, nullptr);
+                close(pidfd);
+                finish(child.pid, child.done);
+            }
+        }
+    }
+
+    // The child has exited (or we're on the fallback path), so waitpid returns right away
+    static void finish(pid_t pid, const Callback& done) {
+        int status;
+        pid_t result = waitpid(pid, &status, 0);
+        bool success = true;
+        std::string errorMsg;
+
+        if (result > 0) {
+            if (WIFEXITED(status) && WEXITSTATUS(status) != 0) {
+                success = false;
+                errorMsg = "cansend failed with exit code " + std::to_string(WEXITSTATUS(status));
+            } else if (WIFSIGNALED(status)) {
+                success = false;
+                errorMsg = "cansend terminated by signal " + std::to_string(WTERMSIG(status));
+            }
+        } else {
+            success = false;
+            errorMsg = "waitpid failed: " + std::string(strerror(errno));
+        }
+
+        try {
+            done(success, errorMsg);
+        } catch (...) {
+            logEvent(ERROR, "Unhandled exception in cansend completion for PID " + std::to_string(pid));
+        }
+    }
+
+    int epfd = -1;
+    std::mutex mtx;
+    std::unordered_map<int, Child> children;  // pidfd -> child
+};
+
+ChildReaper childReaper;
+
+void startCansend(const std::shared_ptr<ScheduledTask>& task, std::function<void(bool)> done);
+
+// Spawn the task's cansend and return straight away. On failure the task is stopped with the error recorded;
+// either way done(success) runs once the child has exited (on the reaper thread) or right here if spawn failed.
+// A task's sends go one at a time: while its previous child still runs, this one waits behind it, so the frames
+// of a CATCH_UP burst reach the bus in order. Up to catch_up_burst wait; a send past that is dropped like a
+// missed tick, and its done never runs (only recurring tasks send more than once)
+void runCansendCommand(const std::shared_ptr<ScheduledTask>& task, std::function<void(bool)> done = nullptr) {
+    switch (task->queueSend(done, static_cast<std::size_t>(std::max(catch_up_burst, 1)))) {
+        case ScheduledTask::SendSlot::NOW:
+            startCansend(task, std::move(done));
+            break;
+        case ScheduledTask::SendSlot::QUEUED:
+            break;
+        case ScheduledTask::SendSlot::FULL:
+            task->stats.missed++;
+            task->stats.dropped++;
+            logEvent(DEBUG, "Task " + task->id + " dropped a send, its previous cansend is still running");
+            break;
+    }
+}
+
+void startCansend(const std::shared_ptr<ScheduledTask>& task, std::function<void(bool)> done) {
+    auto complete = [task, done](bool success, const std::string& errorMsg) {
+        task->reportSend(success);
+        if (!success) {
+            task->setError(errorMsg);
+            task->active = false;
+            logEvent(ERROR, "Task " + task->id + " stopped: " + errorMsg);
+        }
+        if (done) done(success);
+        // Sends queued behind this one are dropped once the task has stopped
+        std::function<void(bool)> next;
+        if (task->nextSend(next)) {
+            startCansend(task, std::move(next));
+        }
+    };
+
+    std::string errorMsg;
+    pid_t pid = ChildReaper::spawn(task->command, errorMsg);
+    if (pid == -1) {
+        complete(false, errorMsg);
+        return;
+    }
+
+    task->pid = pid;
+    childReaper.watch(pid, [task, pid, complete](bool success, const std::string& errorMsg) {
+        pid_t expected = pid;
+        task->pid.compare_exchange_strong(expected, 0);  // a later send may have replaced it
+        complete(success, errorMsg);
+    });
+}
+
 // Test functions
 void testValidCansend() {
     std::string command, canIdData, canBus, errorMsg;
@@ -188,10 +1141,580 @@ void testEdgeCases() {
     std::cout << "testEdgeCases passed\n";
 }
 
+void testMissPolicy() {
+    assert(parseMissPolicy("drop") == MissPolicy::DROP);
+    assert(parseMissPolicy("SKIP") == MissPolicy::SKIP);
+    assert(parseMissPolicy("catch_up") == MissPolicy::CATCH_UP);
+    assert(parseMissPolicy("CatchUp") == MissPolicy::CATCH_UP);
+    assert(!parseMissPolicy("later").has_value());
+    assert(!parseMissPolicy("").has_value());
+
+    // Policy is the 6th field, the first five still parse as before
+    std::string command, canIdData, canBus, errorMsg;
+    int intervalMs, priority;
+    assert(parseCansendPayload("123#deadbeef#10#vcan0#7#catch_up", 5, command, canIdData, canBus, intervalMs, priority, errorMsg));
+    assert(intervalMs == 10);
+    assert(priority == 7);
+
+    // An empty policy field takes the default; a name that isn't a policy is refused, not defaulted
+    assert(parseCansendPayload("123#deadbeef#10#vcan0#7#", 5, command, canIdData, canBus, intervalMs, priority, errorMsg));
+    assert(!parseCansendPayload("123#deadbeef#10#vcan0#7#later", 5, command, canIdData, canBus, intervalMs, priority, errorMsg));
+    assert(errorMsg == "ERROR: Unknown miss policy 'later'. Use drop, skip or catch_up\n");
+
+    std::cout << "testMissPolicy passed\n";
+}
+
+void testPausedShotMiss() {
+    // Paused while still queued, then found late by the worker: parked, not dropped
+    ParkableTask task;
+    std::optional<std::chrono::steady_clock::time_point> rescheduledAt;
+    task.setReschedule([&](std::chrono::steady_clock::time_point deadline) { rescheduledAt = deadline; });
+    auto deadline = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+    task.setPaused(true);
+    assert(!dropMissedShot(task, deadline));
+    assert(task.active);
+    assert(task.missed == 0 && task.dropped == 0);
+    assert(!rescheduledAt);
+
+    // RESUME hands back the deadline it parked at
+    task.setPaused(false);
+    assert(rescheduledAt == deadline);
+
+    // Late and not paused: dropped
+    assert(dropMissedShot(task, deadline));
+    assert(!task.active);
+    assert(task.missed == 1 && task.dropped == 1);
+    assert(!dropMissedShot(task, deadline));  // already gone
+    assert(task.dropped == 1);
+
+    std::cout << "testPausedShotMiss passed\n";
+}
+
+void testCommandDispatch() {
+    assert(matchCommand("KILL_ALL_TASKS\n") == Command::KILL_ALL_TASKS);
+    assert(matchCommand("KILL_ALL\n") == Command::KILL_ALL);
+    assert(matchCommand("KILL_TASK task_1\n") == Command::KILL_TASK);
+    assert(matchCommand("CANSEND#123#beef#10#vcan0\n") == Command::CANSEND);
+    assert(matchCommand("LIST_TASKS\n") == Command::LIST_TASKS);
+    assert(matchCommand("SHM_RING\n") == Command::SHM_RING);
+    assert(matchCommand("SUBSCRIBE\n") == Command::SUBSCRIBE);
+    assert(matchCommand("PING") == Command::PING);
+    assert(!matchCommand("UNKNOWN_COMMAND\n").has_value());
+    assert(!matchCommand("").has_value());
+
+    // Views point into the payload, trailing separator adds no field
+    std::string payload = "0x1A#beef#25ms#vcan0#";
+    CansendRequest request;
+    std::string errorMsg;
+    assert(parseCansendPayload(std::string_view(payload), 5, request, errorMsg));
+    assert(request.canId == "1A");
+    assert(request.canId.data() == payload.data() + 2);
+    assert(request.intervalMs == 25);
+    assert(request.priority == 5);
+
+    std::cout << "testCommandDispatch passed\n";
+}
+
+void testTaggedRequests() {
+    std::string_view tag;
+    std::string_view command;
+    assert(parseTaggedRequest("@42 LIST_TASKS", tag, command));
+    assert(tag == "42" && command == "LIST_TASKS");
+    assert(parseTaggedRequest("@7 PAUSE task_3\r", tag, command));
+    assert(command == "PAUSE task_3");
+    assert(matchCommand(command) == Command::PAUSE);
+    assert(!parseTaggedRequest("LIST_TASKS", tag, command));
+    assert(!parseTaggedRequest("@ LIST_TASKS", tag, command));
+    assert(!parseTaggedRequest("@x1 LIST_TASKS", tag, command));
+    assert(!parseTaggedRequest("@123456789012345678901 LIST_TASKS", tag, command));
+
+    // Length covers the whole reply, newlines included; an empty reply still gets a frame
+    assert(frameTaggedReply("5", "Paused task_0\n") == "@5 14\nPaused task_0\n");
+    assert(frameTaggedReply("9", "") == "@9 0\n");
+
+    std::cout << "testTaggedRequests passed\n";
+}
+
+void testListTasksQuery() {
+    ListTasksQuery query;
+    assert(parseListTasksQuery("since=0", query));
+    assert(query.since == 0 && query.limit == 0);
+    assert(parseListTasksQuery("limit=500  since=1234", query));
+    assert(query.since == 1234 && query.limit == 500);
+    assert(matchCommand("LIST_TASKS since=7 limit=2") == Command::LIST_TASKS);
+
+    ListTasksQuery rejected;
+    assert(!parseListTasksQuery("limit=5", rejected));           // since= is required
+    assert(!parseListTasksQuery("since=", rejected));
+    assert(!parseListTasksQuery("since=12x", rejected));
+    assert(!parseListTasksQuery("since=-1", rejected));
+    assert(!parseListTasksQuery("since=1 offset=3", rejected));
+    assert(!parseListTasksQuery("since=1 limit=4294967296", rejected));
+    assert(!parseListTasksQuery("since", rejected));
+
+    std::cout << "testListTasksQuery passed\n";
+}
+
+void testShmRing() {
+    // A 4-slot ring in ordinary memory, laid out as the server maps it
+    constexpr uint32_t capacity = 4;
+    std::vector<uint64_t> memory((shm_ring::mappedSize(capacity) + 7) / 8);
+    auto* header = new (memory.data()) shm_ring::Header{shm_ring::MAGIC, shm_ring::VERSION, capacity,
+                                                         sizeof(shm_ring::SendReport), {0}, {0}, {0}};
+    size_t size = shm_ring::mappedSize(capacity);
+    assert(shm_ring::valid(header, size));
+
+    // Wraps around: ten reports through four slots, read back in order
+    shm_ring::SendReport report{};
+    for (uint64_t n = 0; n < 10; ++n) {
+        report.taskNumber = n;
+        assert(shm_ring::push(header, report));
+        shm_ring::SendReport out{};
+        assert(shm_ring::pop(header, out));
+        assert(out.taskNumber == n);
+    }
+    assert(!shm_ring::pop(header, report));
+    assert(header->head == 10 && header->tail == 10);
+
+    // Full: the producer drops and counts instead of waiting, and the oldest reports survive
+    for (uint64_t n = 100; n < 100 + capacity; ++n) {
+        report.taskNumber = n;
+        assert(shm_ring::push(header, report));
+    }
+    report.taskNumber = 200;
+    assert(!shm_ring::push(header, report));
+    assert(!shm_ring::push(header, report));
+    assert(header->overruns == 2);
+    shm_ring::SendReport out{};
+    assert(shm_ring::pop(header, out) && out.taskNumber == 100);
+    assert(shm_ring::push(header, report));  // room again after one read
+    assert(header->overruns == 2);
+    for (uint64_t n : {101, 102, 103, 200}) {
+        assert(shm_ring::pop(header, out) && out.taskNumber == n);
+    }
+    assert(!shm_ring::pop(header, out));
+
+    // valid() refuses anything the server didn't lay out this way
+    auto rejects = [&](auto change, size_t mapped) {
+        shm_ring::Header saved{header->magic, header->version, header->capacity, header->slotSize, {0}, {0}, {0}};
+        change(*header);
+        bool ok = shm_ring::valid(header, mapped);
+        header->magic = saved.magic;
+        header->version = saved.version;
+        header->capacity = saved.capacity;
+        header->slotSize = saved.slotSize;
+        return !ok;
+    };
+    auto unchanged = [](shm_ring::Header&) {};
+    assert(rejects([](shm_ring::Header& h) { h.magic = 0x52414e43; }, size));
+    assert(rejects([](shm_ring::Header& h) { h.version = shm_ring::VERSION + 1; }, size));
+    assert(rejects([](shm_ring::Header& h) { h.slotSize = sizeof(shm_ring::SendReport) + 8; }, size));
+    assert(rejects([](shm_ring::Header& h) { h.capacity = 3; }, size));
+    assert(rejects([](shm_ring::Header& h) { h.capacity = 0; }, size));
+    assert(rejects([](shm_ring::Header& h) { h.capacity = 8; }, size));  // more slots than were mapped
+    assert(rejects(unchanged, size - 1));
+    assert(rejects(unchanged, sizeof(shm_ring::Header) - 1));
+    assert(!rejects(unchanged, size));
+
+    header->~Header();
+    std::cout << "testShmRing passed\n";
+}
+
+void testTaskJournal() {
+    namespace fs = std::filesystem;
+    std::string path = (fs::temp_directory_path() / ("test_server_" + std::to_string(getpid()) + ".journal")).string();
+    fs::remove(path);
+    auto makeTask = [](const std::string& id, bool recurring, int intervalMs, int64_t leaseMs) {
+        auto task = std::make_shared<ScheduledTask>();
+        task->id = id;
+        task->command = "cansend vcan0 123#beef";
+        task->recurring = recurring;
+        task->intervalMs = intervalMs;
+        task->leaseMs = leaseMs;
+        return task;
+    };
+    auto lines = [&path] {
+        std::ifstream in(path);
+        size_t count = 0;
+        for (std::string line; std::getline(in, line);) ++count;
+        return count;
+    };
+
+    {
+        TaskJournal journal;
+        assert(journal.open(path));
+        auto ticker = makeTask("task_1", true, 100, 60000);
+        ticker->policy = MissPolicy::CATCH_UP;
+        auto shot = makeTask("task_2", false, 500, 1000);
+        shot->dueMs = 1700000000000;
+        journal.put(ticker);
+        journal.put(shot);
+        ticker->paused = true;
+        ticker->leaseUntil = 1700000005000;
+        journal.put(ticker);                 // new state, same task
+        journal.remove("task_2");
+        journal.remove("task_2");            // already gone: no second DEL
+        journal.remove("task_9");            // never journaled: nothing written
+        journal.put(makeTask("task_3", true, 20, 5000));
+        assert(lines() == 5);
+    }
+
+    // Last record wins, DEL forgets, order is first add
+    auto loaded = TaskJournal::load(path);
+    assert(loaded.size() == 2);
+    assert(loaded[0]->id == "task_1" && loaded[1]->id == "task_3");
+    const ScheduledTask& ticker = *loaded[0];
+    assert(ticker.recurring && ticker.intervalMs == 100 && ticker.priority == 5);
+    assert(ticker.policy == MissPolicy::CATCH_UP);
+    assert(ticker.paused && ticker.leaseMs == 60000 && ticker.leaseUntil == 1700000005000);
+    assert(ticker.command == "cansend vcan0 123#beef");
+    assert(ticker.detail() == "cansend vcan0 123#beef every 100ms priority 5 policy catch_up");
+
+    {
+        // A torn last line, a malformed one and a re-add after DEL
+        std::ofstream out(path, std::ios::app);
+        out << "ADD task_4 R 10 5 skip 0 100 0 0 cansend vcan0 1#01\n";
+        out << "DEL task_4\n";
+        out << "ADD task_4 S 10 5 skip 0 100 0 0 cansend vcan0 1#02\n";
+        out << "ADD task_5 R ten 5 skip 0 100 0 0 cansend vcan0 1#03\n";
+        out << "ADD task_6 R 10 5 skip 0 100 0";
+    }
+    loaded = TaskJournal::load(path);
+    assert(loaded.size() == 3);
+    assert(loaded[2]->id == "task_4" && !loaded[2]->recurring && loaded[2]->command == "cansend vcan0 1#02");
+
+    // Compaction rewrites the live set once the file holds about four records per live task (plus slack)
+    fs::remove(path);
+    {
+        TaskJournal journal;
+        assert(journal.open(path));
+        auto busy = makeTask("task_7", true, 10, 1000);
+        journal.put(makeTask("task_8", true, 10, 1000));
+        for (int i = 0; i < 100; ++i) {
+            busy->priority = i % 10;
+            journal.put(busy);
+        }
+        assert(lines() < 100);
+        journal.compact();
+        assert(lines() == 2);
+        assert(!fs::exists(path + ".tmp"));
+        journal.remove("task_8");
+        assert(lines() == 3);
+    }
+    loaded = TaskJournal::load(path);
+    assert(loaded.size() == 1 && loaded[0]->id == "task_7" && loaded[0]->priority == 9);
+    assert(TaskJournal::load(path + ".missing").empty());
+
+    fs::remove(path);
+    std::cout << "testTaskJournal passed\n";
+}
+
+void testSessionAttach() {
+    auto makeTask = [](const std::string& id) {
+        auto task = std::make_shared<ScheduledTask>();
+        task->id = id;
+        task->command = "cansend vcan0 123#beef";
+        task->setDetail(taskDetailText(*task));
+        taskRegistry.add(task);
+        return task;
+    };
+    std::unordered_map<std::string, std::shared_ptr<ScheduledTask>> tasks;
+    TaskHistory history(8);
+    TaskTombstones tombstones(8);
+    std::vector<std::string> adopted;
+    auto adopt = [&adopted](const std::shared_ptr<ScheduledTask>& task) { adopted.push_back(task->id); };
+
+    // Unknown token: nothing moves
+    assert(!attachSession("no-such-token", tasks, history, tombstones, adopt));
+    assert(tasks.empty() && adopted.empty());
+
+    // Grace ran out: pruning forgets the session and unregisters its stopped tasks; running ones stay
+    // registered until their lease retires them
+    auto stale = makeTask("task_10");
+    stale->active = false;
+    auto leased = makeTask("task_11");
+    leased->leaseUntil = wallClockMs() + 60000;
+    {
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        detachedSessions["expired"] = DetachedSession{{{stale->id, stale}, {leased->id, leased}}, TaskHistory(0), wallClockMs() - 1};
+    }
+    pruneDetachedSessions();
+    assert(!detachedSessions.count("expired"));
+    assert(!taskRegistry.find("task_10") && taskRegistry.find("task_11") == leased);
+    assert(!attachSession("expired", tasks, history, tombstones, adopt));
+    assert(tasks.empty() && adopted.empty());
+
+    // Reattach in time: the running task is owned again; one whose lease ran out and retired while detached
+    // lands in the history after the session's own entries; one whose lease ran out but hadn't been retired yet
+    // is owned again before its wakeup gets to it
+    auto running = makeTask("task_20");
+    running->leaseUntil = wallClockMs() + 60000;
+    auto ranOut = makeTask("task_21");
+    ranOut->leaseUntil = wallClockMs() - 10;
+    ranOut->active = false;
+    taskRegistry.remove("task_21");  // retireTask drops an unowned task from the registry
+    auto justNow = makeTask("task_22");
+    justNow->leaseUntil = wallClockMs() - 1;
+    taskRegistry.remove("task_22");
+    TaskHistory sessionHistory(4);
+    sessionHistory.push(TaskHistory::Entry{"task_19", "task_19: done\n", "task_19 1 stopped\n", 1});
+    {
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        detachedSessions["live"] = DetachedSession{{{running->id, running}, {ranOut->id, ranOut}, {justNow->id, justNow}},
+                                                   sessionHistory, wallClockMs() + 60000};
+    }
+    uint64_t before = taskVersionCounter;
+    auto count = attachSession("live", tasks, history, tombstones, adopt);
+    assert(count && *count == 3);
+    assert(!detachedSessions.count("live"));
+    assert(tasks.size() == 2 && tasks.count("task_20") && tasks.count("task_22"));
+    std::sort(adopted.begin(), adopted.end());
+    assert((adopted == std::vector<std::string>{"task_20", "task_22"}));
+    assert(running->leaseUntil == 0 && justNow->leaseUntil == 0 && !justNow->leaseExpired());
+    assert(taskRegistry.find("task_20") && taskRegistry.find("task_22") && !taskRegistry.find("task_21"));
+    assert(ranOut->leaseUntil == 0 && ranOut->version > before);
+    std::vector<std::string> listed;
+    history.forEach([&listed](const TaskHistory::Entry& entry) { listed.push_back(entry.id); });
+    assert((listed == std::vector<std::string>{"task_19", "task_21"}));
+    assert(history.find("task_21")->line == "task_21: cansend vcan0 123#beef every 0ms priority 5 policy skip missed 0 dropped 0 (stopped)\n");
+
+    // A session is taken once
+    assert(!attachSession("live", tasks, history, tombstones, adopt));
+
+    std::cout << "testSessionAttach passed\n";
+}
+
+void testTaskHistory() {
+    auto entry = [](const std::string& id) { return TaskHistory::Entry{id, id + "\n", id + " record\n", ++taskVersionCounter}; };
+    auto ids = [](const TaskHistory& history) {
+        std::vector<std::string> out;
+        history.forEach([&out](const TaskHistory::Entry& e) { out.push_back(e.id); });
+        return out;
+    };
+
+    // At capacity the oldest entry goes first, and push() says which one it was
+    TaskHistory history(3);
+    assert(history.push(entry("a")).empty());
+    assert(history.push(entry("b")).empty());
+    assert(history.push(entry("c")).empty());
+    assert((ids(history) == std::vector<std::string>{"a", "b", "c"}));
+    assert(history.push(entry("d")) == "a");
+    assert((ids(history) == std::vector<std::string>{"b", "c", "d"}));
+    assert(history.toString() == "b\nc\nd\n");
+
+    // A removed entry leaves a hole: the next push still overwrites the oldest slot, and the hole is
+    // filled once the ring comes round to it, evicting nothing
+    assert(history.remove("c") && !history.remove("c") && !history.find("c"));
+    assert(history.push(entry("e")) == "b");
+    assert((ids(history) == std::vector<std::string>{"d", "e"}));
+    assert(history.push(entry("f")).empty());
+    assert((ids(history) == std::vector<std::string>{"d", "e", "f"}));
+    assert(history.push(entry("g")) == "d");
+
+    // With no room at all the entry itself is what gets dropped
+    TaskHistory none(0);
+    assert(none.push(entry("h")) == "h" && ids(none).empty());
+
+    // Tombstones keep the newest `capacity` removals in version order; asking from before the oldest kept one
+    // (or from before the tombstones existed) means the client has to list again from 0
+    uint64_t created = taskVersionCounter;
+    TaskTombstones tombstones(2);
+    assert(tombstones.covers(0) && tombstones.covers(created) && !tombstones.covers(created - 1));
+    tombstones.add("x");
+    uint64_t xVersion = taskVersionCounter;
+    tombstones.add("y");
+    uint64_t yVersion = taskVersionCounter;
+    tombstones.add("z");
+    assert(!tombstones.covers(created) && !tombstones.covers(xVersion - 1));
+    assert(tombstones.covers(xVersion) && tombstones.covers(yVersion));
+    std::vector<std::string> removed;
+    tombstones.forEachSince(created, [&removed](uint64_t, const std::string& id) { removed.push_back(id); });
+    assert((removed == std::vector<std::string>{"y", "z"}));
+    removed.clear();
+    tombstones.forEachSince(yVersion, [&removed, yVersion](uint64_t version, const std::string& id) {
+        assert(version > yVersion);
+        removed.push_back(id);
+    });
+    assert((removed == std::vector<std::string>{"z"}));
+
+    // An entry pushed out of a full history becomes a tombstone, so LIST_TASKS since= reports it removed
+    std::unordered_map<std::string, std::shared_ptr<ScheduledTask>> tasks;
+    TaskHistory full(2);
+    full.push(entry("task_30"));
+    full.push(entry("task_31"));
+    TaskTombstones gone(8);
+    uint64_t since = taskVersionCounter;
+    TaskHistory sessionHistory(2);
+    sessionHistory.push(entry("task_32"));
+    auto stopped = std::make_shared<ScheduledTask>();
+    stopped->id = "task_33";
+    stopped->active = false;
+    stopped->leaseUntil = wallClockMs() - 1;
+    {
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        detachedSessions["evicting"] = DetachedSession{{{stopped->id, stopped}}, sessionHistory, wallClockMs() + 60000};
+    }
+    assert(attachSession("evicting", tasks, full, gone, [](const std::shared_ptr<ScheduledTask>&) {}));
+    assert((ids(full) == std::vector<std::string>{"task_32", "task_33"}));
+    removed.clear();
+    gone.forEachSince(since, [&removed](uint64_t, const std::string& id) { removed.push_back(id); });
+    assert((removed == std::vector<std::string>{"task_30", "task_31"}));
+
+    std::cout << "testTaskHistory passed\n";
+}
+
+void testCansendQueue() {
+    using namespace std::chrono_literals;
+    // One child runs at a time, up to `limit` wait behind it; nextSend hands them out in order
+    {
+        ScheduledTask task;
+        std::vector<int> order;
+        assert(task.queueSend([&order](bool) { order.push_back(0); }, 2) == ScheduledTask::SendSlot::NOW);
+        assert(task.queueSend([&order](bool) { order.push_back(1); }, 2) == ScheduledTask::SendSlot::QUEUED);
+        assert(task.queueSend([&order](bool) { order.push_back(2); }, 2) == ScheduledTask::SendSlot::QUEUED);
+        assert(task.queueSend([&order](bool) { order.push_back(3); }, 2) == ScheduledTask::SendSlot::FULL);
+        std::function<void(bool)> next;
+        assert(task.nextSend(next));
+        next(true);
+        assert(task.queueSend(nullptr, 2) == ScheduledTask::SendSlot::QUEUED);  // room again behind the running one
+        assert(task.nextSend(next));
+        next(true);
+        assert(task.nextSend(next) && !next);
+        assert(!task.nextSend(next));
+        assert((order == std::vector<int>{1, 2}));
+        assert(task.queueSend(nullptr, 2) == ScheduledTask::SendSlot::NOW);  // idle again
+
+        // A task that stopped drops what is still waiting
+        assert(task.queueSend([&order](bool) { order.push_back(4); }, 2) == ScheduledTask::SendSlot::QUEUED);
+        task.active = false;
+        assert(!task.nextSend(next));
+        assert(task.queueSend(nullptr, 2) == ScheduledTask::SendSlot::NOW);
+        assert((order == std::vector<int>{1, 2}));
+    }
+
+    // The same through real children. The script takes a lock directory for as long as it runs and fails if it
+    // can't, so two children of one task running at once would stop the task
+    namespace fs = std::filesystem;
+    fs::path dir = fs::temp_directory_path() / ("test_server_" + std::to_string(getpid()));
+    fs::create_directories(dir);
+    fs::path script = dir / "send.sh";
+    std::ofstream(script) << "mkdir " << (dir / "lock").string() << " || exit 3\nsleep 0.1\nrmdir " << (dir / "lock").string() << "\nexit $1\n";
+    childReaper.start();
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<bool> results;
+    auto record = [&](bool success) {
+        std::lock_guard<std::mutex> lock(mtx);
+        results.push_back(success);
+        cv.notify_all();
+    };
+    auto waitFor = [&](size_t count) {
+        std::unique_lock<std::mutex> lock(mtx);
+        return cv.wait_for(lock, 5s, [&] { return results.size() >= count; });
+    };
+
+    catch_up_burst = 2;
+    auto task = std::make_shared<ScheduledTask>();
+    task->id = "task_40";
+    task->command = "sh " + script.string() + " 0";
+    for (int i = 0; i < 4; ++i) {
+        runCansendCommand(task, record);
+    }
+    assert(task->pid > 0);
+    // A FULL slot is a missed and dropped tick whose completion never runs
+    assert(task->stats.missed == 1 && task->stats.dropped == 1);
+    assert(waitFor(3));
+    std::this_thread::sleep_for(200ms);
+    assert((results == std::vector<bool>{true, true, true}));
+    assert(task->active && task->sends == 3 && task->error().empty());
+
+    // A failed send stops the task; the sends queued behind it never start and their completions never run
+    results.clear();
+    auto failing = std::make_shared<ScheduledTask>();
+    failing->id = "task_41";
+    failing->command = "sh " + script.string() + " 1";
+    for (int i = 0; i < 3; ++i) {
+        runCansendCommand(failing, record);
+    }
+    assert(waitFor(1));
+    std::this_thread::sleep_for(300ms);
+    assert((results == std::vector<bool>{false}));
+    assert(!failing->active && failing->sends == 0);
+    assert(failing->error() == "cansend failed with exit code 1");
+    assert(failing->stats.dropped == 0);
+    assert(!fs::exists(dir / "lock"));
+    assert(failing->queueSend(nullptr, 2) == ScheduledTask::SendSlot::NOW);  // nothing left waiting
+
+    // A command that can't be spawned completes right away, on the caller
+    results.clear();
+    auto missing = std::make_shared<ScheduledTask>();
+    missing->id = "task_42";
+    missing->command = "no-such-cansend-binary vcan0 123#beef";
+    runCansendCommand(missing, record);
+    assert((results == std::vector<bool>{false}));
+    assert(!missing->active && missing->error().starts_with("posix_spawnp no-such-cansend-binary failed"));
+
+    catch_up_burst = 5;
+    fs::remove_all(dir);
+    std::cout << "testCansendQueue passed\n";
+}
+
+void testRecurringTickPlan() {
+    using namespace std::chrono_literals;
+    auto deadline = std::chrono::steady_clock::time_point{} + 1000s;
+    auto period = 10ms;
+    auto tolerance = 2ms;
+
+    // On time, or late within the tolerance: one send, next tick one period on
+    for (auto late : {0ms, 2ms}) {
+        for (auto policy : {MissPolicy::DROP, MissPolicy::SKIP, MissPolicy::CATCH_UP}) {
+            TickPlan plan = planRecurringTick(deadline, deadline + late, period, tolerance, policy, 5);
+            assert(plan.sends == 1 && plan.missed == 0 && plan.dropped == 0);
+            assert(plan.next == deadline + period);
+        }
+    }
+
+    // 3ms late: only its own grid point went by
+    TickPlan plan = planRecurringTick(deadline, deadline + 3ms, period, tolerance, MissPolicy::SKIP, 5);
+    assert(plan.sends == 1 && plan.missed == 1 && plan.dropped == 0 && plan.next == deadline + 10ms);
+    plan = planRecurringTick(deadline, deadline + 3ms, period, tolerance, MissPolicy::DROP, 5);
+    assert(plan.sends == 0 && plan.missed == 1 && plan.dropped == 1 && plan.next == deadline + 10ms);
+
+    // 35ms late: four grid points (0, 10, 20, 30) went by, next is the first one after now
+    plan = planRecurringTick(deadline, deadline + 35ms, period, tolerance, MissPolicy::DROP, 5);
+    assert(plan.sends == 0 && plan.missed == 4 && plan.dropped == 4 && plan.next == deadline + 40ms);
+    plan = planRecurringTick(deadline, deadline + 35ms, period, tolerance, MissPolicy::SKIP, 5);
+    assert(plan.sends == 1 && plan.missed == 4 && plan.dropped == 3 && plan.next == deadline + 40ms);
+    plan = planRecurringTick(deadline, deadline + 35ms, period, tolerance, MissPolicy::CATCH_UP, 5);
+    assert(plan.sends == 4 && plan.missed == 4 && plan.dropped == 0 && plan.next == deadline + 40ms);
+
+    // CATCH_UP sends at most a burst and drops the rest
+    plan = planRecurringTick(deadline, deadline + 95ms, period, tolerance, MissPolicy::CATCH_UP, 3);
+    assert(plan.sends == 3 && plan.missed == 10 && plan.dropped == 7 && plan.next == deadline + 100ms);
+
+    // Exactly on a later grid point: that one counts as missed too, and next is the one after it
+    plan = planRecurringTick(deadline, deadline + 20ms, period, tolerance, MissPolicy::SKIP, 5);
+    assert(plan.missed == 3 && plan.next == deadline + 30ms);
+
+    std::cout << "testRecurringTickPlan passed\n";
+}
+
 int main() {
     testValidCansend();
     testInvalidCansend();
     testEdgeCases();
+    testMissPolicy();
+    testPausedShotMiss();
+    testRecurringTickPlan();
+    testCommandDispatch();
+    testTaggedRequests();
+    testListTasksQuery();
+    testShmRing();
+    testTaskJournal();
+    testSessionAttach();
+    testTaskHistory();
+    testCansendQueue();
     std::cout << "All tests passed!\n";
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,362 @@
+#include "DbcCodec.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+DbcCodec::Signal compile(const canSignal& sig, int frameLength)
+{
+    DbcCodec::Signal s;
+    s.length = std::clamp(sig.length, 0, 64);
+    s.isSigned = sig.isSigned;
+    s.bigEndian = !sig.littleEndian;
+    s.mask = s.length == 64 ? ~0ULL : (1ULL << s.length) - 1;
+    s.factor = sig.factor;
+    s.offset = sig.offset;
+    s.min = sig.min;
+    s.max = sig.max;
+    s.rawLimit = std::ldexp(1.0, s.isSigned ? s.length - 1 : s.length);
+    if (s.length == 0 || sig.startBit < 0) {
+        return s;
+    }
+
+    // Word: Intel bits run up from the start bit of the little-endian word; Motorola bits run down from the MSB
+    // in the big-endian one (the byte-swapped word), where bit 8 * (7 - byte) + bit stands for DBC bit byte * 8 + bit
+    if (sig.startBit < 64) {
+        if (s.bigEndian) {
+            int msb = 63 - DbcCodec::motorolaLinear(sig.startBit);
+            s.shift = msb - s.length + 1;
+        } else {
+            s.shift = sig.startBit;
+        }
+        uint64_t bits = s.shift >= 0 ? s.mask << s.shift : s.mask >> -s.shift;
+        s.wordMask = s.bigEndian ? DbcCodec::byteSwap(bits) : bits;
+    }
+
+    // Bytes: raw bit k's place in the frame, grouped into runs within a byte. In both layouts the bits of a run go up
+    // together, raw and in the byte
+    int first = s.bigEndian ? DbcCodec::motorolaLinear(sig.startBit) + s.length - 1 : sig.startBit;
+    int previousByte = -1;
+    int previousBit = -1;
+    for (int k = 0; k < s.length; ++k) {
+        int byte, bit;
+        if (s.bigEndian) {
+            int linear = first - k;
+            byte = linear / 8;
+            bit = 7 - linear % 8;
+        } else {
+            byte = (first + k) / 8;
+            bit = (first + k) % 8;
+        }
+        if (byte >= frameLength) {
+            previousByte = -1;
+            continue;
+        }
+        if (byte == previousByte && bit == previousBit + 1) {
+            DbcCodec::Signal::Step& step = s.steps[s.stepCount - 1];
+            step.mask = static_cast<uint8_t>((step.mask << 1) | 1);
+        } else {
+            s.steps[s.stepCount++] = {static_cast<uint8_t>(byte), static_cast<uint8_t>(k), static_cast<uint8_t>(bit), 1};
+        }
+        previousByte = byte;
+        previousBit = bit;
+    }
+    return s;
+}
+
+} // namespace
+
+uint64_t DbcCodec::Signal::toRaw(double physical) const
+{
+    if (length == 0) {
+        return 0;
+    }
+    double value = min < max ? std::clamp(physical, min, max) : physical;
+    double raw = factor != 0.0 ? std::round((value - offset) / factor) : 0.0;
+    if (isSigned) {
+        int64_t v;
+        if (raw >= rawLimit) {
+            v = static_cast<int64_t>(mask >> 1);
+        } else if (raw < -rawLimit) {
+            v = -static_cast<int64_t>(mask >> 1) - 1;
+        } else if (raw == raw) {
+            v = static_cast<int64_t>(raw);
+        } else {
+            v = 0; // NaN
+        }
+        return static_cast<uint64_t>(v) & mask;
+    }
+    if (raw >= rawLimit) {
+        return mask;
+    }
+    return raw > 0.0 ? static_cast<uint64_t>(raw) : 0;
+}
+
+int64_t DbcCodec::Signal::toSigned(uint64_t raw) const
+{
+    if (!isSigned || length == 0 || length == 64) {
+        return static_cast<int64_t>(raw);
+    }
+    int unused = 64 - length;
+    return static_cast<int64_t>(raw << unused) >> unused;
+}
+
+double DbcCodec::Signal::toPhysical(uint64_t raw) const
+{
+    double value = isSigned ? static_cast<double>(toSigned(raw)) : static_cast<double>(raw);
+    return value * factor + offset;
+}
+
+DbcCodec::DbcCodec(const canMessage& msg)
+    : m_frameLength(std::clamp(msg.length, 0, maxFrameLength)), m_wordOps(m_frameLength <= 8)
+{
+    m_signals.reserve(msg.signalList.size());
+    for (const canSignal& sig : msg.signalList) {
+        m_signals.push_back(compile(sig, m_frameLength));
+    }
+}
+
+uint64_t DbcCodec::loadWord(const uint8_t* data, size_t size)
+{
+    uint64_t word = 0;
+    std::memcpy(&word, data, std::min<size_t>(size, 8));
+    return std::endian::native == std::endian::little ? word : byteSwap(word);
+}
+
+void DbcCodec::storeWord(uint64_t word, uint8_t* data, size_t size)
+{
+    if (std::endian::native != std::endian::little) {
+        word = byteSwap(word);
+    }
+    std::memcpy(data, &word, std::min<size_t>(size, 8));
+}
+
+uint64_t DbcCodec::encodeInWord(size_t i, double physical, uint64_t word) const
+{
+    const Signal& s = m_signals[i];
+    uint64_t raw = s.toRaw(physical);
+    uint64_t bits = s.shift >= 0 ? raw << s.shift : raw >> -s.shift;
+    if (s.bigEndian) bits = byteSwap(bits);
+    return (word & ~s.wordMask) | (bits & s.wordMask);
+}
+
+void DbcCodec::encode(const std::vector<canSignal>& signalList, uint8_t* data) const
+{
+    if (m_wordOps) {
+        uint64_t word = 0;
+        for (size_t i = 0; i < m_signals.size() && i < signalList.size(); ++i) {
+            word = encodeInWord(i, signalList[i].value, word);
+        }
+        storeWord(word, data, static_cast<size_t>(m_frameLength));
+        return;
+    }
+    std::memset(data, 0, static_cast<size_t>(m_frameLength));
+    for (size_t i = 0; i < m_signals.size() && i < signalList.size(); ++i) {
+        encodeSignal(i, signalList[i].value, data);
+    }
+}
+
+void DbcCodec::encode(const double* physical, uint8_t* data) const
+{
+    if (m_wordOps) {
+        uint64_t word = 0;
+        for (size_t i = 0; i < m_signals.size(); ++i) {
+            word = encodeInWord(i, physical[i], word);
+        }
+        storeWord(word, data, static_cast<size_t>(m_frameLength));
+        return;
+    }
+    std::memset(data, 0, static_cast<size_t>(m_frameLength));
+    for (size_t i = 0; i < m_signals.size(); ++i) {
+        encodeSignal(i, physical[i], data);
+    }
+}
+
+void DbcCodec::encodeSignal(size_t i, double physical, uint8_t* data) const
+{
+    const Signal& s = m_signals[i];
+    uint64_t raw = s.toRaw(physical);
+    for (int j = 0; j < s.stepCount; ++j) {
+        const Signal::Step& step = s.steps[j];
+        uint8_t bits = static_cast<uint8_t>((raw >> step.rawShift) & step.mask);
+        data[step.byte] = static_cast<uint8_t>((data[step.byte] & ~(step.mask << step.bitShift)) | (bits << step.bitShift));
+    }
+}
+
+uint64_t DbcCodec::decodeRaw(size_t i, const uint8_t* data, size_t size) const
+{
+    if (m_wordOps) {
+        return rawFromWord(i, loadWord(data, size));
+    }
+    const Signal& s = m_signals[i];
+    uint64_t raw = 0;
+    for (int j = 0; j < s.stepCount; ++j) {
+        const Signal::Step& step = s.steps[j];
+        if (step.byte < size) {
+            raw |= static_cast<uint64_t>((data[step.byte] >> step.bitShift) & step.mask) << step.rawShift;
+        }
+    }
+    return raw;
+}
+
+void DbcCodec::decode(const uint8_t* data, size_t size, double* physical) const
+{
+    if (m_wordOps) {
+        uint64_t word = loadWord(data, size);
+        for (size_t i = 0; i < m_signals.size(); ++i) {
+            physical[i] = m_signals[i].toPhysical(rawFromWord(i, word));
+        }
+        return;
+    }
+    for (size_t i = 0; i < m_signals.size(); ++i) {
+        physical[i] = m_signals[i].toPhysical(decodeRaw(i, data, size));
+    }
+}
+
+// ---- batch decode ----
+
+// Kernels that vectorize well, cloned for AVX2 where ifuncs can pick the clone at load time
+#if defined(__x86_64__) && defined(__linux__) && (defined(__GNUC__) || defined(__clang__)) \
+    && !defined(DBCCODEC_NO_CLONES)
+#define DBCCODEC_KERNEL __attribute__((target_clones("avx2", "default")))
+#else
+#define DBCCODEC_KERNEL
+#endif
+
+namespace {
+
+DBCCODEC_KERNEL
+void byteSwapAll(const uint64_t* in, uint64_t* out, size_t count)
+{
+    for (size_t n = 0; n < count; ++n) {
+        out[n] = DbcCodec::byteSwap(in[n]);
+    }
+}
+
+// One signal out of every frame's word. `signBit` is the signal's top bit if signed, else 0: (v ^ s) - s
+// sign-extends without the 64-bit arithmetic shift AVX2 lacks
+DBCCODEC_KERNEL
+void extract(const uint64_t* words, size_t count, int shift, uint64_t mask, uint64_t signBit, uint64_t* raw)
+{
+    if (shift >= 0) {
+        for (size_t n = 0; n < count; ++n) {
+            raw[n] = (((words[n] >> shift) & mask) ^ signBit) - signBit;
+        }
+    } else {
+        for (size_t n = 0; n < count; ++n) {
+            raw[n] = (((words[n] << -shift) & mask) ^ signBit) - signBit;
+        }
+    }
+}
+
+// One per-byte step of a signal in a CAN FD frame
+DBCCODEC_KERNEL
+void extractStep(const uint8_t* bytes, size_t stride, size_t count, const DbcCodec::Signal::Step& step, uint64_t* raw)
+{
+    for (size_t n = 0; n < count; ++n) {
+        raw[n] |= static_cast<uint64_t>((bytes[n * stride] >> step.bitShift) & step.mask) << step.rawShift;
+    }
+}
+
+DBCCODEC_KERNEL
+void signExtend(uint64_t* raw, size_t count, uint64_t signBit)
+{
+    for (size_t n = 0; n < count; ++n) {
+        raw[n] = (raw[n] ^ signBit) - signBit;
+    }
+}
+
+// Up to 52 bits, an integer converts to double by putting it in the mantissa of 2^52 and taking 2^52 away (signed
+// ones biased by 2^51 first), which vectorizes where a 64-bit integer conversion doesn't before AVX-512
+DBCCODEC_KERNEL
+void toPhysicalAll(const uint64_t* raw, size_t count, const DbcCodec::Signal& s, double* physical)
+{
+    constexpr uint64_t exponent = 0x4330000000000000ULL; // 2^52
+    constexpr uint64_t bias = 1ULL << 51;
+    const double factor = s.factor;
+    const double offset = s.offset;
+    if (s.length <= 52 && !s.isSigned) {
+        for (size_t n = 0; n < count; ++n) {
+            physical[n] = (std::bit_cast<double>(raw[n] | exponent) - 0x1p52) * factor + offset;
+        }
+    } else if (s.length <= 52) {
+        for (size_t n = 0; n < count; ++n) {
+            physical[n] = (std::bit_cast<double>((raw[n] + bias) | exponent) - 0x1.8p52) * factor + offset;
+        }
+    } else if (s.isSigned) {
+        for (size_t n = 0; n < count; ++n) {
+            physical[n] = static_cast<double>(static_cast<int64_t>(raw[n])) * factor + offset;
+        }
+    } else {
+        for (size_t n = 0; n < count; ++n) {
+            physical[n] = static_cast<double>(raw[n]) * factor + offset;
+        }
+    }
+}
+
+} // namespace
+
+void DbcCodec::decodeBatch(const uint8_t* data, size_t stride, size_t size, size_t count, Columns& out) const
+{
+    out.frames = count;
+    out.raw.resize(m_signals.size());
+    out.physical.resize(m_signals.size());
+    for (size_t i = 0; i < m_signals.size(); ++i) {
+        out.raw[i].resize(count);
+        out.physical[i].resize(count);
+    }
+    bool motorola = std::any_of(m_signals.begin(), m_signals.end(), [](const Signal& s) { return s.bigEndian; });
+
+    // A block of frames at a time, so that each signal's pass reads them from cache rather than memory
+    constexpr size_t blockFrames = 2048;
+    for (size_t first = 0; first < count; first += blockFrames) {
+        const uint8_t* frames = data + first * stride;
+        size_t block = std::min(blockFrames, count - first);
+
+        if (m_wordOps) {
+            // Every frame as its word, and byte-swapped for the Motorola signals
+            out.words.resize(block);
+            if (stride == 8 && size >= 8) {
+                std::memcpy(out.words.data(), frames, block * 8);
+                if (std::endian::native != std::endian::little) {
+                    byteSwapAll(out.words.data(), out.words.data(), block);
+                }
+            } else {
+                for (size_t n = 0; n < block; ++n) {
+                    out.words[n] = loadWord(frames + n * stride, size);
+                }
+            }
+            if (motorola) {
+                out.swapped.resize(block);
+                byteSwapAll(out.words.data(), out.swapped.data(), block);
+            }
+            for (size_t i = 0; i < m_signals.size(); ++i) {
+                const Signal& s = m_signals[i];
+                uint64_t signBit = s.isSigned && s.length > 0 ? 1ULL << (s.length - 1) : 0;
+                // Bits outside the frame word read as zero, as in rawFromWord
+                uint64_t mask = s.wordMask != 0 ? s.mask : 0;
+                uint64_t* raw = out.raw[i].data() + first;
+                extract(s.bigEndian ? out.swapped.data() : out.words.data(), block, s.shift, mask, signBit, raw);
+                toPhysicalAll(raw, block, s, out.physical[i].data() + first);
+            }
+            continue;
+        }
+
+        for (size_t i = 0; i < m_signals.size(); ++i) {
+            const Signal& s = m_signals[i];
+            uint64_t* raw = out.raw[i].data() + first;
+            std::fill(raw, raw + block, 0);
+            for (int j = 0; j < s.stepCount; ++j) {
+                if (s.steps[j].byte < size) {
+                    extractStep(frames + s.steps[j].byte, stride, block, s.steps[j], raw);
+                }
+            }
+            if (s.isSigned && s.length > 0) {
+                signExtend(raw, block, 1ULL << (s.length - 1));
+            }
+            toPhysicalAll(raw, block, s, out.physical[i].data() + first);
+        }
+    }
+}
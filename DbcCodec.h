@@ -0,0 +1,127 @@
+#ifndef DBCCODEC_H
+#define DBCCODEC_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "DbcReader.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <stdlib.h>
+#endif
+
+// One message's signals compiled for packing into and unpacking from frame bytes. Where a signal's bits sit is
+// worked out once: as a shift and mask on the whole frame read as one 64-bit word for classic CAN (up to 8 bytes;
+// a Motorola signal is shifted in the byte-swapped word), and as one shift/mask step per byte it touches for
+// longer frames. Motorola signals follow the DBC layout: the start bit is the MSB, and the bits after it run down
+// to bit 0 of its byte and on from bit 7 of the next.
+// Values go in through the signal's min/max (when min < max), factor and offset, rounded and saturated to the
+// signal's raw range; signed (@x-) signals are two's complement on the wire.
+class DbcCodec {
+public:
+    static constexpr int maxFrameLength = 64; // CAN FD
+
+    struct Signal {
+        // Frame bytes a signal of up to 64 bits can touch, plus one for a start bit that isn't byte-aligned
+        struct Step {
+            uint8_t byte;     // Frame byte
+            uint8_t rawShift; // First raw bit in it
+            uint8_t bitShift; // Bit of the byte that raw bit goes to
+            uint8_t mask;     // Its bits of the byte, before bitShift
+        };
+
+        int length = 0;
+        bool isSigned = false;
+        bool bigEndian = false; // Motorola
+        uint64_t mask = 0;      // Raw value bits
+        // Frame word: the signal's bits in it (zero if it has none) and the shift that lines the raw value up with
+        // them, in the byte-swapped word for a Motorola signal. Negative if the signal runs past the end of it
+        uint64_t wordMask = 0;
+        int shift = 0;
+        std::array<Step, 9> steps{};
+        int stepCount = 0;
+        double factor = 1.0;
+        double offset = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+        double rawLimit = 0.0; // 2^length, or 2^(length - 1) if signed
+
+        uint64_t toRaw(double physical) const;
+        double toPhysical(uint64_t raw) const;
+        int64_t toSigned(uint64_t raw) const; // Sign-extended if isSigned
+    };
+
+    DbcCodec() = default;
+    explicit DbcCodec(const canMessage& msg);
+
+    int frameLength() const { return m_frameLength; }
+    size_t signalCount() const { return m_signals.size(); }
+    const Signal& signal(size_t i) const { return m_signals[i]; }
+
+    // `data` holds frameLength() bytes. Signals are written in signalList order over a zeroed frame; where they
+    // share bits (multiplexed signals), the later one is what ends up in the frame
+    void encode(const std::vector<canSignal>& signalList, uint8_t* data) const; // Their current values
+    void encode(const double* physical, uint8_t* data) const;                   // One value per signal
+    // Writes one signal over what is already in `data`
+    void encodeSignal(size_t i, double physical, uint8_t* data) const;
+
+    // `size` may be short of frameLength(); missing bytes read as zero
+    uint64_t decodeRaw(size_t i, const uint8_t* data, size_t size) const;
+    void decode(const uint8_t* data, size_t size, double* physical) const; // Every signal
+
+    // Signal time series: column i holds signal i of every frame of a batch
+    struct Columns {
+        size_t frames = 0;
+        std::vector<std::vector<uint64_t>> raw; // Sign-extended for signed signals: read those as int64_t
+        std::vector<std::vector<double>> physical;
+
+        // Scratch, kept between batches so that decoding another one doesn't allocate
+        std::vector<uint64_t> words;
+        std::vector<uint64_t> swapped;
+    };
+    // `count` frames of this message, `stride` bytes apart from `data` and `size` bytes long each: 8 and 8 for
+    // packed classic payloads, sizeof(can_frame) and the DLC for an array of SocketCAN frames with `data` at the
+    // first payload. Decoded a signal at a time over the whole batch, in loops the compiler can vectorize; on
+    // x86-64 Linux they are also built for AVX2 and picked at run time
+    void decodeBatch(const uint8_t* data, size_t stride, size_t size, size_t count, Columns& out) const;
+
+    // A DBC bit (byte * 8 + bit, bit 0 the LSB) counted from the MSB of byte 0 instead, where a Motorola signal's
+    // bits are one run starting at its start bit
+    static int motorolaLinear(int bit) { return (bit / 8) * 8 + 7 - bit % 8; }
+
+    // A classic frame as the word the shifts apply to: byte 0 in the low bits, missing bytes zero
+    static uint64_t loadWord(const uint8_t* data, size_t size);
+    static void storeWord(uint64_t word, uint8_t* data, size_t size);
+    static uint64_t byteSwap(uint64_t v)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_bswap64(v);
+#elif defined(_MSC_VER)
+        return _byteswap_uint64(v);
+#else
+        v = ((v & 0x00FF00FF00FF00FFULL) << 8) | ((v >> 8) & 0x00FF00FF00FF00FFULL);
+        v = ((v & 0x0000FFFF0000FFFFULL) << 16) | ((v >> 16) & 0x0000FFFF0000FFFFULL);
+        return (v << 32) | (v >> 32);
+#endif
+    }
+
+    // Only for classic frames (wordOps())
+    bool wordOps() const { return m_wordOps; }
+    uint64_t rawFromWord(size_t i, uint64_t word) const
+    {
+        const Signal& s = m_signals[i];
+        uint64_t bits = word & s.wordMask;
+        if (s.bigEndian) bits = byteSwap(bits);
+        return (s.shift >= 0 ? bits >> s.shift : bits << -s.shift) & s.mask;
+    }
+
+private:
+    uint64_t encodeInWord(size_t i, double physical, uint64_t word) const;
+
+    int m_frameLength = 0;
+    bool m_wordOps = true; // Classic frame
+    std::vector<Signal> m_signals;
+};
+
+#endif // DBCCODEC_H
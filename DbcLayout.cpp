@@ -0,0 +1,160 @@
+#include "DbcLayout.h"
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+// Bits [first, last) of a bitmap
+DbcLayout::Bits range(int first, int last)
+{
+    DbcLayout::Bits bits{};
+    first = std::max(first, 0);
+    last = std::min(last, DbcLayout::maxBits);
+    for (int word = first / 64; first < last; ++word) {
+        int end = std::min(last, (word + 1) * 64);
+        int count = end - first;
+        uint64_t mask = count == 64 ? ~0ULL : (1ULL << count) - 1;
+        bits[word] |= mask << (first % 64);
+        first = end;
+    }
+    return bits;
+}
+
+uint64_t reverseEachByte(uint64_t v)
+{
+    v = ((v >> 1) & 0x5555555555555555ULL) | ((v & 0x5555555555555555ULL) << 1);
+    v = ((v >> 2) & 0x3333333333333333ULL) | ((v & 0x3333333333333333ULL) << 2);
+    v = ((v >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((v & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    return v;
+}
+
+// Lowest bit at or above `from` that is set (or, for `set` false, clear) in `bits`; maxBits if none
+int nextBit(const DbcLayout::Bits& bits, int from, bool set)
+{
+    for (int word = from / 64; word < static_cast<int>(bits.size()); ++word) {
+        uint64_t v = set ? bits[word] : ~bits[word];
+        if (word == from / 64) {
+            v &= ~0ULL << (from % 64);
+        }
+        if (v) {
+            return word * 64 + std::countr_zero(v);
+        }
+    }
+    return DbcLayout::maxBits;
+}
+
+} // namespace
+
+DbcLayout::DbcLayout(const canMessage& msg)
+    : DbcLayout()
+{
+    m_signals.reserve(msg.signalList.size());
+    for (const canSignal& sig : msg.signalList) {
+        add(sig);
+    }
+}
+
+DbcLayout::Bits DbcLayout::signalBits(int startBit, int length, bool littleEndian)
+{
+    if (length <= 0 || startBit < 0) {
+        return Bits{};
+    }
+    if (littleEndian) {
+        return range(startBit, startBit + length);
+    }
+    // A Motorola signal is a run of bits going up from its MSB in the order DbcCodec::motorolaLinear() gives,
+    // which numbers each byte's bits the other way round
+    int first = DbcCodec::motorolaLinear(startBit);
+    Bits bits = range(first, first + length);
+    for (uint64_t& word : bits) {
+        word = reverseEachByte(word);
+    }
+    return bits;
+}
+
+bool DbcLayout::fits(int startBit, int length, bool littleEndian, int frameBits)
+{
+    if (length < 1 || startBit < 0 || startBit >= frameBits) {
+        return false;
+    }
+    int first = littleEndian ? startBit : DbcCodec::motorolaLinear(startBit);
+    return first + length <= frameBits;
+}
+
+void DbcLayout::add(const canSignal& sig)
+{
+    const Bits bits = signalBits(sig.startBit, sig.length, sig.littleEndian);
+    const int index = static_cast<int>(m_signals.size());
+    for (size_t word = 0; word < bits.size(); ++word) {
+        uint64_t unowned = bits[word] & ~m_occupied[word];
+        m_shared[word] |= bits[word] & m_occupied[word];
+        m_occupied[word] |= bits[word];
+        for (; unowned; unowned &= unowned - 1) {
+            m_owner[word * 64 + std::countr_zero(unowned)] = static_cast<int16_t>(index);
+        }
+    }
+    m_signals.push_back(bits);
+}
+
+bool DbcLayout::occupied(int bit) const
+{
+    return bit >= 0 && bit < maxBits && (m_occupied[bit / 64] >> (bit % 64) & 1);
+}
+
+int DbcLayout::owner(int bit) const
+{
+    return bit >= 0 && bit < maxBits ? m_owner[bit] : -1;
+}
+
+bool DbcLayout::overlaps(const Bits& bits, int except) const
+{
+    const bool excluding = except >= 0 && except < static_cast<int>(m_signals.size());
+    for (size_t word = 0; word < bits.size(); ++word) {
+        uint64_t others = m_occupied[word];
+        if (excluding) {
+            // Its bits stay taken only where another signal has them too
+            const uint64_t own = m_signals[except][word];
+            others = (others & ~own) | (m_shared[word] & own);
+        }
+        if (bits[word] & others) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int DbcLayout::firstOverlap(const Bits& bits, int except) const
+{
+    if (!overlaps(bits, except)) {
+        return -1;
+    }
+    for (int i = 0; i < static_cast<int>(m_signals.size()); ++i) {
+        if (i == except) {
+            continue;
+        }
+        for (size_t word = 0; word < bits.size(); ++word) {
+            if (bits[word] & m_signals[i][word]) {
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
+int DbcLayout::firstFree(int length, int frameBits) const
+{
+    frameBits = std::min(frameBits, maxBits);
+    if (length < 1) {
+        return -1;
+    }
+    // Each run of clear bits, until one is long enough
+    for (int start = nextBit(m_occupied, 0, false); start + length <= frameBits;
+         start = nextBit(m_occupied, start, false)) {
+        int end = nextBit(m_occupied, start, true);
+        if (end - start >= length) {
+            return start;
+        }
+        start = end;
+    }
+    return -1;
+}
@@ -0,0 +1,44 @@
+#ifndef DBCLAYOUT_H
+#define DBCLAYOUT_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "DbcCodec.h"
+#include "DbcReader.h"
+
+// Which frame bits a message's signals use: one bitmap per signal and their union over the largest (CAN FD)
+// frame, plus the signal each bit belongs to. Bits are numbered as start bits are (byte * 8 + bit, bit 0 the
+// LSB) and a signal covers the bits DbcCodec packs it into; bits past the end of a 64-byte frame are left out.
+// Where multiplexed signals share bits, a bit belongs to the first of them in signalList order
+class DbcLayout {
+public:
+    static constexpr int maxBits = DbcCodec::maxFrameLength * 8;
+    using Bits = std::array<uint64_t, maxBits / 64>; // Bit n is bit n % 64 of word n / 64
+
+    DbcLayout() { m_owner.fill(-1); }
+    explicit DbcLayout(const canMessage& msg);
+
+    static Bits signalBits(int startBit, int length, bool littleEndian);
+    // Whether the signal lies within a frame of `frameBits` bits
+    static bool fits(int startBit, int length, bool littleEndian, int frameBits);
+
+    void add(const canSignal& sig); // Just appended to signalList
+
+    bool occupied(int bit) const;
+    int owner(int bit) const; // Index in signalList, -1 if no signal uses the bit
+    // The first signal, in signalList order and other than signal `except`, that uses any of `bits`; -1 if none
+    int firstOverlap(const Bits& bits, int except = -1) const;
+    bool overlaps(const Bits& bits, int except = -1) const;
+    // Lowest start bit at which an Intel signal of `length` bits fits in `frameBits` without overlapping any
+    // signal, -1 if there is none
+    int firstFree(int length, int frameBits) const;
+
+private:
+    Bits m_occupied{};
+    Bits m_shared{}; // Used by more than one signal
+    std::vector<Bits> m_signals;
+    std::array<int16_t, maxBits> m_owner;
+};
+
+#endif // DBCLAYOUT_H
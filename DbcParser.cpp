@@ -1,14 +1,19 @@
 #include "DbcParser.h"
 #include "DbcSender.h"
+#include "ConnectionManager.h"
+#include "DbcSnapshot.h"
 #include <QFile>
 #include <QTextStream>
 #include <QRegularExpression>
 #include <QFileInfo>
 #include <QDir>
+#include <QStandardPaths>
 #include <QDebug>
 #include <QTimer>
 #include <QDateTime>
 #include <QThread>
+#include <QPointer>
+#include <QSet>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
 #include <QtCore/QJsonArray>
@@ -18,17 +23,106 @@
 #include <iomanip>
 #include <bitset>
 #include <cmath>
-#include <set>
 #include <algorithm>
+#include <atomic>
+
+// One background DBC load, shared between its thread and the GUI thread. The thread fills everything but
+// `cancel`; the GUI thread reads it only after the thread has finished
+struct DbcLoad {
+    std::string path;
+    QString fileName;
+    std::string cacheDir; // Where snapshots live, empty to neither read nor write them
+    std::atomic<bool> cancel{false};
+    std::vector<canMessage> messages;
+    QString text;
+    QString error;
+    bool completed = false; // Parsed to the end, not cancelled
+    bool fromCache = false; // Taken from a snapshot instead of parsed
+};
+
+// Node a transmission's bus belongs to, empty for our own server's plain bus names
+static QString nodeOfBus(const QString &canBus)
+{
+    QString node, bus;
+    ConnectionManager::splitBus(canBus, node, bus);
+    return node;
+}
+
+// Fields of the transmission list models, and the keys of the maps activeTransmissions() etc. return
+static const RowList<ActiveTransmission>::Fields activeTransmissionFields{
+    {"messageName", [](const ActiveTransmission &t) -> QVariant { return t.messageName; }},
+    {"messageId", [](const ActiveTransmission &t) -> QVariant { return QString("0x%1").arg(t.messageId, 0, 16).toUpper(); }},
+    {"taskId", [](const ActiveTransmission &t) -> QVariant { return t.taskId; }},
+    {"rateMs", [](const ActiveTransmission &t) -> QVariant { return t.rateMs; }},
+    {"isPaused", [](const ActiveTransmission &t) -> QVariant { return t.isPaused; }},
+    {"status", [](const ActiveTransmission &t) -> QVariant { return t.status; }},
+    {"lastSent", [](const ActiveTransmission &t) -> QVariant { return t.lastSent; }},
+    {"sentCount", [](const ActiveTransmission &t) -> QVariant { return t.sentCount; }},
+    {"hexData", [](const ActiveTransmission &t) -> QVariant { return t.hexData; }},
+    {"startedAt", [](const ActiveTransmission &t) -> QVariant { return t.startedAt.toString("hh:mm:ss"); }},
+    {"canBus", [](const ActiveTransmission &t) -> QVariant { return t.canBus; }},
+};
+
+static const RowList<PastTransmission>::Fields pastTransmissionFields{
+    {"messageName", [](const PastTransmission &t) -> QVariant { return t.messageName; }},
+    {"messageId", [](const PastTransmission &t) -> QVariant { return static_cast<qint64>(t.messageId); }},
+    {"taskId", [](const PastTransmission &t) -> QVariant { return t.taskId; }},
+    {"rateMs", [](const PastTransmission &t) -> QVariant { return t.rateMs; }},
+    {"hexData", [](const PastTransmission &t) -> QVariant { return t.hexData; }},
+    {"startedAt", [](const PastTransmission &t) -> QVariant { return t.startedAt; }},
+    {"endedAt", [](const PastTransmission &t) -> QVariant { return t.endedAt; }},
+    {"endReason", [](const PastTransmission &t) -> QVariant { return t.endReason; }},
+    {"totalSent", [](const PastTransmission &t) -> QVariant { return t.totalSent; }},
+    {"canBus", [](const PastTransmission &t) -> QVariant { return t.canBus; }},
+    {"duration", [](const PastTransmission &t) -> QVariant { return t.duration; }},
+};
+
+static const RowList<OneShotMessage>::Fields oneShotMessageFields{
+    {"messageName", [](const OneShotMessage &m) -> QVariant { return m.messageName; }},
+    {"messageId", [](const OneShotMessage &m) -> QVariant { return QString("0x%1").arg(m.messageId, 0, 16).toUpper(); }},
+    {"hexData", [](const OneShotMessage &m) -> QVariant { return m.hexData; }},
+    {"sentAt", [](const OneShotMessage &m) -> QVariant { return m.sentAt.toString("hh:mm:ss"); }},
+    {"sentAtFull", [](const OneShotMessage &m) -> QVariant { return m.sentAt.toString("yyyy-MM-dd hh:mm:ss"); }},
+    {"canBus", [](const OneShotMessage &m) -> QVariant { return m.canBus; }},
+};
 
 DbcParser::DbcParser(QObject *parent)
-    : QObject(parent), selectedMessageIndex(-1), showAllSignals(false), currentEndian("little"), dbcSender(nullptr)
+    : QObject(parent), selectedMessageIndex(-1), m_signalList(new SignalListModel(messages, this)),
+      showAllSignals(false), currentEndian("little"), dbcSender(nullptr), connections(nullptr),
+      m_activeTransmissions(activeTransmissionFields, this), m_pastTransmissions(pastTransmissionFields, this),
+      m_oneShotMessages(oneShotMessageFields, this)
 {
     // Initialize with some default values
     m_generatedCanFrame = "";
     
     // Initialize DbcSender
     dbcSender = new DbcSender(this);
+    connect(dbcSender, &DbcSender::taskEvent, this, [this](const QString &taskId, const QString &state, const QString &detail) {
+        applyTaskEvent(QString(), taskId, state, detail);
+    });
+    connect(dbcSender, &DbcSender::taskSendsCounted, this, [this](const QString &taskId, int sends) {
+        applyTaskSends(QString(), taskId, sends);
+    });
+    connect(dbcSender, &DbcSender::connectionLost, this, &DbcParser::connectionStatusChanged);
+    connect(dbcSender, &DbcSender::reconnected, this, &DbcParser::connectionStatusChanged);
+    connect(dbcSender, &DbcSender::linkStatsChanged, this, &DbcParser::linkStatsChanged);
+
+    connections = new ConnectionManager(this);
+    connect(connections, &ConnectionManager::taskEvent, this, &DbcParser::applyTaskEvent);
+    connect(connections, &ConnectionManager::taskSendsCounted, this, &DbcParser::applyTaskSends);
+    connect(connections, &ConnectionManager::nodesChanged, this, &DbcParser::serverNodesChanged);
+    connect(connections, &ConnectionManager::nodesChanged, this, &DbcParser::connectionStatusChanged);
+    connect(connections, &ConnectionManager::serverAdded, this, [this](const QString &node, qint8 result) {
+        if (result != 0) {
+            emit showError(QString("Could not connect server %1 (error %2)").arg(node).arg(result));
+        }
+        emit serverAdded(node, result == 0);
+    });
+
+    // The QVariantList properties read the same lists
+    connect(&m_activeTransmissions, &RowListModel::listChanged, this, &DbcParser::activeTransmissionsChanged);
+    connect(&m_pastTransmissions, &RowListModel::listChanged, this, &DbcParser::pastTransmissionsChanged);
+    connect(&m_oneShotMessages, &RowListModel::listChanged, this, &DbcParser::oneShotMessagesChanged);
     
     // Note: Connection to CAN receiver is now handled through the GUI TCP Client tab
     qDebug() << "DbcParser: Initialized - use TCP Client tab to connect to server";
@@ -37,6 +131,15 @@ DbcParser::DbcParser(QObject *parent)
 DbcParser::~DbcParser()
 {
     qDebug() << "DbcParser: Destructor called - cleaning up...";
+
+    // Load threads call back into this object; stop them first
+    if (m_load) {
+        m_load->cancel = true;
+    }
+    for (QThread *thread : std::as_const(m_loadThreads)) {
+        thread->wait();
+        delete thread;
+    }
     
     // Ensure proper cleanup when the application closes
     if (dbcSender) {
@@ -75,176 +178,141 @@ bool DbcParser::loadDbcFile(const QUrl &fileUrl)
         return false;
     }
 
-    // Clear existing data
-    messages.clear();
-    selectedMessageIndex = -1;
-    m_generatedCanFrame.clear();
-
-    // Parse the DBC file
-    // Load and store original content
-    QFile originalFile(filePath);
-    if (originalFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        originalDbcText = QTextStream(&originalFile).readAll();
-        originalFile.close();
+    // Replaces a load still running; its result is thrown away
+    if (m_load) {
+        m_load->cancel = true;
     }
+    auto load = std::make_shared<DbcLoad>();
+    load->path = QFile::encodeName(filePath).toStdString();
+    load->fileName = fileInfo.fileName();
+    QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/dbc";
+    if (QDir().mkpath(cacheDir)) {
+        load->cacheDir = QFile::encodeName(cacheDir).toStdString() + "/";
+    }
+    m_load = load;
+    setLoadProgress(0.0);
+    emit loadingChanged();
 
-    // Parse the DBC content
-    parseDBC(filePath);
+    // Parse into the load's own table off the GUI thread; nothing here touches the current one
+    QThread *thread = QThread::create([this, load]() {
+        MappedFile file;
+        std::string error;
+        if (!file.open(load->path, error)) {
+            load->error = QString::fromStdString(error);
+            return;
+        }
 
+        // One mapping of the file serves both the parser and the text kept for the raw view, stored as a
+        // text-mode QTextStream would have read it
+        std::string_view text = file.view();
+        load->text = QString::fromUtf8(text.data(), static_cast<qsizetype>(text.size()));
+        if (load->text.startsWith(QChar(0xFEFF))) {
+            load->text.remove(0, 1);
+        }
+        load->text.replace("\r\n", "\n");
 
-    // Notify QML that our models have changed
-    emit messageModelChanged();
-    emit signalModelChanged();
-    emit generatedCanFrameChanged();
-    emit dbcLoadedChanged();
+        // An unchanged file has a snapshot of its tables from the last time; anything else is parsed and
+        // snapshotted for next time
+        uint64_t hash = DbcSnapshot::contentHash(text);
+        std::string snapshot = load->cacheDir.empty() ? std::string() : load->cacheDir + DbcSnapshot::fileName(hash);
+        if (!snapshot.empty() && DbcSnapshot::load(snapshot, hash, text.size(), load->messages)) {
+            load->completed = true;
+            load->fromCache = true;
+            return;
+        }
 
+        size_t total = std::max<size_t>(text.size(), 1);
+        load->completed = DbcReader::parse(text, load->messages, load->cancel, [this, load, total](size_t done) {
+            double progress = static_cast<double>(done) / static_cast<double>(total);
+            QMetaObject::invokeMethod(this, [this, load, progress]() {
+                if (m_load == load) {
+                    setLoadProgress(progress);
+                }
+            }, Qt::QueuedConnection);
+        });
+        if (load->completed && !snapshot.empty()) {
+            if (!DbcSnapshot::save(snapshot, hash, text.size(), load->messages, error)) {
+                qWarning() << "DBC snapshot not saved:" << QString::fromStdString(error);
+            }
+            DbcSnapshot::prune(load->cacheDir);
+        }
+    });
+    m_loadThreads.append(thread);
+    connect(thread, &QThread::finished, this, [this, thread, load]() {
+        m_loadThreads.removeOne(thread);
+        thread->deleteLater();
+        finishLoad(load);
+    });
+    thread->start();
     return true;
 }
 
-void DbcParser::parseDBC(const QString &filePath)
+void DbcParser::cancelLoad()
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qWarning() << "Could not open file:" << filePath;
+    if (m_load) {
+        qDebug() << "Cancelling load of" << m_load->fileName;
+        m_load->cancel = true;
+    }
+}
+
+// Runs on the GUI thread once a load's thread is done. The new table replaces the old one in a single swap,
+// so QML never sees a half-loaded file and gets each change signal once
+void DbcParser::finishLoad(const std::shared_ptr<DbcLoad> &load)
+{
+    if (m_load != load) {
+        return; // Superseded by a later load
+    }
+    m_load.reset();
+
+    if (!load->error.isEmpty() || !load->completed || load->cancel) {
+        QString message = load->error.isEmpty() ? "Loading " + load->fileName + " cancelled" : load->error;
+        qWarning() << message;
+        if (!load->error.isEmpty()) {
+            emit showError("Could not read DBC file: " + load->fileName);
+        }
+        setLoadProgress(0.0);
+        emit loadingChanged();
+        emit dbcLoadFinished(false, message);
         return;
     }
 
-    QTextStream in(&file);
-    QString line;
-    canMessage *currentMessage = nullptr;
+    m_signalList->beginResetTable();
+    messages.swap(load->messages);
+    rebuildIndexes();
+    originalDbcText = std::move(load->text);
+    selectedMessageIndex = -1;
+    m_signalList->endResetTable(-1);
+    m_generatedCanFrame.clear();
+    qDebug() << (load->fromCache ? "Loaded" : "Parsed") << messages.size() << "messages from" << load->fileName
+             << (load->fromCache ? "(snapshot)" : "");
 
-    while (!in.atEnd()) {
-        line = in.readLine();
+    setLoadProgress(1.0);
+    emit loadingChanged();
 
-        // Check if this line starts a new CAN message.
-        if (line.startsWith("BO_")) {
-            canMessage msg;
-            QStringList parts = line.split(" ", Qt::SkipEmptyParts);
-            
-            if (parts.size() >= 4) {
-                // Format: BO_ 123 MESSAGE_NAME: 8 SENDER
-                msg.id = parts[1].toULong();
-                
-                // Remove the colon from the message name if present
-                QString msgName = parts[2];
-                if (msgName.endsWith(":")) {
-                    msgName.chop(1);
-                }
-                msg.name = msgName.toStdString();
-                
-                // Get message length
-                int colonIndex = line.indexOf(':');
-                if (colonIndex != -1) {
-                    QStringList afterColon = line.mid(colonIndex + 1).split(" ", Qt::SkipEmptyParts);
-                    if (!afterColon.isEmpty()) {
-                        msg.length = afterColon[0].toInt();
-                    }
-                }
-                
-                msg.signalList.clear();
-                messages.push_back(msg);
-                currentMessage = &messages.back();
-            }
-        }
-        // Look for signal definitions
-        else if (line.contains(" SG_")) {
-            if (!currentMessage) {
-                qWarning() << "Signal found but no message to attach to";
-                continue;
-            }
+    // Notify QML that our models have changed
+    emit messageModelChanged();
+    emit signalModelChanged();
+    emit generatedCanFrameChanged();
+    emit dbcLoadedChanged();
+    emit dbcLoadFinished(true, load->fileName);
+}
+
+bool DbcParser::isLoading() const
+{
+    return m_load != nullptr;
+}
 
-            canSignal sig;
-            sig.value = 0; // Initialize value to 0
+double DbcParser::loadProgress() const
+{
+    return m_loadProgress;
+}
 
-            // Using regex to parse the signal line
-            QRegularExpression re(" SG_ ([^ ]+) : (\\d+)\\|(\\d+)@([01])([+-]) \\(([^,]+),([^\\)]+)\\) \\[([^\\|]+)\\|([^\\]]+)\\] \"([^\"]*)\"");
-            QRegularExpressionMatch match = re.match(line);
-            
-            if (match.hasMatch()) {
-                sig.name = match.captured(1).toStdString();
-                sig.startBit = match.captured(2).toInt();
-                sig.length = match.captured(3).toInt();
-                sig.littleEndian = (match.captured(4) == "1");
-                
-                try {
-                    sig.factor = match.captured(6).toDouble();
-                    sig.offset = match.captured(7).toDouble();
-                    sig.min = match.captured(8).toDouble();
-                    sig.max = match.captured(9).toDouble();
-                } catch (const std::exception& e) {
-                    qWarning() << "Error parsing numeric values in signal" << QString::fromStdString(sig.name);
-                    sig.factor = 1.0;
-                    sig.offset = 0.0;
-                    sig.min = 0.0;
-                    sig.max = 0.0;
-                }
-                
-                sig.unit = match.captured(10).toStdString();
-                
-                currentMessage->signalList.push_back(sig);
-            } else {
-                // Fallback parsing for non-standard format
-                QStringList parts = line.trimmed().split(" ", Qt::SkipEmptyParts);
-                if (parts.size() >= 3 && parts[0] == "SG_") {
-                    sig.name = parts[1].toStdString();
-                    
-                    // Try to extract bit position info
-                    for (int i = 2; i < parts.size(); i++) {
-                        if (parts[i].contains("|") && parts[i].contains("@")) {
-                            QStringList bitInfo = parts[i].split("@");
-                            if (bitInfo.size() >= 2) {
-                                QStringList startLen = bitInfo[0].split("|");
-                                if (startLen.size() >= 2) {
-                                    sig.startBit = startLen[0].toInt();
-                                    sig.length = startLen[1].toInt();
-                                }
-                                sig.littleEndian = bitInfo[1].startsWith("1");
-                            }
-                            break;
-                        }
-                    }
-                    
-                    // Try to extract factor and offset
-                    for (int i = 0; i < parts.size(); i++) {
-                        if (parts[i].startsWith("(") && parts[i].endsWith(")")) {
-                            QString factorOffset = parts[i].mid(1, parts[i].length() - 2);
-                            QStringList values = factorOffset.split(",");
-                            if (values.size() >= 2) {
-                                sig.factor = values[0].toDouble();
-                                sig.offset = values[1].toDouble();
-                            }
-                            break;
-                        }
-                    }
-                    
-                    // Try to extract min and max
-                    for (int i = 0; i < parts.size(); i++) {
-                        if (parts[i].startsWith("[") && parts[i].endsWith("]")) {
-                            QString minMax = parts[i].mid(1, parts[i].length() - 2);
-                            QStringList values = minMax.split("|");
-                            if (values.size() >= 2) {
-                                sig.min = values[0].toDouble();
-                                sig.max = values[1].toDouble();
-                            }
-                            break;
-                        }
-                    }
-                    
-                    // Try to extract unit
-                    for (int i = 0; i < parts.size(); i++) {
-                        if (parts[i].startsWith("\"") && parts[i].endsWith("\"")) {
-                            sig.unit = parts[i].mid(1, parts[i].length() - 2).toStdString();
-                            break;
-                        }
-                    }
-                    
-                    currentMessage->signalList.push_back(sig);
-                }
-            }
-        }
+void DbcParser::setLoadProgress(double progress)
+{
+    if (progress != m_loadProgress) {
+        m_loadProgress = progress;
+        emit loadProgressChanged();
     }
-    
-    file.close();
 }
 
 QStringList DbcParser::messageModel() const
@@ -270,6 +338,7 @@ QVariantList DbcParser::signalModel() const
             signalData["startBit"] = sig.startBit;
             signalData["length"] = sig.length;
             signalData["littleEndian"] = sig.littleEndian;
+            signalData["isSigned"] = sig.isSigned;
             signalData["factor"] = sig.factor;
             signalData["offset"] = sig.offset;
             signalData["min"] = sig.min;
@@ -284,23 +353,161 @@ QVariantList DbcParser::signalModel() const
     return result;
 }
 
+SignalListModel* DbcParser::signalList() const
+{
+    return m_signalList;
+}
+
+int DbcParser::findMessage(const QString &name) const
+{
+    return m_messageByName.value(name, -1);
+}
+
+int DbcParser::findMessageById(unsigned long id) const
+{
+    return m_messageById.value(id, -1);
+}
+
+int DbcParser::findSignalIndex(int messageIndex, const QString &signalName) const
+{
+    if (messageIndex < 0 || messageIndex >= static_cast<int>(m_signalIndex.size())) {
+        return -1;
+    }
+    return m_signalIndex[messageIndex].value(signalName, -1);
+}
+
+canSignal* DbcParser::findSignal(int messageIndex, const QString &signalName)
+{
+    int signalIndex = findSignalIndex(messageIndex, signalName);
+    return signalIndex >= 0 ? &messages[messageIndex].signalList[signalIndex] : nullptr;
+}
+
+void DbcParser::rebuildIndexes()
+{
+    m_messageByName.clear();
+    m_messageById.clear();
+    m_messageByName.reserve(static_cast<qsizetype>(messages.size()));
+    m_messageById.reserve(static_cast<qsizetype>(messages.size()));
+    m_signalIndex.clear();
+    m_signalIndex.resize(messages.size());
+    m_codecs.clear();
+    m_codecs.resize(messages.size());
+    m_layouts.clear();
+    m_layouts.resize(messages.size());
+    // Backwards, so that the first of two messages with the same name or ID is the one left in the index
+    for (int i = static_cast<int>(messages.size()) - 1; i >= 0; --i) {
+        m_messageByName.insert(QString::fromStdString(messages[i].name), i);
+        m_messageById.insert(messages[i].id, i);
+        indexSignals(i);
+    }
+}
+
+void DbcParser::indexMessage(int messageIndex)
+{
+    const canMessage &msg = messages[messageIndex];
+    QString name = QString::fromStdString(msg.name);
+    if (!m_messageByName.contains(name)) {
+        m_messageByName.insert(name, messageIndex);
+    }
+    if (!m_messageById.contains(msg.id)) {
+        m_messageById.insert(msg.id, messageIndex);
+    }
+    m_signalIndex.emplace_back();
+    m_codecs.emplace_back();
+    m_layouts.emplace_back();
+    indexSignals(messageIndex);
+}
+
+void DbcParser::unindexMessage(int messageIndex)
+{
+    m_signalIndex.erase(m_signalIndex.begin() + messageIndex);
+    m_codecs.erase(m_codecs.begin() + messageIndex);
+    m_layouts.erase(m_layouts.begin() + messageIndex);
+
+    // Drop the entries that pointed at the erased message and shift the ones behind it. A name or ID it shared
+    // with a later message now finds that one
+    auto shift = [messageIndex](auto &index) {
+        for (auto it = index.begin(); it != index.end();) {
+            if (it.value() == messageIndex) {
+                it = index.erase(it);
+            } else {
+                if (it.value() > messageIndex) {
+                    --it.value();
+                }
+                ++it;
+            }
+        }
+    };
+    shift(m_messageByName);
+    shift(m_messageById);
+    for (int i = messageIndex; i < static_cast<int>(messages.size()); ++i) {
+        QString name = QString::fromStdString(messages[i].name);
+        if (!m_messageByName.contains(name)) {
+            m_messageByName.insert(name, i);
+        }
+        if (!m_messageById.contains(messages[i].id)) {
+            m_messageById.insert(messages[i].id, i);
+        }
+    }
+}
+
+void DbcParser::indexSignals(int messageIndex)
+{
+    const auto &signalList = messages[messageIndex].signalList;
+    QHash<QString, int> &index = m_signalIndex[messageIndex];
+    m_codecs[messageIndex].reset();
+    m_layouts[messageIndex].reset();
+    index.clear();
+    index.reserve(static_cast<qsizetype>(signalList.size()));
+    for (int i = static_cast<int>(signalList.size()) - 1; i >= 0; --i) {
+        index.insert(QString::fromStdString(signalList[i].name), i);
+    }
+}
+
+const DbcCodec& DbcParser::codecFor(int messageIndex)
+{
+    std::optional<DbcCodec> &codec = m_codecs[messageIndex];
+    if (!codec) {
+        codec.emplace(messages[messageIndex]);
+    }
+    return *codec;
+}
+
+const DbcLayout& DbcParser::layoutFor(int messageIndex)
+{
+    std::optional<DbcLayout> &layout = m_layouts[messageIndex];
+    if (!layout) {
+        layout.emplace(messages[messageIndex]);
+    }
+    return *layout;
+}
+
+std::vector<uint8_t> DbcParser::packFrame(int messageIndex)
+{
+    const DbcCodec &codec = codecFor(messageIndex);
+    std::vector<uint8_t> frameData(static_cast<size_t>(codec.frameLength()));
+    codec.encode(messages[messageIndex].signalList, frameData.data());
+    return frameData;
+}
+
+void DbcParser::selectedSignalChanged(const canSignal &sig, const QList<int> &roles)
+{
+    const auto &signalList = messages[selectedMessageIndex].signalList;
+    m_signalList->signalChanged(static_cast<int>(&sig - signalList.data()), roles);
+    if (roles != QList<int>{SignalListModel::ValueRole}) {
+        emit signalModelChanged();
+    }
+}
+
 void DbcParser::selectMessage(const QString &messageName)
 {
     // Extract the message name without the ID part
     int parenthesisPos = messageName.indexOf(" (");
     QString name = parenthesisPos > 0 ? messageName.left(parenthesisPos) : messageName;
     
-    for (size_t i = 0; i < messages.size(); i++) {
-        if (QString::fromStdString(messages[i].name) == name) {
-            selectedMessageIndex = static_cast<int>(i);
-            emit signalModelChanged();
-            emit generatedCanFrameChanged();
-            return;
-        }
-    }
-    
-    // If we get here, the message wasn't found
-    selectedMessageIndex = -1;
+    // -1 if the message wasn't found
+    selectedMessageIndex = findMessage(name);
+    m_signalList->setMessage(selectedMessageIndex);
     emit signalModelChanged();
     emit generatedCanFrameChanged();
 }
@@ -319,30 +526,17 @@ void DbcParser::setEndian(const QString &endian)
 
 void DbcParser::updateSignalValue(const QString &signalName, double value)
 {
-    if (selectedMessageIndex >= 0 && selectedMessageIndex < static_cast<int>(messages.size())) {
-        auto& msg = messages[selectedMessageIndex];
-        
-        for (auto& sig : msg.signalList) {
-            if (QString::fromStdString(sig.name) == signalName) {
-                sig.value = value;
-                emit generatedCanFrameChanged();
-                emit signalModelChanged();
-                return;
-            }
-        }
+    if (canSignal* sig = findSignal(selectedMessageIndex, signalName)) {
+        sig->value = value;
+        emit generatedCanFrameChanged();
+        selectedSignalChanged(*sig, {SignalListModel::ValueRole});
     }
 }
 
 double DbcParser::getSignalValue(const QString &signalName)
 {
-    if (selectedMessageIndex >= 0 && selectedMessageIndex < static_cast<int>(messages.size())) {
-        auto& msg = messages[selectedMessageIndex];
-        
-        for (const auto& sig : msg.signalList) {
-            if (QString::fromStdString(sig.name) == signalName) {
-                return sig.value;
-            }
-        }
+    if (const canSignal* sig = findSignal(selectedMessageIndex, signalName)) {
+        return sig->value;
     }
     return 0.0; // Default value if signal not found
 }
@@ -378,70 +572,7 @@ QString DbcParser::generatedCanFrame() const
 
 QString DbcParser::buildCanFrame()
 {
-    const auto& msg = messages[selectedMessageIndex];
-    
-    // Create a buffer of zeros for the CAN frame data
-    std::vector<uint8_t> frameData(msg.length, 0);
-    
-    // For each signal, pack its value into the frame
-    for (const auto& sig : msg.signalList) {
-        // Convert the physical value to raw value
-        double rawValue = (sig.value - sig.offset) / sig.factor;
-        
-        // Clamp to min/max if defined
-        if (sig.min != sig.max) {
-            rawValue = std::max(sig.min, std::min(rawValue, sig.max));
-        }
-        
-        // Round to integer
-        uint64_t intValue = static_cast<uint64_t>(std::round(rawValue));
-        
-        // Apply bit mask based on signal length
-        uint64_t mask = (1ULL << sig.length) - 1;
-        intValue &= mask;
-        
-        // Pack the value into the frame based on endianness
-        int startBit = sig.startBit;
-        
-        if (sig.littleEndian) {
-            // Little endian (Intel format)
-            for (int i = 0; i < sig.length; i++) {
-                int byteIndex = startBit / 8;
-                int bitIndex = startBit % 8;
-                
-                if (byteIndex < msg.length) {
-                    // Set or clear bit
-                    if (intValue & (1ULL << i)) {
-                        frameData[byteIndex] |= (1 << bitIndex);
-                    } else {
-                        frameData[byteIndex] &= ~(1 << bitIndex);
-                    }
-                }
-                
-                startBit++;
-            }
-        } else {
-            // Big endian (Motorola format)
-            int msb = startBit;
-            for (int i = 0; i < sig.length; i++) {
-                int byteIndex = msb / 8;
-                int bitIndex = 7 - (msb % 8);
-                
-                if (byteIndex < msg.length) {
-                    // Set or clear bit
-                    if (intValue & (1ULL << (sig.length - 1 - i))) {
-                        frameData[byteIndex] |= (1 << bitIndex);
-                    } else {
-                        frameData[byteIndex] &= ~(1 << bitIndex);
-                    }
-                }
-                
-                // Decrement for Motorola format
-                msb--;
-                if (msb < 0) break;
-            }
-        }
-    }
+    std::vector<uint8_t> frameData = packFrame(selectedMessageIndex);
     
     // Format the frame data as a hex string
     std::stringstream ss;
@@ -472,17 +603,15 @@ double DbcParser::calculateRawValue(const QString &signalName, double physicalVa
         return 0.0;
     }
     
-    auto& msg = messages[selectedMessageIndex];
-    
-    for (auto& sig : msg.signalList) {
-        if (QString::fromStdString(sig.name) == signalName) {
-            // Convert from physical value to raw value
-            double rawValue = (physicalValue - sig.offset) / sig.factor;
-            return rawValue;
-        }
+    canSignal* found = findSignal(selectedMessageIndex, signalName);
+    if (!found) {
+        return 0.0;
     }
+    canSignal& sig = *found;
     
-    return 0.0;
+    // Convert from physical value to raw value
+    double rawValue = (physicalValue - sig.offset) / sig.factor;
+    return rawValue;
 }
 
 double DbcParser::calculatePhysicalValue(const QString &signalName, double rawValue)
@@ -491,17 +620,15 @@ double DbcParser::calculatePhysicalValue(const QString &signalName, double rawVa
         return 0.0;
     }
     
-    auto& msg = messages[selectedMessageIndex];
-    
-    for (auto& sig : msg.signalList) {
-        if (QString::fromStdString(sig.name) == signalName) {
-            // Convert from raw value to physical value
-            double physicalValue = (rawValue * sig.factor) + sig.offset;
-            return physicalValue;
-        }
+    canSignal* found = findSignal(selectedMessageIndex, signalName);
+    if (!found) {
+        return 0.0;
     }
+    canSignal& sig = *found;
     
-    return 0.0;
+    // Convert from raw value to physical value
+    double physicalValue = (rawValue * sig.factor) + sig.offset;
+    return physicalValue;
 }
 
 bool DbcParser::setBit(const QString &signalName, int byteIndex, int bitIndex, bool value)
@@ -510,45 +637,43 @@ bool DbcParser::setBit(const QString &signalName, int byteIndex, int bitIndex, b
         return false;
     }
     
-    auto& msg = messages[selectedMessageIndex];
+    canSignal* found = findSignal(selectedMessageIndex, signalName);
+    if (!found) {
+        return false;
+    }
+    canSignal& sig = *found;
     
-    for (auto& sig : msg.signalList) {
-        if (QString::fromStdString(sig.name) == signalName) {
-            // Get the current raw value
-            double rawValue = calculateRawValue(signalName, sig.value);
-            uint64_t intValue = static_cast<uint64_t>(std::round(rawValue));
-            
-            // Find the bit position in the overall signal
-            int bitPosition = byteIndex * 8 + bitIndex;
-            
-            // Check if this bit is part of the signal
-            if (!isBitPartOfSignal(bitPosition, sig.startBit, sig.length, sig.littleEndian)) {
-                return false;
-            }
-            
-            // Calculate which bit in the raw value needs to be changed
-            int rawBitIndex = getBitIndexInRawValue(bitPosition, sig.startBit, sig.littleEndian);
-            
-            // Set or clear the bit
-            if (value) {
-                intValue |= (1ULL << rawBitIndex);
-            } else {
-                intValue &= ~(1ULL << rawBitIndex);
-            }
-            
-            // Update the signal value
-            double newPhysicalValue = calculatePhysicalValue(signalName, intValue);
-            sig.value = newPhysicalValue;
-            
-            // Notify QML that the signal value has changed
-            emit signalModelChanged();
-            emit generatedCanFrameChanged();
-            
-            return true;
-        }
+    // Get the current raw value
+    double rawValue = calculateRawValue(signalName, sig.value);
+    uint64_t intValue = static_cast<uint64_t>(std::round(rawValue));
+    
+    // Find the bit position in the overall signal
+    int bitPosition = byteIndex * 8 + bitIndex;
+    
+    // Check if this bit is part of the signal
+    if (!isBitPartOfSignal(bitPosition, sig.startBit, sig.length, sig.littleEndian)) {
+        return false;
     }
     
-    return false;
+    // Calculate which bit in the raw value needs to be changed
+    int rawBitIndex = getBitIndexInRawValue(bitPosition, sig.startBit, sig.length, sig.littleEndian);
+    
+    // Set or clear the bit
+    if (value) {
+        intValue |= (1ULL << rawBitIndex);
+    } else {
+        intValue &= ~(1ULL << rawBitIndex);
+    }
+    
+    // Update the signal value
+    double newPhysicalValue = calculatePhysicalValue(signalName, intValue);
+    sig.value = newPhysicalValue;
+    
+    // Notify QML that the signal value has changed
+    selectedSignalChanged(sig, {SignalListModel::ValueRole});
+    emit generatedCanFrameChanged();
+    
+    return true;
 }
 
 bool DbcParser::getBit(const QString &signalName, int byteIndex, int bitIndex)
@@ -557,31 +682,29 @@ bool DbcParser::getBit(const QString &signalName, int byteIndex, int bitIndex)
         return false;
     }
     
-    auto& msg = messages[selectedMessageIndex];
+    canSignal* found = findSignal(selectedMessageIndex, signalName);
+    if (!found) {
+        return false;
+    }
+    canSignal& sig = *found;
     
-    for (auto& sig : msg.signalList) {
-        if (QString::fromStdString(sig.name) == signalName) {
-            // Get the current raw value
-            double rawValue = calculateRawValue(signalName, sig.value);
-            uint64_t intValue = static_cast<uint64_t>(std::round(rawValue));
-            
-            // Find the bit position in the overall signal
-            int bitPosition = byteIndex * 8 + bitIndex;
-            
-            // Check if this bit is part of the signal
-            if (!isBitPartOfSignal(bitPosition, sig.startBit, sig.length, sig.littleEndian)) {
-                return false;
-            }
-            
-            // Calculate which bit in the raw value needs to be checked
-            int rawBitIndex = getBitIndexInRawValue(bitPosition, sig.startBit, sig.littleEndian);
-            
-            // Return the bit value
-            return (intValue & (1ULL << rawBitIndex)) != 0;
-        }
+    // Get the current raw value
+    double rawValue = calculateRawValue(signalName, sig.value);
+    uint64_t intValue = static_cast<uint64_t>(std::round(rawValue));
+    
+    // Find the bit position in the overall signal
+    int bitPosition = byteIndex * 8 + bitIndex;
+    
+    // Check if this bit is part of the signal
+    if (!isBitPartOfSignal(bitPosition, sig.startBit, sig.length, sig.littleEndian)) {
+        return false;
     }
     
-    return false;
+    // Calculate which bit in the raw value needs to be checked
+    int rawBitIndex = getBitIndexInRawValue(bitPosition, sig.startBit, sig.length, sig.littleEndian);
+    
+    // Return the bit value
+    return (intValue & (1ULL << rawBitIndex)) != 0;
 }
 
 QString DbcParser::getSignalBitMask(const QString &signalName)
@@ -590,29 +713,27 @@ QString DbcParser::getSignalBitMask(const QString &signalName)
         return QString();
     }
     
-    auto& msg = messages[selectedMessageIndex];
+    canSignal* found = findSignal(selectedMessageIndex, signalName);
+    if (!found) {
+        return QString();
+    }
+    canSignal& sig = *found;
     
-    for (auto& sig : msg.signalList) {
-        if (QString::fromStdString(sig.name) == signalName) {
-            QString mask;
-            
-            // Generate a mask string where '1' indicates bits that are part of this signal
-            for (int byteIndex = 7; byteIndex >= 0; byteIndex--) {
-                for (int bitIndex = 7; bitIndex >= 0; bitIndex--) {
-                    int bitPosition = byteIndex * 8 + bitIndex;
-                    if (isBitPartOfSignal(bitPosition, sig.startBit, sig.length, sig.littleEndian)) {
-                        mask += "1";
-                    } else {
-                        mask += "0";
-                    }
-                }
+    QString mask;
+    
+    // Generate a mask string where '1' indicates bits that are part of this signal
+    for (int byteIndex = 7; byteIndex >= 0; byteIndex--) {
+        for (int bitIndex = 7; bitIndex >= 0; bitIndex--) {
+            int bitPosition = byteIndex * 8 + bitIndex;
+            if (isBitPartOfSignal(bitPosition, sig.startBit, sig.length, sig.littleEndian)) {
+                mask += "1";
+            } else {
+                mask += "0";
             }
-            
-            return mask;
         }
     }
     
-    return QString();
+    return mask;
 }
 
 void DbcParser::updateSignalFromRawValue(const QString &signalName, uint64_t rawValue)
@@ -621,23 +742,21 @@ void DbcParser::updateSignalFromRawValue(const QString &signalName, uint64_t raw
         return;
     }
     
-    auto& msg = messages[selectedMessageIndex];
-    
-    for (auto& sig : msg.signalList) {
-        if (QString::fromStdString(sig.name) == signalName) {
-            // Convert raw value to physical value
-            double physicalValue = calculatePhysicalValue(signalName, rawValue);
-            
-            // Update the signal value
-            sig.value = physicalValue;
-            
-            // Notify QML that the signal value has changed
-            emit signalModelChanged();
-            emit generatedCanFrameChanged();
-            
-            return;
-        }
+    canSignal* found = findSignal(selectedMessageIndex, signalName);
+    if (!found) {
+        return;
     }
+    canSignal& sig = *found;
+    
+    // Convert raw value to physical value
+    double physicalValue = calculatePhysicalValue(signalName, rawValue);
+    
+    // Update the signal value
+    sig.value = physicalValue;
+    
+    // Notify QML that the signal value has changed
+    selectedSignalChanged(sig, {SignalListModel::ValueRole});
+    emit generatedCanFrameChanged();
 }
 QString DbcParser::formatPhysicalValueCalculation(const QString &signalName, double rawValue)
 {
@@ -645,31 +764,29 @@ QString DbcParser::formatPhysicalValueCalculation(const QString &signalName, dou
         return QString();
     }
     
-    auto& msg = messages[selectedMessageIndex];
-    
-    for (auto& sig : msg.signalList) {
-        if (QString::fromStdString(sig.name) == signalName) {
-            // Format the calculation
-            double physicalValue = calculatePhysicalValue(signalName, rawValue);
-            
-            // Format with hex and decimal
-            QString hexDisplay = QString("0x%1").arg(static_cast<uint64_t>(rawValue), 0, 16).toUpper();
-            
-            QString result = QString("Data = %1 = %2\n").arg(hexDisplay).arg(static_cast<uint64_t>(rawValue));
-            
-            // Add formula with units similar to the second screenshot
-            result += QString("Physical value = %1 * %2 + %3 = %4 %5")
-                         .arg(sig.factor)
-                         .arg(static_cast<uint64_t>(rawValue))
-                         .arg(sig.offset)
-                         .arg(physicalValue)
-                         .arg(QString::fromStdString(sig.unit));
-            
-            return result;
-        }
+    canSignal* found = findSignal(selectedMessageIndex, signalName);
+    if (!found) {
+        return QString();
     }
+    canSignal& sig = *found;
     
-    return QString();
+    // Format the calculation
+    double physicalValue = calculatePhysicalValue(signalName, rawValue);
+    
+    // Format with hex and decimal
+    QString hexDisplay = QString("0x%1").arg(static_cast<uint64_t>(rawValue), 0, 16).toUpper();
+    
+    QString result = QString("Data = %1 = %2\n").arg(hexDisplay).arg(static_cast<uint64_t>(rawValue));
+    
+    // Add formula with units similar to the second screenshot
+    result += QString("Physical value = %1 * %2 + %3 = %4 %5")
+                 .arg(sig.factor)
+                 .arg(static_cast<uint64_t>(rawValue))
+                 .arg(sig.offset)
+                 .arg(physicalValue)
+                 .arg(QString::fromStdString(sig.unit));
+    
+    return result;
 }
 
 void DbcParser::initializePreviewDialog(const QString &signalName, QVariantList &bitValues, double &rawValue)
@@ -678,37 +795,35 @@ void DbcParser::initializePreviewDialog(const QString &signalName, QVariantList
         return;
     }
     
-    auto& msg = messages[selectedMessageIndex];
+    canSignal* found = findSignal(selectedMessageIndex, signalName);
+    if (!found) {
+        return;
+    }
+    canSignal& sig = *found;
+    
+    // Calculate raw value
+    rawValue = calculateRawValue(signalName, sig.value);
     
-    for (auto& sig : msg.signalList) {
-        if (QString::fromStdString(sig.name) == signalName) {
-            // Calculate raw value
-            rawValue = calculateRawValue(signalName, sig.value);
+    // Initialize bit values array
+    bitValues.clear();
+    for (int byteIndex = 7; byteIndex >= 0; byteIndex--) {
+        for (int bitIndex = 7; bitIndex >= 0; bitIndex--) {
+            QVariantMap bitInfo;
+            int bitPosition = byteIndex * 8 + bitIndex;
+            bool isPartOfSignal = isBitPartOfSignal(bitPosition, sig.startBit, sig.length, sig.littleEndian);
+            bool isSet = false;
             
-            // Initialize bit values array
-            bitValues.clear();
-            for (int byteIndex = 7; byteIndex >= 0; byteIndex--) {
-                for (int bitIndex = 7; bitIndex >= 0; bitIndex--) {
-                    QVariantMap bitInfo;
-                    int bitPosition = byteIndex * 8 + bitIndex;
-                    bool isPartOfSignal = isBitPartOfSignal(bitPosition, sig.startBit, sig.length, sig.littleEndian);
-                    bool isSet = false;
-                    
-                    if (isPartOfSignal) {
-                        int rawBitIndex = getBitIndexInRawValue(bitPosition, sig.startBit, sig.littleEndian);
-                        isSet = (static_cast<uint64_t>(rawValue) & (1ULL << rawBitIndex)) != 0;
-                    }
-                    
-                    bitInfo["byteIndex"] = byteIndex;
-                    bitInfo["bitIndex"] = bitIndex;
-                    bitInfo["isPartOfSignal"] = isPartOfSignal;
-                    bitInfo["isSet"] = isSet;
-                    
-                    bitValues.append(bitInfo);
-                }
+            if (isPartOfSignal) {
+                int rawBitIndex = getBitIndexInRawValue(bitPosition, sig.startBit, sig.length, sig.littleEndian);
+                isSet = (static_cast<uint64_t>(rawValue) & (1ULL << rawBitIndex)) != 0;
             }
             
-            return;
+            bitInfo["byteIndex"] = byteIndex;
+            bitInfo["bitIndex"] = bitIndex;
+            bitInfo["isPartOfSignal"] = isPartOfSignal;
+            bitInfo["isSet"] = isSet;
+            
+            bitValues.append(bitInfo);
         }
     }
 }
@@ -719,30 +834,28 @@ uint64_t DbcParser::calculateRawValueFromBits(const QString &signalName, const Q
         return 0;
     }
     
-    auto& msg = messages[selectedMessageIndex];
+    canSignal* found = findSignal(selectedMessageIndex, signalName);
+    if (!found) {
+        return 0;
+    }
+    canSignal& sig = *found;
     
-    for (auto& sig : msg.signalList) {
-        if (QString::fromStdString(sig.name) == signalName) {
-            uint64_t rawValue = 0;
-            
-            for (const QVariant &bitInfo : bitValues) {
-                QVariantMap bitMap = bitInfo.toMap();
-                
-                if (bitMap["isPartOfSignal"].toBool() && bitMap["isSet"].toBool()) {
-                    int byteIndex = bitMap["byteIndex"].toInt();
-                    int bitIndex = bitMap["bitIndex"].toInt();
-                    int bitPosition = byteIndex * 8 + bitIndex;
-                    int rawBitIndex = getBitIndexInRawValue(bitPosition, sig.startBit, sig.littleEndian);
-                    
-                    rawValue |= (1ULL << rawBitIndex);
-                }
-            }
+    uint64_t rawValue = 0;
+    
+    for (const QVariant &bitInfo : bitValues) {
+        QVariantMap bitMap = bitInfo.toMap();
+        
+        if (bitMap["isPartOfSignal"].toBool() && bitMap["isSet"].toBool()) {
+            int byteIndex = bitMap["byteIndex"].toInt();
+            int bitIndex = bitMap["bitIndex"].toInt();
+            int bitPosition = byteIndex * 8 + bitIndex;
+            int rawBitIndex = getBitIndexInRawValue(bitPosition, sig.startBit, sig.length, sig.littleEndian);
             
-            return rawValue;
+            rawValue |= (1ULL << rawBitIndex);
         }
     }
     
-    return 0;
+    return rawValue;
 }
 
 // Add these implementations to your DbcParser.cpp file:
@@ -755,121 +868,123 @@ bool DbcParser::updateSignalParameter(const QString &signalName, const QString &
     }
     
     auto& msg = messages[selectedMessageIndex];
+    canSignal* found = findSignal(selectedMessageIndex, signalName);
+    if (!found) {
+        return false;
+    }
+    canSignal& sig = *found;
+    m_codecs[selectedMessageIndex].reset(); // Layout or scaling may change
+    m_layouts[selectedMessageIndex].reset();
     
-    for (auto& sig : msg.signalList) {
-        if (QString::fromStdString(sig.name) == signalName) {
-            // Store original values for validation
-            int originalStartBit = sig.startBit;
-            int originalLength = sig.length;
-            
-            // Prepare new values for validation
-            int newStartBit = originalStartBit;
-            int newLength = originalLength;
-            
-            // Update the specified parameter with validation
-            if (paramName == "startBit") {
-                newStartBit = value.toInt();
-                // Basic bounds check
-                if (newStartBit < 0 || newStartBit > 63) {
-                    qDebug() << "updateSignalParameter: Invalid start bit" << newStartBit << "for signal" << signalName;
-                    return false;
-                }
-            }
-            else if (paramName == "length") {
-                newLength = value.toInt();
-                // Basic bounds check
-                if (newLength < 1 || newLength > 64) {
-                    qDebug() << "updateSignalParameter: Invalid length" << newLength << "for signal" << signalName;
-                    return false;
-                }
-            }
-            else if (paramName == "factor") {
-                sig.factor = value.toDouble();
-                // Notify QML that the signal model has changed
-                emit signalModelChanged();
-                emit generatedCanFrameChanged();
-                return true;
-            }
-            else if (paramName == "offset") {
-                sig.offset = value.toDouble();
-                // Notify QML that the signal model has changed
-                emit signalModelChanged();
-                emit generatedCanFrameChanged();
-                return true;
-            }
-            else if (paramName == "min") {
-                sig.min = value.toDouble();
-                // Notify QML that the signal model has changed
-                emit signalModelChanged();
-                emit generatedCanFrameChanged();
-                return true;
-            }
-            else if (paramName == "max") {
-                sig.max = value.toDouble();
-                // Notify QML that the signal model has changed
-                emit signalModelChanged();
-                emit generatedCanFrameChanged();
-                return true;
-            }
-            else if (paramName == "unit") {
-                sig.unit = value.toString().toStdString();
-                // Notify QML that the signal model has changed
-                emit signalModelChanged();
-                emit generatedCanFrameChanged();
-                return true;
-            }
-            else if (paramName == "littleEndian") {
-                sig.littleEndian = value.toBool();
-                // Notify QML that the signal model has changed
-                emit signalModelChanged();
-                emit generatedCanFrameChanged();
-                return true;
-            }
-            else {
-                // Unknown parameter
-                return false;
-            }
-            
-            // For startBit and length changes, validate against overlaps
-            if (paramName == "startBit" || paramName == "length") {
-                // Check if new start bit + length exceeds 64 bits
-                if (newStartBit + newLength > 64) {
-                    qDebug() << "updateSignalParameter: Signal" << signalName << "would exceed 64 bits with start bit" << newStartBit << "and length" << newLength;
-                    return false;
-                }
-                
-                // Validate against overlaps with other signals (exclude the current signal being edited)
-                QString validationError = validateSignalData(
-                    QString::fromStdString(msg.name),
-                    signalName,
-                    newStartBit,
-                    newLength,
-                    sig.littleEndian,
-                    signalName  // Exclude the current signal from validation
-                );
-                
-                if (!validationError.isEmpty()) {
-                    qDebug() << "updateSignalParameter: Validation failed for signal" << signalName << ":" << validationError;
-                    return false;
-                }
-                
-                // If validation passes, update the parameter
-                if (paramName == "startBit") {
-                    sig.startBit = newStartBit;
-                } else if (paramName == "length") {
-                    sig.length = newLength;
-                }
-            }
-            
-            // Notify QML that the signal model has changed
-            emit signalModelChanged();
-            emit generatedCanFrameChanged();
-            
-            return true;
+    // Store original values for validation
+    int originalStartBit = sig.startBit;
+    int originalLength = sig.length;
+    
+    // Prepare new values for validation
+    int newStartBit = originalStartBit;
+    int newLength = originalLength;
+    
+    // Update the specified parameter with validation
+    if (paramName == "startBit") {
+        newStartBit = value.toInt();
+        // Basic bounds check
+        if (newStartBit < 0 || newStartBit > 63) {
+            qDebug() << "updateSignalParameter: Invalid start bit" << newStartBit << "for signal" << signalName;
+            return false;
         }
     }
+    else if (paramName == "length") {
+        newLength = value.toInt();
+        // Basic bounds check
+        if (newLength < 1 || newLength > 64) {
+            qDebug() << "updateSignalParameter: Invalid length" << newLength << "for signal" << signalName;
+            return false;
+        }
+    }
+    else if (paramName == "factor") {
+        sig.factor = value.toDouble();
+        // Notify QML that the signal model has changed
+        selectedSignalChanged(sig);
+        emit generatedCanFrameChanged();
+        return true;
+    }
+    else if (paramName == "offset") {
+        sig.offset = value.toDouble();
+        // Notify QML that the signal model has changed
+        selectedSignalChanged(sig);
+        emit generatedCanFrameChanged();
+        return true;
+    }
+    else if (paramName == "min") {
+        sig.min = value.toDouble();
+        // Notify QML that the signal model has changed
+        selectedSignalChanged(sig);
+        emit generatedCanFrameChanged();
+        return true;
+    }
+    else if (paramName == "max") {
+        sig.max = value.toDouble();
+        // Notify QML that the signal model has changed
+        selectedSignalChanged(sig);
+        emit generatedCanFrameChanged();
+        return true;
+    }
+    else if (paramName == "unit") {
+        sig.unit = value.toString().toStdString();
+        // Notify QML that the signal model has changed
+        selectedSignalChanged(sig);
+        emit generatedCanFrameChanged();
+        return true;
+    }
+    else if (paramName == "littleEndian") {
+        sig.littleEndian = value.toBool();
+        // Notify QML that the signal model has changed
+        selectedSignalChanged(sig);
+        emit generatedCanFrameChanged();
+        return true;
+    }
+    else {
+        // Unknown parameter
+        return false;
+    }
     
-    return false;
+    // For startBit and length changes, validate against overlaps
+    if (paramName == "startBit" || paramName == "length") {
+        // Check if new start bit + length exceeds 64 bits
+        if (newStartBit + newLength > 64) {
+            qDebug() << "updateSignalParameter: Signal" << signalName << "would exceed 64 bits with start bit" << newStartBit << "and length" << newLength;
+            return false;
+        }
+        
+        // Validate against overlaps with other signals (exclude the current signal being edited)
+        QString validationError = validateSignalData(
+            QString::fromStdString(msg.name),
+            signalName,
+            newStartBit,
+            newLength,
+            sig.littleEndian,
+            signalName  // Exclude the current signal from validation
+        );
+        
+        if (!validationError.isEmpty()) {
+            qDebug() << "updateSignalParameter: Validation failed for signal" << signalName << ":" << validationError;
+            return false;
+        }
+        
+        // If validation passes, update the parameter
+        if (paramName == "startBit") {
+            sig.startBit = newStartBit;
+        } else if (paramName == "length") {
+            sig.length = newLength;
+        }
+        m_layouts[selectedMessageIndex].reset(); // Validation built it from the old position
+    }
+    
+    // Notify QML that the signal model has changed
+    selectedSignalChanged(sig);
+    emit generatedCanFrameChanged();
+    
+    return true;
 }
 
 // NEW FUNCTION: Check if a bit belongs to a signal (exposed to QML)
@@ -879,19 +994,17 @@ bool DbcParser::isBitPartOfSignal(const QString &signalName, int byteIndex, int
         return false;
     }
     
-    auto& msg = messages[selectedMessageIndex];
-    
-    for (auto& sig : msg.signalList) {
-        if (QString::fromStdString(sig.name) == signalName) {
-            // Calculate the bit position
-            int bitPosition = byteIndex * 8 + bitIndex;
-            
-            // Use the private helper method to check if the bit is part of the signal
-            return isBitPartOfSignal(bitPosition, sig.startBit, sig.length, sig.littleEndian);
-        }
+    canSignal* found = findSignal(selectedMessageIndex, signalName);
+    if (!found) {
+        return false;
     }
+    canSignal& sig = *found;
     
-    return false;
+    // Calculate the bit position
+    int bitPosition = byteIndex * 8 + bitIndex;
+    
+    // Use the private helper method to check if the bit is part of the signal
+    return isBitPartOfSignal(bitPosition, sig.startBit, sig.length, sig.littleEndian);
 }
 
 // Improved helper function for bit endianness
@@ -902,17 +1015,11 @@ bool DbcParser::isBitPartOfSignal(int bitPosition, int startBit, int length, boo
         int endBit = startBit + length - 1;
         return (bitPosition >= startBit && bitPosition <= endBit);
     } else {
-        // For big endian (Motorola format), bits start at startBit and go backwards
-        // Convert to standard Motorola bit numbering
-        int byteIndex = startBit / 8;
-        int bitIndexInByte = startBit % 8;
-        
-        // MSB (Most Significant Bit) is the startBit
-        int msb = byteIndex * 8 + (7 - bitIndexInByte);
-        // LSB (Least Significant Bit) is length-1 bits from MSB
-        int lsb = msb - (length - 1);
-        
-        return (bitPosition <= msb && bitPosition >= lsb);
+        // For big endian (Motorola format), startBit is the MSB and the bits are consecutive from there in
+        // big-endian order (down to bit 0 of the byte, then on from bit 7 of the next)
+        int msb = DbcCodec::motorolaLinear(startBit);
+        int position = DbcCodec::motorolaLinear(bitPosition);
+        return (position >= msb && position < msb + length);
     }
 }
 
@@ -924,90 +1031,16 @@ QString DbcParser::getFrameDataHex(const QString &signalName, double rawValue)
         return "00 00 00 00 00 00 00 00";
     }
     
-    auto msg = messages[selectedMessageIndex]; // Make a non-const copy
-    
-    // Create a buffer of zeros for the CAN frame data
-    std::vector<uint8_t> frameData(msg.length, 0);
-    
-    // Store original signal value
-    double originalValue = 0.0;
-    int signalIndex = -1;
-    
     // Find the signal
-    for (size_t i = 0; i < msg.signalList.size(); i++) {
-        if (QString::fromStdString(msg.signalList[i].name) == signalName) {
-            originalValue = msg.signalList[i].value;
-            signalIndex = static_cast<int>(i);
-            break;
-        }
-    }
+    int signalIndex = findSignalIndex(selectedMessageIndex, signalName);
     
     if (signalIndex < 0) {
         return "00 00 00 00 00 00 00 00";
     }
     
-    // Set the signal value based on raw value
-    msg.signalList[signalIndex].value = calculatePhysicalValue(signalName, rawValue);
-    
-    // For each signal, pack its value into the frame based on the SAME logic as buildCanFrame()
-    for (const auto& sig : msg.signalList) {
-        // Convert the physical value to raw value
-        double sigRawValue = (sig.value - sig.offset) / sig.factor;
-        
-        // Clamp to min/max if defined
-        if (sig.min != sig.max) {
-            sigRawValue = std::max(sig.min, std::min(sigRawValue, sig.max));
-        }
-        
-        // Round to integer
-        uint64_t intValue = static_cast<uint64_t>(std::round(sigRawValue));
-        
-        // Apply bit mask based on signal length
-        uint64_t mask = (1ULL << sig.length) - 1;
-        intValue &= mask;
-        
-        // Pack the value into the frame based on endianness
-        int startBit = sig.startBit;
-        
-        if (sig.littleEndian) {
-            // Little endian (Intel format)
-            for (int i = 0; i < sig.length; i++) {
-                int byteIndex = startBit / 8;
-                int bitIndex = startBit % 8;
-                
-                if (byteIndex < msg.length) {
-                    // Set or clear bit
-                    if (intValue & (1ULL << i)) {
-                        frameData[byteIndex] |= (1 << bitIndex);
-                    } else {
-                        frameData[byteIndex] &= ~(1 << bitIndex);
-                    }
-                }
-                
-                startBit++;
-            }
-        } else {
-            // Big endian (Motorola format)
-            int msb = startBit;
-            for (int i = 0; i < sig.length; i++) {
-                int byteIndex = msb / 8;
-                int bitIndex = 7 - (msb % 8);
-                
-                if (byteIndex < msg.length) {
-                    // Set or clear bit
-                    if (intValue & (1ULL << (sig.length - 1 - i))) {
-                        frameData[byteIndex] |= (1 << bitIndex);
-                    } else {
-                        frameData[byteIndex] &= ~(1 << bitIndex);
-                    }
-                }
-                
-                // Decrement for Motorola format
-                msb--;
-                if (msb < 0) break;
-            }
-        }
-    }
+    // The frame as it is, with this signal set to the raw value
+    std::vector<uint8_t> frameData = packFrame(selectedMessageIndex);
+    codecFor(selectedMessageIndex).encodeSignal(signalIndex, calculatePhysicalValue(signalName, rawValue), frameData.data());
     
     // Format the frame data as a hex string
     std::stringstream ss;
@@ -1026,91 +1059,21 @@ QString DbcParser::getFrameDataBin(const QString &signalName, double rawValue)
 {
     if (selectedMessageIndex < 0 || selectedMessageIndex >= static_cast<int>(messages.size())) {
         return "00000000 00000000 00000000 00000000 00000000 00000000 00000000 00000000";
-    }
-    
-    auto msg = messages[selectedMessageIndex]; // Make a non-const copy
-    
-    // Create a buffer of zeros for the CAN frame data
-    std::vector<uint8_t> frameData(msg.length, 0);
+    }
     
     // Find the signal
-    int signalIndex = -1;
-    for (size_t i = 0; i < msg.signalList.size(); i++) {
-        if (QString::fromStdString(msg.signalList[i].name) == signalName) {
-            signalIndex = static_cast<int>(i);
-            break;
-        }
-    }
+    int signalIndex = findSignalIndex(selectedMessageIndex, signalName);
     
     if (signalIndex < 0) {
         return "00000000 00000000 00000000 00000000 00000000 00000000 00000000 00000000";
     }
     
-    // Set the signal value based on raw value
-    msg.signalList[signalIndex].value = calculatePhysicalValue(signalName, rawValue);
-    
-    // For each signal, pack its value into the frame based on the SAME logic as buildCanFrame()
-    for (const auto& s : msg.signalList) {
-        // Convert the physical value to raw value
-        double sigRawValue = (s.value - s.offset) / s.factor;
-        
-        // Clamp to min/max if defined
-        if (s.min != s.max) {
-            sigRawValue = std::max(s.min, std::min(sigRawValue, s.max));
-        }
-        
-        // Round to integer
-        uint64_t intValue = static_cast<uint64_t>(std::round(sigRawValue));
-        
-        // Apply bit mask based on signal length
-        uint64_t mask = (1ULL << s.length) - 1;
-        intValue &= mask;
-        
-        // Pack the value into the frame based on endianness
-        int startBit = s.startBit;
-        
-        if (s.littleEndian) {
-            // Little endian (Intel format)
-            for (int i = 0; i < s.length; i++) {
-                int byteIndex = startBit / 8;
-                int bitIndex = startBit % 8;
-                
-                if (byteIndex < msg.length) {
-                    // Set or clear bit
-                    if (intValue & (1ULL << i)) {
-                        frameData[byteIndex] |= (1 << bitIndex);
-                    } else {
-                        frameData[byteIndex] &= ~(1 << bitIndex);
-                    }
-                }
-                
-                startBit++;
-            }
-        } else {
-            // Big endian (Motorola format)
-            int msb = startBit;
-            for (int i = 0; i < s.length; i++) {
-                int byteIndex = msb / 8;
-                int bitIndex = 7 - (msb % 8);
-                
-                if (byteIndex < msg.length) {
-                    // Set or clear bit
-                    if (intValue & (1ULL << (s.length - 1 - i))) {
-                        frameData[byteIndex] |= (1 << bitIndex);
-                    } else {
-                        frameData[byteIndex] &= ~(1 << bitIndex);
-                    }
-                }
-                
-                // Decrement for Motorola format
-                msb--;
-                if (msb < 0) break;
-            }
-        }
-    }
+    // The frame as it is, with this signal set to the raw value
+    std::vector<uint8_t> frameData = packFrame(selectedMessageIndex);
+    codecFor(selectedMessageIndex).encodeSignal(signalIndex, calculatePhysicalValue(signalName, rawValue), frameData.data());
     
     // Format the frame data as a binary string
-   std::stringstream ss;
+    std::stringstream ss;
     for (size_t i = 0; i < frameData.size(); i++) {
         for (int bit = 7; bit >= 0; bit--) {
             ss << ((frameData[i] & (1 << bit)) ? "1" : "0");
@@ -1122,21 +1085,14 @@ QString DbcParser::getFrameDataBin(const QString &signalName, double rawValue)
     
     return QString::fromStdString(ss.str());
 }
-int DbcParser::getBitIndexInRawValue(int bitPosition, int startBit, bool littleEndian)
+int DbcParser::getBitIndexInRawValue(int bitPosition, int startBit, int length, bool littleEndian)
 {
     if (littleEndian) {
         // For little endian (Intel format), the bit index is the offset from the start bit
         return bitPosition - startBit;
     } else {
-        // For big endian (Motorola format), convert to standard bit numbering
-        int startByteIndex = startBit / 8;
-        int startBitIndex = startBit % 8;
-        
-        // MSB (Most Significant Bit) is the startBit in Motorola format
-        int msb = startByteIndex * 8 + (7 - startBitIndex);
-        
-        // Calculate bit index from MSB (counting down)
-        return msb - bitPosition;
+        // For big endian (Motorola format), count back from the LSB's place in the big-endian run
+        return DbcCodec::motorolaLinear(startBit) + length - 1 - DbcCodec::motorolaLinear(bitPosition);
     }
 }
 QString DbcParser::getModifiedDbcText() const {
@@ -1163,8 +1119,8 @@ QString DbcParser::getModifiedDbcText() const {
                        .arg(msg.length);
 
         for (const auto& sig : msg.signalList) {
-            QString endian = sig.littleEndian ? "1" : "0";
-            msgLines << QString("   SG_ %1 : %2|%3@%4+ (%5,%6) [%7|%8] \"%9\" Vector__XXX")
+            QString endian = QString(sig.littleEndian ? "1" : "0") + (sig.isSigned ? "-" : "+");
+            msgLines << QString("   SG_ %1 : %2|%3@%4 (%5,%6) [%7|%8] \"%9\" Vector__XXX")
                            .arg(QString::fromStdString(sig.name))
                            .arg(sig.startBit)
                            .arg(sig.length)
@@ -1471,11 +1427,9 @@ QVariantMap DbcParser::getStructuredDiff() {
 bool DbcParser::addMessage(const QString &name, unsigned long id, int length)
 {
     // Check if message with same name or ID already exists
-    for (const auto& msg : messages) {
-        if (QString::fromStdString(msg.name) == name || msg.id == id) {
-            qWarning() << "Message with name" << name << "or ID" << id << "already exists";
-            return false;
-        }
+    if (findMessage(name) >= 0 || findMessageById(id) >= 0) {
+        qWarning() << "Message with name" << name << "or ID" << id << "already exists";
+        return false;
     }
 
     // Create new message
@@ -1487,6 +1441,7 @@ bool DbcParser::addMessage(const QString &name, unsigned long id, int length)
 
     // Add to messages vector
     messages.push_back(newMessage);
+    indexMessage(static_cast<int>(messages.size()) - 1);
 
     // Notify QML
     emit messageModelChanged();
@@ -1496,22 +1451,35 @@ bool DbcParser::addMessage(const QString &name, unsigned long id, int length)
 
 bool DbcParser::removeMessage(const QString &messageName)
 {
-    for (auto it = messages.begin(); it != messages.end(); ++it) {
-        if (QString::fromStdString(it->name) == messageName) {
-            // If this message is currently selected, reset selection
-            if (selectedMessageIndex == std::distance(messages.begin(), it)) {
-                selectedMessageIndex = -1;
-                emit signalModelChanged();
-            }
+    int messageIndex = findMessage(messageName);
+    if (messageIndex < 0) {
+        return false;
+    }
 
-            messages.erase(it);
-            emit messageModelChanged();
-            emit generatedCanFrameChanged();
-            return true;
-        }
+    // If this message is currently selected, reset selection
+    bool wasSelected = selectedMessageIndex == messageIndex;
+    if (wasSelected) {
+        selectedMessageIndex = -1;
+    } else if (selectedMessageIndex > messageIndex) {
+        selectedMessageIndex--; // Same message, one place up
     }
 
-    return false;
+    // The shown message is only affected if it is this one or moves up
+    bool shownMoves = m_signalList->messageIndex() >= messageIndex;
+    if (shownMoves) {
+        m_signalList->beginResetTable();
+    }
+    messages.erase(messages.begin() + messageIndex);
+    unindexMessage(messageIndex);
+    if (shownMoves) {
+        m_signalList->endResetTable(selectedMessageIndex);
+    }
+    if (wasSelected) {
+        emit signalModelChanged();
+    }
+    emit messageModelChanged();
+    emit generatedCanFrameChanged();
+    return true;
 }
 
 bool DbcParser::addSignal(const QString &messageName, const QString &signalName,
@@ -1520,79 +1488,57 @@ bool DbcParser::addSignal(const QString &messageName, const QString &signalName,
                           const QString &unit)
 {
     // Find the message
-    for (auto& msg : messages) {
-        if (QString::fromStdString(msg.name) == messageName) {
-            // Check if signal with same name already exists in this message
-            for (const auto& sig : msg.signalList) {
-                if (QString::fromStdString(sig.name) == signalName) {
-                    qWarning() << "Signal" << signalName << "already exists in message" << messageName;
-                    return false;
-                }
-            }
+    int messageIndex = findMessage(messageName);
+    if (messageIndex >= 0) {
+        auto& msg = messages[messageIndex];
+        // Check if signal with same name already exists in this message
+        if (findSignalIndex(messageIndex, signalName) >= 0) {
+            qWarning() << "Signal" << signalName << "already exists in message" << messageName;
+            return false;
+        }
 
-            // Check if bits would overlap with existing signals
-            for (const auto& sig : msg.signalList) {
-                bool overlap = false;
-                
-                if (littleEndian && sig.littleEndian) {
-                    // Both little endian
-                    int newEndBit = startBit + length - 1;
-                    int existingEndBit = sig.startBit + sig.length - 1;
-                    overlap = !(newEndBit < sig.startBit || startBit > existingEndBit);
-                }
-                else if (!littleEndian && !sig.littleEndian) {
-                    // Both big endian (Motorola format)
-                    // For Motorola, startBit is MSB, need to calculate bit ranges
-                    int newMsb = startBit;
-                    int newLsb = getMotorolaLsb(startBit, length);
-                    int existingMsb = sig.startBit;
-                    int existingLsb = getMotorolaLsb(sig.startBit, sig.length);
-                    
-                    overlap = !(newLsb > existingMsb || newMsb < existingLsb);
-                }
-                else {
-                    // Mixed endianness - convert to absolute bit positions for comparison
-                    std::set<int> newBits = getSignalBitPositions(startBit, length, littleEndian);
-                    std::set<int> existingBits = getSignalBitPositions(sig.startBit, sig.length, sig.littleEndian);
-                    
-                    // Check for intersection
-                    for (int bit : newBits) {
-                        if (existingBits.count(bit) > 0) {
-                            overlap = true;
-                            break;
-                        }
-                    }
-                }
-                
-                if (overlap) {
-                    qWarning() << "Signal bits would overlap with existing signal" << QString::fromStdString(sig.name);
-                    return false;
-                }
-            }
+        // Check if bits would overlap with existing signals
+        int overlapping = layoutFor(messageIndex).firstOverlap(DbcLayout::signalBits(startBit, length, littleEndian));
+        if (overlapping >= 0) {
+            qWarning() << "Signal bits would overlap with existing signal"
+                       << QString::fromStdString(msg.signalList[overlapping].name);
+            return false;
+        }
 
-            // Create new signal
-            canSignal newSignal;
-            newSignal.name = signalName.toStdString();
-            newSignal.startBit = startBit;
-            newSignal.length = length;
-            newSignal.littleEndian = littleEndian;
-            newSignal.factor = factor;
-            newSignal.offset = offset;
-            newSignal.min = min;
-            newSignal.max = max;
-            newSignal.unit = unit.toStdString();
-            newSignal.value = 0.0; // Initialize with default value
-
-            // Add to signal list
-            msg.signalList.push_back(newSignal);
-
-            // Always emit signal model changed if we're adding to any message
-            // This ensures the UI updates properly
-            emit signalModelChanged();
-            emit generatedCanFrameChanged();
+        // Create new signal
+        canSignal newSignal;
+        newSignal.name = signalName.toStdString();
+        newSignal.startBit = startBit;
+        newSignal.length = length;
+        newSignal.littleEndian = littleEndian;
+        newSignal.factor = factor;
+        newSignal.offset = offset;
+        newSignal.min = min;
+        newSignal.max = max;
+        newSignal.unit = unit.toStdString();
+        newSignal.value = 0.0; // Initialize with default value
 
-            return true;
+        // Add to signal list
+        bool shown = messageIndex == selectedMessageIndex;
+        if (shown) {
+            m_signalList->beginInsertSignal(static_cast<int>(msg.signalList.size()));
+        }
+        msg.signalList.push_back(newSignal);
+        m_signalIndex[messageIndex].insert(signalName, static_cast<int>(msg.signalList.size()) - 1);
+        m_codecs[messageIndex].reset();
+        if (m_layouts[messageIndex]) {
+            m_layouts[messageIndex]->add(newSignal);
+        }
+        if (shown) {
+            m_signalList->endInsertSignal();
         }
+
+        // Always emit signal model changed if we're adding to any message
+        // This ensures the UI updates properly
+        emit signalModelChanged();
+        emit generatedCanFrameChanged();
+
+        return true;
     }
 
     qWarning() << "Message" << messageName << "not found";
@@ -1601,27 +1547,30 @@ bool DbcParser::addSignal(const QString &messageName, const QString &signalName,
 
 bool DbcParser::removeSignal(const QString &messageName, const QString &signalName)
 {
-    for (auto& msg : messages) {
-        if (QString::fromStdString(msg.name) == messageName) {
-            for (auto it = msg.signalList.begin(); it != msg.signalList.end(); ++it) {
-                if (QString::fromStdString(it->name) == signalName) {
-                    msg.signalList.erase(it);
-
-                    // If this message is currently selected, update the signal model
-                    if (selectedMessageIndex >= 0 &&
-                        selectedMessageIndex < static_cast<int>(messages.size()) &&
-                        QString::fromStdString(messages[selectedMessageIndex].name) == messageName) {
-                        emit signalModelChanged();
-                        emit generatedCanFrameChanged();
-                    }
+    int messageIndex = findMessage(messageName);
+    int signalIndex = findSignalIndex(messageIndex, signalName);
+    if (signalIndex < 0) {
+        return false;
+    }
 
-                    return true;
-                }
-            }
-        }
+    bool shown = messageIndex == selectedMessageIndex;
+    if (shown) {
+        m_signalList->beginRemoveSignal(signalIndex);
+    }
+    auto& signalList = messages[messageIndex].signalList;
+    signalList.erase(signalList.begin() + signalIndex);
+    indexSignals(messageIndex);
+    if (shown) {
+        m_signalList->endRemoveSignal();
     }
 
-    return false;
+    // If this message is currently selected, update the signal model
+    if (selectedMessageIndex == messageIndex) {
+        emit signalModelChanged();
+        emit generatedCanFrameChanged();
+    }
+
+    return true;
 }
 
 bool DbcParser::messageExists(const QString &messageName)
@@ -1630,26 +1579,12 @@ bool DbcParser::messageExists(const QString &messageName)
     int parenthesisPos = messageName.indexOf(" (");
     QString cleanMessageName = parenthesisPos > 0 ? messageName.left(parenthesisPos) : messageName;
     
-    for (const auto& msg : messages) {
-        if (QString::fromStdString(msg.name) == cleanMessageName) {
-            return true;
-        }
-    }
-    return false;
+    return findMessage(cleanMessageName) >= 0;
 }
 
 bool DbcParser::signalExists(const QString &messageName, const QString &signalName)
 {
-    for (const auto& msg : messages) {
-        if (QString::fromStdString(msg.name) == messageName) {
-            for (const auto& sig : msg.signalList) {
-                if (QString::fromStdString(sig.name) == signalName) {
-                    return true;
-                }
-            }
-        }
-    }
-    return false;
+    return findSignalIndex(findMessage(messageName), signalName) >= 0;
 }
 bool DbcParser::isValidMessageId(unsigned long id)
 {
@@ -1661,35 +1596,16 @@ bool DbcParser::isValidMessageId(unsigned long id)
     }
 
     // Check if ID is already in use
-    for (const auto& msg : messages) {
-        if (msg.id == id) {
-            return false;
-        }
-    }
-
-    return true;
+    return findMessageById(id) < 0;
 }
 
 bool DbcParser::isValidSignalPosition(const QString &messageName, int startBit, int length, bool littleEndian)
 {
     // Find the message
-    for (const auto& msg : messages) {
-        if (QString::fromStdString(msg.name) == messageName) {
-            // Check if signal fits within message length
-            if (littleEndian) {
-                if ((startBit + length) > (msg.length * 8)) {
-                    return false;
-                }
-            } else {
-                // For big endian, need different calculation
-                int byteIndex = startBit / 8;
-                if (byteIndex >= msg.length) {
-                    return false;
-                }
-            }
-
-            return true;
-        }
+    int messageIndex = findMessage(messageName);
+    if (messageIndex >= 0) {
+        // Check if signal fits within message length
+        return DbcLayout::fits(startBit, length, littleEndian, messages[messageIndex].length * 8);
     }
 
     return false;
@@ -1704,10 +1620,8 @@ QString DbcParser::validateMessageData(const QString &name, unsigned long id, in
     }
     
     // Check if name already exists
-    for (const auto& msg : messages) {
-        if (QString::fromStdString(msg.name) == name) {
-            return "Message name '" + name + "' already exists";
-        }
+    if (findMessage(name) >= 0) {
+        return "Message name '" + name + "' already exists";
     }
     
     // Check ID range
@@ -1716,10 +1630,9 @@ QString DbcParser::validateMessageData(const QString &name, unsigned long id, in
     }
     
     // Check if ID already exists
-    for (const auto& msg : messages) {
-        if (msg.id == id) {
-            return "Message ID 0x" + QString::number(id, 16).toUpper() + " already exists in message '" + QString::fromStdString(msg.name) + "'";
-        }
+    int sameId = findMessageById(id);
+    if (sameId >= 0) {
+        return "Message ID 0x" + QString::number(id, 16).toUpper() + " already exists in message '" + QString::fromStdString(messages[sameId].name) + "'";
     }
     
     // Check length
@@ -1745,24 +1658,16 @@ QString DbcParser::validateSignalData(const QString &messageName, const QString
     }
     
     // Find the message
-    const canMessage* targetMessage = nullptr;
-    for (const auto& msg : messages) {
-        if (QString::fromStdString(msg.name) == messageName) {
-            targetMessage = &msg;
-            break;
-        }
-    }
-    
-    if (!targetMessage) {
+    int messageIndex = findMessage(messageName);
+    if (messageIndex < 0) {
         return "Message '" + messageName + "' not found";
     }
+    const canMessage* targetMessage = &messages[messageIndex];
     
     // Check if signal name already exists in this message (exclude the signal being edited)
     if (excludeSignal.isEmpty() || signalName != excludeSignal) {
-        for (const auto& sig : targetMessage->signalList) {
-            if (QString::fromStdString(sig.name) == signalName) {
-                return "Signal name '" + signalName + "' already exists in message '" + messageName + "'";
-            }
+        if (findSignalIndex(messageIndex, signalName) >= 0) {
+            return "Signal name '" + signalName + "' already exists in message '" + messageName + "'";
         }
     }
     
@@ -1777,62 +1682,22 @@ QString DbcParser::validateSignalData(const QString &messageName, const QString
             return "Signal extends beyond message boundary (bit " + QString::number(startBit + length - 1) + " > " + QString::number(targetMessage->length * 8 - 1) + ")";
         }
     } else {
-        // For Motorola format, startBit is MSB
+        // For Motorola format, startBit is MSB and the signal runs on towards the end of the frame
         int byteIndex = startBit / 8;
-        if (byteIndex >= targetMessage->length) {
+        if (startBit < 0 || byteIndex >= targetMessage->length) {
             return "Signal start bit is beyond message boundary";
         }
-        
-        // Check if signal extends below bit 0
-        int lsb = getMotorolaLsb(startBit, length);
-        if (lsb < 0) {
-            return "Signal extends below bit 0 in Motorola format";
+        if (!DbcLayout::fits(startBit, length, littleEndian, targetMessage->length * 8)) {
+            return "Signal extends beyond message boundary in Motorola format";
         }
     }
     
     // Check for overlaps with existing signals (exclude the signal being edited)
-    for (const auto& sig : targetMessage->signalList) {
-        QString conflictingSignal = QString::fromStdString(sig.name);
-        
-        // Skip the signal being edited
-        if (!excludeSignal.isEmpty() && conflictingSignal == excludeSignal) {
-            continue;
-        }
-        
-        bool overlap = false;
-        
-        if (littleEndian && sig.littleEndian) {
-            // Both little endian
-            int newEndBit = startBit + length - 1;
-            int existingEndBit = sig.startBit + sig.length - 1;
-            overlap = !(newEndBit < sig.startBit || startBit > existingEndBit);
-        }
-        else if (!littleEndian && !sig.littleEndian) {
-            // Both big endian
-            int newMsb = startBit;
-            int newLsb = getMotorolaLsb(startBit, length);
-            int existingMsb = sig.startBit;
-            int existingLsb = getMotorolaLsb(sig.startBit, sig.length);
-            
-            overlap = !(newLsb > existingMsb || newMsb < existingLsb);
-        }
-        else {
-            // Mixed endianness - use bit position sets
-            std::set<int> newBits = getSignalBitPositions(startBit, length, littleEndian);
-            std::set<int> existingBits = getSignalBitPositions(sig.startBit, sig.length, sig.littleEndian);
-            
-            // Check for intersection
-            for (int bit : newBits) {
-                if (existingBits.count(bit) > 0) {
-                    overlap = true;
-                    break;
-                }
-            }
-        }
-        
-        if (overlap) {
-            return "Signal bits overlap with existing signal '" + conflictingSignal + "' (start bit " + QString::number(sig.startBit) + ", length " + QString::number(sig.length) + ")";
-        }
+    int excluded = excludeSignal.isEmpty() ? -1 : findSignalIndex(messageIndex, excludeSignal);
+    int overlapping = layoutFor(messageIndex).firstOverlap(DbcLayout::signalBits(startBit, length, littleEndian), excluded);
+    if (overlapping >= 0) {
+        const canSignal& sig = targetMessage->signalList[overlapping];
+        return "Signal bits overlap with existing signal '" + QString::fromStdString(sig.name) + "' (start bit " + QString::number(sig.startBit) + ", length " + QString::number(sig.length) + ")";
     }
     
     return ""; // No errors
@@ -1840,45 +1705,9 @@ QString DbcParser::validateSignalData(const QString &messageName, const QString
 
 bool DbcParser::checkSignalOverlap(const QString &messageName, int startBit, int length, bool littleEndian)
 {
-    for (const auto& msg : messages) {
-        if (QString::fromStdString(msg.name) == messageName) {
-            for (const auto& sig : msg.signalList) {
-                bool overlap = false;
-                
-                if (littleEndian && sig.littleEndian) {
-                    // Both little endian
-                    int newEndBit = startBit + length - 1;
-                    int existingEndBit = sig.startBit + sig.length - 1;
-                    overlap = !(newEndBit < sig.startBit || startBit > existingEndBit);
-                }
-                else if (!littleEndian && !sig.littleEndian) {
-                    // Both big endian
-                    int newMsb = startBit;
-                    int newLsb = getMotorolaLsb(startBit, length);
-                    int existingMsb = sig.startBit;
-                    int existingLsb = getMotorolaLsb(sig.startBit, sig.length);
-                    
-                    overlap = !(newLsb > existingMsb || newMsb < existingLsb);
-                }
-                else {
-                    // Mixed endianness
-                    std::set<int> newBits = getSignalBitPositions(startBit, length, littleEndian);
-                    std::set<int> existingBits = getSignalBitPositions(sig.startBit, sig.length, sig.littleEndian);
-                    
-                    for (int bit : newBits) {
-                        if (existingBits.count(bit) > 0) {
-                            overlap = true;
-                            break;
-                        }
-                    }
-                }
-                
-                if (overlap) {
-                    return true;
-                }
-            }
-            break;
-        }
+    int messageIndex = findMessage(messageName);
+    if (messageIndex >= 0) {
+        return layoutFor(messageIndex).overlaps(DbcLayout::signalBits(startBit, length, littleEndian));
     }
     return false;
 }
@@ -1886,160 +1715,44 @@ bool DbcParser::checkSignalOverlap(const QString &messageName, int startBit, int
 int DbcParser::getNextAvailableStartBit(const QString &messageName, int length)
 {
     // Find the message
-    const canMessage* targetMessage = nullptr;
-    for (const auto& msg : messages) {
-        if (QString::fromStdString(msg.name) == messageName) {
-            targetMessage = &msg;
-            break;
-        }
-    }
-    
-    if (!targetMessage) {
+    int messageIndex = findMessage(messageName);
+    if (messageIndex < 0) {
         qWarning() << "Message not found:" << messageName;
         return 0; // Default to start bit 0 if message not found
     }
     
-    int maxBits = targetMessage->length * 8; // Total bits in message
-    
-    // Try each possible start bit position
-    for (int startBit = 0; startBit <= maxBits - length; startBit++) {
-        bool hasOverlap = false;
-        
-        // Check against all existing signals
-        for (const auto& sig : targetMessage->signalList) {
-            bool overlap = false;
-            
-            // Assume little endian for simplicity in auto-assignment
-            int newEndBit = startBit + length - 1;
-            int existingEndBit = sig.startBit + sig.length - 1;
-            
-            if (sig.littleEndian) {
-                // Both little endian
-                overlap = !(newEndBit < sig.startBit || startBit > existingEndBit);
-            } else {
-                // Mixed endianness - use bit position sets for accuracy
-                std::set<int> newBits = getSignalBitPositions(startBit, length, true); // Assume little endian for new signal
-                std::set<int> existingBits = getSignalBitPositions(sig.startBit, sig.length, sig.littleEndian);
-                
-                // Check for intersection
-                for (int bit : newBits) {
-                    if (existingBits.count(bit) > 0) {
-                        overlap = true;
-                        break;
-                    }
-                }
-            }
-            
-            if (overlap) {
-                hasOverlap = true;
-                break;
-            }
-        }
-        
-        if (!hasOverlap) {
-            return startBit; // Found an available position
-        }
+    // The first run of free bits long enough for a little endian signal
+    int startBit = layoutFor(messageIndex).firstFree(length, messages[messageIndex].length * 8);
+    if (startBit < 0) {
+        qWarning() << "No available start bit position found for message" << messageName << "with length" << length;
     }
-    
-    // No available position found
-    qWarning() << "No available start bit position found for message" << messageName << "with length" << length;
-    return -1;
+    return startBit;
 }
 
 bool DbcParser::isBitOccupied(const QString &messageName, int bitIndex)
 {
     // Find the message
-    const canMessage* targetMessage = nullptr;
-    for (const auto& msg : messages) {
-        if (QString::fromStdString(msg.name) == messageName) {
-            targetMessage = &msg;
-            break;
-        }
-    }
-    
-    if (!targetMessage) {
+    int messageIndex = findMessage(messageName);
+    if (messageIndex < 0) {
         return false;
     }
     
-    // Check if this bit is occupied by any existing signal
-    for (const auto& sig : targetMessage->signalList) {
-        std::set<int> signalBits = getSignalBitPositions(sig.startBit, sig.length, sig.littleEndian);
-        
-        if (signalBits.count(bitIndex) > 0) {
-            return true;
-        }
-    }
-    
-    return false;
+    return layoutFor(messageIndex).occupied(bitIndex);
 }
 
 QString DbcParser::getBitOccupiedBy(const QString &messageName, int bitIndex)
 {
     // Find the message
-    const canMessage* targetMessage = nullptr;
-    for (const auto& msg : messages) {
-        if (QString::fromStdString(msg.name) == messageName) {
-            targetMessage = &msg;
-            break;
-        }
-    }
-    
-    if (!targetMessage) {
+    int messageIndex = findMessage(messageName);
+    if (messageIndex < 0) {
         return "";
     }
     
     // Find which signal occupies this bit
-    for (const auto& sig : targetMessage->signalList) {
-        std::set<int> signalBits = getSignalBitPositions(sig.startBit, sig.length, sig.littleEndian);
-        
-        if (signalBits.count(bitIndex) > 0) {
-            return QString::fromStdString(sig.name);
-        }
-    }
-    
-    return "";
-}
-
-// Helper function to calculate LSB for Motorola format
-int DbcParser::getMotorolaLsb(int msb, int length)
-{
-    int msbByte = msb / 8;
-    int msbBitInByte = msb % 8;
-    
-    // Calculate absolute MSB position
-    int absoluteMsb = msbByte * 8 + (7 - msbBitInByte);
-    
-    // LSB is length-1 bits away
-    int absoluteLsb = absoluteMsb - (length - 1);
-    
-    return absoluteLsb;
+    int owner = layoutFor(messageIndex).owner(bitIndex);
+    return owner >= 0 ? QString::fromStdString(messages[messageIndex].signalList[owner].name) : QString();
 }
 
-// Helper function to get all bit positions occupied by a signal
-std::set<int> DbcParser::getSignalBitPositions(int startBit, int length, bool littleEndian)
-{
-    std::set<int> bitPositions;
-    
-    if (littleEndian) {
-        // Intel format: consecutive bits from startBit
-        for (int i = 0; i < length; i++) {
-            bitPositions.insert(startBit + i);
-        }
-    } else {
-        // Motorola format: startBit is MSB
-        int msb = startBit;
-        for (int i = 0; i < length; i++) {
-            int byteIndex = msb / 8;
-            int bitIndex = msb % 8;
-            int absolutePosition = byteIndex * 8 + (7 - bitIndex);
-            bitPositions.insert(absolutePosition);
-            msb--;
-            if (msb < 0) break;
-        }
-    }
-    
-    return bitPositions;
-}
 // Add these method implementations to your DbcParser.cpp file:
 
 QString DbcParser::prepareCanMessage(const QString &messageName, int rateMs)
@@ -2052,27 +1765,27 @@ QString DbcParser::prepareCanMessage(const QString &messageName, int rateMs)
     
     qDebug() << "Extracted message name:" << name;
 
-    for (const auto& msg : messages) {
-        if (QString::fromStdString(msg.name) == name) {
-            // Get the message ID
-            unsigned long canId = msg.id;
+    int messageIndex = findMessage(name);
+    if (messageIndex >= 0) {
+        const auto& msg = messages[messageIndex];
+        // Get the message ID
+        unsigned long canId = msg.id;
 
-            // Generate the hex data for this message
-            QString hexData = getMessageHexData(messageName);
+        // Generate the hex data for this message
+        QString hexData = getMessageHexData(messageName);
 
-            // New format: "canid#canmessage#rate#canbus"
-            // Remove spaces from hexData and format as continuous hex string
-            QString cleanHexData = hexData;
-            cleanHexData.remove(" ");
-            
-            QString result = QString("%1#%2#%3#vcan0").arg(canId, 0, 16, QChar('0')).arg(cleanHexData).arg(rateMs);
-            qDebug() << "Prepared message:" << result;
-            qDebug() << "  - CAN ID:" << QString::number(canId, 16);
-            qDebug() << "  - Hex Data:" << cleanHexData;
-            qDebug() << "  - Rate:" << rateMs;
-            
-            return result;
-        }
+        // New format: "canid#canmessage#rate#canbus"
+        // Remove spaces from hexData and format as continuous hex string
+        QString cleanHexData = hexData;
+        cleanHexData.remove(" ");
+        
+        QString result = QString("%1#%2#%3#vcan0").arg(canId, 0, 16, QChar('0')).arg(cleanHexData).arg(rateMs);
+        qDebug() << "Prepared message:" << result;
+        qDebug() << "  - CAN ID:" << QString::number(canId, 16);
+        qDebug() << "  - Hex Data:" << cleanHexData;
+        qDebug() << "  - Rate:" << rateMs;
+        
+        return result;
     }
 
     qDebug() << "Message not found:" << name;
@@ -2089,30 +1802,30 @@ QString DbcParser::prepareCanMessage(const QString &messageName, int rateMs, con
     
     qDebug() << "Extracted message name:" << name;
 
-    for (const auto& msg : messages) {
-        if (QString::fromStdString(msg.name) == name) {
-            // Get the message ID
-            unsigned long canId = msg.id;
+    int messageIndex = findMessage(name);
+    if (messageIndex >= 0) {
+        const auto& msg = messages[messageIndex];
+        // Get the message ID
+        unsigned long canId = msg.id;
 
-            // Generate the hex data for this message
-            QString hexData = getMessageHexData(messageName);
+        // Generate the hex data for this message
+        QString hexData = getMessageHexData(messageName);
 
-            // New format: "canid#canmessage#rate#canbus"
-            // Remove spaces from hexData and format as continuous hex string
-            QString cleanHexData = hexData;
-            cleanHexData.remove(" ");
-            
-            // Use the provided CAN bus instead of hardcoded "vcan0"
-            QString busToUse = canBus.isEmpty() ? "vcan0" : canBus;
-            QString result = QString("%1#%2#%3#%4").arg(canId, 0, 16, QChar('0')).arg(cleanHexData).arg(rateMs).arg(busToUse);
-            qDebug() << "Prepared message:" << result;
-            qDebug() << "  - CAN ID:" << QString::number(canId, 16);
-            qDebug() << "  - Hex Data:" << cleanHexData;
-            qDebug() << "  - Rate:" << rateMs;
-            qDebug() << "  - CAN Bus:" << busToUse;
-            
-            return result;
-        }
+        // New format: "canid#canmessage#rate#canbus"
+        // Remove spaces from hexData and format as continuous hex string
+        QString cleanHexData = hexData;
+        cleanHexData.remove(" ");
+        
+        // Use the provided CAN bus instead of hardcoded "vcan0"
+        QString busToUse = canBus.isEmpty() ? "vcan0" : canBus;
+        QString result = QString("%1#%2#%3#%4").arg(canId, 0, 16, QChar('0')).arg(cleanHexData).arg(rateMs).arg(busToUse);
+        qDebug() << "Prepared message:" << result;
+        qDebug() << "  - CAN ID:" << QString::number(canId, 16);
+        qDebug() << "  - Hex Data:" << cleanHexData;
+        qDebug() << "  - Rate:" << rateMs;
+        qDebug() << "  - CAN Bus:" << busToUse;
+        
+        return result;
     }
 
     qDebug() << "Message not found:" << name;
@@ -2126,58 +1839,15 @@ QString DbcParser::getMessageHexData(const QString &messageName)
     QString name = parenthesisPos > 0 ? messageName.left(parenthesisPos) : messageName;
 
     // Find the message index
-    int messageIndex = -1;
-    for (int i = 0; i < static_cast<int>(messages.size()); ++i) {
-        if (QString::fromStdString(messages[i].name) == name) {
-            messageIndex = i;
-            break;
-        }
-    }
+    int messageIndex = findMessage(name);
 
     if (messageIndex == -1) {
         qWarning() << "Message not found:" << name;
         return QString("00 00 00 00 00 00 00 00");
     }
 
-    const auto& msg = messages[messageIndex];
-    
-    // Create a buffer of zeros for the CAN frame data
-    std::vector<uint8_t> frameData(msg.length, 0);
-
     // Pack the signal values into the frame data
-    for (const auto& signal : msg.signalList) {
-        if (signal.value == 0.0) continue; // Skip zero values for efficiency
-
-        // Calculate raw value from physical value
-        double rawValue = (signal.value - signal.offset) / signal.factor;
-        uint64_t intValue = static_cast<uint64_t>(std::round(rawValue));
-
-        // Ensure the value fits within the signal's bit length
-        uint64_t maxValue = (1ULL << signal.length) - 1;
-        if (intValue > maxValue) {
-            intValue = maxValue;
-        }
-
-        // Pack the bits into the frame data
-        for (int bit = 0; bit < signal.length; ++bit) {
-            int bitPosition;
-            if (signal.littleEndian) {
-                bitPosition = signal.startBit + bit;
-            } else {
-                // Motorola (big-endian) bit ordering
-                bitPosition = signal.startBit - bit;
-            }
-
-            int byteIndex = bitPosition / 8;
-            int bitInByte = bitPosition % 8;
-
-            if (byteIndex >= 0 && byteIndex < static_cast<int>(frameData.size())) {
-                if (intValue & (1ULL << bit)) {
-                    frameData[byteIndex] |= (1 << bitInByte);
-                }
-            }
-        }
-    }
+    std::vector<uint8_t> frameData = packFrame(messageIndex);
 
     // Convert to hex string
     QStringList hexBytes;
@@ -2194,13 +1864,8 @@ unsigned long DbcParser::getMessageId(const QString &messageName)
     int parenthesisPos = messageName.indexOf(" (");
     QString name = parenthesisPos > 0 ? messageName.left(parenthesisPos) : messageName;
 
-    for (const auto& msg : messages) {
-        if (QString::fromStdString(msg.name) == name) {
-            return msg.id;
-        }
-    }
-
-    return 0;
+    int messageIndex = findMessage(name);
+    return messageIndex >= 0 ? messages[messageIndex].id : 0;
 }
 
 bool DbcParser::sendCanMessage(const QString &messageName, int rateMs)
@@ -2228,39 +1893,31 @@ bool DbcParser::sendCanMessage(const QString &messageName, int rateMs)
     // Emit starting status
     emit messageSendStatus(messageName, true, "Sending message...");
 
-    // Send the message via DbcSender
-    qint8 result = dbcSender->sendCANMessage(messageData);
-    
-    if (result == 0) {
-        qDebug() << "Successfully sent CAN message:" << messageData;
-        
-        // Get the task ID from the server response
-        QString taskId = dbcSender->getLastTaskId();
-        
-        // Add this transmission to active transmissions
-        addActiveTransmission(messageName, rateMs, taskId);
-        
-        emit messageSendStatus(messageName, true, "Message sent successfully!");
-        return true;
-    } else if (result == 2) {
-        // Error code 2 is typically a timeout waiting for acknowledgment
-        // The message was likely sent successfully but no response received
-        qDebug() << "Message sent but no acknowledgment received:" << messageData;
-        
-        // Get the task ID from the server response
-        QString taskId = dbcSender->getLastTaskId();
-        
-        // Still add to active transmissions since it was likely sent
-        addActiveTransmission(messageName, rateMs, taskId);
-        
-        emit messageSendStatus(messageName, true, "Message transmitted (no acknowledgment received)");
-        return true; // Consider this a success since message was transmitted
-    } else {
-        QString errorMsg = QString("Send failed with error code: %1").arg(result);
-        qWarning() << "Failed to send CAN message. Error code:" << result;
-        emit messageSendStatus(messageName, false, errorMsg);
-        return false;
-    }
+    // Send the message via DbcSender; the outcome comes with the reply
+    dbcSender->sendCANMessage(messageData).then(this, [this, messageName, rateMs, messageData](const SendResult &result) {
+        if (result.status == 0) {
+            qDebug() << "Successfully sent CAN message:" << messageData;
+
+            // Add this transmission to active transmissions, with the task ID from the server response
+            addActiveTransmission(messageName, rateMs, result.taskId);
+
+            emit messageSendStatus(messageName, true, "Message sent successfully!");
+        } else if (result.status == 2) {
+            // Error code 2 is typically a timeout waiting for acknowledgment
+            // The message was likely sent successfully but no response received
+            qDebug() << "Message sent but no acknowledgment received:" << messageData;
+
+            // Still add to active transmissions since it was likely sent
+            addActiveTransmission(messageName, rateMs, result.taskId);
+
+            emit messageSendStatus(messageName, true, "Message transmitted (no acknowledgment received)");
+        } else {
+            QString errorMsg = QString("Send failed with error code: %1").arg(result.status);
+            qWarning() << "Failed to send CAN message. Error code:" << result.status;
+            emit messageSendStatus(messageName, false, errorMsg);
+        }
+    });
+    return true;
 }
 
 bool DbcParser::sendCanMessage(const QString &messageName, int rateMs, const QString &canBus)
@@ -2273,18 +1930,20 @@ bool DbcParser::sendCanMessage(const QString &messageName, int rateMs, const QSt
 }
 
 bool DbcParser::sendCanMessageOnce(const QString &messageName, const QString &canBus)
-{
-    qDebug() << "Send CAN message once called for:" << messageName << "on bus:" << canBus;
-    
-    // Check if we have a dbcSender instance
-    if (!dbcSender) {
-        qWarning() << "DbcSender not initialized";
-        emit messageSendStatus(messageName, false, "Error: DbcSender not initialized");
+{
+    qDebug() << "Send CAN message once called for:" << messageName << "on bus:" << canBus;
+    
+    // Check if we have a connection for this bus
+    QString bus;
+    DbcSender *sender = senderForBus(canBus, &bus);
+    if (!sender) {
+        qWarning() << "No server for bus" << canBus;
+        emit messageSendStatus(messageName, false, "Error: Unknown server for bus " + canBus);
         return false;
     }
 
     // Check if connected to server
-    if (!dbcSender->isConnected()) {
+    if (!sender->isConnected()) {
         qDebug() << "Error: Not connected to server";
         emit messageSendStatus(messageName, false, "Error: Not connected to server");
         return false;
@@ -2292,7 +1951,7 @@ bool DbcParser::sendCanMessageOnce(const QString &messageName, const QString &ca
 
     // Prepare the CAN message for one-shot sending
     // Use rate 0 since it's a one-shot message
-    QString messageData = prepareCanMessage(messageName, 0, canBus);
+    QString messageData = prepareCanMessage(messageName, 0, bus);
     if (messageData.isEmpty()) {
         qWarning() << "Failed to prepare one-shot message:" << messageName;
         emit messageSendStatus(messageName, false, "Error: Failed to prepare message");
@@ -2302,65 +1961,39 @@ bool DbcParser::sendCanMessageOnce(const QString &messageName, const QString &ca
     // Emit starting status
     emit messageSendStatus(messageName, true, "Sending message once...");
 
-    // Send the one-shot message via DbcSender using the new sendOneShotMessage method
-    qint8 result = dbcSender->sendOneShotMessage(messageData, 0); // 0ms delay
-    
-    if (result == 0) {
-        qDebug() << "Successfully sent one-shot CAN message:" << messageData;
-        
-        // Get the task ID from the server response (for logging/debugging)
-        QString taskId = dbcSender->getLastTaskId();
-        qDebug() << "One-shot message task ID:" << taskId;
-        
-        // Add to one-shot message history
-        OneShotMessage oneShotMsg;
-        oneShotMsg.messageName = messageName;
-        oneShotMsg.messageId = getMessageId(messageName);
-        oneShotMsg.hexData = getMessageHexData(messageName);
-        oneShotMsg.sentAt = QDateTime::currentDateTime();
-        oneShotMsg.canBus = canBus.isEmpty() ? "vcan0" : canBus;
-        
-        // Add to beginning of list (most recent first)
-        m_oneShotMessages.prepend(oneShotMsg);
-        
-        // Limit history to 50 messages
-        if (m_oneShotMessages.size() > 50) {
-            m_oneShotMessages.removeLast();
+    // Send the one-shot message via DbcSender using the new sendOneShotMessage method (0ms delay); the outcome
+    // comes with the reply
+    sender->sendOneShotMessage(messageData, 0).then(this, [this, messageName, canBus, messageData](const SendResult &result) {
+        if (result.status != 0 && result.status != 2) {
+            QString errorMsg = QString("One-shot send failed with error code: %1").arg(result.status);
+            qWarning() << "Failed to send one-shot CAN message. Error code:" << result.status;
+            emit messageSendStatus(messageName, false, errorMsg);
+            return;
         }
-        
-        emit oneShotMessagesChanged();
-        emit messageSendStatus(messageName, true, "Message sent once successfully!");
-        return true;
-    } else if (result == 2) {
         // Error code 2 is typically a timeout waiting for acknowledgment
         // The message was likely sent successfully but no response received
-        qDebug() << "One-shot message sent but no acknowledgment received:" << messageData;
-        
-        // Add to one-shot message history even with no acknowledgment
+        qDebug() << "Sent one-shot CAN message:" << messageData << "task ID:" << result.taskId;
+
+        // Add to one-shot message history
         OneShotMessage oneShotMsg;
         oneShotMsg.messageName = messageName;
         oneShotMsg.messageId = getMessageId(messageName);
         oneShotMsg.hexData = getMessageHexData(messageName);
         oneShotMsg.sentAt = QDateTime::currentDateTime();
         oneShotMsg.canBus = canBus.isEmpty() ? "vcan0" : canBus;
-        
+
         // Add to beginning of list (most recent first)
         m_oneShotMessages.prepend(oneShotMsg);
-        
+
         // Limit history to 50 messages
         if (m_oneShotMessages.size() > 50) {
             m_oneShotMessages.removeLast();
         }
-        
-        emit oneShotMessagesChanged();
-        emit messageSendStatus(messageName, true, "Message sent once (no acknowledgment received)");
-        return true; // Consider this a success since message was transmitted
-    } else {
-        QString errorMsg = QString("One-shot send failed with error code: %1").arg(result);
-        qWarning() << "Failed to send one-shot CAN message. Error code:" << result;
-        emit messageSendStatus(messageName, false, errorMsg);
-        return false;
-    }
+
+        emit messageSendStatus(messageName, true, result.status == 0 ? "Message sent once successfully!"
+                                                                    : "Message sent once (no acknowledgment received)");
+    });
+    return true;
 }
 
 // Start transmission with CAN bus parameter
@@ -2371,37 +2004,70 @@ bool DbcParser::startTransmission(const QString &messageName, int rateMs, const
     // Stop any existing transmission for this message on the same CAN bus only
     stopExistingTransmission(messageName, canBus);
 
-    if (!dbcSender || !dbcSender->isConnected()) {
-        qDebug() << "Error: Not connected to server";
+    // The task goes to the server that owns the bus; the row keeps the full "<node>:<bus>" name
+    QString serverBus;
+    DbcSender *sender = senderForBus(canBus, &serverBus);
+    if (!sender || !sender->isConnected()) {
+        qDebug() << "Error: Not connected to the server for bus" << canBus;
         emit messageSendStatus(messageName, false, "Error: Not connected to server");
         return false;
     }
 
     // Prepare the CAN message with the specified bus
-    QString canMessage = prepareCanMessage(messageName, rateMs, canBus);
+    QString canMessage = prepareCanMessage(messageName, rateMs, serverBus);
     if (canMessage.isEmpty()) {
         qDebug() << "Error: Failed to prepare CAN message";
         emit messageSendStatus(messageName, false, "Error: Failed to prepare CAN message");
         return false;
     }
 
-    // Send the message
-    qint8 result = dbcSender->sendCANMessage(canMessage);
-    if (result == 0) {
-        // Get the task ID from the sender
-        QString taskId = dbcSender->getLastTaskId();
-        
-        // Add to active transmissions
-        addActiveTransmission(messageName, taskId, rateMs, canBus);
-        
-        qDebug() << "Message transmission started successfully with task ID:" << taskId;
-        emit messageSendStatus(messageName, true, "Message transmission started");
-        emit activeTransmissionsChanged();
-        return true;
-    } else {
-        qDebug() << "Error: Failed to send CAN message, error code:" << result;
-        emit messageSendStatus(messageName, false, "Error: Failed to send CAN message");
-        return false;
+    // Queue the request and list the transmission right away; the task ID arrives with the reply, so
+    // starting hundreds of transmissions (a loaded config) never waits on the network
+    addActiveTransmission(messageName, QString(), rateMs, canBus);
+    m_activeTransmissions.modify(m_activeTransmissions.size() - 1, [](ActiveTransmission &transmission) {
+        transmission.status = "Starting";
+    });
+
+    QString bus = m_activeTransmissions.last().canBus;
+    sender->requestAsync("CANSEND#" + canMessage).then(this, [this, messageName, bus](const QString &reply) {
+        transmissionStarted(messageName, bus, reply);
+    });
+    emit messageSendStatus(messageName, true, "Message transmission requested");
+    return true;
+}
+
+// Reply to the CANSEND queued by startTransmission
+void DbcParser::transmissionStarted(const QString &messageName, const QString &canBus, const QString &reply)
+{
+    QRegularExpressionMatch match = QRegularExpression("task_(\\d+)").match(reply);
+    QString taskId = match.hasMatch() ? match.captured(0) : QString();
+
+    for (int i = 0; i < m_activeTransmissions.size(); ++i) {
+        const ActiveTransmission &transmission = m_activeTransmissions[i];
+        if (transmission.messageName != messageName || transmission.canBus != canBus || !transmission.taskId.isEmpty()) {
+            continue;
+        }
+        if (taskId.isEmpty()) {
+            qDebug() << "Error: Failed to start transmission for" << messageName << ":" << reply;
+            addToPastTransmissions(transmission, "Failed");
+            m_activeTransmissions.removeAt(i);
+            emit messageSendStatus(messageName, false, "Error: Failed to send CAN message");
+        } else {
+            m_activeTransmissions.modify(i, [&taskId](ActiveTransmission &started) {
+                started.taskId = taskId;
+                started.status = "Active";
+            });
+            qDebug() << "Message transmission started successfully with task ID:" << taskId;
+            emit messageSendStatus(messageName, true, "Message transmission started");
+        }
+        return;
+    }
+
+    // Stopped before the server answered: the task exists now, so stop it there too
+    DbcSender *sender = senderForBus(canBus);
+    if (!taskId.isEmpty() && sender) {
+        qDebug() << "Transmission" << messageName << "was stopped while starting, killing" << taskId;
+        sender->requestAsync("KILL_TASK " + taskId);
     }
 }
 
@@ -2420,12 +2086,10 @@ void DbcParser::addActiveTransmission(const QString &messageName, const QString
     transmission.canBus = canBus.isEmpty() ? "vcan0" : canBus;
     
     // Get message details
-    for (const auto &msg : messages) {
-        if (QString::fromStdString(msg.name) == messageName) {
-            transmission.messageId = msg.id;
-            transmission.hexData = getMessageHexData(messageName);
-            break;
-        }
+    int messageIndex = findMessage(messageName);
+    if (messageIndex >= 0) {
+        transmission.messageId = messages[messageIndex].id;
+        transmission.hexData = getMessageHexData(messageName);
     }
     
     m_activeTransmissions.append(transmission);
@@ -2434,41 +2098,47 @@ void DbcParser::addActiveTransmission(const QString &messageName, const QString
 
 
 
-// Get available CAN interfaces
-QStringList DbcParser::getAvailableCanInterfaces()
+// Ask for the available CAN interfaces; availableCanInterfacesChanged has them once the servers have answered
+void DbcParser::refreshAvailableCanInterfaces()
 {
     qDebug() << "Getting available CAN interfaces";
     
     if (!dbcSender) {
         qDebug() << "Error: DbcSender not available";
-        return QStringList() << "vcan0"; // Default fallback
-    }
-    
-    QString response = dbcSender->listCanInterfaces();
-    if (response.isEmpty() || response.startsWith("Error:")) {
-        qDebug() << "Error getting CAN interfaces:" << response;
-        return QStringList() << "vcan0"; // Default fallback
+        emit availableCanInterfacesChanged(QStringList() << "vcan0"); // Default fallback
+        return;
     }
     
-    // Parse the response to extract CAN interface names
-    QStringList interfaces;
-    QStringList lines = response.split('\n', Qt::SkipEmptyParts);
-    
-    for (const QString &line : lines) {
-        QString trimmed = line.trimmed();
-        if (!trimmed.isEmpty() && !trimmed.startsWith("Available") && !trimmed.startsWith("CAN")) {
-            // Assume each line contains an interface name
-            interfaces.append(trimmed);
+    // Ours and every other node's are asked at once; the list goes out when the slowest has answered
+    QFuture<QStringList> nodeInterfaces = connections->interfaces();
+    dbcSender->listCanInterfaces().then(this, [this, nodeInterfaces](const QString &response) mutable {
+        QStringList interfaces;
+        if (response.isEmpty() || response.startsWith("Error:")) {
+            qDebug() << "Error getting CAN interfaces:" << response;
+        } else {
+            // Parse the response to extract CAN interface names
+            QStringList lines = response.split('\n', Qt::SkipEmptyParts);
+            for (const QString &line : lines) {
+                QString trimmed = line.trimmed();
+                if (!trimmed.isEmpty() && !trimmed.startsWith("Available") && !trimmed.startsWith("CAN")) {
+                    // Assume each line contains an interface name
+                    interfaces.append(trimmed);
+                }
+            }
         }
-    }
-    
-    if (interfaces.isEmpty()) {
-        qDebug() << "No CAN interfaces found in response, using default";
-        interfaces.append("vcan0");
-    }
-    
-    qDebug() << "Available CAN interfaces:" << interfaces;
-    return interfaces;
+
+        if (interfaces.isEmpty()) {
+            qDebug() << "No CAN interfaces found in response, using default";
+            interfaces.append("vcan0");
+        }
+
+        // Then every other node's, as "<node>:<bus>"
+        nodeInterfaces.then(this, [this, interfaces](const QStringList &qualified) {
+            QStringList all = interfaces + qualified;
+            qDebug() << "Available CAN interfaces:" << all;
+            emit availableCanInterfacesChanged(all);
+        });
+    });
 }
 
 // Unified method to get hex data for the currently selected message
@@ -2478,45 +2148,8 @@ QString DbcParser::getCurrentMessageHexData()
         return QString("00 00 00 00 00 00 00 00");
     }
     
-    const auto& msg = messages[selectedMessageIndex];
-    
-    // Create a buffer of zeros for the CAN frame data
-    std::vector<uint8_t> frameData(msg.length, 0);
-
     // Pack the signal values into the frame data
-    for (const auto& signal : msg.signalList) {
-        if (signal.value == 0.0) continue; // Skip zero values for efficiency
-
-        // Calculate raw value from physical value
-        double rawValue = (signal.value - signal.offset) / signal.factor;
-        uint64_t intValue = static_cast<uint64_t>(std::round(rawValue));
-
-        // Ensure the value fits within the signal's bit length
-        uint64_t maxValue = (1ULL << signal.length) - 1;
-        if (intValue > maxValue) {
-            intValue = maxValue;
-        }
-
-        // Pack the bits into the frame data
-        for (int bit = 0; bit < signal.length; ++bit) {
-            int bitPosition;
-            if (signal.littleEndian) {
-                bitPosition = signal.startBit + bit;
-            } else {
-                // Motorola (big-endian) bit ordering
-                bitPosition = signal.startBit - bit;
-            }
-
-            int byteIndex = bitPosition / 8;
-            int bitInByte = bitPosition % 8;
-
-            if (byteIndex >= 0 && byteIndex < static_cast<int>(frameData.size())) {
-                if (intValue & (1ULL << bit)) {
-                    frameData[byteIndex] |= (1 << bitInByte);
-                }
-            }
-        }
-    }
+    std::vector<uint8_t> frameData = packFrame(selectedMessageIndex);
 
     // Convert to hex string
     QStringList hexBytes;
@@ -2534,45 +2167,13 @@ QString DbcParser::getCurrentMessageBinData()
         return QString("00000000 00000000 00000000 00000000 00000000 00000000 00000000 00000000");
     }
 
-    // Get the current message
-    const canMessage& msg = messages[selectedMessageIndex];
+    // Pack the signal values into the frame data
+    std::vector<uint8_t> frameData = packFrame(selectedMessageIndex);
     
     // Build binary representation
     QStringList binBytes;
-    for (int i = 0; i < msg.length; i++) {
-        binBytes << "00000000"; // Default to all zeros
-    }
-    
-    // Apply signal values to generate the actual binary data
-    for (const auto& signal : msg.signalList) {
-        // Convert signal value to raw binary value
-        uint64_t rawValue = static_cast<uint64_t>((signal.value - signal.offset) / signal.factor);
-        
-        // Apply the raw value to the appropriate bits in the message
-        for (int bit = 0; bit < signal.length; bit++) {
-            int bitPos;
-            if (signal.littleEndian) {
-                bitPos = signal.startBit + bit;
-            } else {
-                // Motorola (big-endian) bit numbering
-                bitPos = signal.startBit - bit;
-            }
-            
-            if (bitPos >= 0 && bitPos < msg.length * 8) {
-                int byteIndex = bitPos / 8;
-                int bitIndex = 7 - (bitPos % 8);
-                
-                if (byteIndex < binBytes.size()) {
-                    QString byteStr = binBytes[byteIndex];
-                    if (rawValue & (1ULL << bit)) {
-                        byteStr[bitIndex] = '1';
-                    } else {
-                        byteStr[bitIndex] = '0';
-                    }
-                    binBytes[byteIndex] = byteStr;
-                }
-            }
-        }
+    for (uint8_t byte : frameData) {
+        binBytes << QString("%1").arg(byte, 8, 2, QChar('0'));
     }
     
     return binBytes.join(" ");
@@ -2594,35 +2195,38 @@ bool DbcParser::stopExistingTransmission(const QString &messageName, const QStri
     
     bool foundAndStopped = false;
     
-    for (auto it = m_activeTransmissions.begin(); it != m_activeTransmissions.end(); ++it) {
+    for (int i = 0; i < m_activeTransmissions.size();) {
+        const ActiveTransmission &transmission = m_activeTransmissions[i];
+
         // Extract clean name from existing transmission
-        int existingParenthesisPos = it->messageName.indexOf(" (");
-        QString existingCleanName = existingParenthesisPos > 0 ? it->messageName.left(existingParenthesisPos) : it->messageName;
+        int existingParenthesisPos = transmission.messageName.indexOf(" (");
+        QString existingCleanName = existingParenthesisPos > 0 ? transmission.messageName.left(existingParenthesisPos) : transmission.messageName;
         
         // Check if message name matches
         bool messageMatches = (existingCleanName == cleanMessageName);
         
         // Check if CAN bus matches (empty canBus means match all buses)
-        bool busMatches = canBus.isEmpty() || (it->canBus == canBus);
+        bool busMatches = canBus.isEmpty() || (transmission.canBus == canBus);
         
         if (messageMatches && busMatches) {
             qDebug() << "Found existing transmission for message:" << cleanMessageName 
-                     << "on bus:" << it->canBus << "- stopping it";
+                     << "on bus:" << transmission.canBus << "- stopping it";
             
             // Stop the transmission on the server
-            if (dbcSender && isConnectedToServer() && !it->taskId.isEmpty()) {
-                qDebug() << "Stopping server task:" << it->taskId << "for message:" << it->messageName;
-                dbcSender->stopCANMessage(it->taskId);
+            DbcSender *sender = senderForBus(transmission.canBus);
+            if (sender && sender->isConnected() && !transmission.taskId.isEmpty()) {
+                qDebug() << "Stopping server task:" << transmission.taskId << "for message:" << transmission.messageName;
+                sender->requestAsync("KILL_TASK " + transmission.taskId); // nothing to wait for, the row goes either way
             }
             
-            QString stoppedMessageName = it->messageName;
+            QString stoppedMessageName = transmission.messageName;
             emit transmissionStatusChanged(stoppedMessageName, "Stopped");
             
             // Add to past transmissions before removing from active list
-            addToPastTransmissions(*it, "Stopped");
+            addToPastTransmissions(transmission, "Stopped");
             
-            // Remove from active list
-            m_activeTransmissions.erase(it);
+            // Remove from active list; the next one moves up to i
+            m_activeTransmissions.removeAt(i);
             foundAndStopped = true;
             
             qDebug() << "Successfully stopped existing transmission for:" << cleanMessageName 
@@ -2633,12 +2237,8 @@ bool DbcParser::stopExistingTransmission(const QString &messageName, const QStri
             if (!canBus.isEmpty()) {
                 break;
             }
-            // Reset iterator since we modified the container
-            it = m_activeTransmissions.begin();
-            if (it == m_activeTransmissions.end()) {
-                break;
-            }
-            --it; // Will be incremented by for loop
+        } else {
+            ++i;
         }
     }
     
@@ -2658,12 +2258,8 @@ void DbcParser::addActiveTransmission(const QString &messageName, int rateMs, co
     QString cleanMessageName = parenthesisPos > 0 ? messageName.left(parenthesisPos) : messageName;
     
     // Find the message in DBC data
-    auto messageIt = std::find_if(messages.begin(), messages.end(),
-        [&cleanMessageName](const canMessage& msg) {
-            return QString::fromStdString(msg.name) == cleanMessageName;
-        });
-
-    if (messageIt == messages.end()) {
+    int messageIndex = findMessage(cleanMessageName);
+    if (messageIndex < 0) {
         emit showError("Message '" + messageName + "' not found in DBC file");
         qWarning() << "Message not found:" << messageName;
         return;
@@ -2672,7 +2268,7 @@ void DbcParser::addActiveTransmission(const QString &messageName, int rateMs, co
     // Create new active transmission
     ActiveTransmission newTransmission;
     newTransmission.messageName = messageName;
-    newTransmission.messageId = messageIt->id;
+    newTransmission.messageId = messages[messageIndex].id;
     newTransmission.taskId = taskId;
     newTransmission.rateMs = rateMs;
     newTransmission.isPaused = false;
@@ -2703,7 +2299,7 @@ bool DbcParser::stopAllTransmissions()
 {
     qDebug() << "Stop all transmissions called";
     
-    if (!dbcSender || !dbcSender->isConnected()) {
+    if (!isConnectedToServer()) {
         return false;
     }
     
@@ -2712,12 +2308,18 @@ bool DbcParser::stopAllTransmissions()
         addToPastTransmissions(transmission, "Killed All");
     }
     
-    qint8 result = dbcSender->killAllTasks();
-    if (result == 0) {
-        clearActiveTransmissions();
-        return true;
+    // Every server is told without waiting, and the rows go either way; a refusal from ours is reported
+    connections->killAllTasks();
+    if (dbcSender && dbcSender->isConnected()) {
+        dbcSender->killAllTasks().then(this, [this](qint8 result) {
+            if (result != 0) {
+                qWarning() << "Kill all tasks failed, error code:" << result;
+                emit showError(QString("Kill all tasks failed with error code: %1").arg(result));
+            }
+        });
     }
-    return false;
+    clearActiveTransmissions();
+    return true;
 }
 
 bool DbcParser::pauseAllTransmissions()
@@ -2771,16 +2373,35 @@ bool DbcParser::connectToServer(const QString &address, const QString &port)
         return false;
     }
     
-    qint8 result = dbcSender->initiateConnection(address, port);
-    if (result == 0) {
-        qDebug() << "Successfully connected to server";
-        emit connectionStatusChanged();
-        return true;
-    } else {
-        qDebug() << "Failed to connect to server, error code:" << result;
+    // Connects and sets up the session in the background; connectionStatusChanged follows either way
+    dbcSender->initiateConnection(address, port).then(this, [this](qint8 result) {
+        if (result == 0) {
+            qDebug() << "Successfully connected to server";
+        } else {
+            qDebug() << "Failed to connect to server, error code:" << result;
+        }
         emit connectionStatusChanged();
+    });
+    return true;
+}
+
+bool DbcParser::connectToLocalBus()
+{
+    qDebug() << "Connect to local bus called";
+
+    if (!dbcSender) {
+        qDebug() << "Error: DbcSender not available";
+        return false;
+    }
+
+    qint8 result = dbcSender->useLocalBus();
+    emit connectionStatusChanged();
+    if (result != 0) {
+        qDebug() << "Local bus not available on this platform";
         return false;
     }
+    qDebug() << "Transmitting on the local bus";
+    return true;
 }
 
 QString DbcParser::debugLoadConfig(const QUrl &url)
@@ -2805,21 +2426,19 @@ bool DbcParser::pauseTransmission(const QString &messageName)
 {
     qDebug() << "Pause transmission called for:" << messageName;
     
-    if (!dbcSender || !dbcSender->isConnected()) {
-        return false;
-    }
-    
-    // Find the transmission and pause it
+    // Find the transmission and ask its server to pause it; the row changes when the server confirms
     for (auto &transmission : m_activeTransmissions) {
-        if (transmission.messageName == messageName) {
-            qint8 result = dbcSender->pauseCANMessage(transmission.taskId);
-            if (result == 0) {
-                transmission.isPaused = true;
-                transmission.status = "Paused";
-                emit activeTransmissionsChanged();
-                emit transmissionStatusChanged(messageName, "Paused");
-                return true;
+        if (transmission.messageName == messageName && !transmission.taskId.isEmpty()) {
+            DbcSender *sender = senderForBus(transmission.canBus);
+            if (!sender || !sender->isConnected()) {
+                return false;
             }
+            QString node = nodeOfBus(transmission.canBus);
+            QString taskId = transmission.taskId;
+            sender->requestAsync("PAUSE " + taskId).then(this, [this, node, taskId](const QString &reply) {
+                transmissionPauseChanged(node, taskId, reply.startsWith("Paused"), true);
+            });
+            return true;
         }
     }
     return false;
@@ -2835,26 +2454,85 @@ bool DbcParser::resumeTransmission(const QString &messageName)
 {
     qDebug() << "Resume transmission called for:" << messageName;
     
-    if (!dbcSender || !dbcSender->isConnected()) {
-        return false;
-    }
-    
-    // Find the transmission and resume it
+    // Find the transmission and ask its server to resume it; the row changes when the server confirms
     for (auto &transmission : m_activeTransmissions) {
         if (transmission.messageName == messageName && transmission.isPaused) {
-            qint8 result = dbcSender->resumeCANMessage(transmission.taskId);
-            if (result == 0) {
-                transmission.isPaused = false;
-                transmission.status = "Active";
-                emit activeTransmissionsChanged();
-                emit transmissionStatusChanged(messageName, "Active");
-                return true;
+            DbcSender *sender = senderForBus(transmission.canBus);
+            if (!sender || !sender->isConnected()) {
+                return false;
             }
+            QString node = nodeOfBus(transmission.canBus);
+            QString taskId = transmission.taskId;
+            sender->requestAsync("RESUME " + taskId).then(this, [this, node, taskId](const QString &reply) {
+                transmissionPauseChanged(node, taskId, reply.startsWith("Resumed"), false);
+            });
+            return true;
         }
     }
     return false;
 }
 
+// Reply to a PAUSE or RESUME queued by pauseTransmission/resumeTransmission
+void DbcParser::transmissionPauseChanged(const QString &node, const QString &taskId, bool confirmed, bool paused)
+{
+    if (!confirmed) {
+        qDebug() << "Server did not" << (paused ? "pause" : "resume") << "task" << taskId;
+        return;
+    }
+    // A subscribed connection gets the same change as an event too; whichever comes second is a no-op
+    applyTaskEvent(node, taskId, paused ? "paused" : "resumed", QString());
+}
+
+// "created", "paused", "resumed", "completed", "stopped" or "error" for one of our tasks
+void DbcParser::applyTaskEvent(const QString &node, const QString &taskId, const QString &state, const QString &detail)
+{
+    for (int i = 0; i < m_activeTransmissions.size(); ++i) {
+        const ActiveTransmission &transmission = m_activeTransmissions[i];
+        if (transmission.taskId != taskId || nodeOfBus(transmission.canBus) != node) {
+            continue;
+        }
+        if (state == "paused" || state == "resumed") {
+            bool paused = state == "paused";
+            if (transmission.isPaused == paused) {
+                return;
+            }
+            m_activeTransmissions.modify(i, [paused](ActiveTransmission &changed) {
+                changed.isPaused = paused;
+                changed.status = paused ? "Paused" : "Active";
+            }, {m_activeTransmissions.role("isPaused"), m_activeTransmissions.role("status")});
+            emit transmissionStatusChanged(transmission.messageName, transmission.status);
+        } else if (state == "completed" || state == "stopped" || state == "error") {
+            // Ended on the server without us asking (KILL_TASK removes the row before its event arrives)
+            QString messageName = transmission.messageName;
+            QString reason = state == "error" ? "Error" : state == "completed" ? "Completed" : "Stopped";
+            addToPastTransmissions(transmission, reason);
+            m_activeTransmissions.removeAt(i);
+            emit transmissionStatusChanged(messageName, "Stopped");
+            if (state == "error") {
+                emit messageSendStatus(messageName, false, detail);
+            }
+        }
+        return;
+    }
+}
+
+// Sent counts come in batches every 100 ms per task, at different times for different tasks. The rows they
+// change are redrawn together, at most every RowListModel::updateIntervalMs, and only their count and time
+void DbcParser::applyTaskSends(const QString &node, const QString &taskId, int sends)
+{
+    for (int i = 0; i < m_activeTransmissions.size(); ++i) {
+        const ActiveTransmission &transmission = m_activeTransmissions[i];
+        if (transmission.taskId == taskId && nodeOfBus(transmission.canBus) == node) {
+            QString now = QDateTime::currentDateTime().toString("hh:mm:ss");
+            m_activeTransmissions.modifyLater(i, [sends, &now](ActiveTransmission &counted) {
+                counted.sentCount += sends;
+                counted.lastSent = now;
+            }, {m_activeTransmissions.role("sentCount"), m_activeTransmissions.role("lastSent")});
+            break;
+        }
+    }
+}
+
 bool DbcParser::validateConfigFile(const QUrl &fileUrl)
 {
     qDebug() << "Validate config file called with URL:" << fileUrl;
@@ -2872,7 +2550,6 @@ void DbcParser::disconnectFromServer()
         
         // Clear active transmissions list
         m_activeTransmissions.clear();
-        emit activeTransmissionsChanged();
         
         // Disconnect from server
         dbcSender->disconnect();
@@ -2920,7 +2597,6 @@ void DbcParser::clearActiveTransmissions()
 {
     qDebug() << "Clearing active transmissions";
     m_activeTransmissions.clear();
-    emit activeTransmissionsChanged();
 }
 
 bool DbcParser::resumeActiveTransmission(unsigned int messageId)
@@ -2941,15 +2617,50 @@ void DbcParser::updateActiveTransmissions()
 {
     qDebug() << "Update active transmissions called";
     
-    if (!dbcSender || !dbcSender->isConnected()) {
-        return;
+    // Only what changed since the last refresh comes over the wire, from each server that has our tasks. Each
+    // server's rows are updated when its listing is in
+    QSet<DbcSender*> asked;
+    for (const ActiveTransmission &transmission : m_activeTransmissions) {
+        DbcSender *sender = senderForBus(transmission.canBus);
+        if (!sender || !sender->isConnected() || asked.contains(sender)) {
+            continue;
+        }
+        asked.insert(sender);
+        QPointer<DbcSender> refreshed(sender); // A node can be removed before its listing is in
+        sender->refreshTasks().then(this, [this, refreshed](qint8 result) {
+            if (result == 0 && refreshed) {
+                applyTaskRecords(refreshed);
+            }
+        });
+    }
+}
+
+void DbcParser::applyTaskRecords(DbcSender *sender)
+{
+    const QHash<QString, TaskRecord> &records = sender->taskRecords();
+    for (int i = 0; i < m_activeTransmissions.size(); ++i) {
+        const ActiveTransmission &transmission = m_activeTransmissions[i];
+        if (senderForBus(transmission.canBus) != sender) {
+            continue;
+        }
+        auto record = records.constFind(transmission.taskId);
+        if (record == records.cend()) {
+            continue;
+        }
+        bool paused = record->state == TaskRecord::State::Paused;
+        QString status = record->state == TaskRecord::State::Running ? "Active"
+                       : record->state == TaskRecord::State::Paused ? "Paused"
+                       : record->state == TaskRecord::State::Error ? "Error"
+                       : "Stopped";
+        int sentCount = std::max(transmission.sentCount, static_cast<int>(record->sent));
+        if (paused != transmission.isPaused || status != transmission.status || sentCount != transmission.sentCount) {
+            m_activeTransmissions.modify(i, [&](ActiveTransmission &refreshedRow) {
+                refreshedRow.isPaused = paused;
+                refreshedRow.status = status;
+                refreshedRow.sentCount = sentCount;
+            });
+        }
     }
-    
-    // Get current tasks from server
-    QString tasksResponse = dbcSender->listTasks();
-    // TODO: Parse response and update transmission states
-    
-    emit activeTransmissionsChanged();
 }
 
 bool DbcParser::loadActiveTransmissionsConfig(const QUrl &loadUrl)
@@ -3202,23 +2913,12 @@ bool DbcParser::isDbcLoaded() const
 
 QVariantList DbcParser::activeTransmissions() const
 {
-    QVariantList result;
-    for (const auto &transmission : m_activeTransmissions) {
-        QVariantMap map;
-        map["messageName"] = transmission.messageName;
-        map["messageId"] = QString("0x%1").arg(transmission.messageId, 0, 16).toUpper();
-        map["taskId"] = transmission.taskId;
-        map["rateMs"] = transmission.rateMs;
-        map["isPaused"] = transmission.isPaused;
-        map["status"] = transmission.status;
-        map["lastSent"] = transmission.lastSent;
-        map["sentCount"] = transmission.sentCount;
-        map["hexData"] = transmission.hexData;
-        map["startedAt"] = transmission.startedAt.toString("hh:mm:ss");
-        map["canBus"] = transmission.canBus;
-        result.append(map);
-    }
-    return result;
+    return m_activeTransmissions.toVariantList();
+}
+
+RowListModel* DbcParser::activeTransmissionList()
+{
+    return &m_activeTransmissions;
 }
 
 QStringList DbcParser::getAvailableMessages() const
@@ -3265,30 +2965,17 @@ void DbcParser::addToPastTransmissions(const ActiveTransmission& transmission, c
     if (m_pastTransmissions.size() > 100) {
         m_pastTransmissions.removeLast();
     }
-    
-    emit pastTransmissionsChanged();
 }
 
 // Property getters for new features
 QVariantList DbcParser::pastTransmissions() const
 {
-    QVariantList list;
-    for (const auto& transmission : m_pastTransmissions) {
-        QVariantMap map;
-        map["messageName"] = transmission.messageName;
-        map["messageId"] = static_cast<qint64>(transmission.messageId);
-        map["taskId"] = transmission.taskId;
-        map["rateMs"] = transmission.rateMs;
-        map["hexData"] = transmission.hexData;
-        map["startedAt"] = transmission.startedAt;
-        map["endedAt"] = transmission.endedAt;
-        map["endReason"] = transmission.endReason;
-        map["totalSent"] = transmission.totalSent;
-        map["canBus"] = transmission.canBus;
-        map["duration"] = transmission.duration;
-        list.append(map);
-    }
-    return list;
+    return m_pastTransmissions.toVariantList();
+}
+
+RowListModel* DbcParser::pastTransmissionList()
+{
+    return &m_pastTransmissions;
 }
 
 QVariantList DbcParser::configFiles() const
@@ -3343,7 +3030,6 @@ void DbcParser::clearPastTransmissions()
 {
     qDebug() << "Clearing past transmissions";
     m_pastTransmissions.clear();
-    emit pastTransmissionsChanged();
 }
 
 QVariantList DbcParser::getPastTransmissionsFiltered(const QString &filter)
@@ -3426,7 +3112,73 @@ void DbcParser::exportPastTransmissions(const QUrl &saveUrl)
 
 bool DbcParser::isConnectedToServer() const
 {
-    return dbcSender && dbcSender->isConnected();
+    if (dbcSender && dbcSender->isConnected()) {
+        return true;
+    }
+    for (const QString &node : connections->nodes()) {
+        if (connections->senderFor(node)->isConnected()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DbcParser::addServer(const QString &node, const QString &address, const QString &port)
+{
+    qDebug() << "Add server called for node:" << node << "at" << address << port;
+    if (!connections->addServer(node, address, port)) {
+        emit showError("Invalid server name: " + node + " (letters, digits, '_', '-' and '.' only)");
+        return false;
+    }
+    return true; // serverAdded follows once it has connected or failed to
+}
+
+bool DbcParser::removeServer(const QString &node)
+{
+    qDebug() << "Remove server called for node:" << node;
+    if (!connections->removeServer(node)) {
+        return false;
+    }
+    // Its tasks went with the connection
+    for (int i = m_activeTransmissions.size() - 1; i >= 0; --i) {
+        if (nodeOfBus(m_activeTransmissions[i].canBus) == node) {
+            addToPastTransmissions(m_activeTransmissions[i], "Disconnected");
+            m_activeTransmissions.removeAt(i);
+        }
+    }
+    return true;
+}
+
+QStringList DbcParser::serverNodes() const
+{
+    return connections->nodes();
+}
+
+DbcSender* DbcParser::senderForBus(const QString &canBus, QString *bus) const
+{
+    QString node, serverBus;
+    if (!ConnectionManager::splitBus(canBus, node, serverBus)) {
+        if (bus) {
+            *bus = canBus;
+        }
+        return dbcSender;
+    }
+    if (bus) {
+        *bus = serverBus;
+    }
+    return connections->senderFor(node);
+}
+
+QVariantMap DbcParser::linkStats() const
+{
+    return dbcSender ? dbcSender->linkStats() : QVariantMap();
+}
+
+void DbcParser::setHeartbeat(int intervalMs, int deadAfterMs)
+{
+    if (dbcSender) {
+        dbcSender->setHeartbeat(intervalMs, deadAfterMs);
+    }
 }
 
 // One-shot message implementations
@@ -3434,13 +3186,16 @@ bool DbcParser::sendRawCanMessage(const QString &messageId, const QString &hexDa
 {
     qDebug() << "Send raw CAN message called with ID:" << messageId << "data:" << hexData << "bus:" << canBus << "name:" << messageName;
     
-    if (!dbcSender) {
-        qWarning() << "DbcSender not initialized";
-        emit showError("Error: CAN sender not initialized. Please check your connection setup.");
+    QString busToUse = canBus.isEmpty() ? "vcan0" : canBus;
+    QString serverBus;
+    DbcSender *sender = senderForBus(busToUse, &serverBus);
+    if (!sender) {
+        qWarning() << "No server for bus" << busToUse;
+        emit showError("Error: Unknown server for bus " + busToUse);
         return false;
     }
 
-    if (!dbcSender->isConnected()) {
+    if (!sender->isConnected()) {
         qDebug() << "Error: Not connected to server";
         emit showError("Error: Not connected to server");
         return false;
@@ -3522,15 +3277,18 @@ bool DbcParser::sendRawCanMessage(const QString &messageId, const QString &hexDa
     }
 
     // Format message: "canid#canmessage#rate#canbus" (rate=0 for one-shot)
-    QString busToUse = canBus.isEmpty() ? "vcan0" : canBus;
-    QString messageData = QString("%1#%2#0#%3").arg(canId, 0, 16).arg(cleanHexData).arg(busToUse);
+    QString messageData = QString("%1#%2#0#%3").arg(canId, 0, 16).arg(cleanHexData).arg(serverBus);
     
     qDebug() << "Sending one-shot raw message:" << messageData;
 
-    // Send the one-shot message
-    qint8 result = dbcSender->sendOneShotMessage(messageData, 0);
-    
-    if (result == 0 || result == 2) {
+    // Send the one-shot message; the outcome comes with the reply
+    sender->sendOneShotMessage(messageData, 0).then(this, [this, messageName, canId, hexData, busToUse](const SendResult &result) {
+        if (result.status != 0 && result.status != 2) {
+            QString errorMsg = QString("Send failed with error code: %1").arg(result.status);
+            qWarning() << "Failed to send raw CAN message. Error code:" << result.status;
+            emit showError(errorMsg);
+            return;
+        }
         qDebug() << "Successfully sent raw one-shot CAN message";
         
         // Add to one-shot message history
@@ -3550,40 +3308,27 @@ bool DbcParser::sendRawCanMessage(const QString &messageId, const QString &hexDa
             m_oneShotMessages.removeLast();
         }
         
-        emit oneShotMessagesChanged();
-        
         // Log successful transmission details
         qDebug() << "Added message to one-shot history. Total messages in history:" << m_oneShotMessages.size();
         qDebug() << "Message details - Name:" << oneShotMsg.messageName << "ID:" << QString("0x%1").arg(oneShotMsg.messageId, 0, 16) << "Data:" << oneShotMsg.hexData << "Bus:" << oneShotMsg.canBus;
         
-        if (result == 0) {
+        if (result.status == 0) {
             emit showSuccess("Raw message sent successfully!");
         } else {
             emit showSuccess("Raw message sent (no acknowledgment received)");
         }
-        return true;
-    } else {
-        QString errorMsg = QString("Send failed with error code: %1").arg(result);
-        qWarning() << "Failed to send raw CAN message. Error code:" << result;
-        emit showError(errorMsg);
-        return false;
-    }
+    });
+    return true;
 }
 
 QVariantList DbcParser::oneShotMessages() const
 {
-    QVariantList result;
-    for (const auto &message : m_oneShotMessages) {
-        QVariantMap map;
-        map["messageName"] = message.messageName;
-        map["messageId"] = QString("0x%1").arg(message.messageId, 0, 16).toUpper();
-        map["hexData"] = message.hexData;
-        map["sentAt"] = message.sentAt.toString("hh:mm:ss");
-        map["sentAtFull"] = message.sentAt.toString("yyyy-MM-dd hh:mm:ss");
-        map["canBus"] = message.canBus;
-        result.append(map);
-    }
-    return result;
+    return m_oneShotMessages.toVariantList();
+}
+
+RowListModel* DbcParser::oneShotMessageList()
+{
+    return &m_oneShotMessages;
 }
 
 bool DbcParser::saveOneShotMessagesConfig(const QUrl &saveUrl)
@@ -3721,9 +3466,8 @@ bool DbcParser::loadOneShotMessagesConfig(const QUrl &loadUrl)
         return false;
     }
 
-    // Clear existing history and load from config
-    m_oneShotMessages.clear();
-
+    // Replaces the existing history
+    QList<OneShotMessage> loaded;
     int validMessages = 0;
     int skippedMessages = 0;
     
@@ -3784,11 +3528,11 @@ bool DbcParser::loadOneShotMessagesConfig(const QUrl &loadUrl)
             message.canBus = "vcan0";
         }
         
-        m_oneShotMessages.append(message);
+        loaded.append(message);
         validMessages++;
     }
 
-    emit oneShotMessagesChanged();
+    m_oneShotMessages.assign(std::move(loaded));
     
     qDebug() << "One-shot messages configuration load complete. Loaded:" << validMessages << "valid messages, skipped:" << skippedMessages << "invalid messages";
     
@@ -3808,7 +3552,6 @@ void DbcParser::clearOneShotMessageHistory()
 {
     qDebug() << "Clearing one-shot message history";
     m_oneShotMessages.clear();
-    emit oneShotMessagesChanged();
     emit showInfo("One-shot message history cleared");
 }
 
@@ -13,33 +13,23 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QFileInfo>
+#include <QHash>
 #include <vector>
 #include <string>
-#include <set>
+#include <string_view>
+#include <memory>
+#include <optional>
+#include "DbcReader.h"
+#include "DbcCodec.h"
+#include "DbcLayout.h"
+#include "SignalListModel.h"
+#include "RowListModel.h"
 
 // Forward declarations
 class DbcSender;
-
-// Data structures for CAN messages and signals (from your original code)
-struct canSignal {
-    std::string name;
-    int startBit;
-    int length;
-    bool littleEndian;
-    double factor;
-    double offset;
-    double min;
-    double max;
-    std::string unit;
-    double value; // Added to store current signal value
-};
-
-struct canMessage {
-    unsigned long id;
-    std::string name;
-    int length;
-    std::vector<canSignal> signalList; // Renamed from 'signals' to avoid Qt keyword conflict
-};
+class ConnectionManager;
+class QThread;
+struct DbcLoad;
 
 // Data structure for active transmission
 struct ActiveTransmission {
@@ -94,20 +84,30 @@ class DbcParser : public QObject
     Q_OBJECT
     Q_PROPERTY(QStringList messageModel READ messageModel NOTIFY messageModelChanged)
     Q_PROPERTY(QVariantList signalModel READ signalModel NOTIFY signalModelChanged)
+    Q_PROPERTY(SignalListModel* signalList READ signalList CONSTANT) // The same rows, updated in place
     Q_PROPERTY(QString generatedCanFrame READ generatedCanFrame NOTIFY generatedCanFrameChanged)
     Q_PROPERTY(bool isConnectedToServer READ isConnectedToServer NOTIFY connectionStatusChanged)
     Q_PROPERTY(QVariantList activeTransmissions READ activeTransmissions NOTIFY activeTransmissionsChanged)
     Q_PROPERTY(QVariantList pastTransmissions READ pastTransmissions NOTIFY pastTransmissionsChanged)
     Q_PROPERTY(QVariantList configFiles READ configFiles NOTIFY configFilesChanged)
     Q_PROPERTY(QVariantList oneShotMessages READ oneShotMessages NOTIFY oneShotMessagesChanged)
+    // The same three lists as models, updated a row at a time
+    Q_PROPERTY(RowListModel* activeTransmissionList READ activeTransmissionList CONSTANT)
+    Q_PROPERTY(RowListModel* pastTransmissionList READ pastTransmissionList CONSTANT)
+    Q_PROPERTY(RowListModel* oneShotMessageList READ oneShotMessageList CONSTANT)
     Q_PROPERTY(bool isDbcLoaded READ isDbcLoaded NOTIFY dbcLoadedChanged)
+    Q_PROPERTY(bool isLoading READ isLoading NOTIFY loadingChanged)
+    Q_PROPERTY(double loadProgress READ loadProgress NOTIFY loadProgressChanged)
+    Q_PROPERTY(QVariantMap linkStats READ linkStats NOTIFY linkStatsChanged)
+    Q_PROPERTY(QStringList serverNodes READ serverNodes NOTIFY serverNodesChanged)
 
 public:
     explicit DbcParser(QObject *parent = nullptr);
     ~DbcParser(); // Destructor for proper cleanup
 
     // QML accessible methods
-    Q_INVOKABLE bool loadDbcFile(const QUrl &fileUrl);
+    Q_INVOKABLE bool loadDbcFile(const QUrl &fileUrl); // Starts a background load, dbcLoadFinished tells how it went
+    Q_INVOKABLE void cancelLoad(); // The current table stays as it was
     Q_INVOKABLE void selectMessage(const QString &messageName);
     Q_INVOKABLE void setShowAllSignals(bool show);
     Q_INVOKABLE void setEndian(const QString &endian);
@@ -167,18 +167,25 @@ public:
     Q_INVOKABLE QString getCurrentMessageHexData(); // Unified method for current message hex data
     Q_INVOKABLE QString getCurrentMessageBinData(); // Unified method for current message binary data
     Q_INVOKABLE unsigned long getMessageId(const QString &messageName);
+    // True once the message is on its way; messageSendStatus reports how it went
     Q_INVOKABLE bool sendCanMessage(const QString &messageName, int rateMs);
     Q_INVOKABLE bool sendCanMessage(const QString &messageName, int rateMs, const QString &canBus);
     Q_INVOKABLE bool sendCanMessageOnce(const QString &messageName, const QString &canBus = "vcan0");
 
     // Server connection methods
-    Q_INVOKABLE bool connectToServer(const QString &address, const QString &port);
+    Q_INVOKABLE bool connectToServer(const QString &address, const QString &port); // Connects in the background, then connectionStatusChanged
+    Q_INVOKABLE bool connectToLocalBus(); // No server: transmit from this process on the local SocketCAN interfaces
     Q_INVOKABLE void disconnectFromServer();
     Q_INVOKABLE bool isConnectedToServer() const;
     Q_INVOKABLE void setTcpClient(QObject* tcpClient);
+    Q_INVOKABLE void setHeartbeat(int intervalMs, int deadAfterMs); // How often to ping the server, and how long a silent one gets
+
+    // More servers of a distributed bench: node `node`'s buses are listed and addressed as "<node>:<bus>"
+    Q_INVOKABLE bool addServer(const QString &node, const QString &address, const QString &port); // Connects in the background, then serverAdded
+    Q_INVOKABLE bool removeServer(const QString &node); // Its transmissions move to the past list
 
     // CAN interface management
-    Q_INVOKABLE QStringList getAvailableCanInterfaces();
+    Q_INVOKABLE void refreshAvailableCanInterfaces(); // Answered by availableCanInterfacesChanged
 
     // Active transmissions management
     Q_INVOKABLE bool startTransmission(const QString &messageName, int rateMs);
@@ -196,7 +203,7 @@ public:
     Q_INVOKABLE bool saveActiveTransmissionsConfig(const QUrl &saveUrl);
     Q_INVOKABLE bool loadActiveTransmissionsConfig(const QUrl &loadUrl);
     Q_INVOKABLE void clearActiveTransmissions();
-    Q_INVOKABLE void updateActiveTransmissions();
+    Q_INVOKABLE void updateActiveTransmissions(); // Rows are updated as each server's task listing comes in
     Q_INVOKABLE void refreshTasksFromClient();
     
     // Helper method to add transmission without sending
@@ -207,6 +214,16 @@ public:
     bool stopExistingTransmission(const QString &messageName);
     bool stopExistingTransmission(const QString &messageName, const QString &canBus);
 
+    // Replies to requests startTransmission/pauseTransmission/resumeTransmission queued on DbcSender
+    void transmissionStarted(const QString &messageName, const QString &canBus, const QString &reply);
+    void transmissionPauseChanged(const QString &node, const QString &taskId, bool confirmed, bool paused);
+
+    // Task events a server pushes through DbcSender, applied to the matching row only. Task IDs are per server,
+    // so `node` (empty for our own server) is part of the match
+    void applyTaskEvent(const QString &node, const QString &taskId, const QString &state, const QString &detail);
+    void applyTaskSends(const QString &node, const QString &taskId, int sends);
+    void applyTaskRecords(DbcSender *sender); // The rows whose tasks run on `sender`, from its refreshed task table
+
     // One-shot message management
     Q_INVOKABLE bool sendRawCanMessage(const QString &messageId, const QString &hexData, const QString &canBus = "vcan0", const QString &messageName = QString());
     Q_INVOKABLE bool saveOneShotMessagesConfig(const QUrl &saveUrl);
@@ -238,12 +255,20 @@ public:
     // Property getters
     QStringList messageModel() const;
     QVariantList signalModel() const;
+    SignalListModel* signalList() const;
     QString generatedCanFrame() const;
     QVariantList activeTransmissions() const;
     QVariantList pastTransmissions() const;
     QVariantList configFiles() const;
     QVariantList oneShotMessages() const;
+    RowListModel* activeTransmissionList();
+    RowListModel* pastTransmissionList();
+    RowListModel* oneShotMessageList();
     bool isDbcLoaded() const;
+    bool isLoading() const;
+    double loadProgress() const;
+    QVariantMap linkStats() const;
+    QStringList serverNodes() const;
     
 
 signals:
@@ -258,6 +283,13 @@ signals:
     void oneShotMessagesChanged();
     void transmissionStatusChanged(const QString &messageName, const QString &status);
     void dbcLoadedChanged();
+    void loadingChanged();
+    void loadProgressChanged();
+    void dbcLoadFinished(bool success, const QString &message); // Loaded, failed or cancelled
+    void linkStatsChanged();
+    void serverNodesChanged();
+    void availableCanInterfacesChanged(const QStringList &interfaces); // Every node's, ours by their plain names
+    void serverAdded(const QString &node, bool connected);
     
     // Centralized notification signals
     void showNotification(const QString &message, const QString &type);
@@ -267,40 +299,79 @@ signals:
     void showInfo(const QString &message);
 
 private:
-    void parseDBC(const QString &filePath);
+    void finishLoad(const std::shared_ptr<DbcLoad> &load);
+    void setLoadProgress(double progress);
     QString buildCanFrame();
     std::string trim(const std::string& s);
     
     // Helper methods for bit manipulation
     bool isBitPartOfSignal(int bitPosition, int startBit, int length, bool littleEndian);
-    int getBitIndexInRawValue(int bitPosition, int startBit, bool littleEndian);
+    int getBitIndexInRawValue(int bitPosition, int startBit, int length, bool littleEndian);
     uint64_t calculateRawValueFromBits(const QString &signalName, const QVariantList &bitValues);
     
-    // Helper methods for signal validation
-    int getMotorolaLsb(int msb, int length);
-    std::set<int> getSignalBitPositions(int startBit, int length, bool littleEndian);
-    
     // Helper method for past transmissions
     void addToPastTransmissions(const ActiveTransmission& transmission, const QString& endReason);
 
+    // The connection a bus's tasks go through: ours for a plain bus, the node's for "<node>:<bus>" (null if
+    // there is no such node). `bus` gets the name that server knows the bus by
+    DbcSender* senderForBus(const QString &canBus, QString *bus = nullptr) const;
+
+    // Lookups through the indexes below: positions in `messages` and in a message's signalList, -1 if there is
+    // no such message or signal (findSignalIndex also takes messageIndex -1)
+    int findMessage(const QString &name) const;
+    int findMessageById(unsigned long id) const;
+    int findSignalIndex(int messageIndex, const QString &signalName) const;
+    canSignal* findSignal(int messageIndex, const QString &signalName);
+
+    // Keeping the indexes in step with `messages`. Where names or IDs repeat, the first one is found, as with
+    // the scans these replace
+    void rebuildIndexes();
+    void indexMessage(int messageIndex); // Just appended
+    void unindexMessage(int messageIndex); // Just erased; later messages have moved up one
+    void indexSignals(int messageIndex);
+
+    // The message's codec, compiled on first use after a change to its signals
+    const DbcCodec& codecFor(int messageIndex);
+    // Which bits the message's signals use, built on first use after a change to their layout
+    const DbcLayout& layoutFor(int messageIndex);
+    // The message's frame from its signals' current values
+    std::vector<uint8_t> packFrame(int messageIndex);
+
+    // One of the selected message's signals changed: its row of signalList, and signalModelChanged too unless
+    // only the value did (nothing bound to signalModel reads values, and a value changes on every slider tick)
+    void selectedSignalChanged(const canSignal &sig, const QList<int> &roles = {});
+
     std::vector<canMessage> messages;
+    QHash<QString, int> m_messageByName;
+    QHash<unsigned long, int> m_messageById;
+    std::vector<QHash<QString, int>> m_signalIndex; // Per message, in step with `messages`: signal name -> position
+    std::vector<std::optional<DbcCodec>> m_codecs;  // The same, empty until codecFor()
+    std::vector<std::optional<DbcLayout>> m_layouts; // The same, empty until layoutFor()
     int selectedMessageIndex;
+    SignalListModel* m_signalList; // Shows messages[selectedMessageIndex]
     bool showAllSignals;
     QString currentEndian;
     QString m_generatedCanFrame;
     QString originalDbcText;
 
+    // Background DBC load: the one whose result will be used, and every thread still running (cancelled ones
+    // included) so the destructor can wait for them
+    std::shared_ptr<DbcLoad> m_load;
+    QList<QThread*> m_loadThreads;
+    double m_loadProgress = 0.0;
+
     // Network communication via DbcSender
     DbcSender* dbcSender;
+    ConnectionManager* connections; // The other servers, by node name
 
     // Active transmissions tracking
-    QList<ActiveTransmission> m_activeTransmissions;
+    RowList<ActiveTransmission> m_activeTransmissions; // Send counts go out in batches
     
     // Past transmissions tracking
-    QList<PastTransmission> m_pastTransmissions;
+    RowList<PastTransmission> m_pastTransmissions;
     
     // One-shot messages history
-    QList<OneShotMessage> m_oneShotMessages;
+    RowList<OneShotMessage> m_oneShotMessages;
     
     // Config file browser
     QList<ConfigFileEntry> m_configFiles;
@@ -0,0 +1,524 @@
+#include "DbcReader.h"
+#include <charconv>
+#include <cstring>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#define DBC_READER_MMAP
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string& path, std::string& error)
+{
+    close();
+#ifdef DBC_READER_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = "Could not open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0) {
+        error = "Could not stat " + path + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    if (st.st_size > 0) {
+        void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            // Read front to back exactly once
+            madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+            data = static_cast<const char*>(p);
+            size = static_cast<size_t>(st.st_size);
+            mapped = true;
+            ::close(fd);
+            return true;
+        }
+    }
+    ::close(fd);
+    if (st.st_size == 0) {
+        return true; // Nothing to map
+    }
+#endif
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "Could not open " + path;
+        return false;
+    }
+    in.seekg(0, std::ios::end);
+    buffer.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0, std::ios::beg);
+    if (!buffer.empty() && !in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()))) {
+        error = "Could not read " + path;
+        buffer.clear();
+        return false;
+    }
+    data = buffer.data();
+    size = buffer.size();
+    return true;
+}
+
+void MappedFile::close()
+{
+#ifdef DBC_READER_MMAP
+    if (mapped) {
+        munmap(const_cast<char*>(data), size);
+    }
+#endif
+    mapped = false;
+    data = nullptr;
+    size = 0;
+    buffer.clear();
+}
+
+namespace {
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+std::string_view trimmed(std::string_view s)
+{
+    while (!s.empty() && isSpace(s.front())) s.remove_prefix(1);
+    while (!s.empty() && isSpace(s.back())) s.remove_suffix(1);
+    return s;
+}
+
+// Whole string or nothing, 0 otherwise, as QString::toInt/toDouble gave the old parser
+template <typename T>
+T toNumber(std::string_view s)
+{
+    s = trimmed(s);
+    if (!s.empty() && s.front() == '+') s.remove_prefix(1);
+    T value{};
+    auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+    return ec == std::errc() && end == s.data() + s.size() ? value : T{};
+}
+
+// Walks one line; every read skips the whitespace in front of it
+struct Cursor {
+    const char* p;
+    const char* end;
+
+    explicit Cursor(std::string_view line) : p(line.data()), end(line.data() + line.size()) {}
+
+    void skipSpace() { while (p < end && isSpace(*p)) ++p; }
+    bool consume(char c)
+    {
+        skipSpace();
+        if (p < end && *p == c) {
+            ++p;
+            return true;
+        }
+        return false;
+    }
+    std::string_view token()
+    {
+        skipSpace();
+        const char* begin = p;
+        while (p < end && !isSpace(*p)) ++p;
+        return {begin, static_cast<size_t>(p - begin)};
+    }
+    template <typename T>
+    bool number(T& out)
+    {
+        skipSpace();
+        if (p < end && *p == '+') ++p;
+        auto [next, ec] = std::from_chars(p, end, out);
+        if (ec != std::errc()) return false;
+        p = next;
+        return true;
+    }
+};
+
+// The whitespace-separated tokens of a line, for the fallback; a line has a handful, so no allocation
+template <typename F>
+void forEachToken(std::string_view line, F&& f)
+{
+    Cursor c(line);
+    for (std::string_view t = c.token(); !t.empty(); t = c.token()) {
+        if (!f(t)) return;
+    }
+}
+
+// The old parser's recovery for SG_ lines its regex didn't match: each field from the first token that looks like it
+bool parseSignalFallback(std::string_view line, canSignal& sig)
+{
+    Cursor c(line);
+    if (c.token() != "SG_") return false;
+    std::string_view name = c.token();
+    if (name.empty() || c.token().empty()) return false; // Fewer than three tokens
+
+    sig.name.assign(name);
+    forEachToken(line, [&](std::string_view t) {
+        size_t bar = t.find('|');
+        size_t at = t.find('@');
+        if (bar == std::string_view::npos || at == std::string_view::npos) return true;
+        std::string_view bits = t.substr(0, at);
+        size_t split = bits.find('|');
+        if (split != std::string_view::npos) {
+            sig.startBit = toNumber<int>(bits.substr(0, split));
+            size_t next = bits.find('|', split + 1);
+            sig.length = toNumber<int>(bits.substr(split + 1, next == std::string_view::npos ? next : next - split - 1));
+        }
+        std::string_view format = t.substr(at + 1);
+        sig.littleEndian = format.starts_with('1');
+        sig.isSigned = format.size() >= 2 && format[1] == '-';
+        return false;
+    });
+    forEachToken(line, [&](std::string_view t) {
+        if (t.size() < 2 || t.front() != '(' || t.back() != ')') return true;
+        std::string_view inner = t.substr(1, t.size() - 2);
+        size_t comma = inner.find(',');
+        if (comma != std::string_view::npos) {
+            size_t next = inner.find(',', comma + 1);
+            sig.factor = toNumber<double>(inner.substr(0, comma));
+            sig.offset = toNumber<double>(inner.substr(comma + 1, next == std::string_view::npos ? next : next - comma - 1));
+        }
+        return false;
+    });
+    forEachToken(line, [&](std::string_view t) {
+        if (t.size() < 2 || t.front() != '[' || t.back() != ']') return true;
+        std::string_view inner = t.substr(1, t.size() - 2);
+        size_t bar = inner.find('|');
+        if (bar != std::string_view::npos) {
+            size_t next = inner.find('|', bar + 1);
+            sig.min = toNumber<double>(inner.substr(0, bar));
+            sig.max = toNumber<double>(inner.substr(bar + 1, next == std::string_view::npos ? next : next - bar - 1));
+        }
+        return false;
+    });
+    forEachToken(line, [&](std::string_view t) {
+        if (t.front() != '"' || t.back() != '"') return true;
+        sig.unit.assign(t.size() >= 2 ? t.substr(1, t.size() - 2) : std::string_view());
+        return false;
+    });
+    return true;
+}
+
+} // namespace
+
+bool DbcReader::parseMessageLine(std::string_view line, canMessage& msg)
+{
+    Cursor c(line);
+    if (c.token() != "BO_") return false;
+    std::string_view id = c.token();
+    std::string_view name = c.token();
+    if (name.empty() || c.token().empty()) return false; // Fewer than four tokens
+
+    msg.id = toNumber<unsigned long>(id);
+    if (name.back() == ':') name.remove_suffix(1);
+    msg.name.assign(name);
+    msg.length = 0;
+    size_t colon = line.find(':');
+    if (colon != std::string_view::npos) {
+        Cursor after(line.substr(colon + 1));
+        msg.length = toNumber<int>(after.token());
+    }
+    msg.signalList.clear();
+    return true;
+}
+
+bool DbcReader::parseSignalLine(std::string_view line, canSignal& sig)
+{
+    sig = canSignal();
+
+    Cursor c(line);
+    if (c.token() != "SG_") return false;
+    c.skipSpace();
+    const char* nameBegin = c.p;
+    while (c.p < c.end && !isSpace(*c.p) && *c.p != ':') ++c.p;
+    std::string_view name(nameBegin, static_cast<size_t>(c.p - nameBegin));
+
+    // A multiplexer indicator (M, m<n>) may sit between the name and the colon
+    const char* colon = c.p;
+    while (colon < c.end && *colon != ':') ++colon;
+    c.p = colon;
+
+    char order = 0;
+    char sign = 0;
+    bool standard = !name.empty() && c.consume(':')
+        && c.number(sig.startBit) && c.consume('|') && c.number(sig.length) && c.consume('@')
+        && c.p + 2 <= c.end && ((order = c.p[0]) == '0' || order == '1') && ((sign = c.p[1]) == '+' || sign == '-');
+    if (standard) {
+        c.p += 2;
+        standard = c.consume('(') && c.number(sig.factor) && c.consume(',') && c.number(sig.offset) && c.consume(')')
+            && c.consume('[') && c.number(sig.min) && c.consume('|') && c.number(sig.max) && c.consume(']')
+            && c.consume('"');
+    }
+    if (standard) {
+        const char* unitEnd = static_cast<const char*>(std::memchr(c.p, '"', static_cast<size_t>(c.end - c.p)));
+        standard = unitEnd != nullptr;
+        if (standard) {
+            sig.unit.assign(c.p, static_cast<size_t>(unitEnd - c.p));
+        }
+    }
+    if (standard) {
+        sig.name.assign(name);
+        sig.littleEndian = order == '1';
+        sig.isSigned = sign == '-';
+        return true;
+    }
+
+    sig = canSignal();
+    return parseSignalFallback(line, sig);
+}
+
+namespace {
+
+// One block of the file: the BO_ lines in it and the SG_ lines under them. SG_ lines ahead of the block's first
+// BO_ belong to the message the block before ended with, so they are kept apart in `orphans`
+struct Block {
+    std::string_view text;
+    std::vector<canMessage> messages;
+    std::vector<canSignal> orphans;
+    bool completed = false;
+};
+
+// `advance` gets the bytes parsed since its previous call, every progressStep bytes and at the end
+void parseBlock(Block& block, const std::atomic<bool>& cancel, const std::function<void(size_t)>& advance)
+{
+    const char* begin = block.text.data();
+    const char* p = begin;
+    const char* end = p + block.text.size();
+    const char* reported = p;
+    canSignal sig;
+
+    while (p < end) {
+        if (p - reported >= static_cast<std::ptrdiff_t>(DbcReader::progressStep)) {
+            if (cancel.load(std::memory_order_relaxed)) {
+                return;
+            }
+            advance(static_cast<size_t>(p - reported));
+            reported = p;
+        }
+        const char* eol = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!eol) eol = end;
+        std::string_view line(p, static_cast<size_t>(eol - p));
+        p = eol + 1;
+
+        // Only the first three characters decide; everything that isn't BO_ or SG_ goes by untouched
+        size_t first = 0;
+        while (first < line.size() && isSpace(line[first])) ++first;
+        if (line.size() - first < 3) continue;
+        const char* keyword = line.data() + first;
+        if (first == 0 && keyword[0] == 'B' && keyword[1] == 'O' && keyword[2] == '_') {
+            block.messages.emplace_back();
+            if (!DbcReader::parseMessageLine(line, block.messages.back())) {
+                block.messages.pop_back();
+            }
+        } else if (keyword[0] == 'S' && keyword[1] == 'G' && keyword[2] == '_') {
+            if (DbcReader::parseSignalLine(line, sig)) {
+                auto& list = block.messages.empty() ? block.orphans : block.messages.back().signalList;
+                list.push_back(std::move(sig));
+            }
+        }
+    }
+    advance(static_cast<size_t>(std::min(p, end) - reported));
+    block.completed = true;
+}
+
+// Threads kept for every parse in the process, started the first time a parse needs them, so a load doesn't
+// pay for creating and joining threads. Only DbcReader::parse submits work, and never from a pool thread
+class ParsePool {
+public:
+    static ParsePool& shared()
+    {
+        static ParsePool pool;
+        return pool;
+    }
+
+    ~ParsePool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    // Runs job(0) .. job(count - 1) on the calling thread and up to count - 1 pool threads, returning once all
+    // are done. If no more threads can be started, the ones there are (or the caller alone) do the rest
+    void run(size_t count, const std::function<void(size_t)>& job)
+    {
+        std::atomic<size_t> next{0};
+        auto drain = [&] {
+            for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;) {
+                job(i);
+            }
+        };
+        std::mutex doneMutex;
+        std::condition_variable doneCondition;
+        size_t helpers = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            while (threads.size() + 1 < count) {
+                try {
+                    threads.emplace_back(&ParsePool::work, this);
+                } catch (const std::system_error&) {
+                    break;
+                }
+            }
+            helpers = std::min(count - 1, threads.size());
+            for (size_t i = 0; i < helpers; ++i) {
+                queue.push_back([&] {
+                    drain();
+                    std::lock_guard<std::mutex> doneLock(doneMutex);
+                    if (--helpers == 0) {
+                        doneCondition.notify_all();
+                    }
+                });
+            }
+        }
+        wake.notify_all();
+        drain();
+        std::unique_lock<std::mutex> doneLock(doneMutex);
+        doneCondition.wait(doneLock, [&] { return helpers == 0; });
+    }
+
+private:
+    ParsePool() = default;
+
+    void work()
+    {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this] { return stopping || !queue.empty(); });
+                if (queue.empty()) {
+                    return;
+                }
+                task = std::move(queue.front());
+                queue.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::function<void()>> queue;
+    std::vector<std::thread> threads;
+    bool stopping = false;
+};
+
+// Where `text` can be cut into about `count` blocks: each cut is the start of a "BO_ " line, so every block
+// but the first opens with a message header. Finding a cut reads a few lines past each even split point
+std::vector<std::string_view> splitBlocks(std::string_view text, size_t count)
+{
+    std::vector<std::string_view> blocks;
+    size_t start = 0;
+    for (size_t i = 1; i < count; ++i) {
+        size_t pos = std::max(start, text.size() / count * i);
+        size_t cut = std::string_view::npos;
+        while (pos < text.size()) {
+            size_t eol = text.find('\n', pos);
+            if (eol == std::string_view::npos) break;
+            std::string_view next = text.substr(eol + 1, 4);
+            if (next.size() == 4 && next.starts_with("BO_") && (next[3] == ' ' || next[3] == '\t')) {
+                cut = eol + 1;
+                break;
+            }
+            pos = eol + 1;
+        }
+        if (cut == std::string_view::npos) break;
+        blocks.push_back(text.substr(start, cut - start));
+        start = cut;
+    }
+    blocks.push_back(text.substr(start));
+    return blocks;
+}
+
+} // namespace
+
+void DbcReader::parse(std::string_view text, std::vector<canMessage>& messages)
+{
+    static const std::atomic<bool> never{false};
+    parse(text, messages, never, {});
+}
+
+bool DbcReader::parse(std::string_view text, std::vector<canMessage>& messages, const std::atomic<bool>& cancel,
+                      const std::function<void(size_t)>& progress, unsigned threads)
+{
+    // A block per thread, and none smaller than a progress step: below that, handing blocks out costs more than
+    // it saves
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t count = std::clamp<size_t>(text.size() / progressStep, 1, threads);
+    std::vector<Block> blocks;
+    for (std::string_view part : splitBlocks(text, count)) {
+        blocks.push_back(Block{part, {}, {}, false});
+    }
+
+    // Blocks finish out of order; progress only ever moves forward, one caller at a time
+    std::mutex progressMutex;
+    size_t done = 0;
+    auto advance = [&](size_t bytes) {
+        if (!progress || bytes == 0) return;
+        std::lock_guard<std::mutex> lock(progressMutex);
+        done += bytes;
+        progress(done);
+    };
+
+    if (blocks.size() == 1) {
+        parseBlock(blocks[0], cancel, advance);
+    } else {
+        ParsePool::shared().run(blocks.size(), [&](size_t i) { parseBlock(blocks[i], cancel, advance); });
+    }
+    if (cancel.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    // Merge in file order. A block's orphans go to the last message before it; ahead of the first BO_ there is
+    // none, and they are dropped as the serial parser always did
+    size_t total = messages.size();
+    for (const Block& block : blocks) {
+        total += block.messages.size();
+    }
+    messages.reserve(total);
+    bool haveMessage = !messages.empty();
+    for (Block& block : blocks) {
+        if (!block.completed) {
+            return false;
+        }
+        if (haveMessage) {
+            auto& list = messages.back().signalList;
+            std::move(block.orphans.begin(), block.orphans.end(), std::back_inserter(list));
+        }
+        std::move(block.messages.begin(), block.messages.end(), std::back_inserter(messages));
+        haveMessage = !messages.empty();
+    }
+    return true;
+}
+
+bool DbcReader::parseFile(const std::string& path, std::vector<canMessage>& messages, std::string& error)
+{
+    MappedFile file;
+    if (!file.open(path, error)) {
+        return false;
+    }
+    parse(file.view(), messages);
+    return true;
+}
@@ -0,0 +1,79 @@
+#ifndef DBCREADER_H
+#define DBCREADER_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Data structures for CAN messages and signals
+struct canSignal {
+    std::string name;
+    int startBit = 0;
+    int length = 0;
+    bool littleEndian = true;
+    bool isSigned = false; // @x- rather than @x+
+    double factor = 1.0;
+    double offset = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    std::string unit;
+    double value = 0.0; // Added to store current signal value
+};
+
+struct canMessage {
+    unsigned long id = 0;
+    std::string name;
+    int length = 0;
+    std::vector<canSignal> signalList; // Renamed from 'signals' to avoid Qt keyword conflict
+};
+
+// A whole file mapped read-only, or read into memory where mmap isn't available
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path, std::string& error);
+    void close();
+    std::string_view view() const { return {data, size}; }
+
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+    bool mapped = false;
+    std::vector<char> buffer; // Fallback copy
+};
+
+// Message and signal definitions (BO_ and SG_) of a DBC file, in one pass over the text without regexes or
+// per-line copies; every other section is skipped. Where it differs from the QTextStream/QRegularExpression
+// parser it replaces:
+//  - a message line must start with the BO_ token itself, so BO_TX_BU_ lines no longer become bogus messages;
+//  - a signal line is one whose first token is SG_, however it is indented, not any line containing " SG_";
+//  - multiplexed signals (M or m<n> before the colon) go through the standard path, with their sign, instead
+//    of the token-by-token fallback, which is still there for other SG_ lines laid out some other way
+class DbcReader {
+public:
+    static bool parseFile(const std::string& path, std::vector<canMessage>& messages, std::string& error);
+    static void parse(std::string_view text, std::vector<canMessage>& messages); // Appends to `messages`
+    // The same for a background load: `progress` (may be empty) gets the bytes parsed so far every
+    // progressStep bytes, and setting `cancel` stops the parse early. False if it was cancelled.
+    // Large texts are cut at BO_ lines into blocks that are parsed on up to `threads` threads (0: one per
+    // core), the calling one and a pool shared by all parses, and merged in file order; `progress` is then
+    // called from those threads, one call at a time
+    static bool parse(std::string_view text, std::vector<canMessage>& messages, const std::atomic<bool>& cancel,
+                      const std::function<void(size_t)>& progress, unsigned threads = 0);
+
+    static constexpr size_t progressStep = 256 * 1024;
+
+    // One BO_ line ("BO_ <id> <name>: <length> <sender>"), false if it isn't one
+    static bool parseMessageLine(std::string_view line, canMessage& msg);
+    // One SG_ line (" SG_ <name> [mux] : <start>|<length>@<order><sign> (<factor>,<offset>) [<min>|<max>] "<unit>" ...")
+    static bool parseSignalLine(std::string_view line, canSignal& sig);
+};
+
+#endif // DBCREADER_H
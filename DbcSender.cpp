@@ -4,9 +4,74 @@
 #include <iostream>
 #include <algorithm>
 #include <QGuiApplication>
+#include <QNetworkInterface>
+#include <QFileInfo>
+#include <QSettings>
+#include <QVariantMap>
+#include <QPromise>
+#include <QTimer>
+#include <memory>
+
+#ifdef HAS_SERVER_SUPPORT
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <cerrno>
+#include "DBCClient/shm_ring.h"
+#include "SocketCanBackend.h"
+#endif
+
+namespace {
+
+// A future that already has its value, for the answers that need no round trip
+template <typename T>
+QFuture<T> readyFuture(const T& value)
+{
+    QPromise<T> promise;
+    QFuture<T> future = promise.future();
+    promise.start();
+    promise.addResult(value);
+    promise.finish();
+    return future;
+}
+
+QFuture<void> readyFuture()
+{
+    QPromise<void> promise;
+    QFuture<void> future = promise.future();
+    promise.start();
+    promise.finish();
+    return future;
+}
+
+// KILL_TASK, PAUSE, RESUME and KILL_ALL_TASKS replies, whichever route they came over
+qint8 commandStatus(const QString& reply)
+{
+    if (reply.isEmpty()) {
+        return 3; // No reply in time
+    }
+    if (reply.startsWith("Task not found") || reply.startsWith("ERROR:")) {
+        return 4;
+    }
+    return reply.contains("Failed") ? 1 : 0; // The TCP Client couldn't send it
+}
+
+} // namespace
 
 DbcSender::DbcSender(QObject *parent) : QObject(parent), externalSocket(nullptr), usingExternalSocket(false), tcpClientRef(nullptr)
 {
+    // Both come from the pipeline's thread and are queued over to ours
+    connect(&pipeline, &RequestPipeline::eventReceived, this, &DbcSender::handleServerEvent);
+    connect(&pipeline, &RequestPipeline::connectionLost, this, &DbcSender::connectionLost);
+    connect(&pipeline, &RequestPipeline::reconnected, this, &DbcSender::handleReconnected);
+    connect(&pipeline, &RequestPipeline::linkStatsChanged, this, &DbcSender::linkStatsChanged);
+
+    // A dead link shows up within heartbeatTimeoutMs instead of when a command times out
+    QSettings settings;
+    pipeline.setHeartbeat(settings.value("heartbeatIntervalMs", 200).toInt(), settings.value("heartbeatTimeoutMs", 600).toInt());
+    pipeline.setAutoReconnect(true);
 }
 
 DbcSender::~DbcSender()
@@ -18,6 +83,7 @@ DbcSender::~DbcSender()
         std::cout << "DbcSender: Still connected during destruction, disconnecting..." << std::endl;
         disconnect();
     }
+    unmapReportRing();
     
     std::cout << "DbcSender: Destructor completed" << std::endl;
 }
@@ -27,845 +93,622 @@ DbcSender::~DbcSender()
 
 
 
-qint8 DbcSender::sendCANMessage(QString message)
+QFuture<SendResult> DbcSender::sendCANMessage(QString message)
 {
     qDebug() << "DbcSender::sendCANMessage called with message:" << message;
-    
-    // Check if we should route through TCP Client
-    if (shouldUseTcpClient()) {
-        qDebug() << "Routing CAN message through TCP Client";
-        std::cout << "Routing CAN message through TCP Client" << std::endl;
-        
-        // Format message for TCP Client
-        std::string c_message = "CANSEND#" + message.toStdString();
-        QString qmlMessage = QString::fromStdString(c_message);
-        
-        qDebug() << "Formatted message for TCP Client:" << qmlMessage;
-        std::cout << "Formatted message for TCP Client: " << qmlMessage.toStdString() << std::endl;
-        
-        // Send through TCP Client
-        QString result;
-        bool invokeSuccess = QMetaObject::invokeMethod(tcpClientRef, "sendMessage", Qt::DirectConnection,
-                                  Q_RETURN_ARG(QString, result),
-                                  Q_ARG(QString, qmlMessage));
-        
-        if (!invokeSuccess) {
-            qDebug() << "Failed to invoke sendMessage on TCP Client";
-            std::cout << "Failed to invoke sendMessage on TCP Client" << std::endl;
-            return 1;
-        }
-        
-        qDebug() << "TCP Client response:" << result;
-        std::cout << "TCP Client response: " << result.toStdString() << std::endl;
-        
-        // Extract task ID from server response
-        if (result.contains("task_")) {
-            // Find the task ID in the response (format: "task_X")
-            QRegularExpression taskRegex("task_(\\d+)");
-            QRegularExpressionMatch match = taskRegex.match(result);
-            if (match.hasMatch()) {
-                lastTaskId = match.captured(0); // This will be "task_X"
-                qDebug() << "Extracted task ID from TCP response:" << lastTaskId;
-                std::cout << "Extracted task ID from TCP response: " << lastTaskId.toStdString() << std::endl;
-            } else {
-                lastTaskId = QString::number(QDateTime::currentMSecsSinceEpoch() % 100000);
-                qDebug() << "Could not parse task ID, using temporary:" << lastTaskId;
-                std::cout << "Could not parse task ID, using temporary: " << lastTaskId.toStdString() << std::endl;
-            }
-        } else {
-            lastTaskId = QString::number(QDateTime::currentMSecsSinceEpoch() % 100000);
-            qDebug() << "No task ID in TCP response, using temporary:" << lastTaskId;
-            std::cout << "No task ID in TCP response, using temporary: " << lastTaskId.toStdString() << std::endl;
-        }
-        
-        return result.contains("Failed") ? 1 : 0;
-    }
-    
-    // Otherwise use direct socket connection
-    QTcpSocket* activeSocket = getActiveSocket();
-    
-    // Check if socket is connected
-    if (activeSocket->state() != QTcpSocket::ConnectedState) {
-        std::cerr << "Socket not connected. Current state: " << activeSocket->state() << std::endl;
-        return 1; // Not connected
-    }
 
     // New format: CANSEND#canid#canmessage#rate#canbus
     // Input message format: "canid#canmessage#rate#canbus" (from DbcParser::prepareCanMessage)
     // Final format sent to server: "CANSEND#canid#canmessage#rate#canbus"
-    std::string c_message = "CANSEND#" + message.toStdString();
-    std::cout << "Sending message: " << c_message << std::endl;
-    
-    qint64 bytesWritten = activeSocket->write(c_message.c_str(), c_message.size());
-    if (bytesWritten == -1) {
-        std::cerr << "Failed to write to socket: " << activeSocket->errorString().toStdString() << std::endl;
-        return 1; // Failure to Write
-    }
-    
-    if (!activeSocket->flush()) {
-        std::cerr << "Failed to flush socket" << std::endl;
-        return 2; // Flush failed
-    }
+    QString command = "CANSEND#" + message;
+    std::cout << "Sending message: " << command.toStdString() << std::endl;
 
-    // Wait for write to complete
-    if (!activeSocket->waitForBytesWritten(5000)) {
-        std::cerr << "Send timeout or error: " << activeSocket->errorString().toStdString() << std::endl;
-        
-        // Generate a temporary task ID for tracking even on write timeout
-        lastTaskId = QString::number(QDateTime::currentMSecsSinceEpoch() % 100000);
-        std::cout << "Write timeout occurred, using temporary task ID: " << lastTaskId.toStdString() << std::endl;
-        
-        return 2; // Timeout
-    }
-
-    // Wait for response
-    if (!activeSocket->waitForReadyRead(5000)) {
-        std::cerr << "Receive timeout or error: " << activeSocket->errorString().toStdString() << std::endl;
-        
-        // Generate a temporary task ID for tracking even on timeout
-        lastTaskId = QString::number(QDateTime::currentMSecsSinceEpoch() % 100000);
-        std::cout << "No response received due to timeout, using temporary task ID: " << lastTaskId.toStdString() << std::endl;
-        
-        return 3; // Receive timeout
-    }
-
-    QByteArray response = activeSocket->readAll();
-    if (response.isEmpty()) {
-        std::cout << "No response received" << std::endl;
-        return 0; // Might be normal for some servers
-    }
-
-    std::string responseStr = response.toStdString();
-    std::cout << "Server response: " << responseStr << std::endl;
-    
-    // Parse server response according to protocol
-    if (responseStr.find("OK: Cansend scheduled with task ID:") == 0) {
-        // Extract task ID from response
-        size_t taskIdStart = responseStr.find("task ID:") + 9;
-        std::string taskId = responseStr.substr(taskIdStart);
-        taskId.erase(taskId.find_last_not_of(" \n\r\t") + 1); // trim whitespace
-        
-        // Store the task ID for later use
-        lastTaskId = QString::fromStdString(taskId);
-        
-        std::cout << "Successfully scheduled CAN message with task ID: " << taskId << std::endl;
-        return 0; // Success
-    } else {
-        // If no standard response, try to extract any task ID from the response
-        std::cout << "Non-standard server response, attempting to parse task ID..." << std::endl;
-        
-        // Try to find any numeric task ID in the response
-        size_t taskIdPos = responseStr.find("task");
-        if (taskIdPos != std::string::npos) {
-            // Look for numbers after "task"
-            for (size_t i = taskIdPos; i < responseStr.length(); i++) {
-                if (std::isdigit(responseStr[i])) {
-                    std::string taskId;
-                    while (i < responseStr.length() && std::isdigit(responseStr[i])) {
-                        taskId += responseStr[i];
-                        i++;
-                    }
-                    if (!taskId.empty()) {
-                        lastTaskId = QString::fromStdString(taskId);
-                        std::cout << "Extracted task ID from response: " << taskId << std::endl;
-                        return 0; // Success
-                    }
-                    break;
-                }
-            }
-        }
-        
-        // If still no task ID found, generate a temporary one for tracking
-        lastTaskId = QString::number(QDateTime::currentMSecsSinceEpoch() % 100000);
-        std::cout << "No task ID in response, using temporary ID: " << lastTaskId.toStdString() << std::endl;
-    }
-    
-    if (responseStr.find("ERROR:") == 0) {
-        std::cerr << "Server error: " << responseStr << std::endl;
-        return 4; // Server error
-    } else if (responseStr.find("cansend error") != std::string::npos) {
-        std::cerr << "CAN send executable error: " << responseStr << std::endl;
-        return 5; // CAN executable error
-    }
-    
-    update();
-    return 0;
+    return requestAsync(command).then(this, [this](const QString& reply) {
+        return parseScheduled(reply);
+    });
 }
 
-qint8 DbcSender::sendOneShotMessage(QString message, int delayMs)
+QFuture<SendResult> DbcSender::sendOneShotMessage(QString message, int delayMs)
 {
     qDebug() << "DbcSender::sendOneShotMessage called with message:" << message << "delay:" << delayMs;
     std::cout << "DbcSender::sendOneShotMessage called with message: " << message.toStdString() << " delay: " << delayMs << "ms" << std::endl;
-    
-    // Check if we should route through TCP Client
-    if (shouldUseTcpClient()) {
-        qDebug() << "Routing one-shot CAN message through TCP Client";
-        std::cout << "Routing one-shot CAN message through TCP Client" << std::endl;
-        
-        // Format message for TCP Client using SEND_TASK protocol
-        // Expected format: SEND_TASK#<id#data>#<delay_ms>#<interface>
-        // Input message format: "canid#canmessage#rate#canbus" (from DbcParser::prepareCanMessage)
-        // We'll use the input format and set delay_ms
-        std::string c_message = "SEND_TASK#" + message.toStdString() + "#" + std::to_string(delayMs);
-        QString qmlMessage = QString::fromStdString(c_message);
-        
-        qDebug() << "Formatted one-shot message for TCP Client:" << qmlMessage;
-        std::cout << "Formatted one-shot message for TCP Client: " << qmlMessage.toStdString() << std::endl;
-        
-        // Send through TCP Client
-        QString result;
-        bool invokeSuccess = QMetaObject::invokeMethod(tcpClientRef, "sendMessage", Qt::DirectConnection,
-                                  Q_RETURN_ARG(QString, result),
-                                  Q_ARG(QString, qmlMessage));
-        
-        if (!invokeSuccess) {
-            qDebug() << "Failed to invoke sendMessage on TCP Client for one-shot";
-            std::cout << "Failed to invoke sendMessage on TCP Client for one-shot" << std::endl;
-            return 1;
-        }
-        
-        qDebug() << "TCP Client one-shot response:" << result;
-        std::cout << "TCP Client one-shot response: " << result.toStdString() << std::endl;
-        
-        // Extract task ID from server response
-        if (result.contains("task_")) {
-            QRegularExpression taskRegex("task_(\\d+)");
-            QRegularExpressionMatch match = taskRegex.match(result);
-            if (match.hasMatch()) {
-                lastTaskId = match.captured(0); // This will be "task_X"
-                qDebug() << "Extracted task ID from TCP one-shot response:" << lastTaskId;
-                std::cout << "Extracted task ID from TCP one-shot response: " << lastTaskId.toStdString() << std::endl;
-            } else {
-                lastTaskId = QString::number(QDateTime::currentMSecsSinceEpoch() % 100000);
-                qDebug() << "Could not parse task ID from one-shot, using temporary:" << lastTaskId;
-                std::cout << "Could not parse task ID from one-shot, using temporary: " << lastTaskId.toStdString() << std::endl;
-            }
-        } else {
-            lastTaskId = QString::number(QDateTime::currentMSecsSinceEpoch() % 100000);
-            qDebug() << "No task ID in TCP one-shot response, using temporary:" << lastTaskId;
-            std::cout << "No task ID in TCP one-shot response, using temporary: " << lastTaskId.toStdString() << std::endl;
-        }
-        
-        return result.contains("Failed") ? 1 : 0;
-    }
-    
-    // Otherwise use direct socket connection
-    QTcpSocket* activeSocket = getActiveSocket();
-    
-    // Check if socket is connected
-    if (activeSocket->state() != QTcpSocket::ConnectedState) {
-        std::cerr << "Socket not connected. Current state: " << activeSocket->state() << std::endl;
-        return 1; // Not connected
-    }
 
     // Format: SEND_TASK#<id#data>#<delay_ms>#<interface>
     // Input message format: "canid#canmessage#rate#canbus" (from DbcParser::prepareCanMessage)
     // Final format sent to server: "SEND_TASK#canid#canmessage#rate#canbus#<delay_ms>"
-    std::string c_message = "SEND_TASK#" + message.toStdString() + "#" + std::to_string(delayMs);
-    std::cout << "Sending one-shot message: " << c_message << std::endl;
-    
-    qint64 bytesWritten = activeSocket->write(c_message.c_str(), c_message.size());
-    if (bytesWritten == -1) {
-        std::cerr << "Failed to write one-shot to socket: " << activeSocket->errorString().toStdString() << std::endl;
-        return 1; // Failure to Write
-    }
-    
-    if (!activeSocket->flush()) {
-        std::cerr << "Failed to flush one-shot socket" << std::endl;
-        return 2; // Flush failed
-    }
-
-    // Wait for write to complete
-    if (!activeSocket->waitForBytesWritten(5000)) {
-        std::cerr << "One-shot send timeout or error: " << activeSocket->errorString().toStdString() << std::endl;
-        
-        // Generate a temporary task ID for tracking even on write timeout
-        lastTaskId = QString::number(QDateTime::currentMSecsSinceEpoch() % 100000);
-        std::cout << "One-shot write timeout occurred, using temporary task ID: " << lastTaskId.toStdString() << std::endl;
-        
-        return 2; // Timeout
-    }
-
-    // Wait for response
-    if (!activeSocket->waitForReadyRead(5000)) {
-        std::cerr << "One-shot receive timeout or error: " << activeSocket->errorString().toStdString() << std::endl;
-        
-        // Generate a temporary task ID for tracking even on timeout
-        lastTaskId = QString::number(QDateTime::currentMSecsSinceEpoch() % 100000);
-        std::cout << "No one-shot response received due to timeout, using temporary task ID: " << lastTaskId.toStdString() << std::endl;
-        
-        return 3; // Receive timeout
+    QString command = "SEND_TASK#" + message + "#" + QString::number(delayMs);
+    if (isUsingLocalBus()) {
+        // The local bus takes the delay from the rate field instead
+        QStringList parts = message.split('#');
+        if (parts.size() >= 4) {
+            parts[2] = QString::number(delayMs);
+        }
+        command = "SEND_TASK#" + parts.join('#');
     }
+    std::cout << "Sending one-shot message: " << command.toStdString() << std::endl;
 
-    QByteArray response = activeSocket->readAll();
-    if (response.isEmpty()) {
-        std::cout << "No one-shot response received" << std::endl;
-        return 0; // Might be normal for some servers
-    }
+    // Don't call update() for one-shot messages as they complete immediately
+    return requestAsync(command).then(this, [this](const QString& reply) {
+        return parseScheduled(reply);
+    });
+}
 
-    std::string responseStr = response.toStdString();
-    std::cout << "One-shot server response: " << responseStr << std::endl;
-    
-    // Parse server response according to SEND_TASK protocol
-    // Expected: "OK: SEND_TASK scheduled with task ID: task_5"
-    if (responseStr.find("OK: SEND_TASK scheduled with task ID:") == 0) {
-        // Extract task ID from response
-        size_t taskIdStart = responseStr.find("task ID:") + 9;
-        std::string taskId = responseStr.substr(taskIdStart);
-        taskId.erase(taskId.find_last_not_of(" \n\r\t") + 1); // trim whitespace
-        
-        // Store the task ID for later use
-        lastTaskId = QString::fromStdString(taskId);
-        
-        std::cout << "Successfully scheduled one-shot CAN message with task ID: " << taskId << std::endl;
-        return 0; // Success
+SendResult DbcSender::parseScheduled(const QString& reply)
+{
+    std::cout << "Server response: " << reply.toStdString() << std::endl;
+
+    // "OK: CANSEND scheduled with task ID: task_5" (SEND_TASK likewise), "ERROR: ..." or, from the TCP Client, "Failed ..."
+    SendResult result;
+    if (reply.isEmpty()) {
+        result.status = 3;
+    } else if (reply.startsWith("ERROR:")) {
+        std::cerr << "Server error: " << reply.toStdString() << std::endl;
+        result.status = 4;
+    } else if (reply.contains("cansend error")) {
+        std::cerr << "CAN send executable error: " << reply.toStdString() << std::endl;
+        result.status = 5;
+    } else if (reply.contains("Failed")) {
+        result.status = 1;
+    }
+
+    static const QRegularExpression taskPattern("task_\\d+");
+    QRegularExpressionMatch match = taskPattern.match(reply);
+    if (match.hasMatch()) {
+        result.taskId = match.captured(0);
     } else {
-        // If no standard response, try to extract any task ID from the response
-        std::cout << "Non-standard one-shot server response, attempting to parse task ID..." << std::endl;
-        
-        // Try to find any numeric task ID in the response
-        size_t taskIdPos = responseStr.find("task");
-        if (taskIdPos != std::string::npos) {
-            // Look for numbers after "task"
-            for (size_t i = taskIdPos; i < responseStr.length(); i++) {
-                if (std::isdigit(responseStr[i])) {
-                    std::string taskId;
-                    while (i < responseStr.length() && std::isdigit(responseStr[i])) {
-                        taskId += responseStr[i];
-                        i++;
-                    }
-                    if (!taskId.empty()) {
-                        lastTaskId = QString::fromStdString(taskId);
-                        std::cout << "Extracted task ID from one-shot response: " << taskId << std::endl;
-                        return 0; // Success
-                    }
-                    break;
-                }
-            }
-        }
-        
-        // If still no task ID found, generate a temporary one for tracking
-        lastTaskId = QString::number(QDateTime::currentMSecsSinceEpoch() % 100000);
-        std::cout << "No task ID in one-shot response, using temporary ID: " << lastTaskId.toStdString() << std::endl;
+        // Generate a temporary task ID for tracking even without one in the reply
+        result.taskId = QString::number(QDateTime::currentMSecsSinceEpoch() % 100000);
+        std::cout << "No task ID in response, using temporary ID: " << result.taskId.toStdString() << std::endl;
     }
-    
-    if (responseStr.find("ERROR:") == 0) {
-        std::cerr << "One-shot server error: " << responseStr << std::endl;
-        return 4; // Server error
-    } else if (responseStr.find("cansend error") != std::string::npos) {
-        std::cerr << "One-shot CAN send executable error: " << responseStr << std::endl;
-        return 5; // CAN executable error
-    }
-    
-    // Don't call update() for one-shot messages as they complete immediately
-    return 0;
+    lastTaskId = result.taskId;
+    return result;
 }
 
-qint8 DbcSender::initiateConnection(QString Address, QString Port)
+QFuture<qint8> DbcSender::initiateConnection(QString Address, QString Port)
 {
     // Check if already connected
-    if (socket.state() == QTcpSocket::ConnectedState) {
+    if (pipeline.isConnected()) {
         std::cout << "Already connected to server" << std::endl;
-        return 0;
+        return readyFuture<qint8>(0);
     }
 
-    // Disconnect any existing connection
-    if (socket.state() != QTcpSocket::UnconnectedState) {
-        socket.disconnectFromHost();
-        socket.waitForDisconnected(1000);
-    }
+#ifdef HAS_SERVER_SUPPORT
+    localBus.reset(); // A server replaces the local bus, and its tasks stop
+#endif
+
+    // Drop whatever is left of an earlier connection
+    pipeline.disconnectFromServer();
+    unmapReportRing();
+    taskTable.clear();
+    taskTableVersion = 0;
 
     QHostAddress address(Address);
     quint16 port = Port.toUShort();
+    QString server = Address + ":" + Port;
+
+    // A server on this machine also listens on its local socket, which skips the TCP stack and
+    // offers the shared-memory report ring. Anything else, or no local socket, goes over TCP
+    bool sameHost = address.isLoopback() || Address == "localhost" || QNetworkInterface::allAddresses().contains(address);
+    currentServer = server;
+    QFuture<bool> local = sameHost ? connectLocal() : readyFuture(false);
+    return local.then(this, [this, address, port, server](bool connected) {
+        if (connected) {
+            return setUpSession(server);
+        }
+        std::cout << "Attempting to connect to " << server.toStdString() << std::endl;
 
-    std::cout << "Attempting to connect to " << Address.toStdString() << ":" << port << std::endl;
-
-    socket.connectToHost(address, port);
-
-    // Wait for connection with proper event loop handling
-    if (socket.waitForConnected(5000)) {
-        std::cout << "Successfully connected to server at " << Address.toStdString() << ":" << port << std::endl;
-        return 0;
-    } else {
-        std::cout << "Failed to connect to server: " << socket.errorString().toStdString() << std::endl;
-        return 1;
-    }
+        // The pipeline's thread does the connecting (Nagle off); only the result comes back here
+        return pipeline.connectTcp(address.toString(), port, 5000).then(this, [this, server](bool ok) {
+            if (!ok) {
+                std::cout << "Failed to connect to server at " << server.toStdString() << std::endl;
+                return readyFuture<qint8>(1);
+            }
+            std::cout << "Successfully connected to server at " << server.toStdString() << std::endl;
+            return setUpSession(server);
+        }).unwrap();
+    }).unwrap();
 }
 
-qint8 DbcSender::stopCANMessage(QString taskId)
+QFuture<QString> DbcSender::exchangeMessage(const QString& message)
 {
-    std::cout << "DbcSender::stopCANMessage called with taskId: " << taskId.toStdString() << std::endl;
-    
-    // Check if we should route through TCP Client
-    if (shouldUseTcpClient()) {
-        std::cout << "Routing STOP command through TCP Client" << std::endl;
-        
-        QString killMessage = "KILL_TASK " + taskId;
-        
-        // Send through TCP Client
-        QString result;
-        bool invokeSuccess = QMetaObject::invokeMethod(tcpClientRef, "sendMessage", Qt::DirectConnection,
-                                  Q_RETURN_ARG(QString, result),
-                                  Q_ARG(QString, killMessage));
-        
-        if (!invokeSuccess) {
-            std::cout << "Failed to invoke sendMessage on TCP Client for KILL_TASK" << std::endl;
-            return 1;
+    // Always our own connection (local or TCP), never the external socket. The pipeline times the request out
+    return pipeline.request(message).then(this, [message](const QString& reply) {
+        if (reply.isEmpty()) {
+            std::cerr << "No reply to " << message.toStdString() << std::endl;
         }
-        
-        std::cout << "TCP Client KILL_TASK response: " << result.toStdString() << std::endl;
-        return result.contains("Failed") ? 1 : 0;
-    }
-    
-    // Otherwise use direct socket connection
-    QTcpSocket* activeSocket = getActiveSocket();
-    
-    // Check if socket is connected
-    if (activeSocket->state() != QTcpSocket::ConnectedState) {
-        std::cerr << "Socket not connected. Current state: " << activeSocket->state() << std::endl;
-        return 1; // Not connected
-    }
+        return reply;
+    });
+}
 
-    // Use proper KILL_TASK protocol: KILL_TASK <taskId>
-    std::string c_message = "KILL_TASK " + taskId.toStdString();
-    std::cout << "Sending message: " << c_message << std::endl;
+// The external socket's replies carry no tags: a command's reply is the next data to arrive, or nothing
+// once timeoutMs has passed. requestAsync() sends one command at a time on it
+QFuture<QString> DbcSender::externalRequest(const QString& message, int timeoutMs)
+{
+    auto promise = std::make_shared<QPromise<QString>>();
+    promise->start();
+    QFuture<QString> future = promise->future();
+    auto finish = [promise, future](const QString& reply) {
+        if (!future.isFinished()) {
+            promise->addResult(reply);
+            promise->finish();
+        }
+    };
+
+    if (!externalSocket || externalSocket->state() != QTcpSocket::ConnectedState) {
+        std::cerr << "Socket not connected" << std::endl;
+        finish(QString());
+        return future;
+    }
+    if (externalSocket->write(message.toUtf8()) == -1) {
+        std::cerr << "Failed to write to socket: " << externalSocket->errorString().toStdString() << std::endl;
+        finish(QString());
+        return future;
+    }
+
+    // The read and the timeout both belong to `waiter`, so whichever comes first also ends the other
+    QObject* waiter = new QObject(this);
+    QObject::connect(externalSocket, &QTcpSocket::readyRead, waiter, [this, finish, waiter]() {
+        finish(QString::fromUtf8(externalSocket->readAll()));
+        waiter->deleteLater();
+    });
+    QTimer::singleShot(timeoutMs, waiter, [finish, future, waiter, message]() {
+        if (!future.isFinished()) {
+            std::cerr << "Receive timeout for " << message.toStdString() << std::endl;
+        }
+        finish(QString());
+        waiter->deleteLater();
+    });
+    return future;
+}
 
-    qint64 bytesWritten = activeSocket->write(c_message.c_str(), c_message.size());
-    if (bytesWritten == -1) {
-        std::cerr << "Failed to write to socket: " << activeSocket->errorString().toStdString() << std::endl;
-        return 1; // Failure to Write
+QFuture<QString> DbcSender::requestAsync(const QString& command)
+{
+    if (isUsingLocalBus()) {
+        return readyFuture(localBusCommand(command));
     }
-
-    if (!activeSocket->flush()) {
-        std::cerr << "Failed to flush socket" << std::endl;
-        return 2; // Flush failed
+    if (shouldUseTcpClient()) {
+        QString reply;
+        if (!QMetaObject::invokeMethod(tcpClientRef, "sendMessage", Qt::DirectConnection,
+                                       Q_RETURN_ARG(QString, reply), Q_ARG(QString, command))) {
+            std::cout << "Failed to invoke sendMessage on TCP Client for " << command.toStdString() << std::endl;
+        }
+        return readyFuture(reply);
     }
-
-    // Wait for write to complete
-    if (!activeSocket->waitForBytesWritten(5000)) {
-        std::cerr << "Send timeout or error: " << activeSocket->errorString().toStdString() << std::endl;
-        return 2; // Timeout
+    if (usingExternalSocket) {
+        // Untagged replies, so each command goes out once the one before it is answered
+        externalTail = externalTail.isFinished()
+            ? externalRequest(command)
+            : externalTail.then(this, [this, command](const QString&) { return externalRequest(command); }).unwrap();
+        return externalTail;
     }
+    return pipeline.request(command);
+}
 
-    // Wait for response
-    if (!activeSocket->waitForReadyRead(5000)) {
-        std::cerr << "Receive timeout or error: " << activeSocket->errorString().toStdString() << std::endl;
-        return 3; // Receive timeout
-    }
+int DbcSender::pendingRequests() const
+{
+    return pipeline.outstanding();
+}
 
-    QByteArray response = activeSocket->readAll();
-    if (response.isEmpty()) {
-        std::cout << "No response received" << std::endl;
-        return 0; // Might be normal for some servers
+QFuture<bool> DbcSender::connectLocal()
+{
+    QString path = QSettings().value("localSocketPath", "/tmp/can-scheduler.sock").toString(); // server's UNIX_SOCKET
+    if (!QFileInfo::exists(path)) {
+        return readyFuture(false);
     }
+    return pipeline.connectLocal(path, 1000).then(this, [path](bool connected) {
+        if (connected) {
+            std::cout << "Connected to local server over " << path.toStdString() << std::endl;
+        } else {
+            std::cout << "Local socket " << path.toStdString() << " not answering, using TCP" << std::endl;
+        }
+        return connected;
+    });
+}
 
-    std::string responseStr = response.toStdString();
-    std::cout << "Server response: " << responseStr << std::endl;
-    
-    // Parse KILL_TASK response according to protocol
-    if (responseStr.find("Task ") == 0 && responseStr.find(" killed") != std::string::npos) {
-        std::cout << "Task killed successfully: " << responseStr << std::endl;
-        return 0; // Success
-    } else if (responseStr.find("Task not found") == 0) {
-        std::cerr << "Task not found: " << responseStr << std::endl;
-        return 4; // Task not found
-    }
-    
-    update();
-    return 0;
+// After connecting and after every automatic reconnect. The session comes first, so ATTACH has the tasks back
+// before anything else is asked; then the report ring (local socket only) and the event subscription
+QFuture<qint8> DbcSender::setUpSession(const QString& server)
+{
+    return resumeSession(server).then(this, [this]() {
+        return pipeline.isLocal() ? mapReportRing() : readyFuture();
+    }).unwrap().then(this, [this]() {
+        subscribeTaskEvents();
+        return qint8(0);
+    });
 }
 
-qint8 DbcSender::pauseCANMessage(QString taskId)
+// The server streams one report per finished send into a shared-memory ring for local clients. Reading it
+// costs no round trip, so per-send results don't have to be polled out of LIST_TASKS
+QFuture<void> DbcSender::mapReportRing()
 {
-    std::cout << "DbcSender::pauseCANMessage called with taskId: " << taskId.toStdString() << std::endl;
-    
-    // Check if we should route through TCP Client
-    if (shouldUseTcpClient()) {
-        std::cout << "Routing PAUSE command through TCP Client" << std::endl;
-        
-        QString pauseMessage = "PAUSE " + taskId;
-        
-        // Send through TCP Client
-        QString result;
-        bool invokeSuccess = QMetaObject::invokeMethod(tcpClientRef, "sendMessage", Qt::DirectConnection,
-                                  Q_RETURN_ARG(QString, result),
-                                  Q_ARG(QString, pauseMessage));
-        
-        if (!invokeSuccess) {
-            std::cout << "Failed to invoke sendMessage on TCP Client for PAUSE" << std::endl;
-            return 1;
+#ifdef HAS_SERVER_SUPPORT
+    // Reply is "SHM_RING <name> <slots>"; older servers answer "Unknown command"
+    return exchangeMessage("SHM_RING").then(this, [this](const QString& reply) {
+        QStringList parts = reply.split(' ', Qt::SkipEmptyParts);
+        if (parts.size() < 2 || parts[0] != "SHM_RING") {
+            return;
         }
-        
-        std::cout << "TCP Client PAUSE response: " << result.toStdString() << std::endl;
-        return result.contains("Failed") ? 1 : 0;
-    }
-    
-    // Otherwise use direct socket connection
-    QTcpSocket* activeSocket = getActiveSocket();
-    
-    // Check if socket is connected
-    if (activeSocket->state() != QTcpSocket::ConnectedState) {
-        std::cerr << "Socket not connected. Current state: " << activeSocket->state() << std::endl;
-        return 1; // Not connected
-    }
-
-    std::string c_message = "PAUSE " + taskId.toStdString();
-    std::cout << "Sending message: " << c_message << std::endl;
-
-    qint64 bytesWritten = activeSocket->write(c_message.c_str(), c_message.size());
-    if (bytesWritten == -1) {
-        std::cerr << "Failed to write to socket: " << activeSocket->errorString().toStdString() << std::endl;
-        return 1; // Failure to Write
-    }
-
-    if (!activeSocket->flush()) {
-        std::cerr << "Failed to flush socket" << std::endl;
-        return 2; // Flush failed
-    }
+        QByteArray name = parts[1].trimmed().toUtf8();
+        int fd = shm_open(name.constData(), O_RDWR, 0);
+        if (fd == -1) {
+            std::cerr << "Could not open report ring " << name.toStdString() << ": " << strerror(errno) << std::endl;
+            return;
+        }
+        struct stat st {};
+        void* mem = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            mem = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (mem == MAP_FAILED) {
+            std::cerr << "Could not map report ring " << name.toStdString() << std::endl;
+            return;
+        }
+        auto* header = static_cast<shm_ring::Header*>(mem);
+        if (!shm_ring::valid(header, static_cast<size_t>(st.st_size))) {
+            std::cerr << "Report ring " << name.toStdString() << " has an unknown layout, ignoring it" << std::endl;
+            munmap(mem, static_cast<size_t>(st.st_size));
+            return;
+        }
+        unmapReportRing(); // In case an earlier setup got here first
+        reportRing = header;
+        reportRingSize = static_cast<size_t>(st.st_size);
+        std::cout << "Mapped report ring " << name.toStdString() << " (" << header->capacity << " slots)" << std::endl;
+    });
+#else
+    return readyFuture();
+#endif
+}
 
-    // Wait for write to complete
-    if (!activeSocket->waitForBytesWritten(5000)) {
-        std::cerr << "Send timeout or error: " << activeSocket->errorString().toStdString() << std::endl;
-        return 2; // Timeout
+void DbcSender::unmapReportRing()
+{
+#ifdef HAS_SERVER_SUPPORT
+    if (reportRing) {
+        munmap(reportRing, reportRingSize);
     }
+#endif
+    reportRing = nullptr;
+    reportRingSize = 0;
+}
 
-    // Wait for response
-    if (!activeSocket->waitForReadyRead(5000)) {
-        std::cerr << "Receive timeout or error: " << activeSocket->errorString().toStdString() << std::endl;
-        return 3; // Receive timeout
+QVariantList DbcSender::takeSendReports()
+{
+    QVariantList reports;
+#ifdef HAS_SERVER_SUPPORT
+    if (!reportRing) {
+        return reports;
+    }
+    shm_ring::SendReport report;
+    while (shm_ring::pop(reportRing, report)) {
+        QString taskId = "task_" + QString::number(report.taskNumber);
+        QVariantMap entry;
+        entry["taskId"] = taskId;
+        entry["completedMs"] = static_cast<qint64>(report.completedMs);
+        entry["ok"] = report.ok != 0;
+        entry["missed"] = report.missed;
+        entry["dropped"] = report.dropped;
+        reports.append(entry);
+        if (!report.ok) {
+            for (CAN_Entry& current_entry : CAN_list) {
+                if (current_entry.taskID == taskId) {
+                    current_entry.status = "error";
+                }
+            }
+        }
     }
+#endif
+    return reports;
+}
 
-    QByteArray response = activeSocket->readAll();
-    if (response.isEmpty()) {
-        std::cout << "No response received" << std::endl;
-        return 0; // Might be normal for some servers
+qint8 DbcSender::useLocalBus()
+{
+#ifdef HAS_SERVER_SUPPORT
+    if (localBus) {
+        return 0;
     }
-
-    std::string responseStr = response.toStdString();
-    std::cout << "Server response: " << responseStr << std::endl;
-    
-    // Parse PAUSE response according to protocol
-    if (responseStr.find("Paused ") == 0) {
-        std::cout << "Task paused successfully: " << responseStr << std::endl;
-        return 0; // Success
-    } else if (responseStr.find("Task not found") == 0) {
-        std::cerr << "Task not found: " << responseStr << std::endl;
-        return 4; // Task not found
+    if (activeSocketConnected()) {
+        disconnect(); // Its tasks stop as on any deliberate disconnect
     }
-    
-    update();
+    localBus = std::make_unique<SocketCanBackend>();
+    std::vector<std::string> interfaces = SocketCanBackend::interfaces();
+    std::cout << "Using the local CAN bus, " << interfaces.size() << " interface(s) found" << std::endl;
     return 0;
+#else
+    std::cout << "The local CAN bus needs SocketCAN (Linux builds only)" << std::endl;
+    return 1;
+#endif
 }
 
-qint8 DbcSender::resumeCANMessage(QString taskId)
+bool DbcSender::isUsingLocalBus() const
 {
-    std::cout << "DbcSender::resumeCANMessage called with taskId: " << taskId.toStdString() << std::endl;
-    
-    // Check if we should route through TCP Client
-    if (shouldUseTcpClient()) {
-        std::cout << "Routing RESUME command through TCP Client" << std::endl;
-        
-        QString resumeMessage = "RESUME " + taskId;
-        
-        // Send through TCP Client
-        QString result;
-        bool invokeSuccess = QMetaObject::invokeMethod(tcpClientRef, "sendMessage", Qt::DirectConnection,
-                                  Q_RETURN_ARG(QString, result),
-                                  Q_ARG(QString, resumeMessage));
-        
-        if (!invokeSuccess) {
-            std::cout << "Failed to invoke sendMessage on TCP Client for RESUME" << std::endl;
-            return 1;
+#ifdef HAS_SERVER_SUPPORT
+    return localBus != nullptr;
+#else
+    return false;
+#endif
+}
+
+// Answers the commands DbcSender sends with the same replies the server gives, so the local bus
+// branches read the results the way the socket paths do
+QString DbcSender::localBusCommand(const QString& message)
+{
+#ifdef HAS_SERVER_SUPPORT
+    if (!localBus) {
+        return "ERROR: Not using the local bus\n";
+    }
+    std::string error;
+    if (message.startsWith("CANSEND#") || message.startsWith("SEND_TASK#")) {
+        bool recurring = message.startsWith("CANSEND#");
+        QStringList parts = message.section('#', 1).split('#'); // <id>#<data>#<ms>#<bus>[#priority[#policy]]
+        if (parts.size() < 4) {
+            return "ERROR: Invalid CANSEND syntax\n";
         }
-        
-        std::cout << "TCP Client RESUME response: " << result.toStdString() << std::endl;
-        return result.contains("Failed") ? 1 : 0;
-    }
-    
-    // Otherwise use direct socket connection
-    QTcpSocket* activeSocket = getActiveSocket();
-    
-    // Check if socket is connected
-    if (activeSocket->state() != QTcpSocket::ConnectedState) {
-        std::cerr << "Socket not connected. Current state: " << activeSocket->state() << std::endl;
-        return 1; // Not connected
+        QString time = parts[2].trimmed();
+        if (time.endsWith("ms")) {
+            time.chop(2);
+        }
+        bool ok = false;
+        int ms = time.toInt(&ok);
+        if (!ok) {
+            return "ERROR: Invalid time value\n";
+        }
+        SocketCanBackend::Frame frame;
+        if (!SocketCanBackend::parseFrame(parts[0].trimmed().toStdString(), parts[1].trimmed().toStdString(), frame, error)) {
+            return "ERROR: " + QString::fromStdString(error) + "\n";
+        }
+        std::string bus = parts[3].trimmed().toStdString();
+        std::string taskId = recurring ? localBus->startRecurring(bus, frame, ms, error)
+                                       : localBus->sendOnce(bus, frame, ms, error);
+        if (taskId.empty()) {
+            return "ERROR: " + QString::fromStdString(error) + "\n";
+        }
+        return QString("OK: %1 scheduled with task ID: %2\n").arg(recurring ? "CANSEND" : "SEND_TASK", QString::fromStdString(taskId));
     }
 
-    std::string c_message = "RESUME " + taskId.toStdString();
-    std::cout << "Sending message: " << c_message << std::endl;
-
-    qint64 bytesWritten = activeSocket->write(c_message.c_str(), c_message.size());
-    if (bytesWritten == -1) {
-        std::cerr << "Failed to write to socket: " << activeSocket->errorString().toStdString() << std::endl;
-        return 1; // Failure to Write
+    QString taskId = message.section(' ', 1).trimmed();
+    if (message.startsWith("KILL_TASK ")) {
+        return localBus->stop(taskId.toStdString()) ? "Task " + taskId + " killed\n" : QString("Task not found\n");
     }
-
-    if (!activeSocket->flush()) {
-        std::cerr << "Failed to flush socket" << std::endl;
-        return 2; // Flush failed
+    if (message.startsWith("PAUSE ")) {
+        return localBus->pause(taskId.toStdString()) ? "Paused " + taskId + "\n" : QString("Task not found\n");
     }
-
-    // Wait for write to complete
-    if (!activeSocket->waitForBytesWritten(5000)) {
-        std::cerr << "Send timeout or error: " << activeSocket->errorString().toStdString() << std::endl;
-        return 2; // Timeout
+    if (message.startsWith("RESUME ")) {
+        return localBus->resume(taskId.toStdString()) ? "Resumed " + taskId + "\n" : QString("Task not found\n");
     }
-
-    // Wait for response
-    if (!activeSocket->waitForReadyRead(5000)) {
-        std::cerr << "Receive timeout or error: " << activeSocket->errorString().toStdString() << std::endl;
-        return 3; // Receive timeout
+    if (message == "KILL_ALL_TASKS") {
+        localBus->stopAll();
+        return "All tasks killed\n";
     }
-
-    QByteArray response = activeSocket->readAll();
-    if (response.isEmpty()) {
-        std::cout << "No response received" << std::endl;
-        return 0; // Might be normal for some servers
+    if (message == "LIST_TASKS") {
+        return QString::fromStdString(localBus->listTasks());
     }
-
-    std::string responseStr = response.toStdString();
-    std::cout << "Server response: " << responseStr << std::endl;
-    
-    // Parse RESUME response according to protocol
-    if (responseStr.find("Resumed ") == 0) {
-        std::cout << "Task resumed successfully: " << responseStr << std::endl;
-        return 0; // Success
-    } else if (responseStr.find("Task not found") == 0) {
-        std::cerr << "Task not found: " << responseStr << std::endl;
-        return 4; // Task not found
+    if (message == "LIST_CAN_INTERFACES") {
+        std::vector<std::string> interfaces = SocketCanBackend::interfaces();
+        if (interfaces.empty()) {
+            return "No CAN interfaces available\n";
+        }
+        QString response = QString("Available CAN interfaces (%1):\n").arg(interfaces.size());
+        for (const std::string& iface : interfaces) {
+            response += "  " + QString::fromStdString(iface) + "\n";
+        }
+        return response;
     }
-    
-    update();
-    return 0;
+    return "ERROR: Unknown command\n";
+#else
+    Q_UNUSED(message);
+    return "ERROR: The local CAN bus needs SocketCAN (Linux builds only)\n";
+#endif
 }
 
-QString DbcSender::listTasks()
+// The server keeps a session's tasks running for a grace period after the connection drops, so after a
+// short network hiccup we take them back with ATTACH instead of sending every transmission again
+QFuture<void> DbcSender::resumeSession(const QString& server)
 {
-    std::cout << "DbcSender::listTasks called" << std::endl;
-    
-    // Check if we should route through TCP Client
-    if (shouldUseTcpClient()) {
-        std::cout << "Routing LIST_TASKS command through TCP Client" << std::endl;
-        
-        QString listMessage = "LIST_TASKS";
-        
-        // Send through TCP Client
-        QString result;
-        bool invokeSuccess = QMetaObject::invokeMethod(tcpClientRef, "sendMessage", Qt::DirectConnection,
-                                  Q_RETURN_ARG(QString, result),
-                                  Q_ARG(QString, listMessage));
-        
-        if (!invokeSuccess) {
-            std::cout << "Failed to invoke sendMessage on TCP Client for LIST_TASKS" << std::endl;
-            return "Error: Failed to communicate with TCP Client";
+    if (sessionToken.isEmpty() || sessionServer != server) {
+        return startSession(server);
+    }
+    return exchangeMessage("ATTACH " + sessionToken).then(this, [this, server](const QString& response) {
+        if (response.startsWith("Attached")) {
+            std::cout << "Reattached to session " << sessionToken.toStdString() << std::endl;
+            parseUpdateResponse(response); // The reply carries the whole task list
+            return readyFuture();
         }
-        
-        std::cout << "TCP Client LIST_TASKS response: " << result.toStdString() << std::endl;
-        return result;
-    }
-    
-    // Otherwise use direct socket connection
-    QTcpSocket* activeSocket = getActiveSocket();
-    
-    // Check if socket is connected
-    if (activeSocket->state() != QTcpSocket::ConnectedState) {
-        std::cerr << "Socket not connected. Current state: " << activeSocket->state() << std::endl;
-        return "Error: Not connected";
-    }
+        std::cout << "Could not reattach to session " << sessionToken.toStdString() << ": " << response.toStdString() << std::endl;
+        return startSession(server);
+    }).unwrap();
+}
 
-    std::string c_message = "LIST_TASKS";
-    std::cout << "Sending message: " << c_message << std::endl;
+QFuture<void> DbcSender::startSession(const QString& server)
+{
+    // Reply is "SESSION <token> <grace_ms>"; servers without sessions answer "Unknown command"
+    return exchangeMessage("SESSION").then(this, [this, server](const QString& response) {
+        QStringList parts = response.split(' ', Qt::SkipEmptyParts);
+        if (parts.size() >= 2 && parts[0] == "SESSION") {
+            sessionToken = parts[1].trimmed();
+            sessionServer = server;
+            std::cout << "Started session " << sessionToken.toStdString() << std::endl;
+        } else {
+            sessionToken.clear();
+            sessionServer.clear();
+        }
+    });
+}
 
-    qint64 bytesWritten = activeSocket->write(c_message.c_str(), c_message.size());
-    if (bytesWritten == -1) {
-        std::cerr << "Failed to write to socket: " << activeSocket->errorString().toStdString() << std::endl;
-        return "Error: Failed to write to socket";
-    }
+QFuture<qint8> DbcSender::stopCANMessage(QString taskId)
+{
+    std::cout << "DbcSender::stopCANMessage called with taskId: " << taskId.toStdString() << std::endl;
 
-    if (!activeSocket->flush()) {
-        std::cerr << "Failed to flush socket" << std::endl;
-        return "Error: Failed to flush socket";
-    }
+    // Use proper KILL_TASK protocol: KILL_TASK <taskId>
+    return requestAsync("KILL_TASK " + taskId).then(this, [](const QString& reply) {
+        std::cout << "KILL_TASK response: " << reply.toStdString() << std::endl;
+        return commandStatus(reply);
+    });
+}
 
-    // Wait for write to complete
-    if (!activeSocket->waitForBytesWritten(5000)) {
-        std::cerr << "Send timeout or error: " << activeSocket->errorString().toStdString() << std::endl;
-        return "Error: Send timeout";
-    }
+QFuture<qint8> DbcSender::pauseCANMessage(QString taskId)
+{
+    std::cout << "DbcSender::pauseCANMessage called with taskId: " << taskId.toStdString() << std::endl;
 
-    // Wait for response
-    if (!activeSocket->waitForReadyRead(5000)) {
-        std::cerr << "Receive timeout or error: " << activeSocket->errorString().toStdString() << std::endl;
-        return "Error: Receive timeout";
-    }
+    return requestAsync("PAUSE " + taskId).then(this, [](const QString& reply) {
+        std::cout << "PAUSE response: " << reply.toStdString() << std::endl;
+        return commandStatus(reply);
+    });
+}
 
-    QByteArray response = activeSocket->readAll();
-    if (response.isEmpty()) {
-        std::cout << "No response received for LIST_TASKS" << std::endl;
-        return "No tasks";
-    }
+QFuture<qint8> DbcSender::resumeCANMessage(QString taskId)
+{
+    std::cout << "DbcSender::resumeCANMessage called with taskId: " << taskId.toStdString() << std::endl;
 
-    QString responseStr = QString::fromUtf8(response);
-    std::cout << "LIST_TASKS Server response: " << responseStr.toStdString() << std::endl;
-    
-    return responseStr;
+    return requestAsync("RESUME " + taskId).then(this, [](const QString& reply) {
+        std::cout << "RESUME response: " << reply.toStdString() << std::endl;
+        return commandStatus(reply);
+    });
 }
 
-qint8 DbcSender::killAllTasks()
+QFuture<QString> DbcSender::listTasks()
 {
-    std::cout << "DbcSender::killAllTasks called" << std::endl;
-    
-    // Check if we should route through TCP Client
-    if (shouldUseTcpClient()) {
-        std::cout << "Routing KILL_ALL_TASKS command through TCP Client" << std::endl;
-        
-        QString killAllMessage = "KILL_ALL_TASKS";
-        
-        // Send through TCP Client
-        QString result;
-        bool invokeSuccess = QMetaObject::invokeMethod(tcpClientRef, "sendMessage", Qt::DirectConnection,
-                                  Q_RETURN_ARG(QString, result),
-                                  Q_ARG(QString, killAllMessage));
-        
-        if (!invokeSuccess) {
-            std::cout << "Failed to invoke sendMessage on TCP Client for KILL_ALL_TASKS" << std::endl;
-            return 1;
-        }
-        
-        std::cout << "TCP Client KILL_ALL_TASKS response: " << result.toStdString() << std::endl;
-        return result.contains("Failed") ? 1 : 0;
-    }
-    
-    // Otherwise use direct socket connection
-    QTcpSocket* activeSocket = getActiveSocket();
-    
-    // Check if socket is connected
-    if (activeSocket->state() != QTcpSocket::ConnectedState) {
-        std::cerr << "Socket not connected. Current state: " << activeSocket->state() << std::endl;
-        return 1; // Not connected
-    }
+    std::cout << "DbcSender::listTasks called" << std::endl;
 
-    std::string c_message = "KILL_ALL_TASKS";
-    std::cout << "Sending message: " << c_message << std::endl;
+    return requestAsync("LIST_TASKS").then(this, [](const QString& reply) {
+        std::cout << "LIST_TASKS response: " << reply.toStdString() << std::endl;
+        return reply.isEmpty() ? QString("Error: No reply") : reply;
+    });
+}
 
-    qint64 bytesWritten = activeSocket->write(c_message.c_str(), c_message.size());
-    if (bytesWritten == -1) {
-        std::cerr << "Failed to write to socket: " << activeSocket->errorString().toStdString() << std::endl;
-        return 1; // Failure to write
-    }
+QFuture<qint8> DbcSender::killAllTasks()
+{
+    std::cout << "DbcSender::killAllTasks called" << std::endl;
 
-    if (!activeSocket->flush()) {
-        std::cerr << "Failed to flush socket" << std::endl;
-        return 2; // Flush failed
-    }
+    // "All tasks killed", or "No tasks", which is just as good
+    return requestAsync("KILL_ALL_TASKS").then(this, [](const QString& reply) {
+        std::cout << "KILL_ALL_TASKS response: " << reply.toStdString() << std::endl;
+        return commandStatus(reply);
+    });
+}
 
-    // Wait for write to complete
-    if (!activeSocket->waitForBytesWritten(5000)) {
-        std::cerr << "Send timeout or error: " << activeSocket->errorString().toStdString() << std::endl;
-        return 2; // Timeout
+QFuture<qint8> DbcSender::update()
+{
+    if (!isUsingLocalBus() && !shouldUseTcpClient()) {
+        // Our own connection, which only fetches what changed
+        return refreshTasks();
     }
 
-    // Wait for response
-    if (!activeSocket->waitForReadyRead(5000)) {
-        std::cerr << "Receive timeout or error: " << activeSocket->errorString().toStdString() << std::endl;
-        return 3; // Receive timeout
-    }
+    // The local bus answers LIST_TASKS and the TCP Client UPDATE, both with the listing parseUpdateResponse reads
+    return requestAsync(isUsingLocalBus() ? "LIST_TASKS" : "UPDATE").then(this, [this](const QString& reply) {
+        parseUpdateResponse(reply);
+        return qint8(reply.isEmpty() || reply.contains("Error") ? 1 : 0);
+    });
+}
 
-    QByteArray response = activeSocket->readAll();
-    if (response.isEmpty()) {
-        std::cout << "No response received for KILL_ALL_TASKS" << std::endl;
-        return 0; // Might be normal for some servers
+QFuture<qint8> DbcSender::refreshTasks()
+{
+    if (isUsingLocalBus() || shouldUseTcpClient() || usingExternalSocket) {
+        return readyFuture<qint8>(1); // Only our own connection has the structured listing
     }
-
-    std::string responseStr = response.toStdString();
-    std::cout << "KILL_ALL_TASKS Server response: " << responseStr << std::endl;
-    
-    // Parse KILL_ALL_TASKS response according to protocol
-    if (responseStr.find("All tasks killed") != std::string::npos || 
-        responseStr.find("OK") != std::string::npos) {
-        std::cout << "All tasks killed successfully: " << responseStr << std::endl;
-        return 0; // Success
-    } else if (responseStr.find("No tasks") != std::string::npos) {
-        std::cout << "No tasks to kill: " << responseStr << std::endl;
-        return 0; // Success (no tasks is OK)
+    if (!refreshing.isFinished()) {
+        return refreshing; // Already paging; a second pass would fetch the same records
     }
-    
-    return 0; // Default success
+    refreshing = fetchTaskPage(0);
+    return refreshing;
 }
 
-qint8 DbcSender::update()
+QFuture<qint8> DbcSender::fetchTaskPage(int resets)
 {
-    // Check if we should route through TCP Client
-    if (shouldUseTcpClient()) {
-        std::cout << "Routing UPDATE command through TCP Client" << std::endl;
-        
-        QString updateMessage = "UPDATE";
-        
-        // Send through TCP Client
-        QString result;
-        bool invokeSuccess = QMetaObject::invokeMethod(tcpClientRef, "sendMessage", Qt::DirectConnection,
-                                  Q_RETURN_ARG(QString, result),
-                                  Q_ARG(QString, updateMessage));
-        
-        if (!invokeSuccess) {
-            std::cout << "Failed to invoke sendMessage on TCP Client for UPDATE" << std::endl;
-            return 1;
+    // Pages of changed records, so even thousands of tasks never make one huge reply
+    constexpr int pageSize = 500;
+
+    quint64 since = taskTableVersion;
+    QString command = QString("LIST_TASKS since=%1 limit=%2").arg(since).arg(pageSize);
+    return requestAsync(command).then(this, [this, since, resets](const QString& reply) {
+        if (reply.isEmpty()) {
+            return readyFuture<qint8>(3);
         }
-        
-        std::cout << "TCP Client UPDATE response: " << result.toStdString() << std::endl;
-        
-        // Parse the response to update CAN_list
-        // For TCP Client, we need to parse the result string similar to the direct socket response
-        parseUpdateResponse(result);
-        return result.contains("Error") ? 1 : 0;
-    }
-    
-    // Otherwise use direct socket connection
-    QTcpSocket* activeSocket = getActiveSocket();
-    
-    // Check if socket is connected
-    if (activeSocket->state() != QTcpSocket::ConnectedState) {
-        std::cerr << "Socket not connected. Current state: " << activeSocket->state() << std::endl;
-        return 1; // Not connected
-    }
-
-    std::string c_message = "UPDATE";
-    std::cout << "Sending message: " << c_message << std::endl;
-
-    qint64 bytesWritten = activeSocket->write(c_message.c_str(), c_message.size());
-    if (bytesWritten == -1) {
-        std::cerr << "Failed to write to socket: " << activeSocket->errorString().toStdString() << std::endl;
-        return 1; // Failure to Write
-    }
-
-    if (!activeSocket->flush()) {
-        std::cerr << "Failed to flush socket" << std::endl;
-        return 2; // Flush failed
-    }
-
-    // Wait for write to complete
-    if (!activeSocket->waitForBytesWritten(5000)) {
-        std::cerr << "Send timeout or error: " << activeSocket->errorString().toStdString() << std::endl;
-        return 2; // Timeout
-    }
-
-    // Wait for response
-    if (!activeSocket->waitForReadyRead(5000)) {
-        std::cerr << "Receive timeout or error: " << activeSocket->errorString().toStdString() << std::endl;
-        return 3; // Receive timeout
-    }
-
-    QByteArray response = activeSocket->readAll();
-    if (response.isEmpty()) {
-        std::cout << "No response received" << std::endl;
-        return 0; // Might be normal for some servers
-    }
-
-    std::cout << "Server response: " << response.toStdString() << std::endl; // haven't implemented response codes
+        QByteArray response = reply.toUtf8();
+        bool more = false;
+        if (!applyTaskListing(response, taskTable, taskTableVersion, more)) {
+            std::cerr << "Unexpected task listing: " << response.left(80).toStdString() << std::endl;
+            return readyFuture<qint8>(4);
+        }
+        int resetCount = resets;
+        if (taskTableVersion == 0 && since != 0 && ++resetCount > 2) {
+            return readyFuture<qint8>(4); // Keeps resetting, the server is dropping removals faster than we page
+        }
+        return more ? fetchTaskPage(resetCount) : readyFuture<qint8>(0);
+    }).unwrap();
+}
 
-    QString responseStr = QString::fromUtf8(response);
-    parseUpdateResponse(responseStr);
-    return 0;
+bool DbcSender::applyTaskListing(QByteArrayView reply, QHash<QString, TaskRecord>& table, quint64& version, bool& more)
+{
+    // Fields are views into `reply`; only what ends up in a TaskRecord is copied
+    auto nextLine = [&reply]() {
+        qsizetype end = reply.indexOf('\n');
+        QByteArrayView line = end < 0 ? reply : reply.first(end);
+        reply = end < 0 ? QByteArrayView() : reply.sliced(end + 1);
+        return line;
+    };
+    auto nextField = [](QByteArrayView& line) {
+        qsizetype end = line.indexOf(' ');
+        QByteArrayView field = end < 0 ? line : line.first(end);
+        line = end < 0 ? QByteArrayView() : line.sliced(end + 1);
+        return field;
+    };
+
+    // "TASKS <next> <count> <more>" or "TASKS <version> reset"
+    QByteArrayView header = nextLine();
+    bool ok = false;
+    if (nextField(header) != "TASKS") {
+        return false;
+    }
+    quint64 next = nextField(header).toULongLong(&ok);
+    if (!ok) {
+        return false;
+    }
+    QByteArrayView count = nextField(header);
+    if (count == "reset") {
+        table.clear();
+        version = 0;
+        more = true;
+        return true;
+    }
+    bool hasMore = nextField(header) == "1";
+
+    for (qsizetype remaining = count.toLongLong(&ok); ok && remaining > 0 && !reply.isEmpty(); --remaining) {
+        QByteArrayView line = nextLine();
+        QString taskId = QString::fromLatin1(nextField(line));
+        quint64 recordVersion = nextField(line).toULongLong();
+        QByteArrayView state = nextField(line);
+        if (state == "removed") {
+            table.remove(taskId);
+            continue;
+        }
+        TaskRecord& record = table[taskId];
+        record.taskId = taskId;
+        record.version = recordVersion;
+        record.state = state == "paused" ? TaskRecord::State::Paused
+                     : state == "stopped" ? TaskRecord::State::Stopped
+                     : state == "error" ? TaskRecord::State::Error
+                     : TaskRecord::State::Running;
+        record.recurring = nextField(line) == "recurring";
+        record.intervalMs = nextField(line).toInt();
+        record.priority = nextField(line).toInt();
+        record.policy = QString::fromLatin1(nextField(line));
+        record.bus = QString::fromLatin1(nextField(line));
+        QByteArrayView frame = nextField(line);
+        qsizetype hash = frame.indexOf('#');
+        record.canId = frame.first(hash < 0 ? frame.size() : hash).toUInt(nullptr, 16);
+        record.data = hash < 0 ? QByteArray() : frame.sliced(hash + 1).toByteArray();
+        record.sent = nextField(line).toULongLong();
+        record.missed = nextField(line).toULongLong();
+        record.dropped = nextField(line).toULongLong();
+        record.leaseMs = nextField(line).toLongLong();
+        record.error = QString::fromUtf8(line); // The rest of the line, usually empty
+    }
+    if (!ok) {
+        return false;
+    }
+    version = next;
+    more = hasMore;
+    return true;
 }
 
 void DbcSender::parseUpdateResponse(const QString& responseStr)
@@ -999,6 +842,10 @@ void DbcSender::printCANlist() {
 
 bool DbcSender::isConnected() const
 {
+    if (isUsingLocalBus()) {
+        return true; // Nothing to lose: the local bus has no connection
+    }
+
     // First check if we should use TCP Client
     if (shouldUseTcpClient()) {
         return true; // This method already checked that TCP Client is connected
@@ -1014,10 +861,7 @@ bool DbcSender::isConnected() const
     }
     
     // Otherwise check our own socket connection
-    if (usingExternalSocket && externalSocket) {
-        return externalSocket->state() == QTcpSocket::ConnectedState;
-    }
-    return socket.state() == QTcpSocket::ConnectedState;
+    return activeSocketConnected();
 }
 
 QString DbcSender::getLastTaskId() const
@@ -1032,9 +876,12 @@ void DbcSender::setExternalSocket(QTcpSocket* socket)
     std::cout << "DbcSender: " << (usingExternalSocket ? "Using external socket" : "Using internal socket") << std::endl;
 }
 
-QTcpSocket* DbcSender::getActiveSocket()
+bool DbcSender::activeSocketConnected() const
 {
-    return usingExternalSocket ? externalSocket : &socket;
+    if (usingExternalSocket) {
+        return externalSocket && externalSocket->state() == QTcpSocket::ConnectedState;
+    }
+    return pipeline.isConnected();
 }
 
 bool DbcSender::shouldUseTcpClient() const
@@ -1052,10 +899,87 @@ bool DbcSender::shouldUseTcpClient() const
     return false;
 }
 
+// Task state changes come to us from now on, so nothing has to poll LIST_TASKS. A server without SUBSCRIBE
+// answers "Unknown command" and simply never pushes anything
+void DbcSender::subscribeTaskEvents()
+{
+    pipeline.submit("SUBSCRIBE");
+}
+
+// The pipeline got the connection back by itself. The server sees a new client, so take the session's tasks
+// back and set up the ring and the event subscription again
+void DbcSender::handleReconnected()
+{
+    std::cout << "Reconnected to " << currentServer.toStdString() << std::endl;
+    unmapReportRing();
+    setUpSession(currentServer).then(this, [this](qint8) {
+        emit reconnected();
+    });
+}
+
+QVariantMap DbcSender::linkStats() const
+{
+    LinkStats stats = pipeline.linkStats();
+    QVariantList histogram;
+    for (int count : stats.histogram) {
+        histogram.append(count);
+    }
+    QVariantList edges;
+    for (double edge : RequestPipeline::histogramEdgesMs()) {
+        edges.append(edge);
+    }
+    QVariantMap map;
+    map["rttMs"] = stats.lastMs;
+    map["meanMs"] = stats.meanMs;
+    map["jitterMs"] = stats.jitterMs;
+    map["p50Ms"] = stats.p50Ms;
+    map["p99Ms"] = stats.p99Ms;
+    map["samples"] = stats.samples;
+    map["histogram"] = histogram;
+    map["histogramEdgesMs"] = edges;
+    map["deadPeers"] = stats.deadPeers;
+    map["reconnectAttempt"] = stats.reconnectAttempt;
+    return map;
+}
+
+void DbcSender::setHeartbeat(int intervalMs, int deadAfterMs)
+{
+    QSettings settings;
+    settings.setValue("heartbeatIntervalMs", intervalMs);
+    settings.setValue("heartbeatTimeoutMs", deadAfterMs);
+    pipeline.setHeartbeat(intervalMs, deadAfterMs);
+}
+
+// "TASK <task_id> <state>[ <detail>]" or "SENT <task_id> <count>", see SUBSCRIBE in DBCClient/server.cpp
+void DbcSender::handleServerEvent(const QString& event)
+{
+    QStringList parts = event.split(' ', Qt::SkipEmptyParts);
+    if (parts.size() < 3) {
+        return;
+    }
+    if (parts[0] == "TASK") {
+        emit taskEvent(parts[1], parts[2], parts.mid(3).join(' '));
+    } else if (parts[0] == "SENT") {
+        bool ok = false;
+        int sends = parts[2].toInt(&ok);
+        if (ok) {
+            emit taskSendsCounted(parts[1], sends);
+        }
+    }
+}
+
 void DbcSender::disconnect()
 {
     std::cout << "DbcSender::disconnect() called" << std::endl;
     
+#ifdef HAS_SERVER_SUPPORT
+    if (localBus) {
+        std::cout << "Leaving the local bus, stopping its tasks..." << std::endl;
+        localBus.reset(); // Stops every task and joins the worker
+        return;
+    }
+#endif
+
     // If using TCP Client, we should disconnect through it
     if (shouldUseTcpClient()) {
         std::cout << "Disconnecting through TCP Client..." << std::endl;
@@ -1084,22 +1008,29 @@ void DbcSender::disconnect()
     }
     
     // Otherwise disconnect our own socket
-    QTcpSocket* activeSocket = getActiveSocket();
-    if (activeSocket && activeSocket->state() == QTcpSocket::ConnectedState) {
+    if (activeSocketConnected()) {
         std::cout << "Disconnecting from server..." << std::endl;
         
         // Kill all tasks before disconnecting
         std::cout << "Killing all tasks before disconnect..." << std::endl;
         killAllTasks();
+        sessionToken.clear(); // Deliberate disconnect, nothing to resume
+        currentServer.clear();
+        sessionServer.clear();
         
         // Send a proper disconnect message to server
         std::cout << "Sending disconnect message to server..." << std::endl;
         sendDisconnectMessage();
         
         // Now disconnect
-        activeSocket->disconnectFromHost();
-        if (activeSocket->state() != QTcpSocket::UnconnectedState) {
-            activeSocket->waitForDisconnected(3000);
+        unmapReportRing();
+        if (usingExternalSocket) {
+            externalSocket->disconnectFromHost();
+            if (externalSocket->state() != QTcpSocket::UnconnectedState) {
+                externalSocket->waitForDisconnected(3000);
+            }
+        } else {
+            pipeline.disconnectFromServer(); // After both commands on the pipeline's thread; their replies aren't waited for
         }
         std::cout << "Disconnected from server" << std::endl;
     } else {
@@ -1107,143 +1038,25 @@ void DbcSender::disconnect()
     }
 }
 
-QString DbcSender::listCanInterfaces()
+QFuture<QString> DbcSender::listCanInterfaces()
 {
     std::cout << "DbcSender::listCanInterfaces called" << std::endl;
-    
-    // Check if we should route through TCP Client
-    if (shouldUseTcpClient()) {
-        std::cout << "Routing LIST_CAN_INTERFACES command through TCP Client" << std::endl;
-        
-        QString listMessage = "LIST_CAN_INTERFACES";
-        
-        // Send through TCP Client
-        QString result;
-        bool invokeSuccess = QMetaObject::invokeMethod(tcpClientRef, "sendMessage", Qt::DirectConnection,
-                                  Q_RETURN_ARG(QString, result),
-                                  Q_ARG(QString, listMessage));
-        
-        if (!invokeSuccess) {
-            std::cout << "Failed to invoke sendMessage on TCP Client for LIST_CAN_INTERFACES" << std::endl;
-            return "Error: Failed to communicate with TCP Client";
-        }
-        
-        std::cout << "TCP Client LIST_CAN_INTERFACES response: " << result.toStdString() << std::endl;
-        return result;
-    }
-    
-    // Otherwise use direct socket connection
-    QTcpSocket* activeSocket = getActiveSocket();
-    
-    // Check if socket is connected
-    if (activeSocket->state() != QTcpSocket::ConnectedState) {
-        std::cerr << "Socket not connected. Current state: " << activeSocket->state() << std::endl;
-        return "Error: Not connected";
-    }
-
-    std::string c_message = "LIST_CAN_INTERFACES";
-    std::cout << "Sending message: " << c_message << std::endl;
 
-    qint64 bytesWritten = activeSocket->write(c_message.c_str(), c_message.size());
-    if (bytesWritten == -1) {
-        std::cerr << "Failed to write to socket: " << activeSocket->errorString().toStdString() << std::endl;
-        return "Error: Failed to write to socket";
-    }
-
-    if (!activeSocket->flush()) {
-        std::cerr << "Failed to flush socket" << std::endl;
-        return "Error: Failed to flush socket";
-    }
-
-    // Wait for write to complete
-    if (!activeSocket->waitForBytesWritten(5000)) {
-        std::cerr << "Send timeout or error: " << activeSocket->errorString().toStdString() << std::endl;
-        return "Error: Send timeout";
-    }
-
-    // Wait for response
-    if (!activeSocket->waitForReadyRead(5000)) {
-        std::cerr << "Receive timeout or error: " << activeSocket->errorString().toStdString() << std::endl;
-        return "Error: Receive timeout";
-    }
-
-    QByteArray response = activeSocket->readAll();
-    if (response.isEmpty()) {
-        std::cout << "No response received for LIST_CAN_INTERFACES" << std::endl;
-        return "No CAN interfaces available";
-    }
-
-    QString responseStr = QString::fromUtf8(response);
-    std::cout << "LIST_CAN_INTERFACES Server response: " << responseStr.toStdString() << std::endl;
-    
-    return responseStr;
+    return requestAsync("LIST_CAN_INTERFACES").then(this, [](const QString& reply) {
+        std::cout << "LIST_CAN_INTERFACES response: " << reply.toStdString() << std::endl;
+        return reply.isEmpty() ? QString("Error: No reply") : reply;
+    });
 }
 
-qint8 DbcSender::sendDisconnectMessage()
+QFuture<qint8> DbcSender::sendDisconnectMessage()
 {
     std::cout << "DbcSender::sendDisconnectMessage called" << std::endl;
-    
-    // Check if we should route through TCP Client
-    if (shouldUseTcpClient()) {
-        std::cout << "Routing DISCONNECT command through TCP Client" << std::endl;
-        
-        QString disconnectMessage = "DISCONNECT";
-        
-        // Send through TCP Client
-        QString result;
-        bool invokeSuccess = QMetaObject::invokeMethod(tcpClientRef, "sendMessage", Qt::DirectConnection,
-                                  Q_RETURN_ARG(QString, result),
-                                  Q_ARG(QString, disconnectMessage));
-        
-        if (!invokeSuccess) {
-            std::cout << "Failed to invoke sendMessage on TCP Client for DISCONNECT" << std::endl;
-            return 1;
-        }
-        
-        std::cout << "TCP Client DISCONNECT response: " << result.toStdString() << std::endl;
-        return result.contains("Failed") ? 1 : 0;
-    }
-    
-    // Otherwise use direct socket connection
-    QTcpSocket* activeSocket = getActiveSocket();
-    
-    // Check if socket is connected
-    if (!activeSocket || activeSocket->state() != QTcpSocket::ConnectedState) {
-        std::cout << "Socket not connected, cannot send disconnect message" << std::endl;
-        return 1; // Not connected
-    }
-
-    std::string c_message = "DISCONNECT";
-    std::cout << "Sending disconnect message: " << c_message << std::endl;
 
-    qint64 bytesWritten = activeSocket->write(c_message.c_str(), c_message.size());
-    if (bytesWritten == -1) {
-        std::cerr << "Failed to write disconnect message to socket: " << activeSocket->errorString().toStdString() << std::endl;
-        return 1; // Failure to Write
-    }
-
-    if (!activeSocket->flush()) {
-        std::cerr << "Failed to flush disconnect message" << std::endl;
-        return 2; // Flush failed
-    }
-
-    // Wait for write to complete (shorter timeout for disconnect)
-    if (!activeSocket->waitForBytesWritten(2000)) {
-        std::cerr << "Disconnect message send timeout: " << activeSocket->errorString().toStdString() << std::endl;
-        return 2; // Timeout
-    }
-
-    // Wait for response (shorter timeout for disconnect)
-    if (!activeSocket->waitForReadyRead(2000)) {
-        std::cout << "No response to disconnect message (this is normal)" << std::endl;
-        return 0; // Normal - server might not respond to disconnect
-    }
-
-    QByteArray response = activeSocket->readAll();
-    if (!response.isEmpty()) {
-        std::string responseStr = response.toStdString();
-        std::cout << "Disconnect message server response: " << responseStr << std::endl;
-    }
-    
-    return 0; // Success
+    // No reply to DISCONNECT is normal
+    return requestAsync("DISCONNECT").then(this, [](const QString& reply) {
+        if (!reply.isEmpty()) {
+            std::cout << "Disconnect message server response: " << reply.toStdString() << std::endl;
+        }
+        return qint8(reply.contains("Failed") ? 1 : 0);
+    });
 }
@@ -2,6 +2,17 @@
 #define DBCSENDER_H
 #include <QObject>
 #include <QTcpSocket>
+#include <QFuture>
+#include <QVariantList>
+#include <QVariantMap>
+#include <QHash>
+#include <QByteArrayView>
+#include <memory>
+#include <string>
+#include "RequestPipeline.h"
+
+namespace shm_ring { struct Header; }
+class SocketCanBackend;
 
 struct CAN_Entry{
     // I need to store this like this
@@ -15,39 +26,120 @@ struct CAN_Entry{
     QString status;
 };
 
+// One task as listed by the server's LIST_TASKS since=, see DBCClient/server.cpp
+struct TaskRecord {
+    enum class State : quint8 { Running, Paused, Stopped, Error };
+
+    QString taskId;
+    quint64 version = 0; // Server's task version at the last state change
+    State state = State::Running;
+    bool recurring = true;
+    int intervalMs = 0; // Interval, or the delay of a one-shot
+    int priority = 5;
+    QString policy;
+    QString bus;
+    quint32 canId = 0;
+    QByteArray data; // Hex, as sent
+    quint64 sent = 0; // As of the last state change; the task events carry the running count
+    quint64 missed = 0;
+    quint64 dropped = 0;
+    qint64 leaseMs = 0;
+    QString error;
+};
+
+// A CANSEND or SEND_TASK answered. status is the code the command methods have always used: 0 scheduled,
+// 1 not connected or refused by the TCP Client, 3 no reply in time, 4 server error, 5 cansend error
+struct SendResult {
+    qint8 status = 0;
+    QString taskId; // Temporary if the reply had none, so the row can still be tracked
+};
+
 class DbcSender : public QObject {
     Q_OBJECT
 
 public:
     explicit DbcSender(QObject *parent = nullptr);
     ~DbcSender(); // Destructor for proper cleanup
-    Q_INVOKABLE qint8 initiateConnection(QString Address, QString Port);
+    // Every command answers through a future once its reply is in, so nothing here waits on the network.
+    // The codes are SendResult's; 4 also stands for "Task not found"
+    QFuture<qint8> initiateConnection(QString Address, QString Port); // Finishes once the session is set up
     Q_INVOKABLE void disconnect(); // Add disconnect method
-    Q_INVOKABLE qint8 sendCANMessage(QString message);
-    Q_INVOKABLE qint8 sendOneShotMessage(QString message, int delayMs = 0);
-    Q_INVOKABLE qint8 stopCANMessage(QString taskId);
-    Q_INVOKABLE qint8 pauseCANMessage(QString taskId);
-    Q_INVOKABLE qint8 resumeCANMessage(QString taskId);
-    Q_INVOKABLE QString listTasks();
-    Q_INVOKABLE QString listCanInterfaces();
-    Q_INVOKABLE qint8 killAllTasks();
-    Q_INVOKABLE qint8 update();
+    QFuture<SendResult> sendCANMessage(QString message);
+    QFuture<SendResult> sendOneShotMessage(QString message, int delayMs = 0);
+    QFuture<qint8> stopCANMessage(QString taskId);
+    QFuture<qint8> pauseCANMessage(QString taskId);
+    QFuture<qint8> resumeCANMessage(QString taskId);
+    QFuture<QString> listTasks();
+    QFuture<QString> listCanInterfaces();
+    QFuture<qint8> killAllTasks();
+    QFuture<qint8> update();
     Q_INVOKABLE void printCANlist(); //test
     Q_INVOKABLE bool isConnected() const;
     Q_INVOKABLE QString getLastTaskId() const;
     Q_INVOKABLE void setExternalSocket(QTcpSocket* externalSocket);
+    Q_INVOKABLE QVariantList takeSendReports(); // Per-send results since the last call, from the report ring (local server only)
+    Q_INVOKABLE qint8 useLocalBus(); // Send on this machine's CAN interfaces directly, without a server (Linux only)
+    Q_INVOKABLE bool isUsingLocalBus() const;
+    Q_INVOKABLE int pendingRequests() const; // Sent on the pipeline and not answered yet
+    QFuture<qint8> refreshTasks(); // Bring taskRecords() up to date, fetching only what changed since the last call
+    Q_INVOKABLE QVariantMap linkStats() const; // Heartbeat RTT (last, mean, jitter, p50, p99, histogram) and reconnect state
+    Q_INVOKABLE void setHeartbeat(int intervalMs, int deadAfterMs); // Saved for the next start too; 0 turns it off
+    const QHash<QString, TaskRecord>& taskRecords() const { return taskTable; }
+
+    // Applies one LIST_TASKS since= reply to `table`, parsing it in place. `version` becomes the since= for the
+    // next call; `more` is set when there is another page to fetch (also after a reset). False if not a listing
+    static bool applyTaskListing(QByteArrayView reply, QHash<QString, TaskRecord>& table, quint64& version, bool& more);
+
+    // One command on whichever route is in use: the reply (empty on failure or timeout) arrives through the
+    // future, so any number can be queued. Our own connection pipelines them, the external socket answers the
+    // next read; the local bus and the TCP Client answer in place
+    QFuture<QString> requestAsync(const QString& command);
+
+signals:
+    // Pushed by the server for our own connection's tasks (SUBSCRIBE)
+    void taskEvent(const QString& taskId, const QString& state, const QString& detail); // created, paused, resumed, completed, stopped, error
+    void taskSendsCounted(const QString& taskId, int sends); // Sends since the last count for this task
+    void connectionLost(); // The server closed our connection, or stopped answering heartbeats
+    void reconnected(); // Back on the same server after connectionLost, session and subscription restored
+    void linkStatsChanged();
 
 private:
-    QTcpSocket socket;
+    RequestPipeline pipeline; // Our own server connection, TCP or the local socket, on its own thread
+    shm_ring::Header* reportRing = nullptr; // Shared-memory ring of send reports, mapped over the local socket
+    size_t reportRingSize = 0;
+#ifdef HAS_SERVER_SUPPORT
+    std::unique_ptr<SocketCanBackend> localBus; // Set by useLocalBus(), replaces every server connection
+#endif
     QTcpSocket* externalSocket; // Pointer to external socket (from TCP Client)
+    QFuture<QString> externalTail; // Last command sent on the external socket
     QList<CAN_Entry> CAN_list;
+    QHash<QString, TaskRecord> taskTable; // Our connection's tasks, by ID, kept current by refreshTasks()
+    quint64 taskTableVersion = 0; // since= for the next refreshTasks()
+    QFuture<qint8> refreshing; // The refreshTasks() still paging, which a second call joins
     QString lastTaskId; // Store the last task ID received from server
     bool usingExternalSocket; // Flag to track if using external socket
     mutable QObject* tcpClientRef; // Reference to TcpClientBackend
+    QString sessionToken; // Server session, lets a reconnect take its running tasks back
+    QString sessionServer; // "address:port" the session belongs to
+    QString currentServer; // "address:port" of our own connection, for automatic reconnects
     
-    QTcpSocket* getActiveSocket(); // Helper method to get the active socket
+    bool activeSocketConnected() const;
+    QFuture<QString> externalRequest(const QString& message, int timeoutMs = 5000); // One command and its reply on the external socket
     bool shouldUseTcpClient() const; // Check if we should route through TCP Client
     void parseUpdateResponse(const QString& responseStr); // Helper to parse UPDATE command responses
-    qint8 sendDisconnectMessage(); // Helper to send proper disconnect message to server
+    SendResult parseScheduled(const QString& reply); // Reads a CANSEND or SEND_TASK reply, sets lastTaskId
+    QFuture<qint8> sendDisconnectMessage(); // Helper to send proper disconnect message to server
+    QFuture<QString> exchangeMessage(const QString& message); // One command on the internal connection, logs a missing reply
+    QFuture<qint8> setUpSession(const QString& server); // Session, report ring (local socket only), then SUBSCRIBE
+    QFuture<void> resumeSession(const QString& server); // ATTACH to the previous session or start a new one
+    QFuture<void> startSession(const QString& server);
+    QFuture<qint8> fetchTaskPage(int resets); // One page of refreshTasks(), then the next
+    void subscribeTaskEvents(); // Ask the server to push task events
+    void handleServerEvent(const QString& event);
+    void handleReconnected();
+    QFuture<bool> connectLocal(); // Connect to the server's local socket, false if there is none
+    QFuture<void> mapReportRing(); // Ask for and map the server's report ring
+    void unmapReportRing();
+    QString localBusCommand(const QString& message); // Runs one protocol command on the local bus, returns the server's reply
 };
 #endif // DBCSENDER_H
@@ -0,0 +1,293 @@
+#include "DbcSnapshot.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char magic[8] = {'D', 'B', 'C', 'S', 'N', 'A', 'P', '\0'};
+constexpr uint32_t byteOrderMark = 0x01020304;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t sourceHash;
+    uint64_t sourceSize;
+    uint32_t messageCount;
+    uint32_t signalCount;
+    uint64_t stringBytes;
+};
+
+// Strings are (offset, length) into the string table. A message owns signals [firstSignal, firstSignal + signalCount)
+struct MessageRecord {
+    uint64_t id;
+    uint32_t name;
+    uint32_t nameLength;
+    int32_t length;
+    uint32_t firstSignal;
+    uint32_t signalCount;
+    uint32_t reserved;
+};
+
+struct SignalRecord {
+    uint32_t name;
+    uint32_t nameLength;
+    uint32_t unit;
+    uint32_t unitLength;
+    int32_t startBit;
+    int32_t length;
+    double factor;
+    double offset;
+    double min;
+    double max;
+    uint8_t littleEndian;
+    uint8_t isSigned;
+    uint8_t reserved[6];
+};
+
+static_assert(std::is_trivially_copyable_v<Header> && sizeof(Header) == 48);
+static_assert(std::is_trivially_copyable_v<MessageRecord> && sizeof(MessageRecord) == 32);
+static_assert(std::is_trivially_copyable_v<SignalRecord> && sizeof(SignalRecord) == 64);
+
+uint64_t mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+template <typename T>
+T read(const char* p)
+{
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+constexpr std::string_view snapshotSuffix = ".dbcsnap";
+constexpr std::string_view temporarySuffix = ".tmp";
+
+// "<path>.<pid>.<n>.tmp", unique to this process and save
+std::string temporaryName(const std::string& path)
+{
+    static std::atomic<unsigned> counter{0};
+#ifdef _WIN32
+    long long pid = _getpid();
+#else
+    long long pid = getpid();
+#endif
+    return path + "." + std::to_string(pid) + "." + std::to_string(counter.fetch_add(1)) + std::string(temporarySuffix);
+}
+
+} // namespace
+
+// Eight bytes per step with a multiply-rotate round, finished like MurmurHash3. Not cryptographic: it only has
+// to tell one version of a file from the next
+uint64_t DbcSnapshot::contentHash(std::string_view text)
+{
+    const char* p = text.data();
+    size_t n = text.size();
+    uint64_t h = 0x9E3779B97F4A7C15ULL ^ n;
+    for (; n >= 8; p += 8, n -= 8) {
+        uint64_t w = read<uint64_t>(p) * 0x87c37b91114253d5ULL;
+        h ^= (w << 31) | (w >> 33);
+        h = ((h << 27) | (h >> 37)) * 5 + 0x52dce729;
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, p, n);
+    h ^= tail * 0x4cf5ad432745937fULL;
+    return mix(h);
+}
+
+std::string DbcSnapshot::fileName(uint64_t hash)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.dbcsnap", static_cast<unsigned long long>(hash));
+    return name;
+}
+
+bool DbcSnapshot::load(const std::string& path, uint64_t hash, uint64_t sourceSize, std::vector<canMessage>& messages)
+{
+    MappedFile file;
+    std::string error;
+    if (!file.open(path, error)) {
+        return false;
+    }
+    std::string_view data = file.view();
+    if (data.size() < sizeof(Header)) {
+        return false;
+    }
+    Header header = read<Header>(data.data());
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != formatVersion
+        || header.byteOrder != byteOrderMark || header.sourceHash != hash || header.sourceSize != sourceSize) {
+        return false;
+    }
+    uint64_t messagesAt = sizeof(Header);
+    uint64_t signalsAt = messagesAt + uint64_t(header.messageCount) * sizeof(MessageRecord);
+    uint64_t stringsAt = signalsAt + uint64_t(header.signalCount) * sizeof(SignalRecord);
+    if (stringsAt + header.stringBytes != data.size()) {
+        return false;
+    }
+    std::string_view strings = data.substr(stringsAt);
+    auto string = [&](uint32_t offset, uint32_t length, std::string& out) {
+        if (uint64_t(offset) + length > strings.size()) return false;
+        out.assign(strings.substr(offset, length));
+        return true;
+    };
+
+    std::vector<canMessage> loaded(header.messageCount);
+    for (uint32_t i = 0; i < header.messageCount; ++i) {
+        MessageRecord record = read<MessageRecord>(data.data() + messagesAt + uint64_t(i) * sizeof(MessageRecord));
+        canMessage& msg = loaded[i];
+        if (uint64_t(record.firstSignal) + record.signalCount > header.signalCount
+            || !string(record.name, record.nameLength, msg.name)) {
+            return false;
+        }
+        msg.id = static_cast<unsigned long>(record.id);
+        msg.length = record.length;
+        msg.signalList.resize(record.signalCount);
+        for (uint32_t j = 0; j < record.signalCount; ++j) {
+            uint64_t at = signalsAt + (uint64_t(record.firstSignal) + j) * sizeof(SignalRecord);
+            SignalRecord s = read<SignalRecord>(data.data() + at);
+            canSignal& sig = msg.signalList[j];
+            if (!string(s.name, s.nameLength, sig.name) || !string(s.unit, s.unitLength, sig.unit)) {
+                return false;
+            }
+            sig.startBit = s.startBit;
+            sig.length = s.length;
+            sig.littleEndian = s.littleEndian != 0;
+            sig.isSigned = s.isSigned != 0;
+            sig.factor = s.factor;
+            sig.offset = s.offset;
+            sig.min = s.min;
+            sig.max = s.max;
+        }
+    }
+    messages = std::move(loaded);
+    std::error_code ec;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+    return true;
+}
+
+bool DbcSnapshot::save(const std::string& path, uint64_t hash, uint64_t sourceSize,
+                       const std::vector<canMessage>& messages, std::string& error)
+{
+    std::vector<MessageRecord> messageRecords;
+    std::vector<SignalRecord> signalRecords;
+    std::string strings;
+    messageRecords.reserve(messages.size());
+    auto addString = [&](const std::string& s, uint32_t& offset, uint32_t& length) {
+        offset = static_cast<uint32_t>(strings.size());
+        length = static_cast<uint32_t>(s.size());
+        strings += s;
+    };
+    for (const canMessage& msg : messages) {
+        MessageRecord record{};
+        record.id = msg.id;
+        record.length = msg.length;
+        record.firstSignal = static_cast<uint32_t>(signalRecords.size());
+        record.signalCount = static_cast<uint32_t>(msg.signalList.size());
+        addString(msg.name, record.name, record.nameLength);
+        for (const canSignal& sig : msg.signalList) {
+            SignalRecord s{};
+            addString(sig.name, s.name, s.nameLength);
+            addString(sig.unit, s.unit, s.unitLength);
+            s.startBit = sig.startBit;
+            s.length = sig.length;
+            s.factor = sig.factor;
+            s.offset = sig.offset;
+            s.min = sig.min;
+            s.max = sig.max;
+            s.littleEndian = sig.littleEndian ? 1 : 0;
+            s.isSigned = sig.isSigned ? 1 : 0;
+            signalRecords.push_back(s);
+        }
+        messageRecords.push_back(record);
+    }
+    if (strings.size() > UINT32_MAX) {
+        error = "DBC too large for a snapshot";
+        return false;
+    }
+
+    Header header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = formatVersion;
+    header.byteOrder = byteOrderMark;
+    header.sourceHash = hash;
+    header.sourceSize = sourceSize;
+    header.messageCount = static_cast<uint32_t>(messageRecords.size());
+    header.signalCount = static_cast<uint32_t>(signalRecords.size());
+    header.stringBytes = strings.size();
+
+    std::string temporary = temporaryName(path);
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(messageRecords.data()),
+                  static_cast<std::streamsize>(messageRecords.size() * sizeof(MessageRecord)));
+        out.write(reinterpret_cast<const char*>(signalRecords.data()),
+                  static_cast<std::streamsize>(signalRecords.size() * sizeof(SignalRecord)));
+        out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+        if (!out.flush()) {
+            error = "Could not write " + temporary;
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+#ifdef _WIN32
+    std::remove(path.c_str()); // rename() won't replace an existing file here
+#endif
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        error = "Could not rename " + temporary + " to " + path;
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+void DbcSnapshot::prune(const std::string& directory, size_t keep)
+{
+    namespace fs = std::filesystem;
+    using Clock = fs::file_time_type::clock;
+    std::vector<std::pair<fs::file_time_type, fs::path>> snapshots;
+    std::error_code ec;
+    for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code entryError;
+        if (!it->is_regular_file(entryError)) {
+            continue;
+        }
+        std::string name = it->path().filename().string();
+        fs::file_time_type written = it->last_write_time(entryError);
+        if (entryError) {
+            continue;
+        }
+        if (name.ends_with(snapshotSuffix)) {
+            snapshots.emplace_back(written, it->path());
+        } else if (name.ends_with(temporarySuffix) && name.find(snapshotSuffix) != std::string::npos
+                   && Clock::now() - written > std::chrono::hours(1)) {
+            fs::remove(it->path(), entryError);
+        }
+    }
+    if (snapshots.size() <= keep) {
+        return;
+    }
+    std::sort(snapshots.begin(), snapshots.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    for (size_t i = keep; i < snapshots.size(); ++i) {
+        fs::remove(snapshots[i].second, ec);
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef DBCSNAPSHOT_H
+#define DBCSNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "DbcReader.h"
+
+// The parsed message and signal tables of a DBC file, saved in a compact binary form so that loading the same
+// file again skips the parse. A snapshot is named after a hash of the file's content, so an edited file never
+// picks up a stale one. It holds a header, fixed-size message and signal records and one string table, in this
+// machine's byte order. Loading maps it and rejects anything that doesn't match: wrong magic, format version,
+// byte order, source hash or size, or a record that points outside the file
+class DbcSnapshot {
+public:
+    static constexpr uint32_t formatVersion = 2; // Bump whenever the layout or the parser's results change
+    static constexpr size_t keepCount = 16;      // Snapshots prune() leaves in a directory
+
+    static uint64_t contentHash(std::string_view text);
+    static std::string fileName(uint64_t hash); // "<16 hex digits>.dbcsnap"
+
+    // `sourceSize` is the size of the text the hash was taken of. False if there is no usable snapshot; a
+    // snapshot that loads has its modification time bumped, so prune() keeps the ones in use
+    static bool load(const std::string& path, uint64_t hash, uint64_t sourceSize, std::vector<canMessage>& messages);
+    // Written to a temporary file named for this process and save and renamed into place, so a reader never
+    // sees half a snapshot and two saves of the same file don't write into each other's
+    static bool save(const std::string& path, uint64_t hash, uint64_t sourceSize,
+                     const std::vector<canMessage>& messages, std::string& error);
+    // Deletes all but the `keep` most recently used snapshots in `directory`, and temporary files more than an
+    // hour old that a save never got to rename. Other files are left alone
+    static void prune(const std::string& directory, size_t keep = keepCount);
+};
+
+#endif // DBCSNAPSHOT_H
@@ -50,6 +50,10 @@ ApplicationWindow {
             }
         }
         
+        function onDbcLoadFinished(success, message) {
+            statusText.text = success ? "DBC file loaded: " + message : message
+        }
+        
         function onConnectionStatusChanged() {
             if (dbcParser.isConnectedToServer) {
                 showSuccess("Connected to CAN server successfully!")
@@ -162,8 +166,9 @@ ApplicationWindow {
         title: "Select a DBC File"
         nameFilters: ["DBC Files (*.dbc)"]
         onAccepted: {
-            dbcParser.loadDbcFile(selectedFile)
-            statusText.text = "DBC file loaded: " + selectedFile
+            if (dbcParser.loadDbcFile(selectedFile)) {
+                statusText.text = "Loading DBC file: " + selectedFile
+            }
         }
     }
     
@@ -211,7 +216,7 @@ ApplicationWindow {
                     // Property change notifications
                     Connections {
                         target: dbcParser
-                        function onIsConnectedToServerChanged() {
+                        function onConnectionStatusChanged() {
                             connectionStatusIndicator.color = connectionStatusIndicator.getConnectionStatus() ? "#2E7D32" : "#D32F2F"
                         }
                     }
@@ -262,6 +267,29 @@ ApplicationWindow {
                         ToolTip.delay: 500
                     }
                 }
+
+                // Link quality from the server heartbeat
+                Text {
+                    property var link: dbcParser.linkStats
+                    visible: dbcParser.isConnectedToServer || link.reconnectAttempt > 0
+                    text: link.reconnectAttempt > 0
+                          ? "Reconnecting (attempt " + link.reconnectAttempt + ")"
+                          : link.samples > 0
+                            ? "RTT " + link.rttMs.toFixed(2) + " ms  jitter " + link.jitterMs.toFixed(2) + " ms  p99 " + link.p99Ms.toFixed(2) + " ms"
+                            : "RTT -"
+                    color: "white"
+                    font.pixelSize: 12
+
+                    MouseArea {
+                        id: linkQualityArea
+                        anchors.fill: parent
+                        hoverEnabled: true
+                    }
+                    ToolTip.visible: linkQualityArea.containsMouse
+                    ToolTip.text: "Mean " + link.meanMs.toFixed(2) + " ms, median " + link.p50Ms.toFixed(2) + " ms over the last "
+                                  + link.samples + " heartbeats. Dead links dropped: " + link.deadPeers
+                    ToolTip.delay: 500
+                }
                 
                 Item { Layout.fillWidth: true }
                 Button {
@@ -316,16 +344,33 @@ ApplicationWindow {
             }
         }
         
-        // Status text
-        Text {
-            id: statusText
+        // Status text, with the progress of a DBC load while one runs
+        RowLayout {
             Layout.fillWidth: true
             Layout.margins: 10
-            text: "No DBC file loaded"
-            color: "#757575"
-            wrapMode: Text.WordWrap
-            elide: Text.ElideRight
-            maximumLineCount: 2
+            spacing: 10
+
+            Text {
+                id: statusText
+                Layout.fillWidth: true
+                text: "No DBC file loaded"
+                color: "#757575"
+                wrapMode: Text.WordWrap
+                elide: Text.ElideRight
+                maximumLineCount: 2
+            }
+
+            ProgressBar {
+                Layout.preferredWidth: 200
+                visible: dbcParser.isLoading
+                value: dbcParser.loadProgress
+            }
+
+            Button {
+                text: "Cancel"
+                visible: dbcParser.isLoading
+                onClicked: dbcParser.cancelLoad()
+            }
         }
         
         // Main content area with tabs
@@ -1097,7 +1142,7 @@ ApplicationWindow {
                                     width: parent.width
                                     height: parent.height - signalTableHeader.height
                                     clip: true
-                                    model: dbcParser.signalModel
+                                    model: dbcParser.signalList
                                     
                                     // Add scrollbar
                                     ScrollBar.vertical: ScrollBar {
@@ -1165,7 +1210,7 @@ ApplicationWindow {
                                                 TextField {
                                                     anchors.fill: parent
                                                     anchors.margins: 5
-                                                    text: modelData.name
+                                                    text: model.name
                                                     readOnly: true
                                                     background: Rectangle {
                                                         color: "transparent"
@@ -1213,10 +1258,10 @@ ApplicationWindow {
                                                     anchors.margins: 5
                                                     from: 0
                                                     to: 63
-                                                    value: modelData.startBit
+                                                    value: model.startBit
                                                     editable: true
                                                     
-                                                    property int lastValidValue: modelData.startBit
+                                                    property int lastValidValue: model.startBit
                                                     property bool isReverting: false
                                                     
                                                     // Update lastValidValue when model changes
@@ -1227,11 +1272,11 @@ ApplicationWindow {
                                                         }
                                                         
                                                         // Try to update the backend
-                                                        var success = dbcParser.updateSignalParameter(modelData.name, "startBit", value)
+                                                        var success = dbcParser.updateSignalParameter(model.name, "startBit", value)
                                                         if (!success) {
                                                             // Validation failed - show error and revert immediately
-                                                            console.log("Start bit validation failed for signal", modelData.name, "- reverting from", value, "to", lastValidValue)
-                                                            showNotification("error", "Cannot set start bit to " + value + " for signal '" + modelData.name + "'. This would cause bit overlap or exceed boundaries.")
+                                                            console.log("Start bit validation failed for signal", model.name, "- reverting from", value, "to", lastValidValue)
+                                                            showNotification("error", "Cannot set start bit to " + value + " for signal '" + model.name + "'. This would cause bit overlap or exceed boundaries.")
                                                             
                                                             // Immediately revert to last valid value
                                                             isReverting = true
@@ -1239,7 +1284,7 @@ ApplicationWindow {
                                                         } else {
                                                             // Success - update last valid value and refresh bit editor
                                                             lastValidValue = value
-                                                            if (bitsSection.signalName === modelData.name) {
+                                                            if (bitsSection.signalName === model.name) {
                                                                 bitsSection.updateBitDisplay()
                                                                 bitsSection.updateCalculationText()
                                                                 bitsSection.updateDataDisplay()
@@ -1249,7 +1294,7 @@ ApplicationWindow {
                                                     
                                                     // Update lastValidValue when the model data changes (external updates)
                                                     Component.onCompleted: {
-                                                        lastValidValue = modelData.startBit
+                                                        lastValidValue = model.startBit
                                                     }
                                                 }
                                                 
@@ -1272,10 +1317,10 @@ ApplicationWindow {
                                                     anchors.margins: 5
                                                     from: 1
                                                     to: 64
-                                                    value: modelData.length
+                                                    value: model.length
                                                     editable: true
                                                     
-                                                    property int lastValidValue: modelData.length
+                                                    property int lastValidValue: model.length
                                                     property bool isReverting: false
                                                     
                                                     // Update lastValidValue when model changes
@@ -1286,11 +1331,11 @@ ApplicationWindow {
                                                         }
                                                         
                                                         // Try to update the backend
-                                                        var success = dbcParser.updateSignalParameter(modelData.name, "length", value)
+                                                        var success = dbcParser.updateSignalParameter(model.name, "length", value)
                                                         if (!success) {
                                                             // Validation failed - show error and revert immediately
-                                                            console.log("Length validation failed for signal", modelData.name, "- reverting from", value, "to", lastValidValue)
-                                                            showNotification("error", "Cannot set length to " + value + " bits for signal '" + modelData.name + "'. This would cause bit overlap or exceed 64-bit boundary.")
+                                                            console.log("Length validation failed for signal", model.name, "- reverting from", value, "to", lastValidValue)
+                                                            showNotification("error", "Cannot set length to " + value + " bits for signal '" + model.name + "'. This would cause bit overlap or exceed 64-bit boundary.")
                                                             
                                                             // Immediately revert to last valid value
                                                             isReverting = true
@@ -1298,7 +1343,7 @@ ApplicationWindow {
                                                         } else {
                                                             // Success - update last valid value and refresh bit editor
                                                             lastValidValue = value
-                                                            if (bitsSection.signalName === modelData.name) {
+                                                            if (bitsSection.signalName === model.name) {
                                                                 bitsSection.updateBitDisplay()
                                                                 bitsSection.updateCalculationText()
                                                                 bitsSection.updateDataDisplay()
@@ -1308,7 +1353,7 @@ ApplicationWindow {
                                                     
                                                     // Update lastValidValue when the model data changes (external updates)
                                                     Component.onCompleted: {
-                                                        lastValidValue = modelData.length
+                                                        lastValidValue = model.length
                                                     }
                                                 }
                                                 
@@ -1330,7 +1375,7 @@ ApplicationWindow {
                                                     id: factorField
                                                     anchors.fill: parent
                                                     anchors.margins: 5
-                                                    text: modelData.factor.toString()
+                                                    text: model.factor.toString()
                                                     validator: DoubleValidator {
                                                         notation: DoubleValidator.StandardNotation
                                                     }
@@ -1338,9 +1383,9 @@ ApplicationWindow {
                                                     // Update factor when editing is completed
                                                     onEditingFinished: {
                                                         if (text.length > 0) {
-                                                            dbcParser.updateSignalParameter(modelData.name, "factor", parseFloat(text))
+                                                            dbcParser.updateSignalParameter(model.name, "factor", parseFloat(text))
                                                             // Refresh bit editor if this signal is currently selected
-                                                            if (bitsSection.signalName === modelData.name) {
+                                                            if (bitsSection.signalName === model.name) {
                                                                 bitsSection.updateBitDisplay()
                                                                 bitsSection.updateCalculationText()
                                                                 bitsSection.updateDataDisplay()
@@ -1371,7 +1416,7 @@ ApplicationWindow {
                                                     id: offsetField
                                                     anchors.fill: parent
                                                     anchors.margins: 5
-                                                    text: modelData.offset.toString()
+                                                    text: model.offset.toString()
                                                     validator: DoubleValidator {
                                                         notation: DoubleValidator.StandardNotation
                                                     }
@@ -1379,9 +1424,9 @@ ApplicationWindow {
                                                     // Update offset when editing is completed
                                                     onEditingFinished: {
                                                         if (text.length > 0) {
-                                                            dbcParser.updateSignalParameter(modelData.name, "offset", parseFloat(text))
+                                                            dbcParser.updateSignalParameter(model.name, "offset", parseFloat(text))
                                                             // Refresh bit editor if this signal is currently selected
-                                                            if (bitsSection.signalName === modelData.name) {
+                                                            if (bitsSection.signalName === model.name) {
                                                                 bitsSection.updateBitDisplay()
                                                                 bitsSection.updateCalculationText()
                                                                 bitsSection.updateDataDisplay()
@@ -1411,7 +1456,7 @@ ApplicationWindow {
                                                 TextField {
                                                     anchors.fill: parent
                                                     anchors.margins: 5
-                                                    text: modelData.min.toString()
+                                                    text: model.min.toString()
                                                     validator: DoubleValidator {
                                                         notation: DoubleValidator.StandardNotation
                                                     }
@@ -1419,9 +1464,9 @@ ApplicationWindow {
                                                     // Update min when editing is completed
                                                     onEditingFinished: {
                                                         if (text.length > 0) {
-                                                            dbcParser.updateSignalParameter(modelData.name, "min", parseFloat(text))
+                                                            dbcParser.updateSignalParameter(model.name, "min", parseFloat(text))
                                                             // Refresh bit editor if this signal is currently selected
-                                                            if (bitsSection.signalName === modelData.name) {
+                                                            if (bitsSection.signalName === model.name) {
                                                                 bitsSection.updateBitDisplay()
                                                                 bitsSection.updateCalculationText()
                                                                 bitsSection.updateDataDisplay()
@@ -1447,7 +1492,7 @@ ApplicationWindow {
                                                 TextField {
                                                     anchors.fill: parent
                                                     anchors.margins: 5
-                                                    text: modelData.max.toString()
+                                                    text: model.max.toString()
                                                     validator: DoubleValidator {
                                                         notation: DoubleValidator.StandardNotation
                                                     }
@@ -1455,9 +1500,9 @@ ApplicationWindow {
                                                     // Update max when editing is completed
                                                     onEditingFinished: {
                                                         if (text.length > 0) {
-                                                            dbcParser.updateSignalParameter(modelData.name, "max", parseFloat(text))
+                                                            dbcParser.updateSignalParameter(model.name, "max", parseFloat(text))
                                                             // Refresh bit editor if this signal is currently selected
-                                                            if (bitsSection.signalName === modelData.name) {
+                                                            if (bitsSection.signalName === model.name) {
                                                                 bitsSection.updateBitDisplay()
                                                                 bitsSection.updateCalculationText()
                                                                 bitsSection.updateDataDisplay()
@@ -1483,13 +1528,13 @@ ApplicationWindow {
                                                 TextField {
                                                     anchors.fill: parent
                                                     anchors.margins: 5
-                                                    text: modelData.unit
+                                                    text: model.unit
                                                     
                                                     // Update unit when editing is completed
                                                     onEditingFinished: {
-                                                        dbcParser.updateSignalParameter(modelData.name, "unit", text)
+                                                        dbcParser.updateSignalParameter(model.name, "unit", text)
                                                         // Force update of the physical value calculation
-                                                        if (bitsSection.signalName === modelData.name) {
+                                                        if (bitsSection.signalName === model.name) {
                                                             bitsSection.updateCalculationText()
                                                         }
                                                     }
@@ -1518,16 +1563,16 @@ ApplicationWindow {
                                                         id: valueSpinBox
                                                         Layout.fillWidth: true
                                                         Layout.fillHeight: true
-                                                        from: modelData.min !== modelData.max ? modelData.min : -999999
-                                                        to: modelData.min !== modelData.max ? modelData.max : 999999
-                                                        value: modelData.value
+                                                        from: model.min !== model.max ? model.min : -999999
+                                                        to: model.min !== model.max ? model.max : 999999
+                                                        value: model.value
                                                         editable: true
                                                         stepSize: 1
                                                         onValueChanged: {
-                                                            dbcParser.updateSignalValue(modelData.name, value)
+                                                            dbcParser.updateSignalValue(model.name, value)
                                                             
                                                             // If the bits section is showing this signal, update it
-                                                            if (bitsSection.signalName === modelData.name) {
+                                                            if (bitsSection.signalName === model.name) {
                                                                 bitsSection.signalValue = value
                                                                 bitsSection.updateBitDisplay()
                                                                 bitsSection.updateCalculationText()
@@ -1595,12 +1640,12 @@ ApplicationWindow {
                                                             
                                                             onClicked: {
                                                                 signalListView.currentIndex = index
-                                                                bitsSection.signalName = modelData.name
-                                                                // Get the current value from the backend instead of cached modelData
-                                                                bitsSection.signalValue = dbcParser.getSignalValue(modelData.name)
-                                                                bitsSection.signalStartBit = modelData.startBit
-                                                                bitsSection.signalLength = modelData.length
-                                                                bitsSection.signalLittleEndian = modelData.littleEndian
+                                                                bitsSection.signalName = model.name
+                                                                // Get the current value from the backend instead of the row it was drawn from
+                                                                bitsSection.signalValue = dbcParser.getSignalValue(model.name)
+                                                                bitsSection.signalStartBit = model.startBit
+                                                                bitsSection.signalLength = model.length
+                                                                bitsSection.signalLittleEndian = model.littleEndian
                                                                 bitsSection.visible = true
                                                                 bitsSection.initializeDisplay()
                                                             }
@@ -2288,7 +2333,7 @@ ApplicationWindow {
                         
                         Button {
                             text: "Save Config"
-                            enabled: dbcParser.activeTransmissions.length > 0
+                            enabled: dbcParser.activeTransmissionList.count > 0
                             
                             contentItem: Text {
                                 text: parent.text
@@ -2339,7 +2384,7 @@ ApplicationWindow {
                         
                         Button {
                             text: "Kill All"
-                            enabled: dbcParser.activeTransmissions.length > 0
+                            enabled: dbcParser.activeTransmissionList.count > 0
                             
                             contentItem: Text {
                                 text: parent.text
@@ -2458,7 +2503,7 @@ ApplicationWindow {
                             
                             ListView {
                                 id: transmissionsListView
-                                model: dbcParser.activeTransmissions
+                                model: dbcParser.activeTransmissionList
                                 
                                 delegate: Rectangle {
                                     width: transmissionsListView.width
@@ -2477,7 +2522,7 @@ ApplicationWindow {
                                         x: 20
                                         anchors.verticalCenter: parent.verticalCenter
                                         width: 120
-                                        text: modelData.messageId
+                                        text: model.messageId
                                         color: "#424242"
                                     }
                                     
@@ -2485,7 +2530,7 @@ ApplicationWindow {
                                         x: 160
                                         anchors.verticalCenter: parent.verticalCenter
                                         width: 200
-                                        text: modelData.messageName
+                                        text: model.messageName
                                         color: "#424242"
                                         elide: Text.ElideRight
                                     }
@@ -2494,7 +2539,7 @@ ApplicationWindow {
                                         x: 380
                                         anchors.verticalCenter: parent.verticalCenter
                                         width: 120
-                                        text: modelData.rateMs.toString()
+                                        text: model.rateMs.toString()
                                         color: "#424242"
                                     }
                                     
@@ -2503,17 +2548,17 @@ ApplicationWindow {
                                         anchors.verticalCenter: parent.verticalCenter
                                         width: 120
                                         height: 24
-                                        color: modelData.status === "Active" ? "#C8E6C9" : 
-                                               modelData.status === "Paused" ? "#FFE0B2" : 
-                                               modelData.status === "Stopping" ? "#FFF3E0" : "#FFCDD2"
+                                        color: model.status === "Active" ? "#C8E6C9" : 
+                                               model.status === "Paused" ? "#FFE0B2" : 
+                                               model.status === "Stopping" ? "#FFF3E0" : "#FFCDD2"
                                         radius: 12
                                         
                                         Text {
                                             anchors.centerIn: parent
-                                            text: modelData.status
-                                            color: modelData.status === "Active" ? "#2E7D32" : 
-                                                   modelData.status === "Paused" ? "#F57C00" : 
-                                                   modelData.status === "Stopping" ? "#FF6F00" : "#C62828"
+                                            text: model.status
+                                            color: model.status === "Active" ? "#2E7D32" : 
+                                                   model.status === "Paused" ? "#F57C00" : 
+                                                   model.status === "Stopping" ? "#FF6F00" : "#C62828"
                                             font.pixelSize: 12
                                             font.bold: true
                                         }
@@ -2523,7 +2568,7 @@ ApplicationWindow {
                                         x: 660
                                         anchors.verticalCenter: parent.verticalCenter
                                         width: 100
-                                        text: modelData.startedAt
+                                        text: model.startedAt
                                         color: "#757575"
                                         font.pixelSize: 12
                                     }
@@ -2532,7 +2577,7 @@ ApplicationWindow {
                                         x: 780
                                         anchors.verticalCenter: parent.verticalCenter
                                         width: 80
-                                        text: modelData.canBus
+                                        text: model.canBus
                                         color: "#757575"
                                         font.pixelSize: 12
                                     }
@@ -2543,8 +2588,8 @@ ApplicationWindow {
                                         anchors.verticalCenter: parent.verticalCenter
                                         width: 70
                                         height: 36
-                                        text: modelData.status === "Paused" ? "Resume" : "Pause"
-                                        enabled: modelData.status !== "Stopped" && modelData.status !== "Stopping"
+                                        text: model.status === "Paused" ? "Resume" : "Pause"
+                                        enabled: model.status !== "Stopped" && model.status !== "Stopping"
                                         
                                         contentItem: Text {
                                             text: parent.text
@@ -2560,10 +2605,10 @@ ApplicationWindow {
                                         }
                                         
                                         onClicked: {
-                                            if (modelData.status === "Paused") {
-                                                dbcParser.resumeTransmission(modelData.messageName)
+                                            if (model.status === "Paused") {
+                                                dbcParser.resumeTransmission(model.messageName)
                                             } else {
-                                                dbcParser.pauseTransmission(modelData.messageName)
+                                                dbcParser.pauseTransmission(model.messageName)
                                             }
                                         }
                                     }
@@ -2573,8 +2618,8 @@ ApplicationWindow {
                                         anchors.verticalCenter: parent.verticalCenter
                                         width: 60
                                         height: 36
-                                        text: modelData.status === "Stopping" ? "..." : "Stop"
-                                        enabled: modelData.status !== "Stopped" && modelData.status !== "Stopping"
+                                        text: model.status === "Stopping" ? "..." : "Stop"
+                                        enabled: model.status !== "Stopped" && model.status !== "Stopping"
                                         
                                         contentItem: Text {
                                             text: parent.text
@@ -2590,7 +2635,7 @@ ApplicationWindow {
                                         }
                                         
                                         onClicked: {
-                                            dbcParser.stopTransmission(modelData.messageName)
+                                            dbcParser.stopTransmission(model.messageName)
                                         }
                                     }
                                 }
@@ -2635,7 +2680,7 @@ ApplicationWindow {
                             
                             Button {
                                 text: "Save Config"
-                                enabled: dbcParser.oneShotMessages.length > 0
+                                enabled: dbcParser.oneShotMessageList.count > 0
                                 
                                 contentItem: Text {
                                     text: parent.text
@@ -2676,7 +2721,7 @@ ApplicationWindow {
                             
                             Button {
                                 text: "Clear History"
-                                enabled: dbcParser.oneShotMessages.length > 0
+                                enabled: dbcParser.oneShotMessageList.count > 0
                                 
                                 contentItem: Text {
                                     text: parent.text
@@ -2710,7 +2755,7 @@ ApplicationWindow {
                                 
                                 ListView {
                                     id: oneShotMessagesListView
-                                    model: dbcParser.oneShotMessages
+                                    model: dbcParser.oneShotMessageList
                                     
                                     delegate: Rectangle {
                                         width: oneShotMessagesListView.width
@@ -2732,14 +2777,14 @@ ApplicationWindow {
                                                     Layout.fillWidth: true
                                                     
                                                     Text {
-                                                        text: modelData.messageName
+                                                        text: model.messageName
                                                         font.pixelSize: 14
                                                         font.bold: true
                                                         color: "#2E7D32"
                                                     }
                                                     
                                                     Text {
-                                                        text: "(" + modelData.messageId + ")"
+                                                        text: "(" + model.messageId + ")"
                                                         font.pixelSize: 12
                                                         color: "#757575"
                                                     }
@@ -2747,7 +2792,7 @@ ApplicationWindow {
                                                     Item { Layout.fillWidth: true }
                                                     
                                                     Text {
-                                                        text: modelData.sentAt
+                                                        text: model.sentAt
                                                         font.pixelSize: 12
                                                         color: "#757575"
                                                     }
@@ -2757,7 +2802,7 @@ ApplicationWindow {
                                                     Layout.fillWidth: true
                                                     
                                                     Text {
-                                                        text: "Data: " + modelData.hexData
+                                                        text: "Data: " + model.hexData
                                                         font.pixelSize: 12
                                                         color: "#424242"
                                                         font.family: "monospace"
@@ -2766,7 +2811,7 @@ ApplicationWindow {
                                                     Item { Layout.fillWidth: true }
                                                     
                                                     Text {
-                                                        text: "Bus: " + modelData.canBus
+                                                        text: "Bus: " + model.canBus
                                                         font.pixelSize: 12
                                                         color: "#757575"
                                                     }
@@ -2793,22 +2838,22 @@ ApplicationWindow {
                                                 
                                                 onClicked: {
                                                     // Validate required data before attempting to resend
-                                                    if (!modelData.messageId || !modelData.hexData || !modelData.messageName) {
+                                                    if (!model.messageId || !model.hexData || !model.messageName) {
                                                         showError("Cannot resend message: Missing required data")
-                                                        console.error("Cannot resend message - missing data:", modelData)
+                                                        console.error("Cannot resend message - missing data:", model.messageName, model.messageId, model.hexData)
                                                         return
                                                     }
                                                     
                                                     try {
                                                         // Parse message ID and send raw message again with original name
-                                                        var messageId = modelData.messageId.replace("0x", "").replace("0X", "")
-                                                        var canBus = modelData.canBus || "vcan0"  // Default to vcan0 if undefined
+                                                        var messageId = model.messageId.replace("0x", "").replace("0X", "")
+                                                        var canBus = model.canBus || "vcan0"  // Default to vcan0 if undefined
                                                         
-                                                        var success = dbcParser.sendRawCanMessage(messageId, modelData.hexData, canBus, modelData.messageName)
+                                                        var success = dbcParser.sendRawCanMessage(messageId, model.hexData, canBus, model.messageName)
                                                         if (success) {
-                                                            console.log("Resent one-shot message:", modelData.messageName)
+                                                            console.log("Resent one-shot message:", model.messageName)
                                                         } else {
-                                                            console.log("Failed to resend one-shot message:", modelData.messageName)
+                                                            console.log("Failed to resend one-shot message:", model.messageName)
                                                         }
                                                     } catch (e) {
                                                         showError("Error resending message: " + e.message)
@@ -4090,19 +4135,6 @@ ApplicationWindow {
         }
     }
     
-    // Timer to periodically update connection status
-    Timer {
-        id: connectionStatusTimer
-        interval: 1000
-        running: true
-        repeat: true
-        onTriggered: {
-            if (connectionStatusIndicator) {
-                connectionStatusIndicator.color = connectionStatusIndicator.getConnectionStatus() ? "#2E7D32" : "#D32F2F"
-            }
-        }
-    }
-    
     // Timer to refresh signal model when validation fails
     Timer {
         id: refreshTimer
@@ -0,0 +1,546 @@
+#include "RequestPipeline.h"
+#include <QTcpSocket>
+#include <QLocalSocket>
+#include <QHostAddress>
+#include <QPromise>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QMap>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <numeric>
+
+using ReplyPromise = std::shared_ptr<QPromise<QString>>;
+
+// Upper edges of the RTT histogram buckets, doubling from a quarter of a millisecond. One more bucket holds the rest
+static constexpr std::array<double, 11> rttEdgesMs{0.25, 0.5, 1, 2, 4, 8, 16, 32, 64, 128, 256};
+static constexpr int firstReconnectDelayMs = 250;
+
+static int rttBucket(double ms)
+{
+    return static_cast<int>(std::upper_bound(rttEdgesMs.begin(), rttEdgesMs.end(), ms) - rttEdgesMs.begin());
+}
+
+// Everything that touches the sockets. Only ever runs on the pipeline's thread, so it needs no locking;
+// RequestPipeline talks to it by posting lambdas
+class PipelineWorker : public QObject {
+public:
+    explicit PipelineWorker(RequestPipeline* owner) : owner(owner) {}
+
+    bool open(const QString& address, quint16 port, const QString& serverName, int timeoutMs)
+    {
+        close(QStringLiteral("Reconnecting"));
+        stopReconnecting();
+        endpoint = Endpoint{address, port, serverName, timeoutMs};
+        resetRtt();
+        return connectEndpoint();
+    }
+
+    void send(quint64 id, const QByteArray& command, const ReplyPromise& promise)
+    {
+        if (!device) {
+            fail(id, promise, QStringLiteral("Not connected"));
+            return;
+        }
+        QByteArray line = '@' + QByteArray::number(id) + ' ' + command.trimmed() + '\n';
+        if (device->write(line) != line.size()) {
+            fail(id, promise, QStringLiteral("Write failed: ") + device->errorString());
+            return;
+        }
+        Pending& pending = outstanding[id];
+        pending.promise = promise;
+        pending.sent.start();
+    }
+
+    void close(const QString& reason)
+    {
+        if (sweep) {
+            sweep->stop();
+        }
+        if (heartbeat) {
+            heartbeat->stop();
+        }
+        pings.clear();
+        if (device) {
+            QObject::disconnect(device, nullptr, this, nullptr); // no lost() for a close we asked for
+        }
+        if (localSocket) {
+            localSocket->disconnectFromServer();
+        }
+        if (tcpSocket) {
+            tcpSocket->disconnectFromHost();
+            if (tcpSocket->state() != QAbstractSocket::UnconnectedState) {
+                tcpSocket->waitForDisconnected(1000);
+            }
+        }
+        device = nullptr;
+        // close() may run inside the socket's own disconnected signal
+        if (localSocket) {
+            localSocket.release()->deleteLater();
+        }
+        if (tcpSocket) {
+            tcpSocket.release()->deleteLater();
+        }
+        buffer.clear();
+        owner->connected = false;
+        owner->local = false;
+        failAll(reason);
+    }
+
+    void setHeartbeat(int intervalMs, int deadMs)
+    {
+        heartbeatMs = std::max(intervalMs, 0);
+        deadAfterMs = std::max(deadMs, heartbeatMs);
+        if (device) {
+            startHeartbeat();
+        }
+    }
+
+    void setAutoReconnect(bool enabled, int maxDelayMs)
+    {
+        autoReconnect = enabled;
+        maxReconnectDelayMs = std::max(maxDelayMs, firstReconnectDelayMs);
+        if (!enabled) {
+            stopReconnecting();
+        }
+    }
+
+    void stopReconnecting()
+    {
+        if (reconnectTimer) {
+            reconnectTimer->stop();
+        }
+        if (reconnectAttempt != 0) {
+            reconnectAttempt = 0;
+            publishReconnectAttempt();
+        }
+    }
+
+    int timeoutMs = 5000;
+
+private:
+    struct Pending {
+        ReplyPromise promise; // Null for submit()
+        QElapsedTimer sent;
+    };
+
+    struct Endpoint {
+        QString address;
+        quint16 port = 0;
+        QString serverName; // Local socket, used instead of address/port when set
+        int timeoutMs = 5000;
+    };
+
+    // Connect to `endpoint`, the last server open() was given
+    bool connectEndpoint()
+    {
+        bool ok = false;
+        if (!endpoint.serverName.isEmpty()) {
+            localSocket = std::make_unique<QLocalSocket>();
+            localSocket->connectToServer(endpoint.serverName);
+            ok = localSocket->waitForConnected(endpoint.timeoutMs);
+            if (ok) {
+                device = localSocket.get();
+                QObject::connect(localSocket.get(), &QLocalSocket::disconnected, this, [this]() { lost(); });
+            } else {
+                localSocket.reset();
+            }
+        } else {
+            tcpSocket = std::make_unique<QTcpSocket>();
+            tcpSocket->connectToHost(QHostAddress(endpoint.address), endpoint.port);
+            ok = tcpSocket->waitForConnected(endpoint.timeoutMs);
+            if (ok) {
+                tcpSocket->setSocketOption(QAbstractSocket::LowDelayOption, 1); // small requests, don't let Nagle batch them
+                device = tcpSocket.get();
+                QObject::connect(tcpSocket.get(), &QTcpSocket::disconnected, this, [this]() { lost(); });
+            } else {
+                std::cout << "RequestPipeline: " << tcpSocket->errorString().toStdString() << std::endl;
+                tcpSocket.reset();
+            }
+        }
+        if (ok) {
+            QObject::connect(device, &QIODevice::readyRead, this, [this]() { readFrames(); });
+            if (!sweep) {
+                sweep = new QTimer(this);
+                QObject::connect(sweep, &QTimer::timeout, this, [this]() { expire(); });
+            }
+            sweep->start(250);
+            startHeartbeat();
+        }
+        owner->local = ok && localSocket;
+        owner->connected = ok;
+        return ok;
+    }
+
+    // Frames are "@<id> <length>\n" followed by <length> bytes. Partial frames wait for the next readyRead.
+    // Between frames the server may push "!<event>\n" lines once subscribed
+    void readFrames()
+    {
+        lastReceived.start();
+        buffer += device->readAll();
+        for (;;) {
+            qsizetype headerEnd = buffer.indexOf('\n');
+            if (headerEnd < 0) {
+                return;
+            }
+            if (buffer.startsWith('!')) {
+                // A pushed event, never inside a frame
+                QString event = QString::fromUtf8(buffer.constData() + 1, headerEnd - 1).trimmed();
+                buffer.remove(0, headerEnd + 1);
+                emit owner->eventReceived(event);
+                continue;
+            }
+            QList<QByteArray> header = buffer.mid(1, headerEnd - 1).split(' ');
+            bool idOk = false;
+            bool lengthOk = false;
+            quint64 id = header.value(0).toULongLong(&idOk);
+            qsizetype length = header.value(1).toLongLong(&lengthOk);
+            if (!buffer.startsWith('@') || header.size() != 2 || !idOk || !lengthOk || length < 0) {
+                // Not ours (an untagged reply); skip the line and look for the next frame
+                std::cerr << "RequestPipeline: unframed reply: " << buffer.left(headerEnd).toStdString() << std::endl;
+                buffer.remove(0, headerEnd + 1);
+                continue;
+            }
+            if (buffer.size() < headerEnd + 1 + length) {
+                return;
+            }
+            QString reply = QString::fromUtf8(buffer.constData() + headerEnd + 1, length);
+            buffer.remove(0, headerEnd + 1 + length);
+            finish(id, reply);
+        }
+    }
+
+    void finish(quint64 id, const QString& reply)
+    {
+        if (auto ping = pings.find(id); ping != pings.end()) {
+            recordRtt(ping->nsecsElapsed() / 1e6);
+            pings.erase(ping);
+            return;
+        }
+        auto it = outstanding.find(id);
+        if (it == outstanding.end()) {
+            return; // Timed out already, or a second frame for the same request
+        }
+        ReplyPromise promise = it->promise;
+        outstanding.erase(it);
+        --owner->inFlight;
+        if (promise) {
+            promise->addResult(reply);
+            promise->finish();
+        }
+        emit owner->replyReceived(id, reply);
+    }
+
+    void fail(quint64 id, const ReplyPromise& promise, const QString& error)
+    {
+        --owner->inFlight;
+        if (promise) {
+            promise->addResult(QString());
+            promise->finish();
+        }
+        emit owner->requestFailed(id, error);
+    }
+
+    void failAll(const QString& error)
+    {
+        QMap<quint64, Pending> failed;
+        failed.swap(outstanding);
+        for (auto it = failed.begin(); it != failed.end(); ++it) {
+            fail(it.key(), it->promise, error);
+        }
+    }
+
+    void expire()
+    {
+        // Oldest first, so the loop can stop at the first request that is still in time
+        while (!outstanding.isEmpty() && outstanding.first().sent.hasExpired(timeoutMs)) {
+            quint64 id = outstanding.firstKey();
+            ReplyPromise promise = outstanding.first().promise;
+            outstanding.erase(outstanding.begin());
+            fail(id, promise, QStringLiteral("Timed out"));
+        }
+    }
+
+    void lost()
+    {
+        std::cout << "RequestPipeline: server closed the connection" << std::endl;
+        close(QStringLiteral("Disconnected"));
+        emit owner->connectionLost();
+        if (autoReconnect && (!endpoint.address.isEmpty() || !endpoint.serverName.isEmpty())) {
+            scheduleReconnect(firstReconnectDelayMs);
+        }
+    }
+
+    void startHeartbeat()
+    {
+        pings.clear();
+        lastReceived.start();
+        if (!heartbeat) {
+            heartbeat = new QTimer(this);
+            QObject::connect(heartbeat, &QTimer::timeout, this, [this]() { beat(); });
+        }
+        if (heartbeatMs > 0) {
+            heartbeat->start(heartbeatMs);
+        } else {
+            heartbeat->stop();
+        }
+    }
+
+    // Drop a peer that stopped answering, otherwise ping it. Anything received counts as a sign of life,
+    // so a long reply streaming in doesn't get its own connection dropped
+    void beat()
+    {
+        if (!device) {
+            return;
+        }
+        if (!pings.isEmpty() && pings.first().hasExpired(deadAfterMs) && lastReceived.hasExpired(deadAfterMs)) {
+            std::cout << "RequestPipeline: no reply to heartbeats for " << deadAfterMs << " ms, dropping the connection" << std::endl;
+            {
+                std::lock_guard<std::mutex> lock(owner->statsMutex);
+                ++owner->stats.deadPeers;
+            }
+            lost();
+            return;
+        }
+        quint64 id = owner->nextId++;
+        QByteArray line = '@' + QByteArray::number(id) + " PING\n";
+        if (device->write(line) == line.size()) {
+            pings[id].start();
+        }
+    }
+
+    void recordRtt(double ms)
+    {
+        if (rttCount == RequestPipeline::rttWindow) {
+            --buckets[rttBucket(rtts[rttNext])];
+        } else {
+            ++rttCount;
+        }
+        rtts[rttNext] = ms;
+        rttNext = (rttNext + 1) % RequestPipeline::rttWindow;
+        ++buckets[rttBucket(ms)];
+        if (previousRtt >= 0) {
+            jitter += (std::abs(ms - previousRtt) - jitter) / 16;
+        }
+        previousRtt = ms;
+
+        std::array<double, RequestPipeline::rttWindow> sorted;
+        std::copy_n(rtts.begin(), rttCount, sorted.begin());
+        std::sort(sorted.begin(), sorted.begin() + rttCount);
+        {
+            std::lock_guard<std::mutex> lock(owner->statsMutex);
+            LinkStats& stats = owner->stats;
+            stats.lastMs = ms;
+            stats.meanMs = std::accumulate(sorted.begin(), sorted.begin() + rttCount, 0.0) / rttCount;
+            stats.jitterMs = jitter;
+            stats.p50Ms = sorted[rttCount / 2];
+            stats.p99Ms = sorted[rttCount * 99 / 100];
+            stats.samples = rttCount;
+            stats.histogram = QList<int>(buckets.begin(), buckets.end());
+        }
+        emit owner->linkStatsChanged();
+    }
+
+    void resetRtt()
+    {
+        rttCount = 0;
+        rttNext = 0;
+        buckets.fill(0);
+        jitter = 0;
+        previousRtt = -1;
+        std::lock_guard<std::mutex> lock(owner->statsMutex);
+        quint64 deadPeers = owner->stats.deadPeers;
+        owner->stats = LinkStats{};
+        owner->stats.deadPeers = deadPeers;
+    }
+
+    void scheduleReconnect(int delayMs)
+    {
+        if (!reconnectTimer) {
+            reconnectTimer = new QTimer(this);
+            reconnectTimer->setSingleShot(true);
+            QObject::connect(reconnectTimer, &QTimer::timeout, this, [this]() { reconnect(); });
+        }
+        reconnectDelayMs = delayMs;
+        ++reconnectAttempt;
+        publishReconnectAttempt();
+        std::cout << "RequestPipeline: reconnecting in " << delayMs << " ms (attempt " << reconnectAttempt << ")" << std::endl;
+        reconnectTimer->start(delayMs);
+    }
+
+    void reconnect()
+    {
+        if (connectEndpoint()) {
+            std::cout << "RequestPipeline: reconnected after " << reconnectAttempt << " attempt(s)" << std::endl;
+            reconnectAttempt = 0;
+            publishReconnectAttempt();
+            emit owner->reconnected();
+            return;
+        }
+        scheduleReconnect(std::min(reconnectDelayMs * 2, maxReconnectDelayMs));
+    }
+
+    void publishReconnectAttempt()
+    {
+        {
+            std::lock_guard<std::mutex> lock(owner->statsMutex);
+            owner->stats.reconnectAttempt = reconnectAttempt;
+        }
+        emit owner->linkStatsChanged();
+    }
+
+    RequestPipeline* owner;
+    std::unique_ptr<QTcpSocket> tcpSocket;
+    std::unique_ptr<QLocalSocket> localSocket;
+    QIODevice* device = nullptr;
+    QByteArray buffer; // Received, not yet a complete frame
+    QMap<quint64, Pending> outstanding; // By ID, which is also send order
+    QTimer* sweep = nullptr;
+    Endpoint endpoint; // Where open() connected last, for reconnecting
+
+    // Heartbeat
+    QTimer* heartbeat = nullptr;
+    int heartbeatMs = 0;
+    int deadAfterMs = 0;
+    QMap<quint64, QElapsedTimer> pings; // Unanswered PINGs by request ID
+    QElapsedTimer lastReceived;
+    std::array<double, RequestPipeline::rttWindow> rtts{}; // Ring of the latest RTTs in ms
+    int rttCount = 0;
+    int rttNext = 0;
+    std::array<int, rttEdgesMs.size() + 1> buckets{}; // Histogram of `rtts`
+    double jitter = 0;
+    double previousRtt = -1;
+
+    // Reconnect
+    bool autoReconnect = false;
+    int maxReconnectDelayMs = 8000;
+    int reconnectDelayMs = firstReconnectDelayMs;
+    int reconnectAttempt = 0;
+    QTimer* reconnectTimer = nullptr;
+};
+
+RequestPipeline::RequestPipeline(QObject *parent) : QObject(parent), worker(new PipelineWorker(this))
+{
+    worker->moveToThread(&thread);
+    connect(&thread, &QThread::finished, worker, &QObject::deleteLater); // deleted on its own thread, with its sockets
+    thread.setObjectName("RequestPipeline");
+    thread.start();
+}
+
+RequestPipeline::~RequestPipeline()
+{
+    QMetaObject::invokeMethod(worker, [this]() {
+        worker->stopReconnecting();
+        worker->close(QStringLiteral("Shutting down"));
+    }, Qt::BlockingQueuedConnection);
+    thread.quit();
+    thread.wait();
+}
+
+QFuture<bool> RequestPipeline::connectTcp(const QString& address, quint16 port, int timeoutMs)
+{
+    auto result = std::make_shared<QPromise<bool>>();
+    result->start();
+    QFuture<bool> future = result->future();
+    QMetaObject::invokeMethod(worker, [this, address, port, timeoutMs, result]() {
+        result->addResult(worker->open(address, port, QString(), timeoutMs));
+        result->finish();
+    }, Qt::QueuedConnection);
+    return future;
+}
+
+QFuture<bool> RequestPipeline::connectLocal(const QString& serverName, int timeoutMs)
+{
+    auto result = std::make_shared<QPromise<bool>>();
+    result->start();
+    QFuture<bool> future = result->future();
+    QMetaObject::invokeMethod(worker, [this, serverName, timeoutMs, result]() {
+        result->addResult(worker->open(QString(), 0, serverName, timeoutMs));
+        result->finish();
+    }, Qt::QueuedConnection);
+    return future;
+}
+
+void RequestPipeline::disconnectFromServer()
+{
+    connected = false; // Requests from here on fail on the worker
+    QMetaObject::invokeMethod(worker, [this]() {
+        worker->stopReconnecting();
+        worker->close(QStringLiteral("Disconnected"));
+    }, Qt::QueuedConnection);
+}
+
+bool RequestPipeline::isConnected() const
+{
+    return connected;
+}
+
+bool RequestPipeline::isLocal() const
+{
+    return local;
+}
+
+quint64 RequestPipeline::submit(const QString& command)
+{
+    quint64 id = nextId++;
+    ++inFlight;
+    QByteArray line = command.toUtf8();
+    QMetaObject::invokeMethod(worker, [this, id, line]() {
+        worker->send(id, line, nullptr);
+    }, Qt::QueuedConnection);
+    return id;
+}
+
+QFuture<QString> RequestPipeline::request(const QString& command)
+{
+    auto promise = std::make_shared<QPromise<QString>>();
+    promise->start();
+    QFuture<QString> future = promise->future();
+    quint64 id = nextId++;
+    ++inFlight;
+    QByteArray line = command.toUtf8();
+    QMetaObject::invokeMethod(worker, [this, id, line, promise]() {
+        worker->send(id, line, promise);
+    }, Qt::QueuedConnection);
+    return future;
+}
+
+int RequestPipeline::outstanding() const
+{
+    return inFlight;
+}
+
+void RequestPipeline::setTimeout(int ms)
+{
+    QMetaObject::invokeMethod(worker, [this, ms]() {
+        worker->timeoutMs = ms;
+    }, Qt::QueuedConnection);
+}
+
+void RequestPipeline::setHeartbeat(int intervalMs, int deadAfterMs)
+{
+    QMetaObject::invokeMethod(worker, [this, intervalMs, deadAfterMs]() {
+        worker->setHeartbeat(intervalMs, deadAfterMs);
+    }, Qt::QueuedConnection);
+}
+
+void RequestPipeline::setAutoReconnect(bool enabled, int maxDelayMs)
+{
+    QMetaObject::invokeMethod(worker, [this, enabled, maxDelayMs]() {
+        worker->setAutoReconnect(enabled, maxDelayMs);
+    }, Qt::QueuedConnection);
+}
+
+LinkStats RequestPipeline::linkStats() const
+{
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return stats;
+}
+
+QList<double> RequestPipeline::histogramEdgesMs()
+{
+    return QList<double>(rttEdgesMs.begin(), rttEdgesMs.end());
+}
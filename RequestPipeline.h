@@ -0,0 +1,79 @@
+#ifndef REQUESTPIPELINE_H
+#define REQUESTPIPELINE_H
+#include <QObject>
+#include <QThread>
+#include <QFuture>
+#include <QString>
+#include <QList>
+#include <atomic>
+#include <mutex>
+
+class PipelineWorker;
+
+// Heartbeat round trips over the last RequestPipeline::rttWindow pings
+struct LinkStats {
+    double lastMs = 0;
+    double meanMs = 0;
+    double jitterMs = 0; // Smoothed change between consecutive RTTs, as RTP computes it (RFC 3550)
+    double p50Ms = 0;
+    double p99Ms = 0;
+    int samples = 0;
+    QList<int> histogram; // Samples per bucket: bucket i holds RTTs below RequestPipeline::histogramEdgesMs()[i], the last one the rest
+    quint64 deadPeers = 0; // Connections dropped because heartbeats went unanswered
+    int reconnectAttempt = 0; // Nonzero while reconnecting
+};
+
+// Client side of the server's tagged requests ("@<id> <command>"). One connection, TCP or the local socket,
+// lives on a worker thread and any number of requests can be in flight on it. Every call here returns at once:
+// a request gets its ID back and is answered through replyReceived/requestFailed, and through the future
+// if it came from request(). A failed or timed-out request resolves its future with an empty string.
+class RequestPipeline : public QObject {
+    Q_OBJECT
+
+public:
+    explicit RequestPipeline(QObject *parent = nullptr);
+    ~RequestPipeline(); // Fails what is still outstanding and joins the worker
+
+    QFuture<bool> connectTcp(const QString& address, quint16 port, int timeoutMs = 5000);
+    QFuture<bool> connectLocal(const QString& serverName, int timeoutMs = 1000);
+    void disconnectFromServer();
+    bool isConnected() const;
+    bool isLocal() const; // Connected over the local socket rather than TCP
+
+    quint64 submit(const QString& command);
+    QFuture<QString> request(const QString& command);
+    int outstanding() const; // Sent or queued, not answered yet
+    void setTimeout(int ms); // Per request, counted from when it was written. Default 5000
+
+    // A PING every intervalMs; no reply and no other data for deadAfterMs drops the connection as dead.
+    // An interval of 0 turns the heartbeat off
+    void setHeartbeat(int intervalMs, int deadAfterMs);
+    // After a connection is lost (not closed by us), try the same server again after 250 ms, then twice as long
+    // after every failure up to maxDelayMs
+    void setAutoReconnect(bool enabled, int maxDelayMs = 8000);
+    LinkStats linkStats() const;
+    static QList<double> histogramEdgesMs();
+
+    static constexpr int rttWindow = 256;
+
+signals:
+    void replyReceived(quint64 id, const QString& reply);
+    void requestFailed(quint64 id, const QString& error);
+    void connectionLost(); // The server went away; everything outstanding has failed
+    void eventReceived(const QString& event); // A line the server pushed after SUBSCRIBE, without the leading '!'
+    void linkStatsChanged(); // A heartbeat came back, or the reconnect state changed
+    void reconnected(); // Automatic reconnect succeeded; server-side state (session, subscriptions) has to be set up again
+
+private:
+    friend class PipelineWorker;
+
+    QThread thread;
+    PipelineWorker* worker; // Lives on `thread`, owns the sockets
+    std::atomic<quint64> nextId{1};
+    std::atomic<bool> connected{false};
+    std::atomic<bool> local{false};
+    std::atomic<int> inFlight{0};
+    mutable std::mutex statsMutex;
+    LinkStats stats; // Written by the worker
+};
+#endif // REQUESTPIPELINE_H
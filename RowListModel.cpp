@@ -0,0 +1,111 @@
+#include "RowListModel.h"
+#include <algorithm>
+
+RowListModel::RowListModel(QList<QByteArray> keys, QObject *parent)
+    : QAbstractListModel(parent), keys(std::move(keys))
+{
+    updateTimer.setSingleShot(true);
+    updateTimer.setInterval(updateIntervalMs);
+    connect(&updateTimer, &QTimer::timeout, this, &RowListModel::flush);
+}
+
+QHash<int, QByteArray> RowListModel::roleNames() const
+{
+    QHash<int, QByteArray> names;
+    for (int i = 0; i < keys.size(); ++i) {
+        names.insert(Qt::UserRole + 1 + i, keys[i]);
+    }
+    return names;
+}
+
+int RowListModel::role(const QByteArray &key) const
+{
+    int i = static_cast<int>(keys.indexOf(key));
+    return i < 0 ? -1 : Qt::UserRole + 1 + i;
+}
+
+void RowListModel::beginInsert(int row)
+{
+    flush();
+    beginInsertRows(QModelIndex(), row, row);
+}
+
+void RowListModel::endInsert()
+{
+    endInsertRows();
+    emit countChanged();
+    emit listChanged();
+}
+
+void RowListModel::beginRemove(int first, int last)
+{
+    flush();
+    beginRemoveRows(QModelIndex(), first, last);
+}
+
+void RowListModel::endRemove()
+{
+    endRemoveRows();
+    emit countChanged();
+    emit listChanged();
+}
+
+void RowListModel::beginReset()
+{
+    // A reset redraws everything, gathered changes included
+    updateTimer.stop();
+    pendingFirst = pendingLast = -1;
+    beginResetModel();
+}
+
+void RowListModel::endReset()
+{
+    endResetModel();
+    emit countChanged();
+    emit listChanged();
+}
+
+void RowListModel::changed(int row, const QList<int> &roles)
+{
+    QModelIndex changedRow = index(row);
+    emit dataChanged(changedRow, changedRow, roles);
+    emit listChanged();
+}
+
+// One dataChanged for the span of rows changed since the last one, with every role any of them changed
+void RowListModel::changeLater(int row, const QList<int> &roles)
+{
+    if (pendingFirst < 0) {
+        pendingFirst = pendingLast = row;
+        pendingRoles = roles;
+        updateTimer.start();
+        return;
+    }
+    pendingFirst = std::min(pendingFirst, row);
+    pendingLast = std::max(pendingLast, row);
+    if (pendingRoles.isEmpty()) {
+        return; // Already all of them
+    }
+    if (roles.isEmpty()) {
+        pendingRoles.clear();
+        return;
+    }
+    for (int role : roles) {
+        if (!pendingRoles.contains(role)) {
+            pendingRoles.append(role);
+        }
+    }
+}
+
+void RowListModel::flush()
+{
+    if (pendingFirst < 0) {
+        return;
+    }
+    updateTimer.stop();
+    QModelIndex first = index(pendingFirst);
+    QModelIndex last = index(pendingLast);
+    pendingFirst = pendingLast = -1;
+    emit dataChanged(first, last, pendingRoles);
+    emit listChanged();
+}
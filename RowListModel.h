@@ -0,0 +1,174 @@
+#ifndef ROWLISTMODEL_H
+#define ROWLISTMODEL_H
+#include <QAbstractListModel>
+#include <QByteArray>
+#include <QList>
+#include <QTimer>
+#include <QVariant>
+#include <QVariantList>
+#include <QVariantMap>
+#include <utility>
+
+// A list of rows for QML, one role per field. Every change goes through the calls below, so views are told
+// which rows were inserted, removed or changed instead of getting a whole new list. Changes that can wait
+// (counters ticking many times a second) are gathered and go out together, at most once every updateIntervalMs
+class RowListModel : public QAbstractListModel {
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    static constexpr int updateIntervalMs = 100;
+
+    int count() const { return rowCount(); }
+    QHash<int, QByteArray> roleNames() const override;
+    int role(const QByteArray &key) const; // -1 if there is no such field
+
+signals:
+    void countChanged();
+    void listChanged(); // Anything changed; for gathered changes, when they go out
+
+protected:
+    RowListModel(QList<QByteArray> keys, QObject *parent);
+
+    // Gathered changes go out before rows move, while the rows they name are still where they were
+    void beginInsert(int row);
+    void endInsert();
+    void beginRemove(int first, int last);
+    void endRemove();
+    void beginReset();
+    void endReset();
+    void changed(int row, const QList<int> &roles);
+    void changeLater(int row, const QList<int> &roles);
+
+private:
+    void flush();
+
+    QList<QByteArray> keys;
+    QTimer updateTimer;
+    int pendingFirst = -1;
+    int pendingLast = -1;
+    QList<int> pendingRoles; // Empty for all
+};
+
+// A QList<Row> behind a RowListModel. It reads like the QList; changes are the QList calls that add and remove
+// rows, and modify()/modifyLater() for editing one in place
+template <typename Row>
+class RowList : public RowListModel {
+public:
+    // Role name and value of each field, in role order
+    using Fields = QList<std::pair<QByteArray, QVariant (*)(const Row &)>>;
+
+    explicit RowList(const Fields &fields, QObject *parent = nullptr)
+        : RowListModel(keysOf(fields), parent), fields(fields)
+    {
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : static_cast<int>(m_rows.size());
+    }
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override
+    {
+        int field = role - Qt::UserRole - 1;
+        if (!index.isValid() || index.row() >= m_rows.size() || field < 0 || field >= fields.size()) {
+            return QVariant();
+        }
+        return fields[field].second(m_rows[index.row()]);
+    }
+
+    // Every row as a map from role name to value
+    QVariantList toVariantList() const
+    {
+        QVariantList list;
+        list.reserve(m_rows.size());
+        for (const Row &row : m_rows) {
+            QVariantMap map;
+            for (const auto &[name, value] : fields) {
+                map[QString::fromLatin1(name)] = value(row);
+            }
+            list.append(map);
+        }
+        return list;
+    }
+
+    const QList<Row> &rows() const { return m_rows; }
+    qsizetype size() const { return m_rows.size(); }
+    bool isEmpty() const { return m_rows.isEmpty(); }
+    const Row &at(qsizetype i) const { return m_rows.at(i); }
+    const Row &operator[](qsizetype i) const { return m_rows.at(i); }
+    const Row &last() const { return m_rows.last(); }
+    typename QList<Row>::const_iterator begin() const { return m_rows.cbegin(); }
+    typename QList<Row>::const_iterator end() const { return m_rows.cend(); }
+
+    void append(const Row &row)
+    {
+        beginInsert(static_cast<int>(m_rows.size()));
+        m_rows.append(row);
+        endInsert();
+    }
+
+    void prepend(const Row &row)
+    {
+        beginInsert(0);
+        m_rows.prepend(row);
+        endInsert();
+    }
+
+    void removeAt(qsizetype i)
+    {
+        beginRemove(static_cast<int>(i), static_cast<int>(i));
+        m_rows.removeAt(i);
+        endRemove();
+    }
+
+    void removeLast() { removeAt(m_rows.size() - 1); }
+
+    void clear()
+    {
+        if (m_rows.isEmpty()) {
+            return;
+        }
+        beginRemove(0, static_cast<int>(m_rows.size()) - 1);
+        m_rows.clear();
+        endRemove();
+    }
+
+    // All rows at once, as a reset
+    void assign(QList<Row> rows)
+    {
+        beginReset();
+        m_rows = std::move(rows);
+        endReset();
+    }
+
+    // fn(Row &) edits row i. `roles` are the fields it changes, empty for all of them
+    template <typename Fn>
+    void modify(qsizetype i, Fn &&fn, const QList<int> &roles = {})
+    {
+        fn(m_rows[i]);
+        changed(static_cast<int>(i), roles);
+    }
+
+    // The same, shown with the next batch of gathered changes
+    template <typename Fn>
+    void modifyLater(qsizetype i, Fn &&fn, const QList<int> &roles = {})
+    {
+        fn(m_rows[i]);
+        changeLater(static_cast<int>(i), roles);
+    }
+
+private:
+    static QList<QByteArray> keysOf(const Fields &fields)
+    {
+        QList<QByteArray> keys;
+        for (const auto &field : fields) {
+            keys.append(field.first);
+        }
+        return keys;
+    }
+
+    Fields fields;
+    QList<Row> m_rows;
+};
+#endif // ROWLISTMODEL_H
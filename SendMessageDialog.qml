@@ -48,6 +48,10 @@ Dialog {
             console.log("SendMessageDialog: Connection status changed, updating UI")
             updateConnectionStatus()
         }
+
+        function onAvailableCanInterfacesChanged(interfaces) {
+            applyCanBusList(interfaces)
+        }
     }
 
     // Timer to auto-hide status messages
@@ -161,10 +165,13 @@ Dialog {
         refreshCanBusList()
     }
     
-    // Function to refresh CAN bus list
+    // Function to refresh CAN bus list; the servers' answer arrives through onAvailableCanInterfacesChanged
     function refreshCanBusList() {
         console.log("Refreshing CAN bus list...")
-        var canBuses = dbcParser.getAvailableCanInterfaces()
+        dbcParser.refreshAvailableCanInterfaces()
+    }
+
+    function applyCanBusList(canBuses) {
         if (canBuses.length > 0) {
             availableCanBuses = canBuses
             // Keep current selection if it's still available, otherwise select first
@@ -921,10 +928,8 @@ Dialog {
                     var success = dbcParser.sendCanMessageOnce(sendMessageDialog.messageName, sendMessageDialog.selectedCanBus)
                     
                     if (success) {
-                        console.log("One-shot message sent:", sendMessageDialog.messageName, "on bus:", sendMessageDialog.selectedCanBus)
-                        statusText.text = "Message sent successfully!"
-                        statusText.isSuccess = true
-                        statusHideTimer.start()
+                        // onMessageSendStatus shows the outcome once the server has answered
+                        console.log("One-shot message requested:", sendMessageDialog.messageName, "on bus:", sendMessageDialog.selectedCanBus)
                     } else {
                         console.log("Failed to send one-shot message:", sendMessageDialog.messageName, "on bus:", sendMessageDialog.selectedCanBus)
                         statusText.text = "Error: Failed to send message. Please check server connection and CAN bus availability."
@@ -0,0 +1,122 @@
+#include "SignalListModel.h"
+#include <QString>
+
+SignalListModel::SignalListModel(const std::vector<canMessage>& messages, QObject *parent)
+    : QAbstractListModel(parent), messages(messages)
+{
+}
+
+const std::vector<canSignal>* SignalListModel::signalList() const
+{
+    if (m_messageIndex < 0 || m_messageIndex >= static_cast<int>(messages.size())) {
+        return nullptr;
+    }
+    return &messages[m_messageIndex].signalList;
+}
+
+int SignalListModel::rowCount(const QModelIndex& parent) const
+{
+    const std::vector<canSignal>* list = signalList();
+    return parent.isValid() || !list ? 0 : static_cast<int>(list->size());
+}
+
+QVariant SignalListModel::data(const QModelIndex& index, int role) const
+{
+    const std::vector<canSignal>* list = signalList();
+    if (!list || !index.isValid() || index.row() >= static_cast<int>(list->size())) {
+        return QVariant();
+    }
+    const canSignal& sig = (*list)[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+    case NameRole:
+        return QString::fromStdString(sig.name);
+    case StartBitRole:
+        return sig.startBit;
+    case LengthRole:
+        return sig.length;
+    case LittleEndianRole:
+        return sig.littleEndian;
+    case IsSignedRole:
+        return sig.isSigned;
+    case FactorRole:
+        return sig.factor;
+    case OffsetRole:
+        return sig.offset;
+    case MinRole:
+        return sig.min;
+    case MaxRole:
+        return sig.max;
+    case UnitRole:
+        return QString::fromStdString(sig.unit);
+    case ValueRole:
+        return sig.value;
+    default:
+        return QVariant();
+    }
+}
+
+// The same keys as DbcParser::signalModel()'s maps
+QHash<int, QByteArray> SignalListModel::roleNames() const
+{
+    return {
+        {NameRole, "name"},
+        {StartBitRole, "startBit"},
+        {LengthRole, "length"},
+        {LittleEndianRole, "littleEndian"},
+        {IsSignedRole, "isSigned"},
+        {FactorRole, "factor"},
+        {OffsetRole, "offset"},
+        {MinRole, "min"},
+        {MaxRole, "max"},
+        {UnitRole, "unit"},
+        {ValueRole, "value"},
+    };
+}
+
+void SignalListModel::setMessage(int messageIndex)
+{
+    beginResetModel();
+    m_messageIndex = messageIndex;
+    endResetModel();
+}
+
+void SignalListModel::beginResetTable()
+{
+    beginResetModel();
+}
+
+void SignalListModel::endResetTable(int messageIndex)
+{
+    m_messageIndex = messageIndex;
+    endResetModel();
+}
+
+void SignalListModel::signalChanged(int row, const QList<int>& roles)
+{
+    if (row < 0 || row >= rowCount()) {
+        return;
+    }
+    QModelIndex changed = index(row);
+    emit dataChanged(changed, changed, roles);
+}
+
+void SignalListModel::beginInsertSignal(int row)
+{
+    beginInsertRows(QModelIndex(), row, row);
+}
+
+void SignalListModel::endInsertSignal()
+{
+    endInsertRows();
+}
+
+void SignalListModel::beginRemoveSignal(int row)
+{
+    beginRemoveRows(QModelIndex(), row, row);
+}
+
+void SignalListModel::endRemoveSignal()
+{
+    endRemoveRows();
+}
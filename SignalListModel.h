@@ -0,0 +1,55 @@
+#ifndef SIGNALLISTMODEL_H
+#define SIGNALLISTMODEL_H
+#include <QAbstractListModel>
+#include <QList>
+#include <vector>
+#include "DbcReader.h"
+
+// The selected message's signals as a list model for QML, one row per signal with a role per field. It reads
+// DbcParser's table in place; DbcParser tells it what changed, so a value edit refreshes the one row's value
+// instead of every delegate
+class SignalListModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum Role {
+        NameRole = Qt::UserRole + 1,
+        StartBitRole,
+        LengthRole,
+        LittleEndianRole,
+        IsSignedRole,
+        FactorRole,
+        OffsetRole,
+        MinRole,
+        MaxRole,
+        UnitRole,
+        ValueRole,
+    };
+
+    explicit SignalListModel(const std::vector<canMessage>& messages, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int messageIndex() const { return m_messageIndex; }
+    // Shows message `messageIndex`'s signals, -1 for none
+    void setMessage(int messageIndex);
+    // Around replacing the table or erasing messages from it; afterwards message `messageIndex` is shown
+    void beginResetTable();
+    void endResetTable(int messageIndex);
+    // An empty `roles` means every field changed
+    void signalChanged(int row, const QList<int>& roles = {});
+    // Around adding or erasing signalList[row] of the shown message
+    void beginInsertSignal(int row);
+    void endInsertSignal();
+    void beginRemoveSignal(int row);
+    void endRemoveSignal();
+
+private:
+    const std::vector<canSignal>* signalList() const;
+
+    const std::vector<canMessage>& messages;
+    int m_messageIndex = -1;
+};
+#endif // SIGNALLISTMODEL_H
@@ -0,0 +1,448 @@
+#include "SocketCanBackend.h"
+
+#include <linux/can.h>
+#include <linux/can/bcm.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+namespace {
+
+constexpr int ARPHRD_CAN_TYPE = 280; // /sys/class/net/<if>/type of CAN and vCAN devices
+
+uint64_t taskNumber(const std::string& taskId)
+{
+    uint64_t number = UINT64_MAX;
+    if (taskId.starts_with("task_")) {
+        std::from_chars(taskId.data() + 5, taskId.data() + taskId.size(), number);
+    }
+    return number;
+}
+
+canid_t frameId(const SocketCanBackend::Frame& frame)
+{
+    return frame.extended ? (frame.id & CAN_EFF_MASK) | CAN_EFF_FLAG : frame.id & CAN_SFF_MASK;
+}
+
+can_frame toCanFrame(const SocketCanBackend::Frame& frame)
+{
+    can_frame out {};
+    out.can_id = frameId(frame);
+    out.can_dlc = static_cast<__u8>(frame.data.size());
+    std::copy(frame.data.begin(), frame.data.end(), out.data);
+    return out;
+}
+
+std::string frameText(const SocketCanBackend::Frame& frame)
+{
+    static const char* digits = "0123456789ABCDEF";
+    std::string text;
+    uint32_t id = frame.id;
+    for (int shift = frame.extended ? 28 : 8; shift >= 0; shift -= 4) {
+        text += digits[(id >> shift) & 0xF];
+    }
+    text += '#';
+    for (uint8_t byte : frame.data) {
+        text += digits[byte >> 4];
+        text += digits[byte & 0xF];
+    }
+    return text;
+}
+
+} // namespace
+
+SocketCanBackend::SocketCanBackend() : worker([this] { run(); })
+{
+}
+
+SocketCanBackend::~SocketCanBackend()
+{
+    stopAll();
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    wake.notify_all();
+    worker.join();
+    for (auto& [bus, fd] : rawSockets) {
+        close(fd);
+    }
+}
+
+bool SocketCanBackend::parseFrame(const std::string& canId, const std::string& hexData, Frame& frame, std::string& error)
+{
+    std::string id = canId;
+    if (id.starts_with("0x") || id.starts_with("0X")) {
+        id = id.substr(2);
+    }
+    uint32_t value = 0;
+    auto [end, ec] = std::from_chars(id.data(), id.data() + id.size(), value, 16);
+    if (id.empty() || ec != std::errc() || end != id.data() + id.size()) {
+        error = "Invalid CAN ID '" + canId + "'";
+        return false;
+    }
+    frame.extended = id.size() > 3 || value > CAN_SFF_MASK;
+    frame.id = frame.extended ? value & CAN_EFF_MASK : value;
+
+    std::string hex;
+    std::copy_if(hexData.begin(), hexData.end(), std::back_inserter(hex), [](char c) { return c != '.' && c != ' '; });
+    if (hex.size() % 2 != 0 || hex.size() > 2 * CAN_MAX_DLEN) {
+        error = "CAN data must be 0-8 whole bytes, got '" + hexData + "'";
+        return false;
+    }
+    frame.data.clear();
+    for (size_t i = 0; i < hex.size(); i += 2) {
+        uint8_t byte = 0;
+        auto [byteEnd, byteEc] = std::from_chars(hex.data() + i, hex.data() + i + 2, byte, 16);
+        if (byteEc != std::errc() || byteEnd != hex.data() + i + 2) {
+            error = "Invalid CAN data '" + hexData + "'";
+            return false;
+        }
+        frame.data.push_back(byte);
+    }
+    return true;
+}
+
+std::vector<std::string> SocketCanBackend::interfaces()
+{
+    std::vector<std::string> names;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator("/sys/class/net", ec)) {
+        std::ifstream typeFile(entry.path() / "type");
+        int type = 0;
+        if (typeFile >> type && type == ARPHRD_CAN_TYPE) {
+            names.push_back(entry.path().filename().string());
+        }
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+std::string SocketCanBackend::startRecurring(const std::string& bus, const Frame& frame, int intervalMs, std::string& error)
+{
+    Task task;
+    task.bus = bus;
+    task.frame = frame;
+    task.intervalMs = std::max(intervalMs, 1); // BCM needs a period; the server runs 0 back to back, which a bus can't take anyway
+    task.recurring = true;
+    return addTask(std::move(task), error);
+}
+
+std::string SocketCanBackend::sendOnce(const std::string& bus, const Frame& frame, int delayMs, std::string& error)
+{
+    Task task;
+    task.bus = bus;
+    task.frame = frame;
+    task.intervalMs = std::max(delayMs, 0);
+    task.due = std::chrono::steady_clock::now() + std::chrono::milliseconds(task.intervalMs);
+    return addTask(std::move(task), error);
+}
+
+std::string SocketCanBackend::addTask(Task task, std::string& error)
+{
+    if (if_nametoindex(task.bus.c_str()) == 0) {
+        error = "CAN interface '" + task.bus + "' is not available";
+        return std::string();
+    }
+    if (task.frame.data.size() > CAN_MAX_DLEN) {
+        error = "CAN data longer than 8 bytes";
+        return std::string();
+    }
+
+    std::lock_guard<std::mutex> lock(mtx);
+    uint64_t number = nextTaskNumber++;
+    std::string taskId = "task_" + std::to_string(number);
+    bool recurring = task.recurring;
+    tasks.emplace(number, std::move(task));
+    if (recurring) {
+        post([this, number, taskId] {
+            auto it = tasks.find(number);
+            if (it != tasks.end()) {
+                armBcm(taskId, it);
+            }
+        });
+    } else {
+        wake.notify_all(); // the worker picks the new deadline up
+    }
+    return taskId;
+}
+
+bool SocketCanBackend::stop(const std::string& taskId)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    uint64_t number = taskNumber(taskId);
+    auto it = tasks.find(number);
+    if (it == tasks.end()) {
+        // A finished one just leaves the history
+        auto finished = std::find_if(history.begin(), history.end(), [number](const auto& entry) { return entry.first == number; });
+        if (finished == history.end()) {
+            return false;
+        }
+        history.erase(finished);
+        return true;
+    }
+    int bcmSocket = std::exchange(it->second.bcmSocket, -1);
+    tasks.erase(it);
+    if (bcmSocket != -1) {
+        post([bcmSocket] { close(bcmSocket); }); // closing the BCM socket ends its TX job
+    }
+    return true;
+}
+
+bool SocketCanBackend::pause(const std::string& taskId)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    uint64_t number = taskNumber(taskId);
+    auto it = tasks.find(number);
+    if (it == tasks.end()) {
+        return isFinished(number);
+    }
+    Task& task = it->second;
+    task.paused = true;
+    task.status = "paused";
+    if (task.recurring) {
+        post([this, number] {
+            auto it = tasks.find(number);
+            if (it != tasks.end() && it->second.paused) {
+                disarmBcm(it->second);
+            }
+        });
+    }
+    return true;
+}
+
+bool SocketCanBackend::resume(const std::string& taskId)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    uint64_t number = taskNumber(taskId);
+    auto it = tasks.find(number);
+    if (it == tasks.end()) {
+        return isFinished(number);
+    }
+    Task& task = it->second;
+    if (!task.paused) {
+        return true;
+    }
+    task.paused = false;
+    task.status = "running";
+    if (task.recurring) {
+        post([this, number, taskId] {
+            auto it = tasks.find(number);
+            if (it != tasks.end() && !it->second.paused) {
+                armBcm(taskId, it);
+            }
+        });
+    } else {
+        wake.notify_all(); // a one-shot whose time passed while paused goes out now
+    }
+    return true;
+}
+
+void SocketCanBackend::stopAll()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    std::vector<int> bcmSockets;
+    for (auto& [number, task] : tasks) {
+        if (task.bcmSocket != -1) {
+            bcmSockets.push_back(task.bcmSocket);
+        }
+    }
+    tasks.clear();
+    if (!bcmSockets.empty()) {
+        post([bcmSockets] {
+            for (int fd : bcmSockets) {
+                close(fd);
+            }
+        });
+    }
+}
+
+std::string SocketCanBackend::listTasks() const
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    std::string response = "Active tasks:\n";
+    for (const auto& [number, task] : tasks) {
+        response += listingLine(number, task);
+    }
+    for (const auto& [number, line] : history) {
+        response += line;
+    }
+    return response;
+}
+
+std::string SocketCanBackend::listingLine(uint64_t number, const Task& task)
+{
+    std::string line = "task_" + std::to_string(number) + ": cansend " + task.bus + " " + frameText(task.frame);
+    if (task.recurring) {
+        line += " every " + std::to_string(task.intervalMs) + "ms priority 5";
+    } else {
+        line += " once after " + std::to_string(task.intervalMs) + "ms priority 5";
+    }
+    return line + " (" + task.status + ")\n";
+}
+
+bool SocketCanBackend::isFinished(uint64_t number) const
+{
+    return std::any_of(history.begin(), history.end(), [number](const auto& entry) { return entry.first == number; });
+}
+
+void SocketCanBackend::retire(std::map<uint64_t, Task>::iterator it)
+{
+    if (it->second.bcmSocket != -1) {
+        close(it->second.bcmSocket);
+    }
+    history.emplace_back(it->first, listingLine(it->first, it->second));
+    if (history.size() > historySize) {
+        history.pop_front();
+    }
+    tasks.erase(it);
+}
+
+void SocketCanBackend::post(std::function<void()> job)
+{
+    jobs.push_back(std::move(job));
+    wake.notify_all();
+}
+
+void SocketCanBackend::run()
+{
+    std::unique_lock<std::mutex> lock(mtx);
+    for (;;) {
+        if (!jobs.empty()) {
+            auto job = std::move(jobs.front());
+            jobs.pop_front();
+            job();
+            continue;
+        }
+        if (stopping) {
+            break; // only once the queue is empty, so the BCM sockets stopAll() queued get closed
+        }
+
+        // Send the one-shots that are due, then sleep until the next one or until new work arrives
+        auto now = std::chrono::steady_clock::now();
+        auto next = std::chrono::steady_clock::time_point::max();
+        for (auto it = tasks.begin(); it != tasks.end();) {
+            auto current = it++; // retire() erases it
+            Task& task = current->second;
+            if (task.recurring || task.paused) {
+                continue;
+            }
+            if (task.due <= now) {
+                sendRaw("task_" + std::to_string(current->first), task);
+                retire(current);
+            } else {
+                next = std::min(next, task.due);
+            }
+        }
+        if (next == std::chrono::steady_clock::time_point::max()) {
+            wake.wait(lock);
+        } else {
+            wake.wait_until(lock, next);
+        }
+    }
+}
+
+void SocketCanBackend::armBcm(const std::string& taskId, std::map<uint64_t, Task>::iterator it)
+{
+    Task& task = it->second;
+    if (task.bcmSocket == -1) {
+        int fd = socket(PF_CAN, SOCK_DGRAM | SOCK_CLOEXEC, CAN_BCM);
+        if (fd == -1) {
+            fail(taskId, task, "CAN_BCM socket");
+            retire(it);
+            return;
+        }
+        sockaddr_can addr {};
+        addr.can_family = AF_CAN;
+        addr.can_ifindex = static_cast<int>(if_nametoindex(task.bus.c_str()));
+        if (addr.can_ifindex == 0 || connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1) {
+            close(fd);
+            fail(taskId, task, "connect to " + task.bus);
+            retire(it);
+            return;
+        }
+        task.bcmSocket = fd;
+    }
+
+    // First frame right away (TX_ANNOUNCE), then every intervalMs from the kernel's timer
+    // bcm_msg_head ends in a flexible array, so the one frame is laid out right after it by hand
+    alignas(bcm_msg_head) unsigned char msg[sizeof(bcm_msg_head) + sizeof(can_frame)] {};
+    auto* head = reinterpret_cast<bcm_msg_head*>(msg);
+    head->opcode = TX_SETUP;
+    head->flags = SETTIMER | STARTTIMER | TX_ANNOUNCE;
+    head->ival2.tv_sec = task.intervalMs / 1000;
+    head->ival2.tv_usec = (task.intervalMs % 1000) * 1000;
+    head->can_id = frameId(task.frame);
+    head->nframes = 1;
+    can_frame frame = toCanFrame(task.frame);
+    std::memcpy(msg + sizeof(bcm_msg_head), &frame, sizeof(frame));
+    if (write(task.bcmSocket, msg, sizeof(msg)) != static_cast<ssize_t>(sizeof(msg))) {
+        fail(taskId, task, "TX_SETUP on " + task.bus);
+        retire(it);
+    }
+}
+
+void SocketCanBackend::disarmBcm(Task& task)
+{
+    if (task.bcmSocket == -1) {
+        return;
+    }
+    bcm_msg_head head {};
+    head.opcode = TX_DELETE;
+    head.can_id = frameId(task.frame);
+    if (write(task.bcmSocket, &head, sizeof(head)) == -1) {
+        std::cerr << "SocketCanBackend: TX_DELETE failed: " << strerror(errno) << std::endl;
+    }
+}
+
+void SocketCanBackend::sendRaw(const std::string& taskId, Task& task)
+{
+    int fd = rawSocket(task.bus);
+    if (fd == -1) {
+        fail(taskId, task, "CAN_RAW socket on " + task.bus);
+        return;
+    }
+    can_frame frame = toCanFrame(task.frame);
+    if (write(fd, &frame, sizeof(frame)) != static_cast<ssize_t>(sizeof(frame))) {
+        fail(taskId, task, "send on " + task.bus);
+        return;
+    }
+    task.status = "completed";
+}
+
+int SocketCanBackend::rawSocket(const std::string& bus)
+{
+    auto it = rawSockets.find(bus);
+    if (it != rawSockets.end()) {
+        return it->second;
+    }
+    int fd = socket(PF_CAN, SOCK_RAW | SOCK_CLOEXEC, CAN_RAW);
+    if (fd == -1) {
+        return -1;
+    }
+    sockaddr_can addr {};
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = static_cast<int>(if_nametoindex(bus.c_str()));
+    if (addr.can_ifindex == 0 || bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1) {
+        close(fd);
+        return -1;
+    }
+    rawSockets[bus] = fd;
+    return fd;
+}
+
+void SocketCanBackend::fail(const std::string& taskId, Task& task, const std::string& what)
+{
+    std::cerr << "SocketCanBackend: " << taskId << " " << what << ": " << strerror(errno) << std::endl;
+    task.status = "error";
+}
@@ -0,0 +1,87 @@
+#ifndef SOCKETCANBACKEND_H
+#define SOCKETCANBACKEND_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Transmits straight from the GUI process onto this machine's SocketCAN interfaces, for single-machine use
+// without a server. Recurring frames are CAN_BCM TX_SETUP jobs, so the kernel keeps the interval; one-shots go
+// out through CAN_RAW. All sockets belong to one worker thread, which also times delayed one-shots. The public
+// methods can be called from any thread: argument errors come back right away, everything else is queued.
+// Finished tasks move to a bounded history, like the server's, so they stay listed without being rescanned.
+class SocketCanBackend {
+public:
+    static constexpr size_t historySize = 100; // Finished tasks kept listed, oldest dropped first
+
+    struct Frame {
+        uint32_t id = 0;
+        bool extended = false;
+        std::vector<uint8_t> data; // classic CAN, at most 8 bytes
+    };
+
+    SocketCanBackend();
+    ~SocketCanBackend(); // Stops every task and joins the worker
+
+    // Both return the new task ID ("task_<n>"), or an empty string with `error` set
+    std::string startRecurring(const std::string& bus, const Frame& frame, int intervalMs, std::string& error);
+    std::string sendOnce(const std::string& bus, const Frame& frame, int delayMs, std::string& error);
+
+    bool stop(const std::string& taskId);
+    bool pause(const std::string& taskId);
+    bool resume(const std::string& taskId);
+    void stopAll();
+
+    // Same format as the server's LIST_TASKS reply, so DbcSender parses both the same way
+    std::string listTasks() const;
+
+    static std::vector<std::string> interfaces();
+    // "<hex id>" and "<hex data>" as cansend takes them: more than 3 id digits means an extended ID
+    static bool parseFrame(const std::string& canId, const std::string& hexData, Frame& frame, std::string& error);
+
+private:
+    struct Task {
+        std::string bus;
+        Frame frame;
+        int intervalMs = 0;
+        bool recurring = false;
+        bool paused = false;
+        std::string status = "running"; // running, paused, completed, error
+        int bcmSocket = -1;             // recurring only, one BCM socket per task so equal CAN IDs don't collide
+        std::chrono::steady_clock::time_point due; // one-shots only
+    };
+
+    static std::string listingLine(uint64_t number, const Task& task);
+
+    std::string addTask(Task task, std::string& error);
+    void retire(std::map<uint64_t, Task>::iterator it); // Finished: from `tasks` into `history`
+    bool isFinished(uint64_t number) const; // In `history`
+    void post(std::function<void()> job); // Run on the worker, with `mtx` held
+    void run();
+
+    // Worker thread only
+    void armBcm(const std::string& taskId, std::map<uint64_t, Task>::iterator it); // Retires it on failure
+    void disarmBcm(Task& task);
+    void sendRaw(const std::string& taskId, Task& task);
+    int rawSocket(const std::string& bus);
+    void fail(const std::string& taskId, Task& task, const std::string& what);
+
+    mutable std::mutex mtx; // Guards everything below
+    std::condition_variable wake;
+    std::deque<std::function<void()>> jobs;
+    std::map<uint64_t, Task> tasks; // Live ones, by task number, so listings come out in creation order
+    std::deque<std::pair<uint64_t, std::string>> history; // Number and listing line of finished ones, oldest first
+    std::map<std::string, int> rawSockets; // Bus -> CAN_RAW socket, opened on first use
+    uint64_t nextTaskNumber = 0;
+    bool stopping = false;
+    std::thread worker; // Last, so it starts after the rest is constructed
+};
+
+#endif // SOCKETCANBACKEND_H
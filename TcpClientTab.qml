@@ -40,6 +40,20 @@ Rectangle {
         }
     }
 
+    // The servers added below connect in the background
+    Connections {
+        target: typeof dbcParser !== 'undefined' ? dbcParser : null
+
+        function onServerAdded(node, connected) {
+            messageHistory.append({
+                "timestamp": new Date().toLocaleTimeString(Qt.locale(), "hh:mm:ss"),
+                "type": connected ? "system" : "error",
+                "content": (connected ? "Added server " : "Failed to add server ") + node
+            })
+            messageListView.positionViewAtEnd()
+        }
+    }
+
     ColumnLayout {
         anchors.fill: parent
         anchors.margins: 25
@@ -262,6 +276,105 @@ Rectangle {
             }
         }
 
+        // More servers of a distributed bench; their buses show up as "<name>:<bus>" wherever a bus is picked
+        GroupBox {
+            title: "Bench Servers"
+            Layout.fillWidth: true
+            visible: typeof dbcParser !== 'undefined' && dbcParser !== null
+
+            background: Rectangle {
+                color: "white"
+                border.color: "#E0E0E0"
+                border.width: 1
+                radius: 4
+            }
+
+            label: Label {
+                text: parent.title
+                font.pixelSize: 14
+                font.weight: Font.Medium
+                color: "#424242"
+                leftPadding: 8
+                rightPadding: 8
+                background: Rectangle {
+                    color: "white"
+                }
+            }
+
+            ColumnLayout {
+                anchors.left: parent.left
+                anchors.right: parent.right
+                anchors.margins: 25
+                spacing: 10
+
+                RowLayout {
+                    Layout.fillWidth: true
+                    spacing: 10
+
+                    TextField {
+                        id: nodeNameField
+                        Layout.preferredWidth: 100
+                        placeholderText: "Name"
+                        selectByMouse: true
+                    }
+
+                    TextField {
+                        id: nodeAddressField
+                        Layout.fillWidth: true
+                        placeholderText: "Address"
+                        selectByMouse: true
+                    }
+
+                    TextField {
+                        id: nodePortField
+                        Layout.preferredWidth: 80
+                        text: portField.text
+                        validator: IntValidator { bottom: 1; top: 65535 }
+                        selectByMouse: true
+                    }
+
+                    Button {
+                        text: "Add"
+                        enabled: nodeNameField.text.trim() !== "" && nodeAddressField.text.trim() !== ""
+                        onClicked: {
+                            var name = nodeNameField.text.trim()
+                            var address = nodeAddressField.text.trim()
+                            var ok = dbcParser.addServer(name, address, nodePortField.text)
+                            messageHistory.append({
+                                "timestamp": new Date().toLocaleTimeString(Qt.locale(), "hh:mm:ss"),
+                                "type": ok ? "system" : "error",
+                                "content": (ok ? "Connecting server " : "Invalid server name ") + name + " (" + address + ":" + nodePortField.text + ")"
+                            })
+                            messageListView.positionViewAtEnd()
+                            if (ok) {
+                                nodeNameField.text = ""
+                            }
+                        }
+                    }
+                }
+
+                Repeater {
+                    model: typeof dbcParser !== 'undefined' && dbcParser !== null ? dbcParser.serverNodes : []
+
+                    RowLayout {
+                        Layout.fillWidth: true
+
+                        Text {
+                            text: modelData
+                            font.pixelSize: 13
+                            color: "#424242"
+                            Layout.fillWidth: true
+                        }
+
+                        Button {
+                            text: "Remove"
+                            onClicked: dbcParser.removeServer(modelData)
+                        }
+                    }
+                }
+            }
+        }
+
         // Message history
         GroupBox {
             title: "Message History"
@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 Joseph Ogle, Kunal Singh, and Deven Nasso
+
+// Bulk decode benchmark: a million frames of one message into signal columns, frame by frame through
+// DbcCodec::decode (the per-frame baseline, copying each frame's values into the columns) against decodeBatch, for
+// a classic 8-byte message from packed payloads and from SocketCAN-sized records, and for a 64-byte CAN FD one.
+// Signals as in bench_codec. Prints the median frames decoded per second over several rounds and the range of the
+// per-round speedup, and checks both paths give the same values. Single rounds are noisy: on a shared machine
+// they ranged from about 0.8x to 2.8x in every case.
+//   g++ -std=c++20 -O3 -o bench_batch bench_batch.cpp DbcCodec.cpp && ./bench_batch
+// What SIMD itself buys is the decodeBatch column of that build against the same kernels built without it:
+//   g++ -std=c++20 -O3 -DDBCCODEC_NO_CLONES -fno-tree-vectorize -o bench_batch_novec bench_batch.cpp DbcCodec.cpp
+// On one AVX2/AVX-512 Xeon core, decodeBatch medians over two runs each, clones -> no clones: 8-byte packed 52-55
+// -> 36 M frames/s, 8-byte can_frame 44-49 -> 34, 64-byte FD 3.2-3.3 -> 3.0-3.2. Per-frame decode() ran 24, 23
+// and 2.0 in both. So for 8-byte frames most of the gain over decode() is the column layout and AVX2 adds about
+// 1.4-1.5x on top; for FD frames the byte-wise steps don't vectorize and the clones add next to nothing.
+
+#include "DbcCodec.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// ---- old path: one frame at a time ----
+
+static void decodeFrames(const DbcCodec& codec, const uint8_t* data, size_t stride, size_t size, size_t count,
+                         std::vector<std::vector<double>>& columns) {
+    std::vector<double> values(codec.signalCount());
+    columns.resize(codec.signalCount());
+    for (auto& column : columns) column.resize(count);
+    for (size_t n = 0; n < count; ++n) {
+        codec.decode(data + n * stride, size, values.data());
+        for (size_t i = 0; i < values.size(); ++i) columns[i][n] = values[i];
+    }
+}
+
+// ---- driver ----
+
+// Signals of 4, 8, 12 and 16 bits laid end to end, alternating Intel and Motorola, every third one signed
+static canMessage makeMessage(int length) {
+    canMessage msg;
+    msg.id = 0x100;
+    msg.name = "Bench";
+    msg.length = length;
+    int bit = 0;
+    for (int i = 0; bit < length * 8; ++i) {
+        canSignal sig;
+        sig.name = "Signal_" + std::to_string(i);
+        sig.length = std::min(4 + 4 * (i % 4), length * 8 - bit);
+        sig.littleEndian = i % 2 == 0;
+        sig.startBit = sig.littleEndian ? bit : DbcCodec::motorolaLinear(bit);
+        sig.isSigned = i % 3 == 2;
+        sig.factor = 0.5;
+        sig.offset = sig.isSigned ? 0.0 : -10.0;
+        msg.signalList.push_back(sig);
+        bit += sig.length;
+    }
+    return msg;
+}
+
+template <typename Fn>
+static double framesPerSecond(size_t frames, Fn&& run) {
+    auto start = std::chrono::steady_clock::now();
+    run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return frames / elapsed.count();
+}
+
+static double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+int main() {
+    constexpr int rounds = 9;
+#ifdef DBCCODEC_NO_CLONES
+    std::cout << "decodeBatch kernels: no target_clones\n";
+#else
+    std::cout << "decodeBatch kernels: target_clones(avx2, default) where supported\n";
+#endif
+    struct Case {
+        const char* name;
+        int length;
+        size_t stride;
+        size_t frames;
+    };
+    // 16 bytes a record: a can_frame's 8-byte header and its payload
+    for (Case c : {Case{"8-byte packed", 8, 8, 1'000'000}, Case{"8-byte can_frame", 8, 16, 1'000'000},
+                   Case{"64-byte FD", 64, 64, 200'000}}) {
+        canMessage msg = makeMessage(c.length);
+        DbcCodec codec(msg);
+        std::vector<uint8_t> frames(c.stride * c.frames);
+        std::mt19937_64 rng(42);
+        for (auto& byte : frames) byte = static_cast<uint8_t>(rng());
+
+        // The two paths take turns, so a noisy neighbour slows both in the same round rather than one of them
+        std::vector<std::vector<double>> oldColumns;
+        DbcCodec::Columns columns;
+        std::vector<double> oldRates, newRates, ratios;
+        decodeFrames(codec, frames.data(), c.stride, c.length, c.frames, oldColumns); // Warm-up: sizes the columns
+        codec.decodeBatch(frames.data(), c.stride, c.length, c.frames, columns);
+        for (int round = 0; round < rounds; ++round) {
+            oldRates.push_back(framesPerSecond(c.frames, [&] {
+                decodeFrames(codec, frames.data(), c.stride, c.length, c.frames, oldColumns);
+            }));
+            newRates.push_back(framesPerSecond(c.frames, [&] {
+                codec.decodeBatch(frames.data(), c.stride, c.length, c.frames, columns);
+            }));
+            ratios.push_back(newRates.back() / oldRates.back());
+        }
+        bool same = oldColumns == columns.physical;
+
+        std::cout << c.name << ", " << msg.signalList.size() << " signals: " << median(oldRates) / 1e6 << " -> "
+                  << median(newRates) / 1e6 << " M frames/s (median of " << rounds << "), speedup "
+                  << *std::min_element(ratios.begin(), ratios.end()) << "x to "
+                  << *std::max_element(ratios.begin(), ratios.end()) << "x, median " << median(ratios) << "x"
+                  << (same ? "" : " (MISMATCH)") << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 Joseph Ogle, Kunal Singh, and Deven Nasso
+
+// Frame pack/unpack benchmark: the per-bit loop buildCanFrame used before DbcCodec against the compiled codec, for
+// a classic 8-byte message (one 64-bit word op per signal) and a 64-byte CAN FD one (one step per byte), half Intel
+// and half Motorola signals, some signed. Prints frames encoded and decoded per second; the decode baseline is the
+// same bit loop run backwards.
+//   g++ -std=c++20 -O2 -o bench_codec bench_codec.cpp DbcCodec.cpp && ./bench_codec
+
+#include "DbcCodec.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// ---- old path: buildCanFrame's packing loop, fixed to the DBC Motorola layout so both sides agree ----
+
+static void encodeOld(const canMessage& msg, uint8_t* frameData) {
+    std::fill(frameData, frameData + msg.length, 0);
+    for (const auto& sig : msg.signalList) {
+        double rawValue = std::round((sig.value - sig.offset) / sig.factor);
+        uint64_t intValue = sig.isSigned ? static_cast<uint64_t>(static_cast<int64_t>(rawValue))
+                                         : static_cast<uint64_t>(rawValue);
+        int pos = sig.startBit;
+        for (int i = 0; i < sig.length; i++) {
+            int k = sig.littleEndian ? i : sig.length - 1 - i;
+            int byteIndex = pos / 8;
+            int bitIndex = pos % 8;
+            if (byteIndex < msg.length) {
+                if (intValue & (1ULL << k)) {
+                    frameData[byteIndex] |= (1 << bitIndex);
+                } else {
+                    frameData[byteIndex] &= ~(1 << bitIndex);
+                }
+            }
+            pos = sig.littleEndian ? pos + 1 : (pos % 8 == 0 ? pos + 15 : pos - 1);
+        }
+    }
+}
+
+static void decodeOld(const canMessage& msg, const uint8_t* frameData, double* physical) {
+    for (size_t s = 0; s < msg.signalList.size(); ++s) {
+        const canSignal& sig = msg.signalList[s];
+        uint64_t raw = 0;
+        int pos = sig.startBit;
+        for (int i = 0; i < sig.length; i++) {
+            int k = sig.littleEndian ? i : sig.length - 1 - i;
+            if (pos / 8 < msg.length && (frameData[pos / 8] & (1 << (pos % 8)))) {
+                raw |= 1ULL << k;
+            }
+            pos = sig.littleEndian ? pos + 1 : (pos % 8 == 0 ? pos + 15 : pos - 1);
+        }
+        if (sig.isSigned && sig.length < 64 && (raw >> (sig.length - 1)) & 1) {
+            raw |= ~0ULL << sig.length;
+        }
+        double value = sig.isSigned ? static_cast<double>(static_cast<int64_t>(raw)) : static_cast<double>(raw);
+        physical[s] = value * sig.factor + sig.offset;
+    }
+}
+
+// ---- driver ----
+
+// Signals of 4, 8, 12 and 16 bits laid end to end, alternating Intel and Motorola, every third one signed
+static canMessage makeMessage(int length) {
+    canMessage msg;
+    msg.id = 0x100;
+    msg.name = "Bench";
+    msg.length = length;
+    int bit = 0;
+    for (int i = 0; bit < length * 8; ++i) {
+        canSignal sig;
+        sig.name = "Signal_" + std::to_string(i);
+        sig.length = std::min(4 + 4 * (i % 4), length * 8 - bit);
+        sig.littleEndian = i % 2 == 0;
+        // A Motorola signal's start bit is its MSB: the top bit of the run in big-endian order
+        sig.startBit = sig.littleEndian ? bit : (bit / 8) * 8 + 7 - bit % 8;
+        sig.isSigned = i % 3 == 2;
+        sig.factor = 0.5;
+        sig.offset = sig.isSigned ? 0.0 : -10.0;
+        double top = std::ldexp(1.0, sig.length - (sig.isSigned ? 1 : 0)) - 1;
+        sig.value = (sig.isSigned ? -top / 3 : top / 3) * sig.factor + sig.offset;
+        msg.signalList.push_back(sig);
+        bit += sig.length;
+    }
+    return msg;
+}
+
+template <typename Fn>
+static double framesPerSecond(int frames, Fn&& run) {
+    double best = 1e9;
+    for (int round = 0; round < 5; ++round) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; ++i) run(i);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return frames / best;
+}
+
+int main() {
+    for (int length : {8, 64}) {
+        canMessage msg = makeMessage(length);
+        DbcCodec codec(msg);
+        std::vector<uint8_t> oldFrame(length), newFrame(length);
+        std::vector<double> oldValues(msg.signalList.size()), newValues(msg.signalList.size());
+        int frames = length == 8 ? 2'000'000 : 200'000;
+        volatile uint8_t sink = 0;
+
+        double oldEncode = framesPerSecond(frames, [&](int i) {
+            msg.signalList[0].value = i % 7;
+            encodeOld(msg, oldFrame.data());
+            sink = sink + oldFrame[0];
+        });
+        double newEncode = framesPerSecond(frames, [&](int i) {
+            msg.signalList[0].value = i % 7;
+            codec.encode(msg.signalList, newFrame.data());
+            sink = sink + newFrame[0];
+        });
+        double oldDecode = framesPerSecond(frames, [&](int i) {
+            oldFrame[0] = static_cast<uint8_t>(i);
+            decodeOld(msg, oldFrame.data(), oldValues.data());
+            sink = sink + static_cast<uint8_t>(oldValues[0]);
+        });
+        double newDecode = framesPerSecond(frames, [&](int i) {
+            newFrame[0] = static_cast<uint8_t>(i);
+            codec.decode(newFrame.data(), newFrame.size(), newValues.data());
+            sink = sink + static_cast<uint8_t>(newValues[0]);
+        });
+
+        encodeOld(msg, oldFrame.data());
+        codec.encode(msg.signalList, newFrame.data());
+        decodeOld(msg, oldFrame.data(), oldValues.data());
+        codec.decode(newFrame.data(), newFrame.size(), newValues.data());
+        bool same = oldFrame == newFrame && oldValues == newValues;
+
+        std::cout << length << "-byte frame, " << msg.signalList.size() << " signals: encode " << oldEncode / 1e6
+                  << " -> " << newEncode / 1e6 << " M frames/s (" << newEncode / oldEncode << "x), decode "
+                  << oldDecode / 1e6 << " -> " << newDecode / 1e6 << " M frames/s (" << newDecode / oldDecode << "x)"
+                  << (same ? "" : " (MISMATCH)") << "\n";
+    }
+    return 0;
+}
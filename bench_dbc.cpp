@@ -0,0 +1,229 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 Joseph Ogle, Kunal Singh, and Deven Nasso
+
+// Load-time benchmark for DBC files, single thread: the old line-by-line path (getline, a regex built per SG_
+// line, split into string lists) against DbcReader's tokenizer over the mapped file. Writes synthetic DBCs with
+// 1k, 10k and 50k signals (and 500k for the multi-threaded parse) to the temp directory and prints the best of
+// several loads of each.
+// std::regex stands in for QRegularExpression so this builds without Qt; it is slower than PCRE2, so read the
+// old column as an upper bound.
+// Last, the reload of an unchanged file from its snapshot (hash the text, map and unpack the snapshot).
+//   g++ -std=c++20 -O2 -pthread -o bench_dbc bench_dbc.cpp DbcReader.cpp DbcSnapshot.cpp && ./bench_dbc
+
+#include "DbcReader.h"
+#include "DbcSnapshot.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ---- old path: parseDBC before the tokenizer, with Qt's string helpers replaced by their std equivalents ----
+
+static std::vector<std::string> split(const std::string& s, char sep) {
+    std::vector<std::string> parts;
+    std::stringstream ss(s);
+    std::string part;
+    while (std::getline(ss, part, sep)) {
+        if (!part.empty()) parts.push_back(part);
+    }
+    return parts;
+}
+
+static double toDouble(const std::string& s) {
+    try {
+        return std::stod(s);
+    } catch (...) {
+        return 0.0;
+    }
+}
+
+static const char* const signalPattern =
+    " SG_ ([^ ]+) : (\\d+)\\|(\\d+)@([01])([+-]) \\(([^,]+),([^\\)]+)\\) \\[([^\\|]+)\\|([^\\]]+)\\] \"([^\"]*)\"";
+
+// `shared` hoists the regex out of the loop, which the old code didn't do: the fairer baseline
+static void parseOld(const std::string& path, std::vector<canMessage>& messages, bool shared) {
+    const std::regex sharedRe(signalPattern);
+    std::ifstream in(path);
+    std::string line;
+    canMessage* currentMessage = nullptr;
+    while (std::getline(in, line)) {
+        if (line.rfind("BO_", 0) == 0) {
+            std::vector<std::string> parts = split(line, ' ');
+            if (parts.size() >= 4) {
+                canMessage msg;
+                msg.id = std::stoul(parts[1]);
+                std::string name = parts[2];
+                if (!name.empty() && name.back() == ':') name.pop_back();
+                msg.name = name;
+                size_t colon = line.find(':');
+                if (colon != std::string::npos) {
+                    std::vector<std::string> afterColon = split(line.substr(colon + 1), ' ');
+                    if (!afterColon.empty()) msg.length = std::stoi(afterColon[0]);
+                }
+                messages.push_back(msg);
+                currentMessage = &messages.back();
+            }
+        } else if (line.find(" SG_") != std::string::npos && currentMessage) {
+            std::regex perLine = shared ? std::regex() : std::regex(signalPattern);
+            std::smatch match;
+            if (std::regex_search(line, match, shared ? sharedRe : perLine)) {
+                canSignal sig;
+                sig.name = match[1];
+                sig.startBit = std::stoi(match[2]);
+                sig.length = std::stoi(match[3]);
+                sig.littleEndian = match[4] == "1";
+                sig.factor = toDouble(match[6]);
+                sig.offset = toDouble(match[7]);
+                sig.min = toDouble(match[8]);
+                sig.max = toDouble(match[9]);
+                sig.unit = match[10];
+                currentMessage->signalList.push_back(sig);
+            }
+        }
+    }
+}
+
+// ---- driver ----
+
+// Eight signals per message, every fourth message multiplexed, with the comment, attribute and value table lines
+// real OEM files carry between the blocks
+static std::string writeDbc(int signalCount) {
+    std::string path = (std::filesystem::temp_directory_path() / ("bench_" + std::to_string(signalCount) + ".dbc")).string();
+    std::ofstream out(path, std::ios::binary);
+    out << "VERSION \"\"\n\nNS_ :\n\tCM_\n\tBA_DEF_\n\nBS_:\n\nBU_: ECU1 ECU2 ECU3\n\n";
+    int messages = (signalCount + 7) / 8;
+    for (int m = 0; m < messages; ++m) {
+        bool mux = m % 4 == 3;
+        out << "BO_ " << (0x100 + m) << " Message_" << m << ": 8 ECU" << (m % 3 + 1) << "\n";
+        for (int s = 0; s < 8 && m * 8 + s < signalCount; ++s) {
+            out << " SG_ Signal_" << m << '_' << s;
+            if (mux) out << (s == 0 ? " M" : " m" + std::to_string(s % 2));
+            bool intel = (m + s) % 2 == 0;
+            int start = intel ? s * 8 : s * 8 + 7;
+            out << " : " << start << "|8@" << (intel ? '1' : '0') << (s % 3 ? '+' : '-')
+                << " (0.1," << -s << ") [" << -s << "|" << 25.5 - s << "] \"km/h\" ECU2,ECU3\n";
+        }
+        out << "\n";
+    }
+    for (int m = 0; m < messages; ++m) {
+        out << "CM_ SG_ " << (0x100 + m) << " Signal_" << m << "_0 \"First signal of message " << m << "\";\n";
+        out << "BA_ \"GenMsgCycleTime\" BO_ " << (0x100 + m) << " 100;\n";
+        out << "VAL_ " << (0x100 + m) << " Signal_" << m << "_1 0 \"Off\" 1 \"On\" ;\n";
+    }
+    return path;
+}
+
+template <typename Fn>
+static double bestOf(int runs, Fn&& load) {
+    double best = 1e9;
+    for (int i = 0; i < runs; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        load();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+static size_t countSignals(const std::vector<canMessage>& messages) {
+    size_t n = 0;
+    for (const auto& msg : messages) n += msg.signalList.size();
+    return n;
+}
+
+int main() {
+    for (int signalCount : {1'000, 10'000, 50'000}) {
+        std::string path = writeDbc(signalCount);
+        auto size = std::filesystem::file_size(path);
+
+        std::vector<canMessage> oldMessages, newMessages;
+        double oldMs = bestOf(1, [&] {
+            oldMessages.clear();
+            parseOld(path, oldMessages, false);
+        });
+        double sharedMs = bestOf(3, [&] {
+            oldMessages.clear();
+            parseOld(path, oldMessages, true);
+        });
+        double newMs = bestOf(10, [&] {
+            newMessages.clear();
+            MappedFile file;
+            std::string error;
+            if (!file.open(path, error)) std::cerr << error << "\n";
+            DbcReader::parse(file.view(), newMessages, std::atomic<bool>{false}, {}, 1);
+        });
+
+        // The copy above leaves out the old fallback, so it drops the multiplexed signals the tokenizer keeps
+        std::cout << signalCount << " signals (" << size / 1024 << " KiB): old " << oldMs << " ms, with one regex " << sharedMs << " ms ("
+                  << countSignals(oldMessages) << " signals), tokenizer " << newMs << " ms ("
+                  << newMessages.size() << " messages, " << countSignals(newMessages) << " signals), "
+                  << oldMs / newMs << "x / " << sharedMs / newMs << "x\n";
+        std::filesystem::remove(path);
+    }
+
+    // Block-parallel parse against one thread on the same mapped file
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (int signalCount : {50'000, 500'000}) {
+        std::string path = writeDbc(signalCount);
+        MappedFile file;
+        std::string error;
+        if (!file.open(path, error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        std::cout << signalCount << " signals (" << file.view().size() / 1024 << " KiB):";
+        size_t expected = 0;
+        for (unsigned threads = 1; threads <= cores; threads *= 2) {
+            std::vector<canMessage> messages;
+            double ms = bestOf(10, [&] {
+                messages.clear();
+                DbcReader::parse(file.view(), messages, std::atomic<bool>{false}, {}, threads);
+            });
+            size_t signals = countSignals(messages);
+            if (threads == 1) expected = signals;
+            std::cout << " " << threads << (threads == 1 ? " thread " : " threads ") << ms << " ms"
+                      << (signals == expected ? "" : " (MISMATCH)") << (threads * 2 <= cores ? "," : "\n");
+        }
+        file.close();
+        std::filesystem::remove(path);
+    }
+
+    // Reload from the snapshot against a parse, both from the mapped file
+    for (int signalCount : {10'000, 50'000, 500'000}) {
+        std::string path = writeDbc(signalCount);
+        std::string snapshot = path + ".dbcsnap";
+        MappedFile file;
+        std::string error;
+        if (!file.open(path, error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        std::vector<canMessage> parsed, loaded;
+        double parseMs = bestOf(5, [&] {
+            parsed.clear();
+            DbcReader::parse(file.view(), parsed);
+        });
+        uint64_t hash = DbcSnapshot::contentHash(file.view());
+        if (!DbcSnapshot::save(snapshot, hash, file.view().size(), parsed, error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        bool ok = true;
+        double loadMs = bestOf(5, [&] {
+            loaded.clear();
+            ok = DbcSnapshot::load(snapshot, DbcSnapshot::contentHash(file.view()), file.view().size(), loaded) && ok;
+        });
+        std::cout << signalCount << " signals: parse " << parseMs << " ms, snapshot ("
+                  << std::filesystem::file_size(snapshot) / 1024 << " KiB) " << loadMs << " ms"
+                  << (ok && countSignals(loaded) == countSignals(parsed) ? "" : " (MISMATCH)") << "\n";
+        file.close();
+        std::filesystem::remove(path);
+        std::filesystem::remove(snapshot);
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 Joseph Ogle, Kunal Singh, and Deven Nasso
+
+// Signal layout query benchmark: the std::set scans DbcParser ran on every call before DbcLayout against the
+// message's bitmaps, for a classic 8-byte message and a 64-byte CAN FD one with signals as in bench_codec and a
+// free byte left near the end. Times getNextAvailableStartBit for that byte, checkSignalOverlap for a signal on top
+// of the last one, and an isBitOccupied sweep over every bit of the frame (what a bit grid asks for); the bitmap
+// side includes building the layout, as after an edit. Prints queries per second and checks both give the same.
+//   g++ -std=c++20 -O2 -o bench_layout bench_layout.cpp DbcLayout.cpp && ./bench_layout
+
+#include "DbcLayout.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <vector>
+
+// ---- old path: the per-signal std::set scans, fixed to the DBC Motorola layout so both sides agree ----
+
+static std::set<int> bitPositions(int startBit, int length, bool littleEndian) {
+    std::set<int> bits;
+    for (int i = 0; i < length; i++) {
+        if (littleEndian) {
+            bits.insert(startBit + i);
+        } else {
+            bits.insert(DbcCodec::motorolaLinear(DbcCodec::motorolaLinear(startBit) + i));
+        }
+    }
+    return bits;
+}
+
+static bool overlapsOld(const canMessage& msg, int startBit, int length, bool littleEndian) {
+    std::set<int> newBits = bitPositions(startBit, length, littleEndian);
+    for (const auto& sig : msg.signalList) {
+        std::set<int> existingBits = bitPositions(sig.startBit, sig.length, sig.littleEndian);
+        for (int bit : newBits) {
+            if (existingBits.count(bit) > 0) return true;
+        }
+    }
+    return false;
+}
+
+static int nextAvailableOld(const canMessage& msg, int length) {
+    for (int startBit = 0; startBit <= msg.length * 8 - length; startBit++) {
+        if (!overlapsOld(msg, startBit, length, true)) return startBit;
+    }
+    return -1;
+}
+
+static bool occupiedOld(const canMessage& msg, int bit) {
+    for (const auto& sig : msg.signalList) {
+        if (bitPositions(sig.startBit, sig.length, sig.littleEndian).count(bit) > 0) return true;
+    }
+    return false;
+}
+
+// ---- driver ----
+
+// Signals of 4, 8, 12 and 16 bits laid end to end, alternating Intel and Motorola, with the next to last byte free
+static canMessage makeMessage(int length) {
+    canMessage msg;
+    msg.id = 0x100;
+    msg.name = "Bench";
+    msg.length = length;
+    int gap = (length - 2) * 8;
+    int bit = 0;
+    for (int i = 0; bit < length * 8; ++i) {
+        if (bit == gap) {
+            bit += 8;
+            continue;
+        }
+        int end = bit < gap ? gap : length * 8;
+        canSignal sig;
+        sig.name = "Signal_" + std::to_string(i);
+        sig.length = std::min(4 + 4 * (i % 4), end - bit);
+        sig.littleEndian = i % 2 == 0;
+        sig.startBit = sig.littleEndian ? bit : DbcCodec::motorolaLinear(bit);
+        msg.signalList.push_back(sig);
+        bit += sig.length;
+    }
+    return msg;
+}
+
+template <typename Fn>
+static double queriesPerSecond(int queries, Fn&& run) {
+    double best = 1e9;
+    for (int round = 0; round < 5; ++round) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < queries; ++i) run(i);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return queries / best;
+}
+
+int main() {
+    for (int length : {8, 64}) {
+        canMessage msg = makeMessage(length);
+        const canSignal& last = msg.signalList.back();
+        int frameBits = length * 8;
+        int queries = length == 8 ? 20'000 : 200;
+        volatile int sink = 0;
+
+        double oldNext = queriesPerSecond(queries, [&](int) { sink = sink + nextAvailableOld(msg, 8); });
+        double newNext = queriesPerSecond(queries, [&](int) { sink = sink + DbcLayout(msg).firstFree(8, frameBits); });
+        double oldOverlap = queriesPerSecond(queries, [&](int) {
+            sink = sink + overlapsOld(msg, last.startBit, last.length, last.littleEndian);
+        });
+        double newOverlap = queriesPerSecond(queries, [&](int) {
+            sink = sink + DbcLayout(msg).overlaps(DbcLayout::signalBits(last.startBit, last.length, last.littleEndian));
+        });
+        double oldSweep = queriesPerSecond(queries, [&](int) {
+            for (int bit = 0; bit < frameBits; ++bit) sink = sink + occupiedOld(msg, bit);
+        });
+        double newSweep = queriesPerSecond(queries, [&](int) {
+            DbcLayout layout(msg);
+            for (int bit = 0; bit < frameBits; ++bit) sink = sink + layout.occupied(bit);
+        });
+
+        DbcLayout layout(msg);
+        bool same = nextAvailableOld(msg, 8) == layout.firstFree(8, frameBits) &&
+                    overlapsOld(msg, last.startBit, last.length, last.littleEndian);
+        for (int bit = 0; bit < frameBits; ++bit) {
+            same = same && occupiedOld(msg, bit) == layout.occupied(bit);
+        }
+
+        std::cout << length << "-byte frame, " << msg.signalList.size() << " signals: next start bit "
+                  << oldNext / 1e3 << " -> " << newNext / 1e3 << " k/s (" << newNext / oldNext << "x), overlap "
+                  << oldOverlap / 1e3 << " -> " << newOverlap / 1e3 << " k/s (" << newOverlap / oldOverlap
+                  << "x), bit sweep " << oldSweep / 1e3 << " -> " << newSweep / 1e3 << " k/s (" << newSweep / oldSweep
+                  << "x)" << (same ? "" : " (MISMATCH)") << "\n";
+    }
+    return 0;
+}